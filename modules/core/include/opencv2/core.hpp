@@ -213,7 +213,16 @@ enum KmeansFlags {
         user-supplied labels instead of computing them from the initial centers. For the second and
         further attempts, use the random or semi-random centers. Use one of KMEANS_\*_CENTERS flag
         to specify the exact method.*/
-    KMEANS_USE_INITIAL_LABELS = 1
+    KMEANS_USE_INITIAL_LABELS = 1,
+    /** Use the scalable k-means|| center initialization by Bahmani et al. @cite Bahmani2012. The
+        candidate centers are oversampled in a few rounds with the distance updates running in
+        parallel, and then reclustered into K centers with weighted kmeans++.*/
+    KMEANS_PARALLEL_CENTERS   = 4,
+    /** Use triangle inequality bounds by Hamerly @cite Hamerly2010 to skip most of the
+        point-to-center distance computations during the label assignment. The result matches
+        the standard Lloyd iterations up to floating-point rounding of near-ties, while the
+        memory overhead is only two floats per sample.*/
+    KMEANS_ACCELERATED        = 8
 };
 
 enum ReduceTypes { REDUCE_SUM = 0, //!< the output is the sum of all rows/columns of the matrix.
@@ -1891,6 +1900,26 @@ stores the indices of sorted elements in the output array. For example:
 */
 CV_EXPORTS_W void sortIdx(InputArray src, OutputArray dst, int flags);
 
+/** @brief Finds the k smallest (or largest) elements of each row or each column of a matrix.
+
+The function cv::topK is a partial version of cv::sort and cv::sortIdx: only the first k elements
+of each sorted row (column) are computed, which is considerably faster than the full sort when k is
+small. The equal elements are ordered by their original positions.
+@code
+    Mat scores = (Mat_<float>(1, 6) << 0.1f, 0.7f, 0.3f, 0.9f, 0.7f, 0.2f), values, indices;
+    topK(scores, 3, values, indices, SORT_EVERY_ROW + SORT_DESCENDING);
+    // values: [0.9, 0.7, 0.7], indices: [3, 1, 4]
+@endcode
+@param src input single-channel array.
+@param k number of elements to find in each row (column), 0 <= k <= src.cols (src.rows).
+@param values output array with the found elements, k columns (rows) and the type of src. Can be
+noArray() if only the indices are needed.
+@param indices output integer array with the positions of the found elements in src. Can be noArray().
+@param flags operation flags, a combination of #SortFlags
+@sa sort, sortIdx
+*/
+CV_EXPORTS_W void topK(InputArray src, int k, OutputArray values, OutputArray indices, int flags);
+
 /** @brief Finds the real roots of a cubic equation.
 
 The function solveCubic finds the real roots of a cubic equation:
@@ -1955,6 +1984,80 @@ The function calculates eigenvalues and eigenvectors (optional) of the square ma
 CV_EXPORTS_W void eigenNonSymmetric(InputArray src, OutputArray eigenvalues,
                                     OutputArray eigenvectors);
 
+/** @brief Solves a batch of small linear systems or least-squares problems.
+
+The function solves N independent problems \f$\texttt{src1}_i \cdot \texttt{dst}_i = \texttt{src2}_i\f$
+(see cv::solve), where the matrices are packed into continuous 3-dimensional arrays. This avoids the
+per-call overhead of cv::solve when solving thousands of tiny (3x3, 4x4, 6x6 ...) systems. With
+#DECOMP_LU and #DECOMP_CHOLESKY the systems are solved in parallel across the SIMD lanes, one matrix
+per lane; the other methods process the matrices one by one. For the singular (or, with
+#DECOMP_CHOLESKY, not positive-definite) matrices the corresponding solution is filled with zeros.
+@param src1 input N x m x n array of the left-hand side matrices, CV_32F or CV_64F.
+@param src2 input N x m x k array of the right-hand side matrices of the same type.
+@param dst output N x n x k array of the solutions.
+@param status optional output N x 1 CV_8U array, status_i is 1 if the i-th problem is solved.
+@param flags solution method (#DecompTypes), as in cv::solve.
+@return true if all the problems are solved.
+@sa solve, invertBatch
+*/
+CV_EXPORTS bool solveBatch(InputArray src1, InputArray src2, OutputArray dst,
+                           OutputArray status = noArray(), int flags = DECOMP_LU);
+
+/** @brief Inverts a batch of small matrices.
+
+The batched version of cv::invert, see cv::solveBatch for the layout of the arrays.
+@param src input N x m x n array of matrices, CV_32F or CV_64F.
+@param dst output N x n x m array of the inverse (pseudo-inverse) matrices.
+@param status optional output N x 1 CV_8U array, status_i is 1 if the i-th matrix is not singular.
+@param flags inversion method (cv::DecompTypes)
+@return true if all the matrices are inverted.
+@sa invert, solveBatch
+*/
+CV_EXPORTS bool invertBatch(InputArray src, OutputArray dst,
+                            OutputArray status = noArray(), int flags = DECOMP_LU);
+
+/** @brief Computes the singular value decompositions of a batch of small matrices.
+
+The batched version of cv::SVDecomp. For the N x m x n input array the outputs are N x min(m,n) x 1
+array of the singular values, N x m x min(m,n) (N x m x m if SVD::FULL_UV is set) array of the left
+singular vectors and N x min(m,n) x n (N x n x n) array of the transposed right singular vectors.
+The matrices are processed in parallel, without any allocations per matrix.
+@param src input N x m x n array of matrices, CV_32F or CV_64F.
+@param w output array of the singular values.
+@param u optional output array of the left singular vectors.
+@param vt optional output array of the transposed right singular vectors.
+@param flags operation flags, see SVD::Flags.
+@sa SVDecomp, SVD
+*/
+CV_EXPORTS void SVDecompBatch(InputArray src, OutputArray w, OutputArray u = noArray(),
+                              OutputArray vt = noArray(), int flags = 0);
+
+/** @brief Calculates eigenvalues and eigenvectors of a batch of small symmetric matrices.
+
+The batched version of cv::eigen. The eigenvalues of each matrix are stored in the descending order
+into N x n x 1 array, the eigenvectors are stored as subsequent rows of the N x n x n array.
+@param src input N x n x n array of symmetric matrices, CV_32F or CV_64F.
+@param eigenvalues output array of eigenvalues.
+@param eigenvectors optional output array of eigenvectors.
+@return true if all the decompositions converged.
+@sa eigen
+*/
+CV_EXPORTS bool eigenBatch(InputArray src, OutputArray eigenvalues, OutputArray eigenvectors = noArray());
+
+/** @overload
+Fixed-size variant: solves the systems src1[i]*dst[i] = src2[i].
+*/
+template<typename _Tp, int m, int n> static inline
+bool solveBatch(const std::vector< Matx<_Tp, m, m> >& src1, const std::vector< Matx<_Tp, m, n> >& src2,
+                std::vector< Matx<_Tp, m, n> >& dst, std::vector<uchar>& status, int flags = DECOMP_LU);
+
+/** @overload
+Fixed-size variant: computes the inverse matrices dst[i] = src[i]^-1.
+*/
+template<typename _Tp, int m> static inline
+bool invertBatch(const std::vector< Matx<_Tp, m, m> >& src, std::vector< Matx<_Tp, m, m> >& dst,
+                 std::vector<uchar>& status, int flags = DECOMP_LU);
+
 /** @brief Calculates the covariance matrix of a set of vectors.
 
 The function cv::calcCovarMatrix calculates the covariance matrix and, optionally, the mean vector of
@@ -2396,7 +2499,11 @@ class CV_EXPORTS PCA
 public:
     enum Flags { DATA_AS_ROW = 0, //!< indicates that the input samples are stored as matrix rows
                  DATA_AS_COL = 1, //!< indicates that the input samples are stored as matrix columns
-                 USE_AVG     = 2  //!
+                 USE_AVG     = 2, //!
+                 /** compute only the leading `maxComponents` components with a randomized truncated
+                 SVD (random range finder refined by power iterations) instead of the full covariance
+                 matrix decomposition; the data is centered on the fly, in blocks */
+                 RANDOMIZED  = 4
                };
 
     /** @brief default constructor
@@ -2444,10 +2551,15 @@ public:
     columns.
     @param mean optional mean value; if the matrix is empty (noArray()),
     the mean is computed from the data.
-    @param flags operation flags; currently the parameter is only used to
-    specify the data layout. (Flags)
+    @param flags operation flags: the data layout and, optionally, PCA::RANDOMIZED (Flags)
     @param maxComponents maximum number of components that PCA should
-    retain; by default, all the components are retained.
+    retain; by default, all the components are retained. It must be positive
+    for PCA::RANDOMIZED.
+
+    With PCA::RANDOMIZED the operator never forms the covariance matrix: the
+    leading subspace is found from products of the centered data with a thin
+    random matrix, which are computed in parallel over blocks of samples, so
+    the cost is linear in the number of samples and in their dimensionality.
     */
     PCA& operator()(InputArray data, InputArray mean, int flags, int maxComponents = 0);
 
@@ -2464,6 +2576,30 @@ public:
      */
     PCA& operator()(InputArray data, InputArray mean, int flags, double retainedVariance);
 
+    /** @brief updates the model with the next batch of samples (incremental %PCA)
+
+    The model is updated from its current components and the batch only, so the
+    memory does not depend on the number of samples seen so far. An empty structure
+    is initialized from the first batch. The number of samples the model is computed
+    from is not a part of the structure (and is not stored by PCA::write), the caller
+    keeps it along with the model:
+    @code
+    PCA pca;
+    int64 nsamples = 0;
+    for (size_t i = 0; i < batches.size(); i++)
+        pca.update(batches[i], nsamples, PCA::DATA_AS_ROW, 32);
+    @endcode
+
+    @param data the next batch of samples stored as the matrix rows or as the matrix
+    columns.
+    @param samples number of samples the current model is computed from; it must be 0
+    for an empty structure and positive otherwise. It is increased by the batch size.
+    @param flags operation flags; only the data layout is used (PCA::Flags)
+    @param maxComponents maximum number of components that %PCA should
+    retain; by default, all the components are retained.
+     */
+    PCA& update(InputArray data, int64& samples, int flags, int maxComponents = 0);
+
     /** @brief Projects vector(s) to the principal component subspace.
 
     The methods project one or more vectors to the principal component
@@ -3000,6 +3136,72 @@ CV_EXPORTS_W double kmeans( InputArray data, int K, InputOutputArray bestLabels,
                             TermCriteria criteria, int attempts,
                             int flags, OutputArray centers = noArray() );
 
+/** @brief Mini-batch k-means clustering.
+
+The class implements the mini-batch variant of k-means by Sculley @cite Sculley2010. Instead of
+assigning every sample on each iteration, the centers are updated from small batches of samples
+with a per-center learning rate that decays as 1/count. This makes it possible to cluster data
+sets that do not fit into memory: feed the samples batch-by-batch via MiniBatchKMeans::partialFit,
+or let MiniBatchKMeans::fit draw random batches from a large in-memory array.
+
+@code
+    MiniBatchKMeans mbk(1000, KMEANS_PARALLEL_CENTERS);
+    while (readNextBatch(descriptors))  // CV_32F, one descriptor per row
+        mbk.partialFit(descriptors);
+    Mat vocabulary = mbk.centers;
+@endcode
+@sa kmeans
+*/
+class CV_EXPORTS MiniBatchKMeans
+{
+public:
+    /** @brief Constructor
+
+    @param K Number of clusters.
+    @param flags Center initialization method used on the first batch: one of
+    #KMEANS_RANDOM_CENTERS, #KMEANS_PP_CENTERS or #KMEANS_PARALLEL_CENTERS.
+    */
+    explicit MiniBatchKMeans(int K = 0, int flags = KMEANS_PP_CENTERS);
+
+    /** @brief Sets the initial cluster centers and resets the per-center sample counters.
+
+    @param centers K x dims floating-point matrix of the initial centers.
+    */
+    void setCenters(InputArray centers);
+
+    /** @brief Updates the cluster centers with one batch of samples.
+
+    If the centers are not initialized yet, they are seeded from the batch, which should have at
+    least K samples in this case.
+    @param batch Samples of the same layout as accepted by cv::kmeans.
+    */
+    void partialFit(InputArray batch);
+
+    /** @brief Clusters the data set by running mini-batch iterations on random subsets of it.
+
+    @param data Samples of the same layout as accepted by cv::kmeans.
+    @param batchSize Number of samples in each batch.
+    @param criteria The algorithm stops after criteria.maxCount batches or when none of the centers
+    moves by more than criteria.epsilon during a batch.
+    @param labels Optional output array with the cluster index of every sample.
+    @return The compactness of the final clustering, see cv::kmeans.
+    */
+    double fit(InputArray data, int batchSize, TermCriteria criteria, OutputArray labels = noArray());
+
+    /** @brief Finds the nearest center for every sample.
+
+    @param data Samples of the same layout as accepted by cv::kmeans.
+    @param labels Output integer array with the cluster index of every sample.
+    @return The compactness of the samples with respect to the current centers.
+    */
+    double predict(InputArray data, OutputArray labels) const;
+
+    int K;        //!< number of clusters
+    int flags;    //!< center initialization method
+    Mat centers;  //!< K x dims matrix of the cluster centers (CV_32F)
+    Mat counts;   //!< K x 1 matrix with the number of samples seen by every center (CV_64F)
+};
+
 //! @} core_cluster
 
 //! @addtogroup core_basic
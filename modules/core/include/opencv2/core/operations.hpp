@@ -373,6 +373,46 @@ SVD::backSubst( const Matx<_Tp, nm, 1>& w, const Matx<_Tp, m, nm>& u,
 
 
 
+///////////////////////////////////// batched linear algebra //////////////////////////////////
+
+template<typename _Tp, int m, int n> static inline
+bool solveBatch(const std::vector< Matx<_Tp, m, m> >& src1, const std::vector< Matx<_Tp, m, n> >& src2,
+                std::vector< Matx<_Tp, m, n> >& dst, std::vector<uchar>& status, int flags)
+{
+    CV_Assert( src1.size() == src2.size() );
+    int N = (int)src1.size();
+    dst.resize(N);
+    if( N == 0 )
+    {
+        status.clear();
+        return true;
+    }
+    int asizes[] = { N, m, m }, bsizes[] = { N, m, n };
+    Mat _src1(3, asizes, traits::Type<_Tp>::value, (void*)&src1[0]);
+    Mat _src2(3, bsizes, traits::Type<_Tp>::value, (void*)&src2[0]);
+    Mat _dst(3, bsizes, traits::Type<_Tp>::value, (void*)&dst[0]);
+    return solveBatch(_src1, _src2, _dst, status, flags);
+}
+
+template<typename _Tp, int m> static inline
+bool invertBatch(const std::vector< Matx<_Tp, m, m> >& src, std::vector< Matx<_Tp, m, m> >& dst,
+                 std::vector<uchar>& status, int flags)
+{
+    int N = (int)src.size();
+    dst.resize(N);
+    if( N == 0 )
+    {
+        status.clear();
+        return true;
+    }
+    int sizes[] = { N, m, m };
+    Mat _src(3, sizes, traits::Type<_Tp>::value, (void*)&src[0]);
+    Mat _dst(3, sizes, traits::Type<_Tp>::value, (void*)&dst[0]);
+    return invertBatch(_src, _dst, status, flags);
+}
+
+
+
 /////////////////////////////////// Multiply-with-Carry RNG ///////////////////////////////////
 
 inline RNG::RNG()              { state = 0xffffffff; }
@@ -316,9 +316,12 @@ public:
         FORMAT_XML  = (1<<3), //!< flag, XML format
         FORMAT_YAML = (2<<3), //!< flag, YAML format
         FORMAT_JSON = (3<<3), //!< flag, JSON format
+        FORMAT_BINARY = (4<<3), //!< flag, binary format
 
         BASE64      = 64,     //!< flag, write rawdata in Base64 by default. (consider using WRITE_BASE64)
         WRITE_BASE64 = BASE64 | WRITE, //!< flag, enable both WRITE and BASE64
+        DEFER_MAT_DATA = 128, //!< flag, read mode only: the Base64 or binary data of the matrices in the uncompressed
+        //!< file is not parsed into nodes, FileNode >> Mat reads it straight from the mapped file (see FileStorage::open)
     };
     enum State
     {
@@ -348,12 +351,22 @@ public:
      See description of parameters in FileStorage::FileStorage. The method calls FileStorage::release
      before opening the file.
      @param filename Name of the file to open or the text string to read the data from.
-     Extension of the file (.xml, .yml/.yaml or .json) determines its format (XML, YAML or JSON
-     respectively). Also you can append .gz to work with compressed files, for example myHugeMatrix.xml.gz. If both
+     Extension of the file (.xml, .yml/.yaml, .json or .cvbin) determines its format (XML, YAML, JSON or
+     binary respectively). The binary format stores the same node tree with the raw data (e.g. the matrix
+     elements) as binary blocks; it can not be compressed, appended or used with FileStorage::MEMORY.
+     Also you can append .gz to work with compressed files, for example myHugeMatrix.xml.gz. If both
      FileStorage::WRITE and FileStorage::MEMORY flags are specified, source is used just to specify
      the output file format (e.g. mydata.xml, .yml etc.). A file name can also contain parameters.
      You can use this format, "*?base64" (e.g. "file.json?base64" (case sensitive)), as an alternative to
      FileStorage::BASE64 flag.
+     With FileStorage::DEFER_MAT_DATA the matrices written in Base64 (e.g. with FileStorage::BASE64)
+     or in the binary format are not parsed into the element nodes: the file is memory-mapped and stays
+     mapped until the storage is released, and FileNode >> Mat decodes or copies the data straight into
+     the destination (which can be a submatrix of the user buffer). The "data" nodes of such matrices
+     are empty, so they can be read with FileNode >> Mat only. Only the "data" elements of the
+     opencv-matrix and opencv-nd-matrix maps are deferred; the other nodes, plain text data and the files
+     which can not be mapped are parsed as usual. The file must not be truncated or replaced in place
+     while it is mapped: on POSIX systems reading the lost pages terminates the process with SIGBUS.
      @param flags Mode of operation. One of FileStorage::Mode
      @param encoding Encoding of the file. Note that UTF-16 XML encoding is not supported currently and
      you should use 8-bit encoding instead of it.
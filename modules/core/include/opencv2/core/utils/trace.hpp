@@ -32,6 +32,41 @@ namespace trace {
 //! Macro to trace argument value (expanded version)
 #define CV_TRACE_ARG_VALUE(arg_id, arg_name, value)
 
+/** @brief Writes the regions collected by the in-memory trace sink to a file in Chrome trace event format.
+
+The file can be opened with chrome://tracing or https://ui.perfetto.dev.
+The sink keeps the last completed regions of every thread in a fixed-size lock-free ring buffer.
+It is configured through environment variables, so no rebuild is required:
+- OPENCV_TRACE_RING_BUFFER=<N> enables the sink with N events per thread (0 by default - disabled);
+- OPENCV_TRACE_SAMPLING=<N> records only every N-th call from application code into OpenCV on each thread,
+  together with its nested regions, including the parallel_for_ bodies on the other threads.
+  Sampling applies to this sink only, the other trace sinks get all the regions;
+- OPENCV_TRACE_RING_MIN_DURATION_US=<T> drops the regions shorter than T microseconds;
+- OPENCV_TRACE_DUMP_SIGNAL=<signum> requests a dump on the signal (for example, 10 for SIGUSR1 on Linux).
+  The file is written by the thread which completes the next traced region. The handler previously installed
+  for the signal is called after the dump is requested;
+- OPENCV_TRACE_DUMP_AT_EXIT=1 writes the file at process exit;
+- OPENCV_TRACE_CHROME_LOCATION=<path> specifies the default file name ("OpenCVTrace.json").
+
+The depth of the recorded nested OpenCV calls is controlled by OPENCV_TRACE_DEPTH_OPENCV (1 by default).
+
+@param filename output file name, NULL means the OPENCV_TRACE_CHROME_LOCATION value
+@return false if the sink is disabled or the file can't be written
+*/
+CV_EXPORTS bool dumpChromeTrace(const char* filename = NULL);
+
+/** @brief Reconfigures the in-memory trace sink of the running process, see cv::utils::trace::dumpChromeTrace.
+
+The values override OPENCV_TRACE_RING_BUFFER, OPENCV_TRACE_SAMPLING and OPENCV_TRACE_RING_MIN_DURATION_US.
+The events collected before are discarded. The function must not be called while traced code runs on
+the other threads.
+
+@param ringBufferSize number of the events kept per thread, 0 disables the sink
+@param samplingInterval every samplingInterval-th call from application code into OpenCV is recorded
+@param minDurationUs the regions shorter than this number of microseconds are not recorded
+*/
+CV_EXPORTS void setChromeTraceParameters(size_t ringBufferSize, unsigned samplingInterval = 1, int64 minDurationUs = 0);
+
 //! @cond IGNORED
 #define CV_TRACE_NS cv::utils::trace
 
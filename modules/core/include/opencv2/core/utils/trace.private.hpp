@@ -15,8 +15,10 @@
 
 //! @cond IGNORED
 
+#include <atomic>
 #include <deque>
 #include <ostream>
+#include <vector>
 
 #define INTEL_ITTNOTIFY_API_PRIVATE 1
 #ifdef OPENCV_WITH_ITT
@@ -231,6 +233,41 @@ std::ostream& operator<<(std::ostream& out, const RegionStatisticsStatus& s)
     return out;
 }
 
+//! In-memory trace sink: fixed-size ring of completed regions.
+//! Single writer (owner thread), readers take lock-free snapshots.
+struct TraceRingBuffer
+{
+    struct Event
+    {
+        const Region::LocationStaticStorage* location;
+        int64 beginTimestamp;
+        int64 duration;
+    };
+
+    std::vector<Event> events;   // empty if the sink is disabled
+    std::atomic<uint64> head;    // total number of written events
+
+    TraceRingBuffer();
+
+    //! discards the events and sets the new size, must not be called concurrently with put()
+    void reset(size_t size);
+
+    inline bool enabled() const { return !events.empty(); }
+
+    inline void put(const Region::LocationStaticStorage* location, int64 beginTimestamp, int64 duration)
+    {
+        const uint64 h = head.load(std::memory_order_relaxed);
+        Event& e = events[(size_t)(h % events.size())];
+        e.location = location;
+        e.beginTimestamp = beginTimestamp;
+        e.duration = duration;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    //! copies the events which are not overwritten during the call (oldest first)
+    void snapshot(std::vector<Event>& dst) const;
+};
+
 //! TraceManager for local thread
 struct TraceManagerThreadLocal
 {
@@ -267,13 +304,19 @@ struct TraceManagerThreadLocal
 
     mutable cv::Ptr<TraceStorage> storage;
 
+    TraceRingBuffer ringBuffer;
+    unsigned sampleCounter;            // calls into OpenCV seen by this thread (see OPENCV_TRACE_SAMPLING)
+    int ringBufferSkipDepth;           // depth of the OpenCV call which is not sampled, 0 - the whole parallel_for_ body, -1 - none
+
     TraceManagerThreadLocal() :
         threadID(cv::utils::getThreadID()),
         region_counter(0), totalSkippedEvents(0),
         currentActiveRegion(NULL),
         regionDepth(0),
         regionDepthOpenCV(0),
-        parallel_for_stack_size(0)
+        parallel_for_stack_size(0),
+        sampleCounter(0),
+        ringBufferSkipDepth(-1)
     {
     }
 
@@ -337,6 +380,12 @@ public:
     TLSDataAccumulator<TraceManagerThreadLocal> tls;
 
     cv::Ptr<TraceStorage> trace_storage;
+
+    // in-memory sink parameters, see dumpChromeTrace() and setChromeTraceParameters()
+    size_t ringBufferSize;             // OPENCV_TRACE_RING_BUFFER
+    unsigned samplingInterval;         // OPENCV_TRACE_SAMPLING
+    int64 ringBufferMinDuration;       // OPENCV_TRACE_RING_MIN_DURATION_US, in nanoseconds
+    std::string chromeTraceLocation;   // OPENCV_TRACE_CHROME_LOCATION
 private:
     // disable copying
     TraceManager(const TraceManager&);
@@ -159,6 +159,165 @@ static void generateCentersPP(const Mat& data, Mat& _out_centers,
     }
 }
 
+class KMeansParallelDistanceComputer : public ParallelLoopBody
+{
+public:
+    KMeansParallelDistanceComputer(float *dist_, int *nearest_, const Mat& data_,
+                                   const int *candidates_, int c0_, int c1_) :
+        dist(dist_), nearest(nearest_), data(data_), candidates(candidates_), c0(c0_), c1(c1_)
+    { }
+
+    void operator()( const cv::Range& range ) const CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        const int dims = data.cols;
+
+        for (int i = range.start; i < range.end; i++)
+        {
+            const float* sample = data.ptr<float>(i);
+            float d = dist[i];
+            int best = nearest[i];
+            for (int c = c0; c < c1; c++)
+            {
+                float t = hal::normL2Sqr_(sample, data.ptr<float>(candidates[c]), dims);
+                if (t < d)
+                {
+                    d = t;
+                    best = c;
+                }
+            }
+            dist[i] = d;
+            nearest[i] = best;
+        }
+    }
+
+private:
+    KMeansParallelDistanceComputer& operator=(const KMeansParallelDistanceComputer&); // = delete
+
+    float *dist;
+    int *nearest;
+    const Mat& data;
+    const int *candidates;
+    const int c0, c1;
+};
+
+/*
+k-means center initialization using the following algorithm:
+Bahmani, Moseley, Vattani, Kumar, Vassilvitskii (2012) Scalable K-Means++
+
+The candidates are oversampled in a few rounds (each round costs a single parallel pass over
+the data instead of K sequential passes of kmeans++), weighted by the number of samples closest
+to them and then reduced to K centers with weighted kmeans++.
+*/
+static void generateCentersParallel(const Mat& data, Mat& _out_centers,
+                                    int K, RNG& rng)
+{
+    CV_TRACE_FUNCTION();
+    const int dims = data.cols, N = data.rows;
+    const int ROUNDS = 5;
+    const double oversampling = 2.0*K;
+
+    std::vector<int> candidates;
+    candidates.reserve((size_t)(oversampling*ROUNDS) + 1);
+    cv::AutoBuffer<float, 0> _dist(N);
+    cv::AutoBuffer<int, 0> _nearest(N);
+    float* dist = _dist.data();
+    int* nearest = _nearest.data();
+
+    candidates.push_back((unsigned)rng % N);
+    for (int i = 0; i < N; i++)
+    {
+        // huge or NaN values keep the infinite distance and are reported below
+        dist[i] = std::numeric_limits<float>::infinity();
+        nearest[i] = 0;
+    }
+
+    int c0 = 0;
+    for (int round = 0; ; round++)
+    {
+        const int c1 = (int)candidates.size();
+        parallel_for_(Range(0, N),
+                      KMeansParallelDistanceComputer(dist, nearest, data, candidates.data(), c0, c1),
+                      (double)divUp((size_t)dims * N * (c1 - c0), CV_KMEANS_PARALLEL_GRANULARITY));
+        c0 = c1;
+
+        double psi = 0;
+        for (int i = 0; i < N; i++)
+            psi += dist[i];
+        if (!(psi < DBL_MAX))
+            CV_Error(Error::StsNoConv, "kmeans: can't update cluster center (check input for huge or NaN values)");
+
+        if (psi <= 0 || (round >= ROUNDS && c1 >= K) || c1 >= N)
+            break;
+
+        double scale = oversampling/psi;
+        for (int i = 0; i < N; i++)
+        {
+            if (dist[i] > 0 && (double)rng < dist[i]*scale)
+                candidates.push_back(i);
+        }
+    }
+
+    // weight every candidate by the number of samples it attracts
+    const int M = (int)candidates.size();
+    std::vector<double> weights(M, 0.);
+    for (int i = 0; i < N; i++)
+        weights[nearest[i]] += 1.;
+
+    // weighted kmeans++ over the candidates
+    cv::AutoBuffer<int, 64> _centers(K);
+    int* centers = _centers.data();
+    std::vector<double> cdist(M, DBL_MAX);
+    int k = 0, last = -1;
+    {
+        double p = (double)rng*N;
+        for (last = 0; last < M - 1; last++)
+        {
+            p -= weights[last];
+            if (p <= 0)
+                break;
+        }
+    }
+    for (;;)
+    {
+        centers[k++] = candidates[last];
+        if (k >= K || k >= M)
+            break;
+
+        const float* c = data.ptr<float>(candidates[last]);
+        double sum0 = 0;
+        for (int j = 0; j < M; j++)
+        {
+            double d = hal::normL2Sqr_(data.ptr<float>(candidates[j]), c, dims);
+            cdist[j] = std::min(cdist[j], d);
+            sum0 += cdist[j]*weights[j];
+        }
+        if (sum0 <= 0)
+        {
+            // all the remaining candidates coincide with the selected centers
+            break;
+        }
+        double p = (double)rng*sum0;
+        for (last = 0; last < M - 1; last++)
+        {
+            p -= cdist[last]*weights[last];
+            if (p <= 0)
+                break;
+        }
+    }
+    // not enough distinct candidates, e.g. in case of many duplicated samples
+    for (; k < K; k++)
+        centers[k] = (unsigned)rng % N;
+
+    for (k = 0; k < K; k++)
+    {
+        const float* src = data.ptr<float>(centers[k]);
+        float* dst = _out_centers.ptr<float>(k);
+        for (int j = 0; j < dims; j++)
+            dst[j] = src[j];
+    }
+}
+
 template<bool onlyDistance>
 class KMeansDistanceComputer : public ParallelLoopBody
 {
@@ -223,6 +382,183 @@ private:
     const Mat& centers;
 };
 
+/*
+Label assignment with the bounds from:
+Hamerly (2010) Making k-means even faster
+
+upper[i] bounds the distance from the sample to its assigned center from above and lower[i]
+bounds the distance to all other centers from below. The bounds are kept valid across the
+iterations by the center shifts, so the full scan over the centers is needed only when the
+bounds can't prove that the assignment stays the same.
+*/
+class KMeansBoundedDistanceComputer : public ParallelLoopBody
+{
+public:
+    KMeansBoundedDistanceComputer( int *labels_,
+                                   float *upper_,
+                                   float *lower_,
+                                   const Mat& data_,
+                                   const Mat& centers_,
+                                   const float *halfSeparation_,
+                                   const float *shifts_,
+                                   int maxShiftIdx_,
+                                   bool resetBounds_ )
+        : labels(labels_),
+          upper(upper_),
+          lower(lower_),
+          data(data_),
+          centers(centers_),
+          halfSeparation(halfSeparation_),
+          shifts(shifts_),
+          maxShiftIdx(maxShiftIdx_),
+          resetBounds(resetBounds_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        const int K = centers.rows;
+        const int dims = centers.cols;
+        float maxShift = 0, secondShift = 0;
+        if (!resetBounds)
+        {
+            maxShift = shifts[maxShiftIdx];
+            for (int k = 0; k < K; k++)
+                if (k != maxShiftIdx)
+                    secondShift = std::max(secondShift, shifts[k]);
+        }
+
+        for (int i = range.start; i < range.end; ++i)
+        {
+            const float *sample = data.ptr<float>(i);
+            if (!resetBounds)
+            {
+                const int a = labels[i];
+                upper[i] += shifts[a];
+                lower[i] -= a == maxShiftIdx ? secondShift : maxShift;
+
+                const float m = std::max(halfSeparation[a], lower[i]);
+                if (upper[i] <= m)
+                    continue;
+                upper[i] = std::sqrt(hal::normL2Sqr_(sample, centers.ptr<float>(a), dims));
+                if (upper[i] <= m)
+                    continue;
+            }
+
+            int k_best = 0;
+            float d1 = FLT_MAX, d2 = FLT_MAX;
+            for (int k = 0; k < K; k++)
+            {
+                const float dist = hal::normL2Sqr_(sample, centers.ptr<float>(k), dims);
+                if (dist < d1)
+                {
+                    d2 = d1;
+                    d1 = dist;
+                    k_best = k;
+                }
+                else if (dist < d2)
+                    d2 = dist;
+            }
+
+            labels[i] = k_best;
+            upper[i] = std::sqrt(d1);
+            lower[i] = std::sqrt(d2);
+        }
+    }
+
+private:
+    KMeansBoundedDistanceComputer& operator=(const KMeansBoundedDistanceComputer&); // = delete
+
+    int *labels;
+    float *upper;
+    float *lower;
+    const Mat& data;
+    const Mat& centers;
+    const float *halfSeparation;
+    const float *shifts;
+    const int maxShiftIdx;
+    const bool resetBounds;
+};
+
+class KMeansCenterSeparationComputer : public ParallelLoopBody
+{
+public:
+    KMeansCenterSeparationComputer(float *halfSeparation_, const Mat& centers_)
+        : halfSeparation(halfSeparation_), centers(centers_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        const int K = centers.rows;
+        const int dims = centers.cols;
+
+        for (int k = range.start; k < range.end; ++k)
+        {
+            float d = FLT_MAX;
+            for (int k1 = 0; k1 < K; k1++)
+            {
+                if (k1 != k)
+                    d = std::min(d, hal::normL2Sqr_(centers.ptr<float>(k), centers.ptr<float>(k1), dims));
+            }
+            halfSeparation[k] = 0.5f*std::sqrt(d);
+        }
+    }
+
+private:
+    KMeansCenterSeparationComputer& operator=(const KMeansCenterSeparationComputer&); // = delete
+
+    float *halfSeparation;
+    const Mat& centers;
+};
+
+static void generateCenters(const Mat& data, Mat& centers, int K, int flags,
+                            const Vec2f* box, RNG& rng, int trials)
+{
+    if (flags & KMEANS_PARALLEL_CENTERS)
+        generateCentersParallel(data, centers, K, rng);
+    else if (flags & KMEANS_PP_CENTERS)
+        generateCentersPP(data, centers, K, rng, trials);
+    else
+    {
+        for (int k = 0; k < K; k++)
+            generateRandomCenter(data.cols, box, centers.ptr<float>(k), rng);
+    }
+}
+
+static void computeBoundingBox(const Mat& data, Vec2f* box)
+{
+    const int N = data.rows, dims = data.cols;
+    {
+        const float* sample = data.ptr<float>(0);
+        for (int j = 0; j < dims; j++)
+            box[j] = Vec2f(sample[j], sample[j]);
+    }
+    for (int i = 1; i < N; i++)
+    {
+        const float* sample = data.ptr<float>(i);
+        for (int j = 0; j < dims; j++)
+        {
+            float v = sample[j];
+            box[j][0] = std::min(box[j][0], v);
+            box[j][1] = std::max(box[j][1], v);
+        }
+    }
+}
+
+// wraps the input samples as N x dims single-channel matrix (see cv::kmeans for the layouts)
+static Mat getSamplesMat(InputArray _data)
+{
+    Mat data0 = _data.getMat();
+    const bool isrow = data0.rows == 1;
+    const int N = isrow ? data0.cols : data0.rows;
+    const int dims = (isrow ? 1 : data0.cols)*data0.channels();
+    CV_Assert( data0.dims <= 2 && data0.depth() == CV_32F );
+    return Mat(N, dims, CV_32F, data0.ptr(), isrow ? dims * sizeof(float) : static_cast<size_t>(data0.step));
+}
+
 }
 
 double cv::kmeans( InputArray _data, int K,
@@ -296,24 +632,14 @@ double cv::kmeans( InputArray _data, int K,
     }
 
     cv::AutoBuffer<Vec2f, 64> box(dims);
-    if (!(flags & KMEANS_PP_CENTERS))
-    {
-        {
-            const float* sample = data.ptr<float>(0);
-            for (int j = 0; j < dims; j++)
-                box[j] = Vec2f(sample[j], sample[j]);
-        }
-        for (int i = 1; i < N; i++)
-        {
-            const float* sample = data.ptr<float>(i);
-            for (int j = 0; j < dims; j++)
-            {
-                float v = sample[j];
-                box[j][0] = std::min(box[j][0], v);
-                box[j][1] = std::max(box[j][1], v);
-            }
-        }
-    }
+    if (!(flags & (KMEANS_PP_CENTERS | KMEANS_PARALLEL_CENTERS)))
+        computeBoundingBox(data, box.data());
+
+    const bool useBounds = (flags & KMEANS_ACCELERATED) != 0 && K > 1;
+    cv::AutoBuffer<float, 0> upper(useBounds ? N : 0), lower(useBounds ? N : 0);
+    cv::AutoBuffer<float, 64> halfSeparation(K), shifts(K);
+    bool boundsValid = false;
+    int maxShiftIdx = 0;
 
     double best_compactness = DBL_MAX;
     for (int a = 0; a < attempts; a++)
@@ -326,15 +652,12 @@ double cv::kmeans( InputArray _data, int K,
 
             swap(centers, old_centers);
 
+            if (iter == 0)
+                boundsValid = false;
+
             if (iter == 0 && (a > 0 || !(flags & KMEANS_USE_INITIAL_LABELS)))
             {
-                if (flags & KMEANS_PP_CENTERS)
-                    generateCentersPP(data, centers, K, rng, SPP_TRIALS);
-                else
-                {
-                    for (int k = 0; k < K; k++)
-                        generateRandomCenter(dims, box.data(), centers.ptr<float>(k), rng);
-                }
+                generateCenters(data, centers, K, flags, box.data(), rng, SPP_TRIALS);
             }
             else
             {
@@ -342,6 +665,7 @@ double cv::kmeans( InputArray _data, int K,
                 centers = Scalar(0);
                 for (int k = 0; k < K; k++)
                     counters[k] = 0;
+                maxShiftIdx = 0;
 
                 for (int i = 0; i < N; i++)
                 {
@@ -394,6 +718,12 @@ double cv::kmeans( InputArray _data, int K,
                     counters[max_k]--;
                     counters[k]++;
                     labels[farthest_i] = k;
+                    if (useBounds)
+                    {
+                        // the bounds of the moved sample refer to the other center
+                        upper[farthest_i] = FLT_MAX;
+                        lower[farthest_i] = 0.f;
+                    }
 
                     const float* sample = data.ptr<float>(farthest_i);
                     float* cur_center = centers.ptr<float>(k);
@@ -423,6 +753,13 @@ double cv::kmeans( InputArray _data, int K,
                             dist += t*t;
                         }
                         max_center_shift = std::max(max_center_shift, dist);
+                        if (useBounds)
+                        {
+                            // round up to keep the bounds conservative
+                            shifts[k] = (float)std::sqrt(dist)*(1.f + FLT_EPSILON);
+                            if (shifts[k] > shifts[maxShiftIdx])
+                                maxShiftIdx = k;
+                        }
                     }
                 }
             }
@@ -436,6 +773,16 @@ double cv::kmeans( InputArray _data, int K,
                 compactness = sum(Mat(Size(N, 1), CV_64F, &dists[0]))[0];
                 break;
             }
+            else if (useBounds)
+            {
+                // assign labels, skipping the samples which can't change their cluster
+                parallel_for_(Range(0, K), KMeansCenterSeparationComputer(halfSeparation.data(), centers),
+                              (double)divUp((size_t)(dims * K * K), CV_KMEANS_PARALLEL_GRANULARITY));
+                parallel_for_(Range(0, N), KMeansBoundedDistanceComputer(labels, upper.data(), lower.data(), data, centers,
+                                                                         halfSeparation.data(), shifts.data(), maxShiftIdx, !boundsValid),
+                              (double)divUp((size_t)(dims * N * (boundsValid ? 1 : K)), CV_KMEANS_PARALLEL_GRANULARITY));
+                boundsValid = true;
+            }
             else
             {
                 // assign labels
@@ -459,3 +806,115 @@ double cv::kmeans( InputArray _data, int K,
 
     return best_compactness;
 }
+
+////////////////////////////////////// mini-batch kmeans //////////////////////////////////////
+
+cv::MiniBatchKMeans::MiniBatchKMeans(int K_, int flags_) : K(K_), flags(flags_)
+{
+}
+
+void cv::MiniBatchKMeans::setCenters(InputArray _centers)
+{
+    CV_INSTRUMENT_REGION();
+    Mat c = _centers.getMat();
+    CV_Assert( c.dims <= 2 && c.depth() == CV_32F && !c.empty() );
+    c.reshape(1, c.rows).copyTo(centers);
+    K = centers.rows;
+    counts = Mat::zeros(K, 1, CV_64F);
+}
+
+void cv::MiniBatchKMeans::partialFit(InputArray _batch)
+{
+    CV_INSTRUMENT_REGION();
+    Mat batch = getSamplesMat(_batch);
+    const int N = batch.rows, dims = batch.cols;
+    if (N == 0)
+        return;
+
+    if (centers.empty())
+    {
+        CV_Assert( K > 0 );
+        CV_CheckGE(N, K, "The first batch should have at least K samples to initialize the centers");
+        Mat c(K, dims, CV_32F);
+        cv::AutoBuffer<Vec2f, 64> box(dims);
+        if (!(flags & (KMEANS_PP_CENTERS | KMEANS_PARALLEL_CENTERS)))
+            computeBoundingBox(batch, box.data());
+        generateCenters(batch, c, K, flags, box.data(), theRNG(), 3);
+        setCenters(c);
+    }
+    CV_CheckEQ(dims, centers.cols, "Dimensionality of samples doesn't match the centers");
+
+    cv::AutoBuffer<double, 64> dists(N);
+    cv::AutoBuffer<int, 64> labels(N);
+    parallel_for_(Range(0, N), KMeansDistanceComputer<false>(dists.data(), labels.data(), batch, centers),
+                  (double)divUp((size_t)(dims * N * K), CV_KMEANS_PARALLEL_GRANULARITY));
+
+    // per-center gradient step with the learning rate 1/count
+    double* cnt = counts.ptr<double>();
+    for (int i = 0; i < N; i++)
+    {
+        const int k = labels[i];
+        const float* sample = batch.ptr<float>(i);
+        float* center = centers.ptr<float>(k);
+        const float eta = (float)(1./(cnt[k] += 1.));
+        for (int j = 0; j < dims; j++)
+            center[j] += (sample[j] - center[j])*eta;
+    }
+}
+
+double cv::MiniBatchKMeans::fit(InputArray _data, int batchSize, TermCriteria criteria, OutputArray _labels)
+{
+    CV_INSTRUMENT_REGION();
+    Mat data = getSamplesMat(_data);
+    const int N = data.rows, dims = data.cols;
+    CV_Assert( K > 0 );
+    CV_CheckGE(N, K, "Number of clusters should be more than number of elements");
+    batchSize = std::min(std::max(batchSize, K), N);
+
+    double eps = (criteria.type & TermCriteria::EPS) ? std::max(criteria.epsilon, 0.) : 0.;
+    eps *= eps;
+    const int maxCount = (criteria.type & TermCriteria::COUNT) ? std::max(criteria.maxCount, 1) : 100;
+
+    RNG& rng = theRNG();
+    Mat batch(batchSize, dims, CV_32F), old_centers;
+    for (int iter = 0; iter < maxCount; iter++)
+    {
+        for (int i = 0; i < batchSize; i++)
+            memcpy(batch.ptr<float>(i), data.ptr<float>((unsigned)rng % N), dims*sizeof(float));
+
+        if (eps > 0 && !centers.empty())
+            centers.copyTo(old_centers);
+        partialFit(batch);
+
+        if (eps > 0 && !old_centers.empty())
+        {
+            double max_center_shift = 0;
+            for (int k = 0; k < K; k++)
+                max_center_shift = std::max(max_center_shift, (double)hal::normL2Sqr_(centers.ptr<float>(k), old_centers.ptr<float>(k), dims));
+            if (max_center_shift <= eps)
+                break;
+        }
+    }
+
+    if (_labels.needed())
+        return predict(data, _labels);
+    Mat labels;
+    return predict(data, labels);
+}
+
+double cv::MiniBatchKMeans::predict(InputArray _data, OutputArray _labels) const
+{
+    CV_INSTRUMENT_REGION();
+    CV_Assert( !centers.empty() );
+    Mat data = getSamplesMat(_data);
+    const int N = data.rows, dims = data.cols;
+    CV_CheckEQ(dims, centers.cols, "Dimensionality of samples doesn't match the centers");
+
+    _labels.create(N, 1, CV_32S);
+    Mat labels = _labels.getMat();
+    CV_Assert( labels.isContinuous() );
+    cv::AutoBuffer<double, 64> dists(N);
+    parallel_for_(Range(0, N), KMeansDistanceComputer<false>(dists.data(), labels.ptr<int>(), data, centers),
+                  (double)divUp((size_t)(dims * N * centers.rows), CV_KMEANS_PARALLEL_GRANULARITY));
+    return sum(Mat(Size(N, 1), CV_64F, dists.data()))[0];
+}
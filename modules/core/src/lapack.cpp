@@ -1598,6 +1598,512 @@ void cv::SVBackSubst(InputArray w, InputArray u, InputArray vt, InputArray rhs,
 }
 
 
+/////////////////////////////// batched small matrices ///////////////////////////////
+
+namespace cv
+{
+
+// The batch of N rows x cols matrices is stored as continuous N x rows x cols array
+static void getBatchInfo(const Mat& a, int& N, int& rows, int& cols)
+{
+    CV_Assert( a.dims == 3 && a.channels() == 1 && a.isContinuous() );
+    CV_Assert( a.depth() == CV_32F || a.depth() == CV_64F );
+    N = a.size[0];
+    rows = a.size[1];
+    cols = a.size[2];
+}
+
+#if CV_SIMD
+template<typename _Tp> struct BatchVec {};
+
+template<> struct BatchVec<float>
+{
+    typedef v_float32 vec_type;
+    static inline vec_type setall(float v) { return vx_setall_f32(v); }
+};
+
+#if CV_SIMD_64F
+template<> struct BatchVec<double>
+{
+    typedef v_float64 vec_type;
+    static inline vec_type setall(double v) { return vx_setall_f64(v); }
+};
+#endif
+
+template<typename _Tp, typename _Tvec> static inline
+void batchSwapLanes(_Tp* p, _Tp* q, const _Tvec& mask)
+{
+    _Tvec x = vx_load(p), y = vx_load(q);
+    v_store(p, v_select(mask, y, x));
+    v_store(q, v_select(mask, x, y));
+}
+
+/*
+The matrices are processed in groups of W = vec_type::nlanes, one matrix per SIMD lane.
+The element (i, j) of the lane l is stored at a[(i*cols + j)*W + l]. The pivoting is done
+per lane with masks, so all the matrices of the group follow the same instruction stream.
+The right-hand sides in b are replaced with the solutions. Returns the mask of the lanes
+with non-degenerate matrices.
+*/
+template<typename _Tp> static typename BatchVec<_Tp>::vec_type
+batchLU(_Tp* a, int m, _Tp* b, int k, _Tp eps)
+{
+    typedef typename BatchVec<_Tp>::vec_type VT;
+    const int W = VT::nlanes;
+    const VT vone = BatchVec<_Tp>::setall(1), veps = BatchVec<_Tp>::setall(eps);
+    VT ok = vone == vone;
+
+    for (int i = 0; i < m; i++)
+    {
+        VT pmax = v_abs(vx_load(a + (i*m + i)*W)), pidx = BatchVec<_Tp>::setall((_Tp)i);
+        for (int j = i + 1; j < m; j++)
+        {
+            VT v = v_abs(vx_load(a + (j*m + i)*W));
+            VT mask = v > pmax;
+            pmax = v_select(mask, v, pmax);
+            pidx = v_select(mask, BatchVec<_Tp>::setall((_Tp)j), pidx);
+        }
+        VT good = pmax >= veps;
+        ok = ok & good;
+
+        for (int j = i + 1; j < m; j++)
+        {
+            VT mask = pidx == BatchVec<_Tp>::setall((_Tp)j);
+            if (!v_check_any(mask))
+                continue;
+            for (int c = i; c < m; c++)
+                batchSwapLanes(a + (i*m + c)*W, a + (j*m + c)*W, mask);
+            for (int c = 0; c < k; c++)
+                batchSwapLanes(b + (i*k + c)*W, b + (j*k + c)*W, mask);
+        }
+
+        // degenerate lanes continue with the unit pivot, their results are discarded
+        VT d = vone / v_select(good, vx_load(a + (i*m + i)*W), vone);
+        for (int j = i + 1; j < m; j++)
+        {
+            VT alpha = vx_load(a + (j*m + i)*W) * d;
+            for (int c = i + 1; c < m; c++)
+                v_store(a + (j*m + c)*W, vx_load(a + (j*m + c)*W) - alpha*vx_load(a + (i*m + c)*W));
+            for (int c = 0; c < k; c++)
+                v_store(b + (j*k + c)*W, vx_load(b + (j*k + c)*W) - alpha*vx_load(b + (i*k + c)*W));
+        }
+        v_store(a + (i*m + i)*W, d);
+    }
+
+    for (int i = m - 1; i >= 0; i--)
+    {
+        VT d = vx_load(a + (i*m + i)*W);
+        for (int c = 0; c < k; c++)
+        {
+            VT s = vx_load(b + (i*k + c)*W);
+            for (int j = i + 1; j < m; j++)
+                s = s - vx_load(a + (i*m + j)*W)*vx_load(b + (j*k + c)*W);
+            v_store(b + (i*k + c)*W, s*d);
+        }
+    }
+    return ok;
+}
+
+// Cholesky decomposition A = L*L^T of the interleaved matrices, see batchLU
+template<typename _Tp> static typename BatchVec<_Tp>::vec_type
+batchCholesky(_Tp* a, int m, _Tp* b, int k)
+{
+    typedef typename BatchVec<_Tp>::vec_type VT;
+    const int W = VT::nlanes;
+    const VT vone = BatchVec<_Tp>::setall(1), veps = BatchVec<_Tp>::setall(std::numeric_limits<_Tp>::epsilon());
+    VT ok = vone == vone;
+
+    // the diagonal keeps 1/L(i, i)
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < i; j++)
+        {
+            VT s = vx_load(a + (i*m + j)*W);
+            for (int p = 0; p < j; p++)
+                s = s - vx_load(a + (i*m + p)*W)*vx_load(a + (j*m + p)*W);
+            v_store(a + (i*m + j)*W, s*vx_load(a + (j*m + j)*W));
+        }
+        VT s = vx_load(a + (i*m + i)*W);
+        for (int p = 0; p < i; p++)
+        {
+            VT t = vx_load(a + (i*m + p)*W);
+            s = s - t*t;
+        }
+        VT good = s >= veps;
+        ok = ok & good;
+        v_store(a + (i*m + i)*W, vone / v_sqrt(v_select(good, s, vone)));
+    }
+
+    for (int c = 0; c < k; c++)
+    {
+        // L*y = b
+        for (int i = 0; i < m; i++)
+        {
+            VT s = vx_load(b + (i*k + c)*W);
+            for (int p = 0; p < i; p++)
+                s = s - vx_load(a + (i*m + p)*W)*vx_load(b + (p*k + c)*W);
+            v_store(b + (i*k + c)*W, s*vx_load(a + (i*m + i)*W));
+        }
+        // L^T*x = y
+        for (int i = m - 1; i >= 0; i--)
+        {
+            VT s = vx_load(b + (i*k + c)*W);
+            for (int p = i + 1; p < m; p++)
+                s = s - vx_load(a + (p*m + i)*W)*vx_load(b + (p*k + c)*W);
+            v_store(b + (i*k + c)*W, s*vx_load(a + (i*m + i)*W));
+        }
+    }
+    return ok;
+}
+
+template<typename _Tp> class BatchSolveSIMDInvoker : public ParallelLoopBody
+{
+public:
+    BatchSolveSIMDInvoker(const Mat& A_, const Mat& B_, Mat& X_, uchar* status_, int method_)
+        : A(A_), B(B_), X(X_), status(status_), method(method_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        typedef typename BatchVec<_Tp>::vec_type VT;
+        const int W = VT::nlanes;
+        const int N = A.size[0], m = A.size[1], k = X.size[2];
+        const bool invert = B.empty();
+        const _Tp eps = std::numeric_limits<_Tp>::epsilon()*(sizeof(_Tp) == 4 ? 10 : 100);  // as in hal::LU
+
+        AutoBuffer<_Tp> _buf((m*m + m*k + 1)*W);
+        _Tp *abuf = _buf.data(), *bbuf = abuf + m*m*W, *okbuf = bbuf + m*k*W;
+
+        for (int blk = range.start; blk < range.end; blk++)
+        {
+            const int n0 = blk*W, count = std::min(W, N - n0);
+            for (int l = 0; l < W; l++)
+            {
+                // the tail of the last group is padded with identity matrices
+                const _Tp* a = l < count ? A.ptr<_Tp>(n0 + l) : NULL;
+                const _Tp* b = l < count && !invert ? B.ptr<_Tp>(n0 + l) : NULL;
+                for (int i = 0; i < m; i++)
+                {
+                    for (int j = 0; j < m; j++)
+                        abuf[(i*m + j)*W + l] = a ? a[i*m + j] : (_Tp)(i == j);
+                    for (int j = 0; j < k; j++)
+                        bbuf[(i*k + j)*W + l] = b ? b[i*k + j] : invert ? (_Tp)(i == j) : (_Tp)0;
+                }
+            }
+
+            VT ok = method == DECOMP_CHOLESKY ? batchCholesky<_Tp>(abuf, m, bbuf, k) : batchLU<_Tp>(abuf, m, bbuf, k, eps);
+            v_store(okbuf, ok & BatchVec<_Tp>::setall(1));
+
+            for (int l = 0; l < count; l++)
+            {
+                _Tp* x = X.ptr<_Tp>(n0 + l);
+                const bool good = okbuf[l] != 0;
+                for (int e = 0; e < m*k; e++)
+                    x[e] = good ? bbuf[e*W + l] : (_Tp)0;
+                status[n0 + l] = (uchar)good;
+            }
+        }
+    }
+
+private:
+    BatchSolveSIMDInvoker& operator=(const BatchSolveSIMDInvoker&); // = delete
+
+    const Mat& A;
+    const Mat& B;
+    Mat& X;
+    uchar* status;
+    int method;
+};
+#endif
+
+// Generic path: one matrix at a time, without allocations for LU and Cholesky
+class BatchSolveInvoker : public ParallelLoopBody
+{
+public:
+    BatchSolveInvoker(const Mat& A_, const Mat& B_, Mat& X_, uchar* status_, int method_)
+        : A(A_), B(B_), X(X_), status(status_), method(method_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const int type = A.type(), m = A.size[1], n = A.size[2], k = X.size[2];
+        const bool invert = B.empty();
+        const bool square = m == n && (method == DECOMP_LU || method == DECOMP_CHOLESKY);
+        const size_t esz = A.elemSize();
+        AutoBuffer<uchar> _abuf(square ? m*m*esz : 0);
+
+        for (int i = range.start; i < range.end; i++)
+        {
+            Mat a(m, n, type, (void*)A.ptr(i));
+            Mat x(n, k, type, X.ptr(i));
+            bool ok;
+            if (square)
+            {
+                Mat temp(m, m, type, _abuf.data());
+                a.copyTo(temp);
+                if (invert)
+                    setIdentity(x);
+                else
+                    Mat(m, k, type, (void*)B.ptr(i)).copyTo(x);
+                if (type == CV_32F)
+                    ok = method == DECOMP_CHOLESKY ?
+                        hal::Cholesky32f(temp.ptr<float>(), temp.step, m, x.ptr<float>(), x.step, k) :
+                        hal::LU32f(temp.ptr<float>(), temp.step, m, x.ptr<float>(), x.step, k) != 0;
+                else
+                    ok = method == DECOMP_CHOLESKY ?
+                        hal::Cholesky64f(temp.ptr<double>(), temp.step, m, x.ptr<double>(), x.step, k) :
+                        hal::LU64f(temp.ptr<double>(), temp.step, m, x.ptr<double>(), x.step, k) != 0;
+            }
+            else if (invert)
+                ok = cv::invert(a, x, method) != 0;
+            else
+                ok = cv::solve(a, Mat(m, k, type, (void*)B.ptr(i)), x, method);
+            if (!ok)
+                x = Scalar::all(0);
+            status[i] = (uchar)ok;
+        }
+    }
+
+private:
+    BatchSolveInvoker& operator=(const BatchSolveInvoker&); // = delete
+
+    const Mat& A;
+    const Mat& B;
+    Mat& X;
+    uchar* status;
+    int method;
+};
+
+static bool solveBatch_(const Mat& A, const Mat& B, Mat& X, OutputArray _status, int method)
+{
+    const int N = A.size[0], m = A.size[1], n = A.size[2], k = X.size[2];
+    AutoBuffer<uchar> _statusBuf;
+    uchar* status;
+    if (_status.needed())
+    {
+        _status.create(N, 1, CV_8U);
+        Mat s = _status.getMat();
+        CV_Assert( s.isContinuous() );
+        status = s.ptr();
+    }
+    else
+    {
+        _statusBuf.allocate(N);
+        status = _statusBuf.data();
+    }
+    if (N == 0)
+        return true;
+
+    const double nstripes = (double)N*m*m*(n + k)/(1 << 16);
+    bool done = false;
+#if CV_SIMD
+    if (m == n && (method == DECOMP_LU || method == DECOMP_CHOLESKY))
+    {
+        if (A.depth() == CV_32F)
+        {
+            const int W = v_float32::nlanes;
+            parallel_for_(Range(0, (N + W - 1)/W), BatchSolveSIMDInvoker<float>(A, B, X, status, method), nstripes);
+            done = true;
+        }
+#if CV_SIMD_64F
+        else
+        {
+            const int W = v_float64::nlanes;
+            parallel_for_(Range(0, (N + W - 1)/W), BatchSolveSIMDInvoker<double>(A, B, X, status, method), nstripes);
+            done = true;
+        }
+#endif
+    }
+#endif
+    if (!done)
+        parallel_for_(Range(0, N), BatchSolveInvoker(A, B, X, status, method), nstripes);
+
+    for (int i = 0; i < N; i++)
+        if (!status[i])
+            return false;
+    return true;
+}
+
+class BatchSVDInvoker : public ParallelLoopBody
+{
+public:
+    BatchSVDInvoker(const Mat& A_, Mat& W_, Mat& U_, Mat& Vt_, int flags_)
+        : A(A_), W(W_), U(U_), Vt(Vt_), flags(flags_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const int type = A.type(), m = A.size[1], n = A.size[2];
+        for (int i = range.start; i < range.end; i++)
+        {
+            Mat a(m, n, type, (void*)A.ptr(i));
+            Mat w(W.size[1], 1, type, W.ptr(i));
+            // the outputs are wrapped around the preallocated memory, so no allocations happen
+            Mat u, vt;
+            if (!U.empty())
+                u = Mat(U.size[1], U.size[2], type, U.ptr(i));
+            if (!Vt.empty())
+                vt = Mat(Vt.size[1], Vt.size[2], type, Vt.ptr(i));
+            if (U.empty() && Vt.empty())
+                _SVDcompute(a, w, noArray(), noArray(), flags);
+            else if (U.empty())
+                _SVDcompute(a, w, noArray(), vt, flags);
+            else if (Vt.empty())
+                _SVDcompute(a, w, u, noArray(), flags);
+            else
+                _SVDcompute(a, w, u, vt, flags);
+        }
+    }
+
+private:
+    BatchSVDInvoker& operator=(const BatchSVDInvoker&); // = delete
+
+    const Mat& A;
+    Mat& W;
+    Mat& U;
+    Mat& Vt;
+    int flags;
+};
+
+class BatchEigenInvoker : public ParallelLoopBody
+{
+public:
+    BatchEigenInvoker(const Mat& A_, Mat& E_, Mat& V_, uchar* status_)
+        : A(A_), E(E_), V(V_), status(status_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const int type = A.type(), n = A.size[1];
+        const size_t esz = A.elemSize(), astep = n*esz;
+        AutoBuffer<uchar> _buf(n*astep + n*5*esz + 32);
+        uchar* abuf = alignPtr(_buf.data(), 16);
+        uchar* wbuf = abuf + n*astep;
+        for (int i = range.start; i < range.end; i++)
+        {
+            memcpy(abuf, A.ptr(i), n*astep);
+            uchar* v = V.empty() ? NULL : V.ptr(i);
+            bool ok = type == CV_32F ?
+                Jacobi((float*)abuf, astep, (float*)E.ptr(i), (float*)v, astep, n, wbuf) :
+                Jacobi((double*)abuf, astep, (double*)E.ptr(i), (double*)v, astep, n, wbuf);
+            status[i] = (uchar)ok;
+        }
+    }
+
+private:
+    BatchEigenInvoker& operator=(const BatchEigenInvoker&); // = delete
+
+    const Mat& A;
+    Mat& E;
+    Mat& V;
+    uchar* status;
+};
+
+}
+
+bool cv::solveBatch( InputArray _src1, InputArray _src2, OutputArray _dst, OutputArray _status, int method )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat A = _src1.getMat(), B = _src2.getMat();
+    int N, m, n, Nb, mb, k;
+    getBatchInfo(A, N, m, n);
+    getBatchInfo(B, Nb, mb, k);
+    CV_CheckTypeEQ(A.type(), B.type(), "");
+    CV_CheckEQ(N, Nb, "Number of matrices in the batches should be the same");
+    CV_CheckEQ(m, mb, "");
+    CV_Assert( !(method & DECOMP_NORMAL) || method == (DECOMP_NORMAL | DECOMP_LU) ||
+               method == (DECOMP_NORMAL | DECOMP_CHOLESKY) || method == (DECOMP_NORMAL | DECOMP_QR) );
+
+    int sizes[] = { N, n, k };
+    _dst.create(3, sizes, A.type());
+    Mat X = _dst.getMat();
+    CV_Assert( X.isContinuous() && X.data != A.data && X.data != B.data );
+    return solveBatch_(A, B, X, _status, method);
+}
+
+bool cv::invertBatch( InputArray _src, OutputArray _dst, OutputArray _status, int method )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat A = _src.getMat();
+    int N, m, n;
+    getBatchInfo(A, N, m, n);
+    CV_Assert( method == DECOMP_LU || method == DECOMP_CHOLESKY || method == DECOMP_SVD || method == DECOMP_EIG );
+
+    int sizes[] = { N, n, m };
+    _dst.create(3, sizes, A.type());
+    Mat X = _dst.getMat();
+    CV_Assert( X.isContinuous() && X.data != A.data );
+    return solveBatch_(A, Mat(), X, _status, method);
+}
+
+void cv::SVDecompBatch( InputArray _src, OutputArray _w, OutputArray _u, OutputArray _vt, int flags )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat A = _src.getMat();
+    int N, m, n;
+    getBatchInfo(A, N, m, n);
+    const int nm = std::min(m, n);
+    const bool full_uv = (flags & SVD::FULL_UV) != 0;
+    const bool compute_uv = (flags & SVD::NO_UV) == 0 && (_u.needed() || _vt.needed());
+
+    int wsizes[] = { N, nm, 1 };
+    _w.create(3, wsizes, A.type());
+    Mat W = _w.getMat(), U, Vt;
+    if (compute_uv && _u.needed())
+    {
+        int usizes[] = { N, m, full_uv ? m : nm };
+        _u.create(3, usizes, A.type());
+        U = _u.getMat();
+    }
+    else
+        _u.release();
+    if (compute_uv && _vt.needed())
+    {
+        int vsizes[] = { N, full_uv ? n : nm, n };
+        _vt.create(3, vsizes, A.type());
+        Vt = _vt.getMat();
+    }
+    else
+        _vt.release();
+
+    parallel_for_(Range(0, N), BatchSVDInvoker(A, W, U, Vt, flags), (double)N*m*n*nm/(1 << 14));
+}
+
+bool cv::eigenBatch( InputArray _src, OutputArray _evals, OutputArray _evects )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat A = _src.getMat();
+    int N, m, n;
+    getBatchInfo(A, N, m, n);
+    CV_CheckEQ(m, n, "Matrices should be square (and symmetric)");
+
+    int esizes[] = { N, n, 1 };
+    _evals.create(3, esizes, A.type());
+    Mat E = _evals.getMat(), V;
+    if (_evects.needed())
+    {
+        int vsizes[] = { N, n, n };
+        _evects.create(3, vsizes, A.type());
+        V = _evects.getMat();
+    }
+
+    AutoBuffer<uchar> status(N);
+    parallel_for_(Range(0, N), BatchEigenInvoker(A, E, V, status.data()), (double)N*n*n*n/(1 << 14));
+    for (int i = 0; i < N; i++)
+        if (!status[i])
+            return false;
+    return true;
+}
+
+
 CV_IMPL double
 cvDet( const CvArr* arr )
 {
@@ -1127,55 +1127,325 @@ void cv::reduce(InputArray _src, OutputArray _dst, int dim, int op, int dtype)
 namespace cv
 {
 
-template<typename T> static void sort_( const Mat& src, Mat& dst, int flags )
+// sequences shorter than this are sorted with std::sort
+static const int RADIX_SORT_MIN_LEN = 256;
+// sequences longer than this are split between several threads
+static const int RADIX_SORT_PARALLEL_LEN = 1 << 16;
+
+// order-preserving mapping of the values to unsigned integer keys
+template<typename T> struct RadixSortKey {};
+
+template<> struct RadixSortKey<uchar>
 {
-    AutoBuffer<T> buf;
-    int n, len;
-    bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
-    bool inplace = src.data == dst.data;
-    bool sortDescending = (flags & CV_SORT_DESCENDING) != 0;
+    typedef uchar key_type;
+    static inline key_type encode(uchar v) { return v; }
+    static inline uchar decode(key_type k) { return k; }
+};
 
-    if( sortRows )
-        n = src.rows, len = src.cols;
-    else
+template<> struct RadixSortKey<schar>
+{
+    typedef uchar key_type;
+    static inline key_type encode(schar v) { return (uchar)((uchar)v ^ 0x80); }
+    static inline schar decode(key_type k) { return (schar)(k ^ 0x80); }
+};
+
+template<> struct RadixSortKey<ushort>
+{
+    typedef ushort key_type;
+    static inline key_type encode(ushort v) { return v; }
+    static inline ushort decode(key_type k) { return k; }
+};
+
+template<> struct RadixSortKey<short>
+{
+    typedef ushort key_type;
+    static inline key_type encode(short v) { return (ushort)((ushort)v ^ 0x8000); }
+    static inline short decode(key_type k) { return (short)(k ^ 0x8000); }
+};
+
+template<> struct RadixSortKey<int>
+{
+    typedef unsigned key_type;
+    static inline key_type encode(int v) { return (unsigned)v ^ 0x80000000u; }
+    static inline int decode(key_type k) { return (int)(k ^ 0x80000000u); }
+};
+
+template<> struct RadixSortKey<float>
+{
+    typedef unsigned key_type;
+    // negative values: flip all the bits, positive values: flip the sign bit
+    static inline key_type encode(float v)
+    {
+        Cv32suf u; u.f = v;
+        return u.u ^ ((unsigned)(u.i >> 31) | 0x80000000u);
+    }
+    static inline float decode(key_type k)
     {
-        n = src.cols, len = src.rows;
-        buf.allocate(len);
+        Cv32suf u; u.u = k ^ ((k & 0x80000000u) ? 0x80000000u : 0xffffffffu);
+        return u.f;
     }
-    T* bptr = buf.data();
+};
 
-    for( int i = 0; i < n; i++ )
+template<> struct RadixSortKey<double>
+{
+    typedef uint64 key_type;
+    static inline key_type encode(double v)
     {
-        T* ptr = bptr;
-        if( sortRows )
+        Cv64suf u; u.f = v;
+        return u.u ^ ((uint64)(u.i >> 63) | CV_BIG_UINT(0x8000000000000000));
+    }
+    static inline double decode(key_type k)
+    {
+        Cv64suf u; u.u = k ^ ((k & CV_BIG_UINT(0x8000000000000000)) ? CV_BIG_UINT(0x8000000000000000) : CV_BIG_UINT(0xffffffffffffffff));
+        return u.f;
+    }
+};
+
+template<typename KT> class RadixSortHistInvoker : public ParallelLoopBody
+{
+public:
+    RadixSortHistInvoker(const KT* keys_, int len_, int nchunks_, int* hist_)
+        : keys(keys_), len(len_), nchunks(nchunks_), hist(hist_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const int NBYTES = (int)sizeof(KT);
+        for (int c = range.start; c < range.end; c++)
         {
-            T* dptr = dst.ptr<T>(i);
-            if( !inplace )
+            int* h = hist + c*NBYTES*256;
+            const int i0 = (int)((int64)len*c/nchunks), i1 = (int)((int64)len*(c + 1)/nchunks);
+            for (int i = i0; i < i1; i++)
             {
-                const T* sptr = src.ptr<T>(i);
-                memcpy(dptr, sptr, sizeof(T) * len);
+                const KT k = keys[i];
+                for (int b = 0; b < NBYTES; b++)
+                    h[b*256 + ((k >> (b*8)) & 255)]++;
             }
-            ptr = dptr;
         }
-        else
+    }
+
+private:
+    RadixSortHistInvoker& operator=(const RadixSortHistInvoker&); // = delete
+
+    const KT* keys;
+    int len, nchunks;
+    int* hist;
+};
+
+template<typename KT> class RadixSortScatterInvoker : public ParallelLoopBody
+{
+public:
+    RadixSortScatterInvoker(const KT* keys_, const int* idx_, KT* dkeys_, int* didx_,
+                            int len_, int nchunks_, int shift_, const int* offsets_)
+        : keys(keys_), idx(idx_), dkeys(dkeys_), didx(didx_),
+          len(len_), nchunks(nchunks_), shift(shift_), offsets(offsets_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int pos[256];
+        for (int c = range.start; c < range.end; c++)
         {
-            for( int j = 0; j < len; j++ )
-                ptr[j] = src.ptr<T>(j)[i];
+            memcpy(pos, offsets + c*256, sizeof(pos));
+            const int i0 = (int)((int64)len*c/nchunks), i1 = (int)((int64)len*(c + 1)/nchunks);
+            if (idx)
+            {
+                for (int i = i0; i < i1; i++)
+                {
+                    const KT k = keys[i];
+                    const int p = pos[(k >> shift) & 255]++;
+                    dkeys[p] = k;
+                    didx[p] = idx[i];
+                }
+            }
+            else
+            {
+                for (int i = i0; i < i1; i++)
+                {
+                    const KT k = keys[i];
+                    dkeys[pos[(k >> shift) & 255]++] = k;
+                }
+            }
         }
+    }
+
+private:
+    RadixSortScatterInvoker& operator=(const RadixSortScatterInvoker&); // = delete
+
+    const KT* keys;
+    const int* idx;
+    KT* dkeys;
+    int* didx;
+    int len, nchunks, shift;
+    const int* offsets;
+};
 
-        std::sort( ptr, ptr + len );
-        if( sortDescending )
+/*
+Stable LSD radix sort of the keys (and optional payload indices) by 8-bit digits.
+The digits shared by all the keys are skipped. Long sequences are split into nchunks
+parts, so both the histogram and the scatter steps of each pass run in parallel.
+The result is independent of the number of threads.
+*/
+template<typename KT>
+static void radixSort(KT* keys, int* idx, KT* kbuf, int* ibuf, int len, int nchunks)
+{
+    const int NBYTES = (int)sizeof(KT);
+    AutoBuffer<int, 1024> _hist(nchunks*NBYTES*256), _offsets(nchunks*256);
+    int* hist = _hist.data();
+    int* offsets = _offsets.data();
+    memset(hist, 0, nchunks*NBYTES*256*sizeof(hist[0]));
+
+    RadixSortHistInvoker<KT> histInvoker(keys, len, nchunks, hist);
+    if (nchunks > 1)
+        parallel_for_(Range(0, nchunks), histInvoker);
+    else
+        histInvoker(Range(0, 1));
+
+    KT *src = keys, *dst = kbuf;
+    int *isrc = idx, *idst = ibuf;
+    for (int b = 0; b < NBYTES; b++)
+    {
+        // exclusive prefix sum over (digit, chunk)
+        int sum = 0;
+        bool trivial = false;
+        for (int d = 0; d < 256; d++)
         {
-            for( int j = 0; j < len/2; j++ )
-                std::swap(ptr[j], ptr[len-1-j]);
+            int total = 0;
+            for (int c = 0; c < nchunks; c++)
+            {
+                offsets[c*256 + d] = sum + total;
+                total += hist[(c*NBYTES + b)*256 + d];
+            }
+            if (total == len)
+                trivial = true;
+            sum += total;
         }
+        if (trivial)
+            continue;
 
-        if( !sortRows )
-            for( int j = 0; j < len; j++ )
-                dst.ptr<T>(j)[i] = ptr[j];
+        RadixSortScatterInvoker<KT> scatterInvoker(src, isrc, dst, idst, len, nchunks, b*8, offsets);
+        if (nchunks > 1)
+            parallel_for_(Range(0, nchunks), scatterInvoker);
+        else
+            scatterInvoker(Range(0, 1));
+        std::swap(src, dst);
+        std::swap(isrc, idst);
+    }
+
+    if (src != keys)
+    {
+        memcpy(keys, src, len*sizeof(keys[0]));
+        if (idx)
+            memcpy(idx, isrc, len*sizeof(idx[0]));
     }
 }
 
+static inline int radixSortChunks(int len, int nseq)
+{
+    if (len < RADIX_SORT_PARALLEL_LEN || nseq >= getNumThreads())
+        return 1;
+    return std::min(len / (RADIX_SORT_PARALLEL_LEN/4), 64);
+}
+
+template<typename T> class SortInvoker : public ParallelLoopBody
+{
+public:
+    SortInvoker(const Mat& src_, Mat& dst_, int flags_, int nchunks_)
+        : src(src_), dst(dst_), flags(flags_), nchunks(nchunks_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        typedef typename RadixSortKey<T>::key_type KT;
+        bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
+        bool inplace = src.data == dst.data;
+        bool sortDescending = (flags & CV_SORT_DESCENDING) != 0;
+        int len = sortRows ? src.cols : src.rows;
+        bool useRadix = len >= RADIX_SORT_MIN_LEN;
+
+        AutoBuffer<T> buf;
+        AutoBuffer<KT> kbuf;
+        if (!sortRows)
+            buf.allocate(len);
+        if (useRadix)
+            kbuf.allocate(len*2);
+        T* bptr = buf.data();
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            T* ptr = bptr;
+            if( sortRows )
+            {
+                T* dptr = dst.ptr<T>(i);
+                if( !inplace && !useRadix )
+                {
+                    const T* sptr = src.ptr<T>(i);
+                    memcpy(dptr, sptr, sizeof(T) * len);
+                }
+                ptr = dptr;
+            }
+            else if( !useRadix )
+            {
+                for( int j = 0; j < len; j++ )
+                    ptr[j] = src.ptr<T>(j)[i];
+            }
+
+            if( useRadix )
+            {
+                KT* keys = kbuf.data();
+                if( sortRows )
+                {
+                    const T* sptr = src.ptr<T>(i);
+                    for( int j = 0; j < len; j++ )
+                        keys[j] = RadixSortKey<T>::encode(sptr[j]);
+                }
+                else
+                {
+                    for( int j = 0; j < len; j++ )
+                        keys[j] = RadixSortKey<T>::encode(src.ptr<T>(j)[i]);
+                }
+                radixSort<KT>(keys, NULL, keys + len, NULL, len, nchunks);
+                for( int j = 0; j < len; j++ )
+                    ptr[j] = RadixSortKey<T>::decode(keys[j]);
+            }
+            else
+                std::sort( ptr, ptr + len );
+            if( sortDescending )
+            {
+                for( int j = 0; j < len/2; j++ )
+                    std::swap(ptr[j], ptr[len-1-j]);
+            }
+
+            if( !sortRows )
+                for( int j = 0; j < len; j++ )
+                    dst.ptr<T>(j)[i] = ptr[j];
+        }
+    }
+
+private:
+    SortInvoker& operator=(const SortInvoker&); // = delete
+
+    const Mat& src;
+    Mat& dst;
+    int flags;
+    int nchunks;
+};
+
+template<typename T> static void sort_( const Mat& src, Mat& dst, int flags )
+{
+    bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
+    int n = sortRows ? src.rows : src.cols, len = sortRows ? src.cols : src.rows;
+    int nchunks = radixSortChunks(len, n);
+    SortInvoker<T> invoker(src, dst, flags, nchunks);
+    if (nchunks > 1 || n == 1)
+        invoker(Range(0, n));
+    else
+        parallel_for_(Range(0, n), invoker, (double)n*len/RADIX_SORT_PARALLEL_LEN);
+}
+
 #ifdef HAVE_IPP
 typedef IppStatus (CV_STDCALL *IppSortFunc)(void  *pSrcDst, int    len, Ipp8u *pBuffer);
 
@@ -1272,56 +1542,105 @@ public:
     const _Tp* arr;
 };
 
-template<typename T> static void sortIdx_( const Mat& src, Mat& dst, int flags )
+template<typename T> class SortIdxInvoker : public ParallelLoopBody
 {
-    AutoBuffer<T> buf;
-    AutoBuffer<int> ibuf;
-    bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
-    bool sortDescending = (flags & CV_SORT_DESCENDING) != 0;
-
-    CV_Assert( src.data != dst.data );
-
-    int n, len;
-    if( sortRows )
-        n = src.rows, len = src.cols;
-    else
+public:
+    SortIdxInvoker(const Mat& src_, Mat& dst_, int flags_, int nchunks_)
+        : src(src_), dst(dst_), flags(flags_), nchunks(nchunks_)
     {
-        n = src.cols, len = src.rows;
-        buf.allocate(len);
-        ibuf.allocate(len);
     }
-    T* bptr = buf.data();
-    int* _iptr = ibuf.data();
 
-    for( int i = 0; i < n; i++ )
+    void operator()(const Range& range) const CV_OVERRIDE
     {
-        T* ptr = bptr;
-        int* iptr = _iptr;
-
-        if( sortRows )
-        {
-            ptr = (T*)(src.data + src.step*i);
-            iptr = dst.ptr<int>(i);
-        }
-        else
+        typedef typename RadixSortKey<T>::key_type KT;
+        bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
+        bool sortDescending = (flags & CV_SORT_DESCENDING) != 0;
+        int len = sortRows ? src.cols : src.rows;
+        bool useRadix = len >= RADIX_SORT_MIN_LEN;
+
+        AutoBuffer<T> buf;
+        AutoBuffer<int> ibuf;
+        AutoBuffer<KT> kbuf;
+        if( !sortRows || useRadix )
+            ibuf.allocate(useRadix ? len*2 : len);
+        if( !sortRows && !useRadix )
+            buf.allocate(len);
+        if( useRadix )
+            kbuf.allocate(len*2);
+        T* bptr = buf.data();
+        int* _iptr = ibuf.data();
+
+        for( int i = range.start; i < range.end; i++ )
         {
+            T* ptr = bptr;
+            int* iptr = _iptr;
+
+            if( sortRows )
+            {
+                ptr = (T*)(src.data + src.step*i);
+                if( !useRadix )
+                    iptr = dst.ptr<int>(i);
+            }
+            else if( !useRadix )
+            {
+                for( int j = 0; j < len; j++ )
+                    ptr[j] = src.ptr<T>(j)[i];
+            }
             for( int j = 0; j < len; j++ )
-                ptr[j] = src.ptr<T>(j)[i];
-        }
-        for( int j = 0; j < len; j++ )
-            iptr[j] = j;
+                iptr[j] = j;
 
-        std::sort( iptr, iptr + len, LessThanIdx<T>(ptr) );
-        if( sortDescending )
-        {
-            for( int j = 0; j < len/2; j++ )
-                std::swap(iptr[j], iptr[len-1-j]);
-        }
+            if( useRadix )
+            {
+                KT* keys = kbuf.data();
+                if( sortRows )
+                {
+                    for( int j = 0; j < len; j++ )
+                        keys[j] = RadixSortKey<T>::encode(ptr[j]);
+                }
+                else
+                {
+                    for( int j = 0; j < len; j++ )
+                        keys[j] = RadixSortKey<T>::encode(src.ptr<T>(j)[i]);
+                }
+                radixSort<KT>(keys, iptr, keys + len, iptr + len, len, nchunks);
+            }
+            else
+                std::sort( iptr, iptr + len, LessThanIdx<T>(ptr) );
+            if( sortDescending )
+            {
+                for( int j = 0; j < len/2; j++ )
+                    std::swap(iptr[j], iptr[len-1-j]);
+            }
 
-        if( !sortRows )
-            for( int j = 0; j < len; j++ )
-                dst.ptr<int>(j)[i] = iptr[j];
+            if( sortRows && useRadix )
+                memcpy(dst.ptr<int>(i), iptr, len*sizeof(iptr[0]));
+            else if( !sortRows )
+                for( int j = 0; j < len; j++ )
+                    dst.ptr<int>(j)[i] = iptr[j];
+        }
     }
+
+private:
+    SortIdxInvoker& operator=(const SortIdxInvoker&); // = delete
+
+    const Mat& src;
+    Mat& dst;
+    int flags;
+    int nchunks;
+};
+
+template<typename T> static void sortIdx_( const Mat& src, Mat& dst, int flags )
+{
+    CV_Assert( src.data != dst.data );
+
+    bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
+    int n = sortRows ? src.rows : src.cols, len = sortRows ? src.cols : src.rows;
+    int nchunks = radixSortChunks(len, n);
+    SortIdxInvoker<T> invoker(src, dst, flags, nchunks);
+    if (nchunks > 1 || n == 1)
+        invoker(Range(0, n));
+    else
+        parallel_for_(Range(0, n), invoker, (double)n*len/RADIX_SORT_PARALLEL_LEN);
 }
 
 #ifdef HAVE_IPP
@@ -1405,6 +1724,100 @@ static bool ipp_sortIdx( const Mat& src, Mat& dst, int flags )
 #endif
 
 typedef void (*SortFunc)(const Mat& src, Mat& dst, int flags);
+
+template<typename _Tp> class TopKLess
+{
+public:
+    TopKLess( const _Tp* _arr ) : arr(_arr) {}
+    bool operator()(int a, int b) const { return arr[a] < arr[b] || (arr[a] == arr[b] && a < b); }
+    const _Tp* arr;
+};
+
+template<typename _Tp> class TopKGreater
+{
+public:
+    TopKGreater( const _Tp* _arr ) : arr(_arr) {}
+    bool operator()(int a, int b) const { return arr[b] < arr[a] || (arr[a] == arr[b] && a < b); }
+    const _Tp* arr;
+};
+
+template<typename T> class TopKInvoker : public ParallelLoopBody
+{
+public:
+    TopKInvoker(const Mat& src_, int k_, Mat& values_, Mat& indices_, int flags_)
+        : src(src_), k(k_), values(values_), indices(indices_), flags(flags_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
+        bool sortDescending = (flags & CV_SORT_DESCENDING) != 0;
+        int len = sortRows ? src.cols : src.rows;
+
+        AutoBuffer<T> buf;
+        AutoBuffer<int> ibuf(len);
+        if( !sortRows )
+            buf.allocate(len);
+        int* iptr = ibuf.data();
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const T* ptr = buf.data();
+            if( sortRows )
+                ptr = src.ptr<T>(i);
+            else
+            {
+                T* bptr = buf.data();
+                for( int j = 0; j < len; j++ )
+                    bptr[j] = src.ptr<T>(j)[i];
+            }
+            for( int j = 0; j < len; j++ )
+                iptr[j] = j;
+
+            if( sortDescending )
+                std::partial_sort( iptr, iptr + k, iptr + len, TopKGreater<T>(ptr) );
+            else
+                std::partial_sort( iptr, iptr + k, iptr + len, TopKLess<T>(ptr) );
+
+            for( int j = 0; j < k; j++ )
+            {
+                if( !values.empty() )
+                {
+                    if( sortRows )
+                        values.ptr<T>(i)[j] = ptr[iptr[j]];
+                    else
+                        values.ptr<T>(j)[i] = ptr[iptr[j]];
+                }
+                if( !indices.empty() )
+                {
+                    if( sortRows )
+                        indices.ptr<int>(i)[j] = iptr[j];
+                    else
+                        indices.ptr<int>(j)[i] = iptr[j];
+                }
+            }
+        }
+    }
+
+private:
+    TopKInvoker& operator=(const TopKInvoker&); // = delete
+
+    const Mat& src;
+    int k;
+    Mat& values;
+    Mat& indices;
+    int flags;
+};
+
+template<typename T> static void topK_( const Mat& src, int k, Mat& values, Mat& indices, int flags )
+{
+    bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
+    int n = sortRows ? src.rows : src.cols, len = sortRows ? src.cols : src.rows;
+    parallel_for_(Range(0, n), TopKInvoker<T>(src, k, values, indices, flags), (double)n*len/RADIX_SORT_PARALLEL_LEN);
+}
+
+typedef void (*TopKFunc)(const Mat& src, int k, Mat& values, Mat& indices, int flags);
 }
 
 void cv::sort( InputArray _src, OutputArray _dst, int flags )
@@ -1451,3 +1864,39 @@ void cv::sortIdx( InputArray _src, OutputArray _dst, int flags )
     CV_Assert( func != 0 );
     func( src, dst, flags );
 }
+
+void cv::topK( InputArray _src, int k, OutputArray _values, OutputArray _indices, int flags )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = _src.getMat();
+    CV_Assert( src.dims <= 2 && src.channels() == 1 );
+    bool sortRows = (flags & 1) == SORT_EVERY_ROW;
+    int len = sortRows ? src.cols : src.rows;
+    CV_CheckGE(k, 0, "k must be non-negative");
+    CV_CheckLE(k, len, "k should not exceed the number of elements in the row (column)");
+
+    Size dsize = sortRows ? Size(k, src.rows) : Size(src.cols, k);
+    Mat values, indices;
+    if( _values.needed() )
+    {
+        _values.create( dsize, src.type() );
+        values = _values.getMat();
+    }
+    if( _indices.needed() )
+    {
+        _indices.create( dsize, CV_32S );
+        indices = _indices.getMat();
+    }
+    if( k == 0 || src.empty() || (values.empty() && indices.empty()) )
+        return;
+
+    static TopKFunc tab[] =
+    {
+        topK_<uchar>, topK_<schar>, topK_<ushort>, topK_<short>,
+        topK_<int>, topK_<float>, topK_<double>, 0
+    };
+    TopKFunc func = tab[src.depth()];
+    CV_Assert( func != 0 );
+    func( src, k, values, indices, flags );
+}
@@ -62,6 +62,227 @@ PCA::PCA(InputArray data, InputArray _mean, int flags, double retainedVariance)
     operator()(data, _mean, flags, retainedVariance);
 }
 
+// the products below operate on the centered data matrix A = X - 1*mean' (one sample per row),
+// which is never materialized: every stripe converts and centers its own block of samples
+enum { PCA_BLOCK_SAMPLES = 256, PCA_RSVD_OVERSAMPLING = 10, PCA_RSVD_POWER_ITERS = 4 };
+
+static void loadCenteredSamples(const Mat& data, bool asCol, const Mat& mean, int a, int b, Mat& buf)
+{
+    if( asCol )
+    {
+        Mat tmp;
+        transpose(data.colRange(a, b), tmp);
+        tmp.convertTo(buf, mean.type());
+    }
+    else
+        data.rowRange(a, b).convertTo(buf, mean.type());
+    for( int i = 0; i < buf.rows; i++ )
+    {
+        Mat row = buf.row(i);
+        subtract(row, mean, row);
+    }
+}
+
+class PCAProductInvoker : public ParallelLoopBody
+{
+public:
+    // partials == 0: dst = A*rhs, otherwise partials[stripe] = A(stripe)'*rhs(stripe)
+    PCAProductInvoker(const Mat& _data, bool _asCol, const Mat& _mean, const Mat& _rhs,
+                      Mat* _dst, std::vector<Mat>* _partials, int _nsamples, int _nstripes)
+        : data(_data), asCol(_asCol), mean(_mean), rhs(_rhs), dst(_dst),
+          partials(_partials), nsamples(_nsamples), nstripes(_nstripes)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        Mat buf, tmp;
+        for( int s = range.start; s < range.end; s++ )
+        {
+            int start = (int)((int64)nsamples*s/nstripes), end = (int)((int64)nsamples*(s + 1)/nstripes);
+            Mat* acc = partials ? &(*partials)[s] : 0;
+            if( acc )
+                acc->setTo(Scalar::all(0));
+            for( int a = start; a < end; a += PCA_BLOCK_SAMPLES )
+            {
+                int b = std::min(a + PCA_BLOCK_SAMPLES, end);
+                loadCenteredSamples(data, asCol, mean, a, b, buf);
+                if( !acc )
+                {
+                    Mat d = dst->rowRange(a, b);
+                    gemm(buf, rhs, 1, noArray(), 0, d);
+                }
+                else
+                {
+                    gemm(buf, rhs.rowRange(a, b), 1, noArray(), 0, tmp, GEMM_1_T);
+                    add(*acc, tmp, *acc);
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& data;
+    bool asCol;
+    const Mat& mean;
+    const Mat& rhs;
+    Mat* dst;
+    std::vector<Mat>* partials;
+    int nsamples, nstripes;
+
+    PCAProductInvoker& operator=(const PCAProductInvoker&); // = delete
+};
+
+static int pcaProductStripes(int nsamples)
+{
+    return std::max(1, std::min((nsamples + PCA_BLOCK_SAMPLES - 1)/PCA_BLOCK_SAMPLES, getNumThreads()*4));
+}
+
+// Y = A*omega
+static void pcaMulA(const Mat& data, bool asCol, const Mat& mean, const Mat& omega, int nsamples, Mat& Y)
+{
+    Y.create(nsamples, omega.cols, mean.type());
+    int nstripes = pcaProductStripes(nsamples);
+    parallel_for_(Range(0, nstripes), PCAProductInvoker(data, asCol, mean, omega, &Y, 0, nsamples, nstripes));
+}
+
+// Z = A'*Y
+static void pcaMulAt(const Mat& data, bool asCol, const Mat& mean, const Mat& Y, int nsamples, Mat& Z)
+{
+    int nstripes = pcaProductStripes(nsamples);
+    std::vector<Mat> partials(nstripes);
+    for( int s = 0; s < nstripes; s++ )
+        partials[s].create(mean.cols, Y.cols, mean.type());
+    parallel_for_(Range(0, nstripes), PCAProductInvoker(data, asCol, mean, Y, 0, &partials, nsamples, nstripes));
+    partials[0].copyTo(Z);
+    for( int s = 1; s < nstripes; s++ )
+        add(Z, partials[s], Z);
+}
+
+// orthonormalizes the columns of M in place: M'M = V*diag(w)*V' -> M*V*diag(1/sqrt(w)).
+// Done twice, since one pass loses accuracy proportionally to the squared condition number.
+static void orthonormalizeColumns(Mat& M)
+{
+    for( int pass = 0; pass < 2; pass++ )
+    {
+        Mat G, w, V;
+        mulTransposed(M, G, true, noArray(), 1, CV_64F);
+        eigen(G, w, V);
+        double wmax = std::max(w.at<double>(0), DBL_MIN);
+        Mat T(V.cols, V.rows, CV_64F);
+        for( int j = 0; j < V.rows; j++ )
+        {
+            double wj = w.at<double>(j);
+            double scale = wj > wmax*DBL_EPSILON ? 1./std::sqrt(wj) : 0.;
+            for( int i = 0; i < V.cols; i++ )
+                T.at<double>(i, j) = V.at<double>(j, i)*scale;
+        }
+        T.convertTo(T, M.type());
+        Mat Q;
+        gemm(M, T, 1, noArray(), 0, Q);
+        M = Q;
+    }
+}
+
+// randomized truncated SVD of A (Halko, Martinsson, Tropp, 2011)
+static void randomizedPCA(const Mat& data, bool asCol, const Mat& mean, int maxComponents,
+                          Mat& eigenvalues, Mat& eigenvectors)
+{
+    int nsamples = asCol ? data.cols : data.rows, len = mean.cols, ctype = mean.type();
+    int k = std::min(maxComponents, std::min(nsamples, len));
+    int l = std::min(k + PCA_RSVD_OVERSAMPLING, std::min(nsamples, len));
+
+    Mat omega(len, l, ctype), Y, Z;
+    RNG rng(0x34985739);
+    rng.fill(omega, RNG::NORMAL, Scalar::all(0), Scalar::all(1));
+
+    pcaMulA(data, asCol, mean, omega, nsamples, Y);
+    for( int iter = 0; iter < PCA_RSVD_POWER_ITERS; iter++ )
+    {
+        orthonormalizeColumns(Y);
+        pcaMulAt(data, asCol, mean, Y, nsamples, Z);
+        orthonormalizeColumns(Z);
+        pcaMulA(data, asCol, mean, Z, nsamples, Y);
+    }
+    orthonormalizeColumns(Y);
+
+    // A ~ Q*Q'*A = Q*B; B' = A'*Q = U*S*V' -> the right singular vectors of A are the columns of U
+    Mat Bt, w, u, vt;
+    pcaMulAt(data, asCol, mean, Y, nsamples, Bt);
+    SVD::compute(Bt, w, u, vt);
+
+    eigenvectors = u.colRange(0, k).t();
+    multiply(w.rowRange(0, k), w.rowRange(0, k), eigenvalues, 1./nsamples);
+}
+
+// rows of the batch converted to the computation type
+static Mat batchSamples(const Mat& data, bool asCol, int ctype)
+{
+    Mat samples;
+    if( asCol )
+        transpose(data, samples);
+    else
+        samples = data;
+    samples.convertTo(samples, ctype);
+    return samples;
+}
+
+// incremental PCA update (Ross, Lim, Lin, Yang, 2008): the current model is represented by the
+// scaled components S*V, they are stacked together with the centered batch and the mean shift
+// correction and the result is re-factorized with SVD, so the memory does not depend on the
+// number of the samples seen so far.
+static void updatePCA(PCA& pca, const Mat& data, bool asCol, int64& samples, int maxComponents)
+{
+    int ctype = pca.mean.empty() ? std::max(CV_32F, data.depth()) : pca.mean.depth();
+    Mat X = batchSamples(data, asCol, ctype), bmean;
+    int b = X.rows, len = X.cols;
+    reduce(X, bmean, 0, REDUCE_AVG, ctype);
+
+    Mat prevMean, M;
+    int prevCount = 0;
+    double n = (double)samples;
+    if( samples > 0 )
+    {
+        prevMean = pca.mean.reshape(1, 1);
+        CV_Assert( prevMean.cols == len && pca.eigenvectors.cols == len );
+        CV_Assert( pca.eigenvalues.total() == (size_t)pca.eigenvectors.rows );
+        prevCount = pca.eigenvectors.rows;
+    }
+
+    M.create(prevCount + b + (prevCount > 0), len, ctype);
+    Mat eval;
+    if( prevCount > 0 )
+        pca.eigenvalues.reshape(1, prevCount).convertTo(eval, CV_64F);
+    for( int i = 0; i < prevCount; i++ )
+    {
+        Mat row = M.row(i);
+        pca.eigenvectors.row(i).convertTo(row, ctype, std::sqrt(std::max(eval.at<double>(i), 0.)*n));
+    }
+    for( int i = 0; i < b; i++ )
+    {
+        Mat row = M.row(prevCount + i);
+        subtract(X.row(i), bmean, row);
+    }
+    if( prevCount > 0 )
+    {
+        Mat row = M.row(prevCount + b);
+        subtract(prevMean, bmean, row);
+        row *= std::sqrt(n*b/(n + b));
+    }
+
+    Mat w, vt;
+    SVD::compute(M, w, noArray(), vt);
+    int k = maxComponents > 0 ? std::min(maxComponents, w.rows) : w.rows;
+    double total = n + b;
+
+    pca.eigenvectors = vt.rowRange(0, k).clone();
+    multiply(w.rowRange(0, k), w.rowRange(0, k), pca.eigenvalues, 1./total);
+    if( prevCount > 0 )
+        addWeighted(prevMean, n/total, bmean, b/total, 0, bmean);
+    pca.mean = asCol ? bmean.reshape(1, len) : bmean;
+    samples += b;
+}
+
 PCA& PCA::operator()(InputArray _data, InputArray __mean, int flags, int maxComponents)
 {
     Mat data = _data.getMat(), _mean = __mean.getMat();
@@ -89,6 +310,28 @@ PCA& PCA::operator()(InputArray _data, InputArray __mean, int flags, int maxComp
     if( maxComponents > 0 )
         out_count = std::min(count, maxComponents);
 
+    if( flags & PCA::RANDOMIZED )
+    {
+        CV_Assert( maxComponents > 0 );
+        int ctype = std::max(CV_32F, data.depth());
+        Mat rowMean;
+        if( !_mean.empty() )
+        {
+            CV_Assert( _mean.size() == mean_sz );
+            _mean.reshape(1, 1).convertTo(rowMean, ctype);
+        }
+        else if( flags & CV_PCA_DATA_AS_COL )
+        {
+            reduce(data, rowMean, 1, REDUCE_AVG, ctype);
+            rowMean = rowMean.reshape(1, 1);
+        }
+        else
+            reduce(data, rowMean, 0, REDUCE_AVG, ctype);
+        randomizedPCA(data, (flags & CV_PCA_DATA_AS_COL) != 0, rowMean, out_count, eigenvalues, eigenvectors);
+        mean = rowMean.reshape(1, mean_sz.height);
+        return *this;
+    }
+
     // "scrambled" way to compute PCA (when cols(A)>rows(A)):
     // B = A'A; B*x=b*x; C = AA'; C*y=c*y -> AA'*y=c*y -> A'A*(A'*y)=c*(A'*y) -> c = b, x=A'*y
     if( len <= in_count )
@@ -222,6 +465,7 @@ PCA& PCA::operator()(InputArray _data, InputArray __mean, int flags, double reta
     }
 
     CV_Assert( retainedVariance > 0 && retainedVariance <= 1 );
+    CV_Assert( !(flags & PCA::RANDOMIZED) );
 
     int count = std::min(len, in_count);
 
@@ -289,6 +533,24 @@ PCA& PCA::operator()(InputArray _data, InputArray __mean, int flags, double reta
     return *this;
 }
 
+PCA& PCA::update(InputArray _data, int64& samples, int flags, int maxComponents)
+{
+    Mat data = _data.getMat();
+
+    CV_Assert( data.channels() == 1 && !data.empty() );
+    CV_Assert( samples >= 0 );
+    // the model can't be weighted against the batch without the number of its samples,
+    // so a loaded model is never replaced by the batch silently
+    if( samples == 0 && !eigenvectors.empty() )
+        CV_Error( Error::StsBadArg, "The number of samples the PCA model is computed from is unknown, "
+                  "pass it to PCA::update() along with the model" );
+    if( samples > 0 && eigenvectors.empty() )
+        CV_Error( Error::StsBadArg, "The PCA model is empty, the number of samples must be 0" );
+
+    updatePCA(*this, data, (flags & CV_PCA_DATA_AS_COL) != 0, samples, maxComponents);
+    return *this;
+}
+
 void PCA::project(InputArray _data, OutputArray result) const
 {
     Mat data = _data.getMat();
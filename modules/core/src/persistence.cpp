@@ -4,9 +4,20 @@
 
 #include "precomp.hpp"
 #include "persistence.hpp"
+#include <opencv2/core/utils/configuration.private.hpp>
 #include <unordered_map>
+#include <map>
+#include <set>
 #include <iterator>
 
+#if defined __unix__ || defined __APPLE__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CV_FS_USE_MMAP 1
+#endif
+
 namespace cv
 {
 
@@ -294,6 +305,88 @@ static inline int readInt(const uchar* p)
 #endif
 }
 
+// Decodes the Base64 text straight from the input, the characters out of the Base64 alphabet
+// (line breaks, indentation) are skipped
+class Base64TextReader
+{
+public:
+    Base64TextReader(const char* _ptr, const char* _end) : ptr(_ptr), end(_end), bits(0), nbits(0) {}
+
+    size_t read(uchar* dst, size_t len)
+    {
+        size_t i = 0;
+        for( ; i < len && ptr < end; ptr++ )
+        {
+            char c = *ptr;
+            int v = 'A' <= c && c <= 'Z' ? c - 'A' : 'a' <= c && c <= 'z' ? c - 'a' + 26 :
+                    '0' <= c && c <= '9' ? c - '0' + 52 : c == '+' ? 62 : c == '/' ? 63 : -1;
+            if( v < 0 )
+                continue;
+            bits = ((bits << 6) | (unsigned)v) & 0xffff;
+            nbits += 6;
+            if( nbits >= 8 )
+            {
+                nbits -= 8;
+                dst[i++] = (uchar)(bits >> nbits);
+            }
+        }
+        return i;
+    }
+
+private:
+    const char* ptr;
+    const char* end;
+    unsigned bits;
+    int nbits;
+};
+
+// Copies the raw data blocks of the binary storage one after another
+class RawBlockReader
+{
+public:
+    RawBlockReader(const char* _base, const std::vector<std::pair<size_t, size_t> >& _blocks)
+        : base(_base), blocks(_blocks), idx(0), ofs(0) {}
+
+    size_t read(uchar* dst, size_t len)
+    {
+        size_t i = 0;
+        while( i < len && idx < blocks.size() )
+        {
+            size_t n = std::min(len - i, blocks[idx].second - ofs);
+            memcpy(dst + i, base + blocks[idx].first + ofs, n);
+            i += n;
+            ofs += n;
+            if( ofs == blocks[idx].second )
+                idx++, ofs = 0;
+        }
+        return i;
+    }
+
+private:
+    const char* base;
+    const std::vector<std::pair<size_t, size_t> >& blocks;
+    size_t idx, ofs;
+};
+
+// Reads the little-endian matrix data into the destination plane by plane
+template<typename Reader> static void readMatPlanes(Reader& reader, Mat& m)
+{
+    const int one = 1;
+    const bool swapBytes = *(const uchar*)&one != 1;
+    const size_t esz1 = m.elemSize1();
+    const Mat* arrays[] = { &m, 0 };
+    uchar* ptrs[1] = {};
+    NAryMatIterator it(arrays, ptrs);
+    size_t planeSize = it.size*m.elemSize();
+    for( size_t i = 0; i < it.nplanes; i++, ++it )
+    {
+        if( reader.read(ptrs[0], planeSize) != planeSize )
+            CV_Error( Error::StsParseError, "Unexpected end of the matrix data" );
+        for( size_t j = 0; swapBytes && j < planeSize; j += esz1 )
+            std::reverse(ptrs[0] + j, ptrs[0] + j + esz1);
+    }
+}
+
 static inline double readReal(const uchar* p)
 {
 #if CV_UNALIGNED_LITTLE_ENDIAN_MEM_ACCESS
@@ -361,7 +454,15 @@ public:
 
         strbufv.clear();
         strbuf = 0;
-        strbufsize = strbufpos = 0;
+        strbufsize = strbufpos = strbuflinepos = 0;
+        mapped_data = 0;
+        mapped_size = 0;
+        deferredData.clear();
+        matrixNodes.clear();
+        matrixDataNodes.clear();
+        base64state = BASE64_NONE;
+        base64dt.clear();
+        base64data.clear();
         roots.clear();
 
         fs_data.clear();
@@ -448,8 +549,6 @@ public:
 
     bool open( const char* filename_or_buf, int _flags, const char* encoding )
     {
-        _flags &= ~FileStorage::BASE64;
-
         bool ok = true;
         release();
 
@@ -468,9 +567,9 @@ public:
             if( !params.empty() )
                 filename = params[0];
 
-            /*if( !write_base64 && params.size() >= 2 &&
-                std::find(params.begin()+1, params.end(), std::string("base64")) != params.end())
-                write_base64 = (write_mode || append);*/
+            if( write_mode && params.size() >= 2 &&
+                std::find(params.begin()+1, params.end(), std::string("base64")) != params.end() )
+                _flags |= FileStorage::BASE64;
         }
 
         if( filename.size() == 0 && !mem_mode && !write_mode )
@@ -481,6 +580,12 @@ public:
 
         flags = _flags;
 
+        const char* ext = strrchr(filename.c_str(), '.');
+        bool binary = write_mode && ((flags & FileStorage::FORMAT_MASK) == FileStorage::FORMAT_BINARY ||
+            ((flags & FileStorage::FORMAT_MASK) == FileStorage::FORMAT_AUTO && ext && fs::strcasecmp(ext, ".cvbin") == 0));
+        if( binary && (mem_mode || append) )
+            CV_Error( CV_StsNotImplemented, "The binary storage can not be appended or written to memory" );
+
         if( !mem_mode )
         {
             char* dot_pos = strrchr((char*)filename.c_str(), '.');
@@ -493,6 +598,8 @@ public:
                 {
                     CV_Error(CV_StsNotImplemented, "Appending data to compressed file is not implemented" );
                 }
+                if( binary )
+                    CV_Error(CV_StsNotImplemented, "The binary storage can not be compressed" );
                 isGZ = true;
                 compression = dot_pos[3];
                 if( compression )
@@ -501,9 +608,14 @@ public:
 
             if( !isGZ )
             {
-                file = fopen(filename.c_str(), !write_mode ? "rt" : !append ? "wt" : "a+t" );
-                if( !file )
-                    return false;
+                // the parsers read the mapped file as the in-memory string,
+                // so the data are neither copied to the heap nor passed through stdio
+                if( write_mode || !mapFile() )
+                {
+                    file = fopen(filename.c_str(), !write_mode ? "rt" : binary ? "wb" : !append ? "wt" : "a+t" );
+                    if( !file )
+                        return false;
+                }
             }
             else
             {
@@ -551,6 +663,7 @@ public:
                         ? FileStorage::FORMAT_XML
                     : (fs::strcasecmp(dot_pos, ".json") == 0 || fs::strcasecmp(dot_pos, ".json.gz") == 0)
                         ? FileStorage::FORMAT_JSON
+                    : binary ? FileStorage::FORMAT_BINARY
                     : FileStorage::FORMAT_YAML;
             }
             else if( fmt == FileStorage::FORMAT_AUTO )
@@ -640,6 +753,10 @@ public:
 
                 emitter = createXMLEmitter(this);
             }
+            else if( fmt == FileStorage::FORMAT_BINARY )
+            {
+                emitter = createBinaryEmitter(this);
+            }
             else if( fmt == FileStorage::FORMAT_YAML )
             {
                 if( !append)
@@ -713,6 +830,8 @@ public:
                 fmt = FileStorage::FORMAT_JSON;
             else if(strncmp( bufPtr, xml_signature, strlen(xml_signature) ) == 0)
                 fmt = FileStorage::FORMAT_XML;
+            else if(isBinaryStorageSignature( buf ))
+                fmt = FileStorage::FORMAT_BINARY;
             else if(strbufsize  == bufOffset)
                 CV_Error(CV_BADARG_ERR, "Input file is invalid");
             else
@@ -722,6 +841,14 @@ public:
             strbufpos = bufOffset;
             bufofs = 0;
 
+            if( fmt == FileStorage::FORMAT_BINARY )
+            {
+                if( mem_mode || gzfile )
+                    CV_Error(CV_StsNotImplemented, "The binary storage can only be read from uncompressed file");
+                if( !strbuf )
+                    readWholeFile();
+            }
+
             try
             {
                 char* ptr = bufferStart();
@@ -740,6 +867,7 @@ public:
                     case FileStorage::FORMAT_XML: parser = createXMLParser(this); break;
                     case FileStorage::FORMAT_YAML: parser = createYAMLParser(this); break;
                     case FileStorage::FORMAT_JSON: parser = createJSONParser(this); break;
+                    case FileStorage::FORMAT_BINARY: parser = createBinaryParser(this); break;
                     default: parser = Ptr<FileStorageParser>();
                 }
 
@@ -767,11 +895,16 @@ public:
                 throw;
             }
 
-            // release resources that we do not need anymore
-            closeFile();
+            // release resources that we do not need anymore; the mapped file is kept
+            // while it holds the matrix data that is decoded on request (FileStorage::DEFER_MAT_DATA)
+            matrixNodes.clear();
+            matrixDataNodes.clear();
+            if( deferredData.empty() )
+                closeFile();
             is_opened = true;
             std::vector<char> tmpbuf;
             std::swap(buffer, tmpbuf);
+            std::vector<char>().swap(strbufv);
             bufofs = 0;
         }
         return ok;
@@ -792,6 +925,47 @@ public:
             CV_Error( CV_StsError, "The storage is not opened" );
     }
 
+    void putBytes( const void* data, size_t len )
+    {
+        CV_Assert( write_mode );
+        const char* str = (const char*)data;
+        if( mem_mode )
+            std::copy(str, str + len, std::back_inserter(outbuf));
+        else if( file )
+            fwrite( str, 1, len, file );
+#if USE_ZLIB
+        else if( gzfile )
+            gzwrite( gzfile, str, (unsigned)len );
+#endif
+        else
+            CV_Error( CV_StsError, "The storage is not opened" );
+    }
+
+    const char* getInputData( size_t& size ) const
+    {
+        size = strbuf ? strbufsize : 0;
+        return strbuf;
+    }
+
+    // used when the file could not be mapped
+    void readWholeFile()
+    {
+        closeFile();
+        file = fopen(filename.c_str(), "rb");
+        CV_Assert( file != 0 );
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        CV_Assert( size >= 0 );
+        fseek(file, 0, SEEK_SET);
+        strbufv.resize((size_t)size + 1);
+        size_t count = fread(&strbufv[0], 1, (size_t)size, file);
+        if( count != (size_t)size )
+            CV_Error(CV_StsError, "Can not read the file");
+        strbuf = &strbufv[0];
+        strbufsize = count;
+        strbufpos = 0;
+    }
+
     char* getsFromFile( char* buf, int count )
     {
         if( file )
@@ -825,6 +999,7 @@ public:
             buffer.resize(std::max(buffer.size(), maxCount + 8));
             memcpy(&buffer[0], instr + strbufpos, maxCount);
             buffer[maxCount] = '\0';
+            strbuflinepos = strbufpos;
             strbufpos = i;
             return maxCount > 0 ? &buffer[0] : 0;
         }
@@ -904,6 +1079,7 @@ public:
         else if( gzfile )
             gzclose( gzfile );
 #endif
+        unmapFile();
         file = 0;
         gzfile = 0;
         strbuf = 0;
@@ -911,6 +1087,53 @@ public:
         is_opened = false;
     }
 
+    static bool useMemoryMapping()
+    {
+        static bool param = utils::getConfigurationParameterBool("OPENCV_PERSISTENCE_MMAP", false);
+        return param;
+    }
+
+    // Maps the whole file for reading. Returns false if it is not possible (or not supported),
+    // then the file is read with the regular stdio functions. The mapping is used with
+    // FileStorage::DEFER_MAT_DATA or when OPENCV_PERSISTENCE_MMAP is set: a file truncated by another
+    // writer while it is mapped makes the access to the lost pages fail with SIGBUS
+    bool mapFile()
+    {
+#ifdef CV_FS_USE_MMAP
+        if( !(flags & FileStorage::DEFER_MAT_DATA) && !useMemoryMapping() )
+            return false;
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if( fd < 0 )
+            return false;
+        struct stat st;
+        void* data = MAP_FAILED;
+        if( fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 )
+            data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if( data == MAP_FAILED )
+            return false;
+        madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+        mapped_data = (char*)data;
+        mapped_size = (size_t)st.st_size;
+        strbuf = mapped_data;
+        strbufsize = mapped_size;
+        strbufpos = 0;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void unmapFile()
+    {
+#ifdef CV_FS_USE_MMAP
+        if( mapped_data )
+            munmap(mapped_data, mapped_size);
+#endif
+        mapped_data = 0;
+        mapped_size = 0;
+    }
+
     void rewind()
     {
         if( file )
@@ -971,6 +1194,16 @@ public:
         CV_Assert( write_mode );
         CV_Assert( !write_stack.empty() );
 
+        if( base64state == BASE64_DATA )
+        {
+            FStructData s = write_stack.back();
+            write_stack.pop_back();
+            base64state = BASE64_NONE;
+            writeBase64Node(s.tag.empty() ? 0 : s.tag.c_str());
+            return;
+        }
+        startDelayedStruct();
+
         FStructData& current_struct = write_stack.back();
         if( fmt == FileStorage::FORMAT_JSON && !FileNode::isFlow(current_struct.flags) && write_stack.size() > 1 )
             current_struct.indent = write_stack[write_stack.size() - 2].indent;
@@ -983,7 +1216,7 @@ public:
     }
 
     void startWriteStruct( const char* key, int struct_flags,
-                           const char* type_name )
+                           const char* type_name, bool allowBase64=true )
     {
         CV_Assert( write_mode );
 
@@ -995,6 +1228,19 @@ public:
         if( type_name && type_name[0] == '\0' )
             type_name = 0;
 
+        startDelayedStruct();
+
+        // in the Base64 mode the raw data of a flow sequence is written as a single Base64 node,
+        // so the sequence is emitted only when it turns out to hold something else
+        if( allowBase64 && (flags & FileStorage::BASE64) && fmt != FileStorage::FORMAT_BINARY && !type_name &&
+            FileNode::isSeq(struct_flags) && FileNode::isFlow(struct_flags) &&
+            !FileNode::isFlow(write_stack.back().flags) )
+        {
+            write_stack.push_back(FStructData(key ? key : "", struct_flags, write_stack.back().indent));
+            base64state = BASE64_DELAYED;
+            return;
+        }
+
         FStructData s = emitter->startWriteStruct( write_stack.back(), key, struct_flags, type_name );
         write_stack.push_back(s);
         size_t write_stack_size = write_stack.size();
@@ -1013,12 +1259,14 @@ public:
     void writeComment( const char* comment, bool eol_comment )
     {
         CV_Assert(write_mode);
+        startDelayedStruct();
         emitter->writeComment( comment, eol_comment );
     }
 
     void startNextStream()
     {
         CV_Assert(write_mode);
+        startDelayedStruct();
         if( !empty_stream )
         {
             while( !write_stack.empty() )
@@ -1034,18 +1282,21 @@ public:
     void write( const String& key, int value )
     {
         CV_Assert(write_mode);
+        startDelayedStruct();
         emitter->write(key.c_str(), value);
     }
 
     void write( const String& key, double value )
     {
         CV_Assert(write_mode);
+        startDelayedStruct();
         emitter->write(key.c_str(), value);
     }
 
     void write( const String& key, const String& value )
     {
         CV_Assert(write_mode);
+        startDelayedStruct();
         emitter->write(key.c_str(), value.c_str(), false);
     }
 
@@ -1053,6 +1304,31 @@ public:
     {
         CV_Assert(write_mode);
 
+        if( fmt == FileStorage::FORMAT_BINARY )
+        {
+            if( len > 0 )
+            {
+                CV_Assert( _data != 0 && len % fs::calcStructSize(dt.c_str(), 0) == 0 );
+                emitter->writeRawData(dt.c_str(), _data, len);
+            }
+            return;
+        }
+
+        if( base64state != BASE64_NONE )
+        {
+            if( len == 0 )
+                return;
+            if( dt.size() <= (size_t)base64::HEADER_SIZE && (base64state == BASE64_DELAYED || dt == base64dt) )
+            {
+                CV_Assert( _data != 0 );
+                base64dt = dt;
+                base64state = BASE64_DATA;
+                appendBase64Data(dt.c_str(), (const uchar*)_data, len);
+                return;
+            }
+            startDelayedStruct();
+        }
+
         size_t elemSize = fs::calcStructSize(dt.c_str(), 0);
         CV_Assert( len % elemSize == 0 );
         len /= elemSize;
@@ -1138,9 +1414,127 @@ public:
         }
     }
 
-    void writeRawDataBase64(const void* /*data*/, int /*len*/, const char* /*dt*/ )
+    // emits the flow sequence delayed in the Base64 mode; the raw data collected so far is written as text
+    void startDelayedStruct()
+    {
+        if( base64state == BASE64_NONE )
+            return;
+        FStructData s = write_stack.back();
+        write_stack.pop_back();
+        base64state = BASE64_NONE;
+        startWriteStruct(s.tag.empty() ? 0 : s.tag.c_str(), s.flags, 0, false);
+        if( !base64data.empty() )
+        {
+            std::vector<uchar> data;
+            std::swap(data, base64data);
+            // the collected data is packed, so it is written element by element
+            int fmt_pairs[CV_FS_MAX_FMT_PAIRS*2];
+            int fmt_pair_count = fs::decodeFormat( base64dt.c_str(), fmt_pairs, CV_FS_MAX_FMT_PAIRS );
+            std::vector<uchar> elem(fs::calcStructSize(base64dt.c_str(), 0));
+            for( size_t ofs = 0; ofs < data.size(); )
+            {
+                for( int k = 0, offset = 0; k < fmt_pair_count; k++ )
+                {
+                    int elem_size = CV_ELEM_SIZE(fmt_pairs[k*2+1]);
+                    offset = cvAlign( offset, elem_size );
+                    for( int i = 0; i < fmt_pairs[k*2]; i++, offset += elem_size, ofs += elem_size )
+                        copyLittleEndian(&elem[offset], &data[ofs], elem_size);
+                }
+                writeRawData(base64dt, &elem[0], elem.size());
+            }
+        }
+    }
+
+    // copies a scalar converting it between the native and the little-endian byte order
+    static void copyLittleEndian(uchar* dst, const uchar* src, int size)
+    {
+        const int one = 1;
+        if( *(const uchar*)&one == 1 )
+            memcpy(dst, src, size);
+        else
+            std::reverse_copy(src, src + size, dst);
+    }
+
+    // appends the elements to the Base64 data in the packed little-endian layout that the parsers read
+    void appendBase64Data(const char* dt, const uchar* data, size_t len)
+    {
+        int fmt_pairs[CV_FS_MAX_FMT_PAIRS*2];
+        int fmt_pair_count = fs::decodeFormat( dt, fmt_pairs, CV_FS_MAX_FMT_PAIRS );
+        size_t elemSize = fs::calcStructSize(dt, 0);
+        CV_Assert( len % elemSize == 0 );
+
+        const int one = 1;
+        if( fmt_pair_count == 1 && *(const uchar*)&one == 1 )
+        {
+            base64data.insert(base64data.end(), data, data + len);
+            return;
+        }
+
+        for( const uchar* data_end = data + len; data < data_end; data += elemSize )
+        {
+            for( int k = 0, offset = 0; k < fmt_pair_count; k++ )
+            {
+                int elem_size = CV_ELEM_SIZE(fmt_pairs[k*2+1]);
+                offset = cvAlign( offset, elem_size );
+                for( int i = 0; i < fmt_pairs[k*2]; i++, offset += elem_size )
+                {
+                    size_t pos = base64data.size();
+                    base64data.resize(pos + elem_size);
+                    copyLittleEndian(&base64data[pos], data + offset, elem_size);
+                }
+            }
+        }
+    }
+
+    // writes the collected raw data with the header as a Base64 node: "!!binary |" block in YAML,
+    // type_id="binary" element in XML, "$base64$..." string in JSON
+    void writeBase64Node(const char* key)
     {
+        static const char tab[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::vector<uchar> data;
+        std::swap(data, base64data);
+        data.insert(data.begin(), base64::HEADER_SIZE, (uchar)' ');
+        memcpy(&data[0], base64dt.c_str(), base64dt.size());
+
+        std::string text;
+        text.reserve((data.size() + 2)/3*4 + 10);
+        if( fmt == FileStorage::FORMAT_JSON )
+            text = "\"$base64$";
+        for( size_t i = 0; i < data.size(); i += 3 )
+        {
+            unsigned v = (unsigned)data[i] << 16;
+            if( i + 1 < data.size() )
+                v |= (unsigned)data[i+1] << 8;
+            if( i + 2 < data.size() )
+                v |= data[i+2];
+            text += tab[(v >> 18) & 63];
+            text += tab[(v >> 12) & 63];
+            text += i + 1 < data.size() ? tab[(v >> 6) & 63] : '=';
+            text += i + 2 < data.size() ? tab[v & 63] : '=';
+        }
 
+        if( fmt == FileStorage::FORMAT_JSON )
+        {
+            // the JSON parser reads the Base64 string from a single line
+            text += '\"';
+            emitter->writeScalar(key, text.c_str());
+            write_stack.back().flags &= ~FileNode::EMPTY;
+            return;
+        }
+
+        const size_t rowLen = 76;
+        startWriteStruct(key, FileNode::SEQ, "binary");
+        for( size_t i = 0; i < text.size(); i += rowLen )
+        {
+            int n = (int)std::min(rowLen, text.size() - i);
+            char* ptr = resizeWriteBuffer(flush(), n);
+            memcpy(ptr, &text[i], n);
+            setBufferPtr(ptr + n);
+        }
+        // the XML parser takes the rest of the line as Base64, so the closing tag goes to the next one
+        flush();
+        write_stack.back().flags &= ~FileNode::EMPTY;
+        endWriteStruct();
     }
 
     String releaseAndGetString();
@@ -1280,6 +1674,7 @@ public:
                 CV_Error_(Error::StsError, ("The node of type %d cannot be converted to collection", node_type));
         }
 
+        std::pair<size_t, size_t> pos0(node.blockIdx, node.ofs);
         ptr = reserveNodeSpace(node, 1 + (named ? 4 : 0) + 4 + 4);
         *ptr++ = (uchar)(type | (named ? FileNode::NAMED : 0));
         // name has been copied automatically
@@ -1289,6 +1684,16 @@ public:
         writeInt(ptr, 4);
         writeInt(ptr + 4, 0);
 
+        // the matrix map or its "data" node may move to another block when it is converted from the empty node
+        std::pair<size_t, size_t> pos(node.blockIdx, node.ofs);
+        if( pos != pos0 )
+        {
+            if( matrixNodes.erase(pos0) )
+                matrixNodes.insert(pos);
+            if( matrixDataNodes.erase(pos0) )
+                matrixDataNodes.insert(pos);
+        }
+
         if( add_first_scalar )
             addNode(node, std::string(), node_type,
                     node_type == FileNode::INT ? (const void*)&ival :
@@ -1388,6 +1793,8 @@ public:
         FileStorage_API* fs = this;
         bool noname = key.empty() || (fmt == FileStorage::FORMAT_XML && strcmp(key.c_str(), "_") == 0);
         convertToCollection( noname ? FileNode::SEQ : FileNode::MAP, collection );
+        bool matrix = !matrixNodes.empty() &&
+                      matrixNodes.count(std::make_pair(collection.blockIdx, collection.ofs)) != 0;
 
         bool isseq = collection.empty() ? false : collection.isSeq();
         if( noname != isseq )
@@ -1440,9 +1847,19 @@ public:
         int nelems = readInt(cp + 5);
         writeInt(cp + 5, nelems + 1);
 
+        if( matrix && key == "data" )
+            matrixDataNodes.insert(std::make_pair(node.blockIdx, node.ofs));
         return node;
     }
 
+    void setTypeName( FileNode& node, const std::string& type_name )
+    {
+        // only the matrix data is left in the mapped file with FileStorage::DEFER_MAT_DATA
+        if( (flags & FileStorage::DEFER_MAT_DATA) && mapped_data &&
+            (type_name == "opencv-matrix" || type_name == "opencv-nd-matrix") )
+            matrixNodes.insert(std::make_pair(node.blockIdx, node.ofs));
+    }
+
     void finalizeCollection( FileNode& collection )
     {
         if( !collection.isSeq() && !collection.isMap() )
@@ -1621,6 +2038,21 @@ public:
             return fval;
         }
 
+        // decodes the rest of the stream without storing it, returns the number of the bytes
+        size_t skip()
+        {
+            size_t total = 0;
+            for(;;)
+            {
+                total += decoded.size() - ofs;
+                ofs = decoded.size();
+                if( eos )
+                    break;
+                readMore(1);
+            }
+            return total;
+        }
+
         bool endOfStream() const { return eos; }
         char* getPtr() const { return ptr; }
     protected:
@@ -1639,6 +2071,9 @@ public:
     {
         const int BASE64_HDR_SIZE = 24;
         char dt[BASE64_HDR_SIZE+1] = {0};
+        bool deferred = mapped_data && strbuf == mapped_data &&
+                        matrixDataNodes.count(std::make_pair(collection.blockIdx, collection.ofs)) != 0;
+        size_t begin = deferred ? inputPos(ptr) : 0;
         base64decoder.init(parser, ptr, indent);
 
         int i, k;
@@ -1652,6 +2087,22 @@ public:
 
         CV_Assert( !base64decoder.endOfStream() );
 
+        // the matrix data of the mapped file is only located here, FileNode >> Mat decodes it
+        // straight from the file into the destination, and the element nodes are not created
+        if( deferred )
+        {
+            DeferredData data;
+            data.begin = begin;
+            data.dt = dt;
+            data.size = base64decoder.skip();
+            ptr = base64decoder.getPtr();
+            data.end = inputPos(ptr);
+            convertToCollection(FileNode::SEQ, collection);
+            finalizeCollection(collection);
+            deferredData[std::make_pair(collection.blockIdx, collection.ofs)] = data;
+            return ptr;
+        }
+
         int fmt_pairs[CV_FS_MAX_FMT_PAIRS*2];
         int fmt_pair_count = fs::decodeFormat( dt, fmt_pairs, CV_FS_MAX_FMT_PAIRS );
         int ival = 0;
@@ -1718,6 +2169,68 @@ public:
         return base64decoder.getPtr();
     }
 
+    bool deferRawData( FileNode& collection, const std::string& dt, size_t ofs, size_t len )
+    {
+        std::pair<size_t, size_t> pos(collection.blockIdx, collection.ofs);
+        if( !mapped_data || strbuf != mapped_data || !matrixDataNodes.count(pos) )
+            return false;
+        CV_Assert( ofs <= mapped_size && len <= mapped_size - ofs );
+        DeferredData& data = deferredData[pos];
+        if( data.rawBlocks.empty() )
+        {
+            data.begin = data.end = data.size = 0;
+            data.dt = dt;
+        }
+        else if( data.dt != dt )
+        {
+            FileStorage_API* fs = this;
+            CV_PARSE_ERROR_CPP( "The matrix data blocks have different formats" );
+        }
+        data.rawBlocks.push_back(std::make_pair(ofs, len));
+        data.size += len;
+        return true;
+    }
+
+    // position of the pointer to the current line in the input string
+    size_t inputPos(const char* ptr) const
+    {
+        CV_Assert( ptr >= bufferStart() && ptr <= bufferEnd() );
+        return strbuflinepos + (size_t)(ptr - bufferStart());
+    }
+
+    bool readDeferredMatData(const FileNode& node, Mat& m) const
+    {
+        std::map<std::pair<size_t, size_t>, DeferredData>::const_iterator it =
+            deferredData.find(std::make_pair(node.blockIdx, node.ofs));
+        if( it == deferredData.end() )
+            return false;
+        const DeferredData& data = it->second;
+        CV_Assert( mapped_data && data.begin <= data.end && data.end <= mapped_size );
+
+        int fmt_pairs[CV_FS_MAX_FMT_PAIRS*2];
+        int fmt_pair_count = fs::decodeFormat( data.dt.c_str(), fmt_pairs, CV_FS_MAX_FMT_PAIRS );
+        bool match = fmt_pair_count > 0 && data.size == m.total()*m.elemSize();
+        for( int k = 0; k < fmt_pair_count; k++ )
+            match = match && CV_MAT_DEPTH(fmt_pairs[k*2+1]) == m.depth();
+        if( !match )
+            CV_Error( Error::StsUnmatchedSizes, "The matrix data does not match the matrix header" );
+        if( m.total() == 0 )
+            return true;
+
+        if( !data.rawBlocks.empty() )
+        {
+            RawBlockReader reader(mapped_data, data.rawBlocks);
+            readMatPlanes(reader, m);
+            return true;
+        }
+
+        Base64TextReader reader(mapped_data + data.begin, mapped_data + data.end);
+        uchar header[base64::HEADER_SIZE];
+        reader.read(header, sizeof(header));
+        readMatPlanes(reader, m);
+        return true;
+    }
+
     void parseError( const char* func_name, const std::string& err_msg, const char* source_file, int source_line )
     {
         std::string msg = format("%s(%d): %s", filename.c_str(), lineno, err_msg.c_str());
@@ -1780,6 +2293,28 @@ public:
     char* strbuf;
     size_t strbufsize;
     size_t strbufpos;
+    size_t strbuflinepos;
+    char* mapped_data;
+    size_t mapped_size;
+
+    // Base64 or binary matrix data left in the mapped file, the key is the position of the "data" node
+    struct DeferredData
+    {
+        size_t begin, end; // the encoded text, including the header
+        size_t size; // number of the decoded bytes without the header
+        std::string dt;
+        std::vector<std::pair<size_t, size_t> > rawBlocks; // offsets and sizes of the binary storage data
+    };
+    std::map<std::pair<size_t, size_t>, DeferredData> deferredData;
+    // positions of the matrix maps and of their "data" nodes that are parsed with FileStorage::DEFER_MAT_DATA
+    std::set<std::pair<size_t, size_t> > matrixNodes, matrixDataNodes;
+
+    // writing in the Base64 mode: a flow sequence is delayed until its content is known,
+    // then the raw data written into it is collected and emitted as a single Base64 node
+    enum { BASE64_NONE, BASE64_DELAYED, BASE64_DATA };
+    int base64state;
+    std::string base64dt;
+    std::vector<uchar> base64data;
     int lineno;
 };
 
@@ -2469,6 +3004,11 @@ FileNodeIterator& FileNodeIterator::operator += (int _ofs)
     return *this;
 }
 
+bool fs::readDeferredMatData(const FileNode& node, Mat& m)
+{
+    return node.fs && node.fs->readDeferredMatData(node, m);
+}
+
 FileNodeIterator& FileNodeIterator::readRaw( const String& fmt, void* _data0, size_t maxsz)
 {
     if( fs && idx < nodeNElems )
@@ -94,6 +94,8 @@ int calcElemSize( const char* dt, int initial_size );
 char* encodeFormat( int elem_type, char* dt );
 int decodeFormat( const char* dt, int* fmt_pairs, int max_len );
 int decodeSimpleFormat( const char* dt );
+// decodes the matrix data left in the input (FileStorage::DEFER_MAT_DATA), false for the regular nodes
+bool readDeferredMatData( const FileNode& node, Mat& m );
 }
 
 
@@ -137,6 +139,7 @@ public:
     virtual FileStorage* getFS() = 0;
 
     virtual void puts( const char* str ) = 0;
+    virtual void putBytes( const void* data, size_t len ) = 0;
     virtual char* gets() = 0;
     virtual bool eof() = 0;
     virtual void setEof() = 0;
@@ -157,9 +160,15 @@ public:
     virtual FileNode addNode( FileNode& collection, const std::string& key,
                                int type, const void* value=0, int len=-1 ) = 0;
     virtual void finalizeCollection( FileNode& collection ) = 0;
+    // the type name of the parsed node (e.g. type_id="opencv-matrix" in XML) that is not stored in the node tree
+    virtual void setTypeName( FileNode& node, const std::string& type_name ) = 0;
     virtual double strtod(char* ptr, char** endptr) = 0;
 
     virtual char* parseBase64(char* ptr, int indent, FileNode& collection) = 0;
+    // leaves the raw matrix data of the binary storage at the given offset in the mapped file
+    // (FileStorage::DEFER_MAT_DATA), false if the elements of the collection should be parsed
+    virtual bool deferRawData( FileNode& collection, const std::string& dt, size_t ofs, size_t len ) = 0;
+    virtual const char* getInputData(size_t& size) const = 0;
     CV_NORETURN
     virtual void parseError(const char* funcname, const std::string& msg,
                             const char* filename, int lineno) = 0;
@@ -179,6 +188,10 @@ public:
     virtual void writeScalar(const char* key, const char* value) = 0;
     virtual void writeComment(const char* comment, bool eol_comment) = 0;
     virtual void startNextStream() = 0;
+    virtual void writeRawData(const char* /*dt*/, const void* /*data*/, size_t /*len*/)
+    {
+        CV_Error(Error::StsNotImplemented, "Raw data is written by FileStorage for the text formats");
+    }
 };
 
 class FileStorageParser
@@ -197,6 +210,10 @@ Ptr<FileStorageParser> createXMLParser(FileStorage_API* fs);
 Ptr<FileStorageParser> createYAMLParser(FileStorage_API* fs);
 Ptr<FileStorageParser> createJSONParser(FileStorage_API* fs);
 
+Ptr<FileStorageEmitter> createBinaryEmitter(FileStorage_API* fs);
+Ptr<FileStorageParser> createBinaryParser(FileStorage_API* fs);
+bool isBinaryStorageSignature(const char* buf);
+
 }
 
 #endif // SRC_PERSISTENCE_HPP
@@ -0,0 +1,424 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#include "precomp.hpp"
+#include "persistence.hpp"
+
+/*
+Binary file storage layout. All the numbers are little-endian.
+
+    header:  "%OPENCV-BINARY:1.0\n" padded with zeros to CV_FS_BIN_HEADER_SIZE bytes
+    record:  <tag:u8> [<key>] <payload>
+    key:     <len:u32> <chars>, present for the elements of maps only
+    string:  <len:u32> <chars>
+
+    tag  payload
+    'i'  <value:i32>
+    'r'  <value:f64>
+    's'  <string>
+    '['  sequence, the elements follow until ']'
+    '{'  map: <type_name:string>, the elements follow until '}'
+    'd'  raw data (element of a sequence): <dt:string> <size:u64> <zero padding> <size bytes>
+    '-'  beginning of the next stream
+
+The top-level elements of each stream form the implicit map, as in the other formats.
+The raw data bytes start at the offset from the beginning of the file that is a multiple of
+CV_FS_BIN_ALIGN and have the layout of the C structure described by dt, including the padding
+between the fields, so they can be copied to the destination as is.
+*/
+
+namespace cv
+{
+
+enum
+{
+    CV_FS_BIN_HEADER_SIZE = 32,
+    CV_FS_BIN_ALIGN = 16,
+    CV_FS_BIN_MAX_DEPTH = 1024
+};
+
+static const char binarySignature[] = "%OPENCV-BINARY:1.0\n";
+static const size_t binarySignatureIdLen = 14; // "%OPENCV-BINARY"
+
+static inline bool isLittleEndian()
+{
+    const int one = 1;
+    return *(const uchar*)&one == 1;
+}
+
+class BinaryEmitter : public FileStorageEmitter
+{
+public:
+    BinaryEmitter(FileStorage_API* _fs) : fs(_fs), offset(0)
+    {
+        uchar header[CV_FS_BIN_HEADER_SIZE] = {0};
+        memcpy(header, binarySignature, sizeof(binarySignature) - 1);
+        putBytes(header, sizeof(header));
+    }
+    virtual ~BinaryEmitter() {}
+
+    FStructData startWriteStruct( const FStructData& parent, const char* key,
+                                  int struct_flags, const char* type_name=0 )
+    {
+        struct_flags = (struct_flags & (FileNode::TYPE_MASK|FileNode::FLOW)) | FileNode::EMPTY;
+        if( !FileNode::isCollection(struct_flags))
+            CV_Error( CV_StsBadArg,
+                     "Some collection type - FileNode::SEQ or FileNode::MAP, must be specified" );
+
+        putTag(FileNode::isMap(struct_flags) ? '{' : '[', parent, key);
+        if( FileNode::isMap(struct_flags) )
+            putString(type_name);
+        return FStructData("", struct_flags, 0);
+    }
+
+    void endWriteStruct(const FStructData& current_struct)
+    {
+        CV_Assert( FileNode::isCollection(current_struct.flags) );
+        uchar c = FileNode::isMap(current_struct.flags) ? '}' : ']';
+        putBytes(&c, 1);
+    }
+
+    void write(const char* key, int value)
+    {
+        putTag('i', fs->getCurrentStruct(), key);
+        putInt(value);
+    }
+
+    void write( const char* key, double value )
+    {
+        putTag('r', fs->getCurrentStruct(), key);
+        Cv64suf v;
+        v.f = value;
+        putInt((int)v.u);
+        putInt((int)(v.u >> 32));
+    }
+
+    void write(const char* key, const char* str, bool /*quote*/)
+    {
+        putTag('s', fs->getCurrentStruct(), key);
+        putString(str);
+    }
+
+    void writeScalar(const char* key, const char* data)
+    {
+        write(key, data, false);
+    }
+
+    void writeRawData(const char* dt, const void* data, size_t len)
+    {
+        putTag('d', fs->getCurrentStruct(), 0);
+        putString(dt);
+        putInt((int)(uint64)len);
+        putInt((int)((uint64)len >> 32));
+
+        static const uchar zeros[CV_FS_BIN_ALIGN] = {0};
+        putBytes(zeros, alignSize(offset, CV_FS_BIN_ALIGN) - offset);
+
+        if( isLittleEndian() )
+        {
+            putBytes(data, len);
+            return;
+        }
+
+        // the fields are swapped in place, the padding between them is zeroed,
+        // so exactly len bytes are written, as the reader expects
+        int fmt_pairs[CV_FS_MAX_FMT_PAIRS*2];
+        int fmt_pair_count = fs::decodeFormat( dt, fmt_pairs, CV_FS_MAX_FMT_PAIRS );
+        size_t elemSize = fs::calcStructSize(dt, 0);
+        const uchar* data0 = (const uchar*)data;
+        AutoBuffer<uchar> buf(elemSize);
+        for( size_t ofs0 = 0; ofs0 < len; ofs0 += elemSize )
+        {
+            memset(buf.data(), 0, elemSize);
+            size_t ofs = 0;
+            for( int k = 0; k < fmt_pair_count; k++ )
+            {
+                int count = fmt_pairs[k*2], esz = CV_ELEM_SIZE(fmt_pairs[k*2+1]);
+                ofs = alignSize(ofs, esz);
+                for( int i = 0; i < count; i++, ofs += esz )
+                    for( int j = 0; j < esz; j++ )
+                        buf[ofs + j] = data0[ofs0 + ofs + esz - 1 - j];
+            }
+            putBytes(buf.data(), elemSize);
+        }
+    }
+
+    void writeComment(const char* /*comment*/, bool /*eol_comment*/)
+    {
+        // comments are not stored
+    }
+
+    void startNextStream()
+    {
+        uchar c = '-';
+        putBytes(&c, 1);
+    }
+
+protected:
+    void putBytes(const void* data, size_t len)
+    {
+        fs->putBytes(data, len);
+        offset += len;
+    }
+
+    void putInt(int value)
+    {
+        uchar buf[4] = { (uchar)value, (uchar)(value >> 8), (uchar)(value >> 16), (uchar)(value >> 24) };
+        putBytes(buf, 4);
+    }
+
+    void putString(const char* str)
+    {
+        size_t len = str ? strlen(str) : 0;
+        putInt((int)len);
+        putBytes(str, len);
+    }
+
+    void putTag(char tag, const FStructData& parent, const char* key)
+    {
+        uchar c = (uchar)tag;
+        putBytes(&c, 1);
+        // the top level of the stream is the implicit map
+        if( !FileNode::isSeq(parent.flags) )
+        {
+            if( !key || !*key )
+                CV_Error( CV_StsBadArg, "Map element should have a name" );
+            putString(key);
+        }
+    }
+
+    FileStorage_API* fs;
+    size_t offset; // number of the bytes written so far, to align the raw data
+};
+
+class BinaryParser : public FileStorageParser
+{
+public:
+    BinaryParser(FileStorage_API* _fs) : fs(_fs), ptr(0), end(0), start(0)
+    {
+    }
+
+    virtual ~BinaryParser() {}
+
+    bool getBase64Row(char* /*ptr*/, int /*indent*/, char* &/*beg*/, char* &/*end*/)
+    {
+        return false;
+    }
+
+    bool parse( char* )
+    {
+        size_t size = 0;
+        start = (const uchar*)fs->getInputData(size);
+        if( !start || size < CV_FS_BIN_HEADER_SIZE ||
+            memcmp(start, binarySignature, sizeof(binarySignature) - 1) != 0 )
+            CV_PARSE_ERROR_CPP( "Invalid binary storage header" );
+        ptr = start + CV_FS_BIN_HEADER_SIZE;
+        end = start + size;
+
+        FileNode root_collection(fs->getFS(), 0, 0);
+        for(;;)
+        {
+            FileNode root_node = fs->addNode(root_collection, std::string(), FileNode::MAP);
+            fs->convertToCollection(FileNode::MAP, root_node);
+            bool nextStream = parseElements(root_node, true, 0);
+            fs->finalizeCollection(root_node);
+            if( !nextStream )
+                break;
+        }
+        return true;
+    }
+
+protected:
+    // returns true if the elements are terminated by the beginning of the next stream
+    bool parseElements( FileNode& collection, bool isMap, int depth )
+    {
+        if( depth > CV_FS_BIN_MAX_DEPTH )
+            CV_PARSE_ERROR_CPP( "Too deep nesting" );
+        for(;;)
+        {
+            if( ptr >= end )
+            {
+                if( depth > 0 )
+                    CV_PARSE_ERROR_CPP( "Unexpected end of the file" );
+                return false;
+            }
+            uchar tag = *ptr++;
+            if( tag == '-' )
+            {
+                if( depth > 0 )
+                    CV_PARSE_ERROR_CPP( "Unexpected beginning of the next stream" );
+                return true;
+            }
+            if( tag == (isMap ? '}' : ']') && depth > 0 )
+                return false;
+
+            if( tag == 'd' )
+            {
+                if( isMap )
+                    CV_PARSE_ERROR_CPP( "Raw data is only allowed in sequences" );
+                parseRawData(collection);
+                continue;
+            }
+
+            std::string key;
+            if( isMap )
+                key = getString();
+            int ival;
+            double fval;
+            switch( tag )
+            {
+            case 'i':
+                ival = getInt();
+                fs->addNode(collection, key, FileNode::INT, &ival, -1);
+                break;
+            case 'r':
+                {
+                Cv64suf v;
+                v.u = (unsigned)getInt();
+                v.u |= (uint64)(unsigned)getInt() << 32;
+                fval = v.f;
+                fs->addNode(collection, key, FileNode::REAL, &fval, -1);
+                }
+                break;
+            case 's':
+                {
+                std::string str = getString();
+                fs->addNode(collection, key, FileNode::STRING, str.c_str(), (int)str.size());
+                }
+                break;
+            case '[':
+            case '{':
+                {
+                FileNode child = fs->addNode(collection, key, FileNode::NONE);
+                if( tag == '{' )
+                    fs->setTypeName(child, getString());
+                fs->convertToCollection(tag == '{' ? FileNode::MAP : FileNode::SEQ, child);
+                parseElements(child, tag == '{', depth + 1);
+                fs->finalizeCollection(child);
+                }
+                break;
+            default:
+                CV_PARSE_ERROR_CPP( "Unknown record type" );
+            }
+        }
+    }
+
+    void parseRawData( FileNode& collection )
+    {
+        std::string dt = getString();
+        uint64 len = (unsigned)getInt();
+        len |= (uint64)(unsigned)getInt() << 32;
+        size_t pos = alignSize((size_t)(ptr - start), CV_FS_BIN_ALIGN);
+        if( pos > (size_t)(end - start) || len > (uint64)(end - start - pos) )
+            CV_PARSE_ERROR_CPP( "Unexpected end of the file" );
+        ptr = start + pos;
+
+        int fmt_pairs[CV_FS_MAX_FMT_PAIRS*2];
+        int fmt_pair_count = fs::decodeFormat( dt.c_str(), fmt_pairs, CV_FS_MAX_FMT_PAIRS );
+        size_t elemSize = fs::calcStructSize(dt.c_str(), 0);
+        if( fmt_pair_count <= 0 || elemSize == 0 || len % elemSize != 0 )
+            CV_PARSE_ERROR_CPP( "Invalid raw data format" );
+
+        const uchar* data0 = ptr;
+        ptr += len;
+        // the matrix data of the mapped file is only located, FileNode >> Mat copies it to the destination
+        if( fs->deferRawData(collection, dt, pos, (size_t)len) )
+            return;
+        for( ; data0 < ptr; data0 += elemSize )
+        {
+            size_t ofs = 0;
+            for( int k = 0; k < fmt_pair_count; k++ )
+            {
+                int count = fmt_pairs[k*2], elem_type = fmt_pairs[k*2+1];
+                int esz = CV_ELEM_SIZE(elem_type);
+                ofs = alignSize(ofs, esz);
+                for( int i = 0; i < count; i++, ofs += esz )
+                {
+                    const uchar* p = data0 + ofs;
+                    int ival = 0;
+                    double fval = 0;
+                    int node_type = FileNode::INT;
+                    switch( elem_type )
+                    {
+                    case CV_8U: ival = p[0]; break;
+                    case CV_8S: ival = (schar)p[0]; break;
+                    case CV_16U: ival = (ushort)(p[0] | (p[1] << 8)); break;
+                    case CV_16S: ival = (short)(p[0] | (p[1] << 8)); break;
+                    case CV_32S: ival = readInt32(p); break;
+                    case CV_32F:
+                        {
+                        Cv32suf v;
+                        v.i = readInt32(p);
+                        fval = v.f;
+                        node_type = FileNode::REAL;
+                        }
+                        break;
+                    case CV_64F:
+                        {
+                        Cv64suf v;
+                        v.u = (unsigned)readInt32(p) | ((uint64)(unsigned)readInt32(p + 4) << 32);
+                        fval = v.f;
+                        node_type = FileNode::REAL;
+                        }
+                        break;
+                    case CV_16F:
+                        fval = (float)float16_t::fromBits((ushort)(p[0] | (p[1] << 8)));
+                        node_type = FileNode::REAL;
+                        break;
+                    default:
+                        CV_Error( Error::StsUnsupportedFormat, "Unsupported type" );
+                    }
+                    fs->addNode(collection, std::string(), node_type,
+                                node_type == FileNode::INT ? (void*)&ival : (void*)&fval, -1);
+                }
+            }
+        }
+    }
+
+    static int readInt32(const uchar* p)
+    {
+        return (int)(p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned)p[3] << 24));
+    }
+
+    int getInt()
+    {
+        if( end - ptr < 4 )
+            CV_PARSE_ERROR_CPP( "Unexpected end of the file" );
+        int val = readInt32(ptr);
+        ptr += 4;
+        return val;
+    }
+
+    std::string getString()
+    {
+        size_t len = (unsigned)getInt();
+        if( len > (size_t)(end - ptr) )
+            CV_PARSE_ERROR_CPP( "Unexpected end of the file" );
+        std::string str((const char*)ptr, len);
+        ptr += len;
+        return str;
+    }
+
+    FileStorage_API* fs;
+    const uchar* ptr;
+    const uchar* end;
+    const uchar* start;
+};
+
+Ptr<FileStorageEmitter> createBinaryEmitter(FileStorage_API* fs)
+{
+    return makePtr<BinaryEmitter>(fs);
+}
+
+Ptr<FileStorageParser> createBinaryParser(FileStorage_API* fs)
+{
+    return makePtr<BinaryParser>(fs);
+}
+
+bool isBinaryStorageSignature(const char* buf)
+{
+    return strncmp(buf, binarySignature, binarySignatureIdLen) == 0;
+}
+
+}
@@ -712,6 +712,10 @@ public:
                     ptr = parseMap( ptr, child );
                 else
                     ptr = parseValue( ptr, child );
+
+                // the writer puts the type name of the map into its first element
+                if( child.isString() && child.name() == "type_id" )
+                    fs->setTypeName(node, child.string());
             }
 
             ptr = skipSpaces( ptr );
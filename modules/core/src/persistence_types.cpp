@@ -150,10 +150,24 @@ void read(const FileNode& node, Mat& m, const Mat& default_mat)
     FileNode data_node = node["data"];
     CV_Assert(!data_node.empty());
 
+    if( fs::readDeferredMatData(data_node, m) )
+        return;
+
     size_t nelems = data_node.size();
     CV_Assert(nelems == m.total()*m.channels());
 
-    data_node.readRaw(dt, (uchar*)m.ptr(), m.total()*m.elemSize());
+    if( m.isContinuous() )
+        data_node.readRaw(dt, (uchar*)m.ptr(), m.total()*m.elemSize());
+    else
+    {
+        // the destination can be a submatrix of the user-provided buffer, read it plane by plane
+        const Mat* arrays[] = { &m, 0 };
+        uchar* ptrs[1] = {};
+        NAryMatIterator it(arrays, ptrs);
+        FileNodeIterator data_it = data_node.begin();
+        for( size_t i = 0; i < it.nplanes; i++, ++it )
+            data_it.readRaw(dt, ptrs[0], it.size*m.elemSize());
+    }
 }
 
 void read( const FileNode& node, SparseMat& m, const SparseMat& default_mat )
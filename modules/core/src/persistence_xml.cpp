@@ -504,6 +504,8 @@ public:
                 }
 
                 new_elem = fs->addNode(node, key, elem_type, 0);
+                if( !type_name.empty() && !binary_string )
+                    fs->setTypeName(new_elem, type_name);
                 if (!binary_string)
                     ptr = parseValue(ptr, new_elem);
                 else
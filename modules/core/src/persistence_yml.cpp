@@ -479,6 +479,8 @@ public:
                 CV_PARSE_ERROR_CPP( "Empty type name" );
             d = *endptr;
             *endptr = '\0';
+            if( is_user )
+                fs->setTypeName(node, std::string(ptr, (size_t)len));
 
             if( len == 3 && !is_user )
             {
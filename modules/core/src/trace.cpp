@@ -11,6 +11,7 @@
 #include <opencv2/core/opencl/ocl_defs.hpp>
 
 #include <cstdarg> // va_start
+#include <csignal>
 
 #include <sstream>
 #include <ostream>
@@ -89,6 +90,21 @@ static const cv::String& getParameterTraceLocation()
     return param_traceLocation;
 }
 
+// In-memory ring buffer sink (Chrome trace event format export), the parameters are stored in TraceManager
+// TraceManager may be created during static initialization, so these are not plain static variables
+static int getParameterDumpSignal()
+{
+    static int param_dumpSignal = (int)utils::getConfigurationParameterSizeT("OPENCV_TRACE_DUMP_SIGNAL", 0);
+    return param_dumpSignal;
+}
+static bool getParameterDumpAtExit()
+{
+    static bool param_dumpAtExit = utils::getConfigurationParameterBool("OPENCV_TRACE_DUMP_AT_EXIT", false);
+    return param_dumpAtExit;
+}
+
+static void checkDumpRequest();
+
 #ifdef HAVE_OPENCL
 static bool param_synchronizeOpenCL = utils::getConfigurationParameterBool("OPENCV_TRACE_SYNC_OPENCL", false);
 #endif
@@ -383,6 +399,12 @@ void Region::Impl::leaveRegion(TraceManagerThreadLocal& ctx)
         msg.formatRegionLeave(region, result);
         s->put(msg);
     }
+    if (ctx.ringBuffer.enabled())
+    {
+        if (ctx.ringBufferSkipDepth < 0 && duration >= getTraceManager().ringBufferMinDuration)
+            ctx.ringBuffer.put(&location, beginTimestamp, duration);
+        checkDumpRequest();
+    }
 
     if (location.flags & REGION_FLAG_FUNCTION)
     {
@@ -581,6 +603,19 @@ Region::Region(const LocationStaticStorage& location) :
         }
     }
 
+    const unsigned samplingInterval = getTraceManager().samplingInterval;
+    if (samplingInterval > 1 && ctx.ringBufferSkipDepth < 0 &&
+        (location.flags & REGION_FLAG_APP_CODE) == 0 && ctx.regionDepthOpenCV == 0)
+    {
+        // sampling is applied to the calls from application code into OpenCV and only to the ring buffer sink.
+        // Nested regions, including parallel_for_ bodies on the other threads, follow the decision for the outermost call
+        if ((ctx.sampleCounter++ % samplingInterval) != 0)
+        {
+            CV_LOG(_spaces(ctx.getCurrentDepth()*4) << "OpenCV call is not sampled");
+            ctx.ringBufferSkipDepth = currentDepth;
+        }
+    }
+
     new Impl(ctx, parentRegion, *this, location, beginTimestamp);
     CV_DbgAssert(pImpl != NULL);
     implFlags |= REGION_FLAG__ACTIVE;
@@ -712,6 +747,8 @@ void Region::destroy()
         CV_DbgAssert(ctx.stackTopRegion() == this);
         ctx.stackPop();
         ctx.stat_status.checkResetSkipMode(currentDepth);
+        if (ctx.ringBufferSkipDepth == currentDepth)
+            ctx.ringBufferSkipDepth = -1;
         DEBUG_ONLY(implFlags &= ~REGION_FLAG__NEED_STACK_POP);
     }
     CV_LOG_CTX_STAT(NULL, _spaces(currentDepth*4) << "===> " << ctx.stat << ' ' << ctx.stat_status);
@@ -748,6 +785,127 @@ void TraceManagerThreadLocal::dumpStack(std::ostream& out, bool onlyFunctions) c
     out << ss.str();
 }
 
+TraceRingBuffer::TraceRingBuffer() :
+    head(0)
+{
+    reset(getTraceManager().ringBufferSize);
+}
+
+void TraceRingBuffer::reset(size_t size)
+{
+    events.assign(size, Event());
+    head.store(0, std::memory_order_release);
+}
+
+void TraceRingBuffer::snapshot(std::vector<Event>& dst) const
+{
+    dst.clear();
+    if (events.empty())
+        return;
+    const uint64 size = events.size();
+    const uint64 h0 = head.load(std::memory_order_acquire);
+    const uint64 first = h0 > size ? h0 - size : 0;
+    dst.reserve((size_t)(h0 - first));
+    for (uint64 i = first; i < h0; i++)
+        dst.push_back(events[(size_t)(i % size)]);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // drop the events which could be overwritten by the writer during copying
+    const uint64 h1 = head.load(std::memory_order_relaxed);
+    const uint64 valid = h1 >= size ? h1 - size + 1 : 0;
+    if (valid > first)
+        dst.erase(dst.begin(), dst.begin() + (size_t)std::min(valid - first, (uint64)dst.size()));
+}
+
+static void writeJSONString(std::ostream& out, const char* str)
+{
+    out << '"';
+    for (const char* p = str ? str : ""; *p; p++)
+    {
+        const unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\')
+            out << '\\' << (char)c;
+        else if (c < 0x20)
+            out << cv::format("\\u%04x", c);
+        else
+            out << (char)c;
+    }
+    out << '"';
+}
+
+static bool writeChromeTrace(const std::string& filename)
+{
+    if (getTraceManager().ringBufferSize == 0)
+        return false;
+
+    std::vector<TraceManagerThreadLocal*> threads_ctx;
+    getTraceManager().tls.gather(threads_ctx);
+
+    std::ofstream out(filename.c_str(), std::ios::trunc);
+    if (!out.is_open())
+    {
+        CV_LOG_WARNING(NULL, "Trace: can't open file for writing: " << filename);
+        return false;
+    }
+    out << "{\"traceEvents\":[" << std::endl;
+    bool first = true;
+    size_t totalEvents = 0;
+    std::vector<TraceRingBuffer::Event> events;
+    for (size_t i = 0; i < threads_ctx.size(); i++)
+    {
+        const TraceManagerThreadLocal* ctx = threads_ctx[i];
+        if (!ctx)
+            continue;
+        ctx->ringBuffer.snapshot(events);
+        if (events.empty())
+            continue;
+        out << (first ? "" : ",\n")
+            << cv::format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"OpenCV thread %d\"}}",
+                          ctx->threadID, ctx->threadID);
+        first = false;
+        for (size_t j = 0; j < events.size(); j++)
+        {
+            const TraceRingBuffer::Event& e = events[j];
+            out << ",\n{\"name\":";
+            writeJSONString(out, e.location->name);
+            out << ",\"cat\":\"" << ((e.location->flags & REGION_FLAG_APP_CODE) ? "app" : "opencv") << "\""
+                << cv::format(",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%d,\"args\":{\"file\":",
+                              e.beginTimestamp * 1e-3, e.duration * 1e-3, ctx->threadID);
+            writeJSONString(out, e.location->filename);
+            out << ",\"line\":" << e.location->line << "}}";
+        }
+        totalEvents += events.size();
+    }
+    out << std::endl << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+    CV_LOG_INFO(NULL, "Trace: " << totalEvents << " events are written to " << filename);
+    return !out.fail();
+}
+
+// Signal handler only raises the flag, the dump itself is done by the next region leave.
+// The handler installed by the application before is called after that.
+static volatile sig_atomic_t g_dumpRequested = 0;
+static void (*g_prevDumpSignalHandler)(int) = SIG_DFL;
+
+static void dumpSignalHandler(int signum)
+{
+    g_dumpRequested = 1;
+    void (*prev)(int) = g_prevDumpSignalHandler;
+    if (prev != SIG_DFL && prev != SIG_IGN && prev != SIG_ERR)
+        prev(signum);
+}
+
+static void checkDumpRequest()
+{
+    if (g_dumpRequested)
+    {
+        static std::atomic<bool> dumpInProgress(false);
+        if (dumpInProgress.exchange(true))
+            return;
+        g_dumpRequested = 0;
+        writeChromeTrace(getTraceManager().chromeTraceLocation);
+        dumpInProgress = false;
+    }
+}
+
 class AsyncTraceStorage CV_FINAL : public TraceStorage
 {
     mutable std::ofstream out;
@@ -855,6 +1013,19 @@ TraceManager::TraceManager()
     if (activated)
         trace_storage.reset(new SyncTraceStorage(std::string(getParameterTraceLocation()) + ".txt"));
 
+    // the parameters are read here, not in the function-local statics: the destructor needs them,
+    // and this global object may be destroyed after such statics
+    ringBufferSize = utils::getConfigurationParameterSizeT("OPENCV_TRACE_RING_BUFFER", 0);
+    samplingInterval = (unsigned)utils::getConfigurationParameterSizeT("OPENCV_TRACE_SAMPLING", 1);
+    ringBufferMinDuration = (int64)utils::getConfigurationParameterSizeT("OPENCV_TRACE_RING_MIN_DURATION_US", 0) * 1000;
+    chromeTraceLocation = utils::getConfigurationParameterString("OPENCV_TRACE_CHROME_LOCATION", "OpenCVTrace.json");
+    if (ringBufferSize > 0)
+    {
+        activated = true; // in-memory sink only, text storage is controlled by OPENCV_TRACE
+        if (getParameterDumpSignal() > 0)
+            g_prevDumpSignalHandler = signal(getParameterDumpSignal(), dumpSignalHandler);
+    }
+
 #ifdef OPENCV_WITH_ITT
     if (isITTEnabled())
     {
@@ -894,6 +1065,8 @@ TraceManager::~TraceManager()
     {
         CV_LOG_WARNING(NULL, "Trace: Total skipped events: " << totalSkippedEvents);
     }
+    if (getParameterDumpAtExit())
+        writeChromeTrace(chromeTraceLocation);
 
     // This is a global static object, so process starts shutdown here
     // Turn off trace
@@ -959,6 +1132,7 @@ void parallelForSetRootRegion(const Region& rootRegion, const TraceManagerThread
     ctx.parallel_for_stack_size = 0;
 
     ctx.stat_status.propagateFrom(root_ctx.stat_status);
+    ctx.ringBufferSkipDepth = root_ctx.ringBufferSkipDepth >= 0 ? 0 : -1;
 }
 
 void parallelForAttachNestedRegion(const Region& rootRegion)
@@ -1140,6 +1314,39 @@ void traceArg(const TraceArg& arg, double value)
 #endif
 }
 
+} // namespace details
+
+bool dumpChromeTrace(const char* filename)
+{
+    return details::writeChromeTrace(filename ? std::string(filename) : details::getTraceManager().chromeTraceLocation);
+}
+
+void setChromeTraceParameters(size_t ringBufferSize, unsigned samplingInterval, int64 minDurationUs)
+{
+    details::TraceManager& manager = details::getTraceManager();
+    manager.ringBufferSize = ringBufferSize;
+    manager.samplingInterval = std::max(samplingInterval, 1u);
+    manager.ringBufferMinDuration = minDurationUs * 1000;
+
+    std::vector<details::TraceManagerThreadLocal*> threads_ctx;
+    manager.tls.gather(threads_ctx);
+    for (size_t i = 0; i < threads_ctx.size(); i++)
+    {
+        if (!threads_ctx[i])
+            continue;
+        threads_ctx[i]->ringBuffer.reset(ringBufferSize);
+        threads_ctx[i]->sampleCounter = 0;
+    }
+
+    details::activated = ringBufferSize > 0 || !manager.trace_storage.empty();
+#ifdef OPENCV_WITH_ITT
+    if (details::isITTEnabled())
+        details::activated = true;
+#endif
+}
+
+namespace details {
+
 #else
 
 Region::Region(const LocationStaticStorage&) : pImpl(NULL), implFlags(0) {}
@@ -1150,6 +1357,13 @@ void traceArg(const TraceArg&, int) {};
 void traceArg(const TraceArg&, int64) {};
 void traceArg(const TraceArg&, double) {};
 
+} // namespace details
+
+bool dumpChromeTrace(const char*) { return false; }
+void setChromeTraceParameters(size_t, unsigned, int64) {}
+
+namespace details {
+
 #endif
 
 }}}} // namespace
@@ -757,27 +757,27 @@ TEST(Core_InputOutput, filestorage_base64_basic_read_JSON)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".json", false);
 }
-TEST(Core_InputOutput, DISABLED_filestorage_base64_basic_rw_XML)
+TEST(Core_InputOutput, filestorage_base64_basic_rw_XML)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".xml", true);
 }
-TEST(Core_InputOutput, DISABLED_filestorage_base64_basic_rw_YAML)
+TEST(Core_InputOutput, filestorage_base64_basic_rw_YAML)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".yml", true);
 }
-TEST(Core_InputOutput, DISABLED_filestorage_base64_basic_rw_JSON)
+TEST(Core_InputOutput, filestorage_base64_basic_rw_JSON)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".json", true);
 }
-TEST(Core_InputOutput, DISABLED_filestorage_base64_basic_memory_XML)
+TEST(Core_InputOutput, filestorage_base64_basic_memory_XML)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".xml", true, true);
 }
-TEST(Core_InputOutput, DISABLED_filestorage_base64_basic_memory_YAML)
+TEST(Core_InputOutput, filestorage_base64_basic_memory_YAML)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".yml", true, true);
 }
-TEST(Core_InputOutput, DISABLED_filestorage_base64_basic_memory_JSON)
+TEST(Core_InputOutput, filestorage_base64_basic_memory_JSON)
 {
     test_filestorage_basic(cv::FileStorage::WRITE_BASE64, ".json", true, true);
 }
@@ -1811,4 +1811,211 @@ TEST(Core_InputOutput, FileStorage_copy_constructor_17412_heap)
     EXPECT_EQ(0, remove(fname.c_str()));
 }
 
+TEST(Core_InputOutput, FileStorage_read_into_submatrix)
+{
+    const char* suffixes[] = { ".yml", ".xml", ".json" };
+    for (size_t i = 0; i < sizeof(suffixes)/sizeof(suffixes[0]); i++)
+    {
+        for (int base64 = 0; base64 < 2; base64++)
+        {
+            SCOPED_TRACE(cv::format("%s base64=%d", suffixes[i], base64));
+            std::string fname = tempfile(suffixes[i]);
+            Mat src(37, 41, CV_32FC3);
+            randu(src, -100, 100);
+            {
+                FileStorage fs(fname, FileStorage::WRITE + (base64 ? FileStorage::BASE64 : 0));
+                fs << "m" << src;
+            }
+
+            // the matrix is read straight into the user buffer, including non-continuous ROI
+            Mat buf(50, 60, CV_32FC3, Scalar::all(1000)), roi = buf(Rect(5, 7, 41, 37));
+            uchar* data = roi.data;
+            {
+                FileStorage fs(fname, FileStorage::READ);
+                fs["m"] >> roi;
+            }
+            EXPECT_EQ(data, roi.data);
+            EXPECT_EQ(0, cvtest::norm(src, roi, NORM_INF));
+            Mat mask(buf.size(), CV_8U, Scalar::all(255));
+            mask(Rect(5, 7, 41, 37)).setTo(Scalar::all(0));
+            EXPECT_EQ(1000, cvtest::norm(buf, NORM_INF, mask));
+            EXPECT_EQ(0, remove(fname.c_str()));
+        }
+    }
+}
+
+TEST(Core_InputOutput, FileStorage_defer_mat_data)
+{
+    Mat src(37, 41, CV_16SC3), small(1, 5, CV_8UC1);
+    randu(src, -1000, 1000);
+    randu(small, 0, 256);
+    std::vector<int> ivec;
+    for (int i = 0; i < 20; i++)
+        ivec.push_back(i*i - 100);
+    const char* suffixes[] = { ".yml", ".xml", ".json" };
+    for (size_t i = 0; i < sizeof(suffixes)/sizeof(suffixes[0]); i++)
+    {
+        for (int base64 = 0; base64 < 2; base64++)
+        {
+            SCOPED_TRACE(cv::format("%s base64=%d", suffixes[i], base64));
+            std::string fname = tempfile(suffixes[i]);
+            {
+                FileStorage fs(fname, FileStorage::WRITE + (base64 ? FileStorage::BASE64 : 0));
+                fs << "m" << src << "small" << small << "value" << 7;
+                // a user map with the "data" element is not a matrix, its data is always parsed
+                fs << "user" << "{" << "data" << ivec << "}";
+            }
+            {
+                std::ifstream f(fname.c_str());
+                std::string text((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+                EXPECT_EQ(base64 != 0, text.find(i == 2 ? "$base64$" : "binary") != std::string::npos);
+            }
+            Mat buf(50, 60, CV_16SC3, Scalar::all(1000)), roi = buf(Rect(5, 7, 41, 37)), small2;
+            uchar* data = roi.data;
+            {
+                FileStorage fs(fname, FileStorage::READ + FileStorage::DEFER_MAT_DATA);
+                ASSERT_TRUE(fs.isOpened());
+                // the element nodes are not created for the Base64 data
+                EXPECT_EQ(base64 ? 0u : src.total()*src.channels(), fs["m"]["data"].size());
+                EXPECT_EQ(7, (int)fs["value"]);
+                std::vector<int> ivec2;
+                fs["user"]["data"] >> ivec2;
+                EXPECT_EQ(ivec, ivec2);
+                fs["m"] >> roi;
+                fs["small"] >> small2;
+                Mat again;
+                fs["m"] >> again;
+                EXPECT_EQ(0, cvtest::norm(src, again, NORM_INF));
+            }
+            EXPECT_EQ(data, roi.data);
+            EXPECT_EQ(0, cvtest::norm(src, roi, NORM_INF));
+            Mat mask(buf.size(), CV_8U, Scalar::all(255));
+            mask(Rect(5, 7, 41, 37)).setTo(Scalar::all(0));
+            EXPECT_EQ(1000, cvtest::norm(buf, NORM_INF, mask));
+            EXPECT_EQ(0, cvtest::norm(small, small2, NORM_INF));
+
+            // without the flag the same file is parsed into the nodes
+            {
+                FileStorage fs(fname, FileStorage::READ);
+                EXPECT_EQ(src.total()*src.channels(), fs["m"]["data"].size());
+                Mat m;
+                fs["m"] >> m;
+                EXPECT_EQ(0, cvtest::norm(src, m, NORM_INF));
+            }
+            EXPECT_EQ(0, remove(fname.c_str()));
+        }
+    }
+}
+
+TEST(Core_InputOutput, FileStorage_binary)
+{
+    std::string fname = tempfile(".cvbin");
+    Mat m8u(13, 17, CV_8UC3), m32f(5, 7, CV_32FC2), m64f(3, 1, CV_64F);
+    randu(m8u, 0, 256);
+    randu(m32f, -1e3, 1e3);
+    randu(m64f, -1e10, 1e10);
+    int sizes[] = { 3, 4, 5 };
+    Mat mnd(3, sizes, CV_16SC1);
+    randu(mnd, -30000, 30000);
+    std::vector<int> ivec;
+    for (int i = 0; i < 100; i++)
+        ivec.push_back(i*i - 50);
+    // the structure with the padding after the first field
+    struct { uchar u; double d; } elems[3] = { { 1, 0.5 }, { 2, -1e100 }, { 255, 3.25 } };
+    {
+        FileStorage fs(fname, FileStorage::WRITE);
+        ASSERT_EQ(FileStorage::FORMAT_BINARY, fs.getFormat());
+        fs << "int" << -123456789;
+        fs << "real" << 0.1;
+        fs << "string" << "some text: with \"quotes\" and ]brackets[";
+        fs << "empty_string" << "";
+        fs << "m8u" << m8u << "m32f" << m32f << "m64f" << m64f << "mnd" << mnd;
+        fs << "ivec" << ivec;
+        fs << "elems" << "[:";
+        fs.writeRaw("ud", elems, sizeof(elems));
+        fs << "]";
+        fs << "nested" << "{" << "seq" << "[" << 1 << 2.5 << "three" << "{:" << "a" << 4 << "}" << "]";
+        fs << "empty_map" << "{" << "}" << "}";
+        fs.writeComment("comments are skipped");
+    }
+    {
+        std::ifstream f(fname.c_str(), std::ios::binary);
+        char header[5] = {};
+        f.read(header, 4);
+        EXPECT_EQ(std::string("%OPE"), std::string(header));
+        // the raw data is aligned in the file
+        std::string content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        size_t pos = content.find(std::string((const char*)mnd.data, mnd.total()*mnd.elemSize()));
+        ASSERT_NE(std::string::npos, pos);
+        EXPECT_EQ(0u, (pos + 4) % 16);
+    }
+
+    FileStorage fs(fname, FileStorage::READ);
+    ASSERT_TRUE(fs.isOpened());
+    EXPECT_EQ(FileStorage::FORMAT_BINARY, fs.getFormat());
+    EXPECT_EQ(-123456789, (int)fs["int"]);
+    EXPECT_EQ(0.1, (double)fs["real"]);
+    EXPECT_EQ("some text: with \"quotes\" and ]brackets[", (std::string)fs["string"]);
+    EXPECT_TRUE(fs["empty_string"].isString());
+    EXPECT_EQ("", (std::string)fs["empty_string"]);
+
+    Mat r8u, r32f, r64f, rnd;
+    std::vector<int> rvec;
+    fs["m8u"] >> r8u;
+    fs["m32f"] >> r32f;
+    fs["m64f"] >> r64f;
+    fs["mnd"] >> rnd;
+    fs["ivec"] >> rvec;
+    EXPECT_EQ(0, cvtest::norm(m8u, r8u, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(m32f, r32f, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(m64f, r64f, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(mnd, rnd, NORM_INF));
+    EXPECT_EQ(ivec, rvec);
+
+    FileNode elems_node = fs["elems"];
+    ASSERT_EQ(6u, elems_node.size());
+    struct { uchar u; double d; } relems[3];
+    elems_node.readRaw("ud", relems, sizeof(relems));
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(elems[i].u, relems[i].u);
+        EXPECT_EQ(elems[i].d, relems[i].d);
+    }
+
+    FileNode seq = fs["nested"]["seq"];
+    ASSERT_TRUE(seq.isSeq());
+    ASSERT_EQ(4u, seq.size());
+    EXPECT_EQ(1, (int)seq[0]);
+    EXPECT_EQ(2.5, (double)seq[1]);
+    EXPECT_EQ("three", (std::string)seq[2]);
+    EXPECT_EQ(4, (int)seq[3]["a"]);
+    EXPECT_TRUE(fs["nested"]["empty_map"].isMap());
+    EXPECT_EQ(0u, fs["nested"]["empty_map"].size());
+    fs.release();
+
+    // the matrix data is copied straight from the mapped file
+    {
+        FileStorage dfs(fname, FileStorage::READ + FileStorage::DEFER_MAT_DATA);
+        ASSERT_TRUE(dfs.isOpened());
+        EXPECT_EQ(0u, dfs["m8u"]["data"].size());
+        Mat buf(20, 20, CV_8UC3, Scalar::all(7)), roi = buf(Rect(2, 3, 17, 13));
+        uchar* data = roi.data;
+        dfs["m8u"] >> roi;
+        dfs["mnd"] >> rnd;
+        dfs["ivec"] >> rvec;
+        EXPECT_EQ(data, roi.data);
+        EXPECT_EQ(0, cvtest::norm(m8u, roi, NORM_INF));
+        EXPECT_EQ(0, cvtest::norm(mnd, rnd, NORM_INF));
+        EXPECT_EQ(ivec, rvec);
+        Mat mask(buf.size(), CV_8U, Scalar::all(255));
+        mask(Rect(2, 3, 17, 13)).setTo(Scalar::all(0));
+        EXPECT_EQ(7, cvtest::norm(buf, NORM_INF, mask));
+        EXPECT_EQ(6u, dfs["elems"].size());
+    }
+
+    EXPECT_THROW(FileStorage(fname + ".gz", FileStorage::WRITE + FileStorage::FORMAT_BINARY), cv::Exception);
+    EXPECT_THROW(FileStorage(fname, FileStorage::WRITE + FileStorage::MEMORY), cv::Exception);
+    EXPECT_EQ(0, remove(fname.c_str()));
+}
+
 }} // namespace
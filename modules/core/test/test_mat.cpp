@@ -474,6 +474,120 @@ TEST(Core_PCA, accuracy)
     EXPECT_LE(err, 0) << "bad accuracy of write/load functions (YML)";
 }
 
+static Mat makeLowRankSamples(int nsamples, int len, int rank, RNG& rng)
+{
+    Mat coeffs(nsamples, rank, CV_32F), basis(rank, len, CV_32F), noise(nsamples, len, CV_32F), offset(1, len, CV_32F);
+    rng.fill(coeffs, RNG::NORMAL, Scalar::all(0), Scalar::all(1));
+    rng.fill(basis, RNG::UNIFORM, Scalar::all(-1), Scalar::all(1));
+    rng.fill(noise, RNG::NORMAL, Scalar::all(0), Scalar::all(0.01));
+    rng.fill(offset, RNG::UNIFORM, Scalar::all(-5), Scalar::all(5));
+    for( int i = 0; i < rank; i++ )
+        coeffs.col(i) *= (float)(rank - i);
+    Mat data = coeffs*basis + noise;
+    for( int i = 0; i < nsamples; i++ )
+        data.row(i) += offset;
+    return data;
+}
+
+static void checkPCAModels(const PCA& ref, const PCA& pca, int ncomponents, int nvectors, double evalEps, double evecEps)
+{
+    ASSERT_EQ(ncomponents, pca.eigenvectors.rows);
+    ASSERT_EQ(ncomponents, (int)pca.eigenvalues.total());
+    EXPECT_LE(cvtest::norm(ref.mean, pca.mean, NORM_L2 | NORM_RELATIVE), 1e-4);
+    EXPECT_LE(cvtest::norm(ref.eigenvalues.rowRange(0, ncomponents), pca.eigenvalues, NORM_L2 | NORM_RELATIVE), evalEps);
+    for( int i = 0; i < nvectors; i++ )
+    {
+        // both directions v and -v are valid
+        double d = std::abs(ref.eigenvectors.row(i).dot(pca.eigenvectors.row(i)));
+        EXPECT_GE(d, 1 - evecEps) << "component " << i;
+    }
+}
+
+TEST(Core_PCA, randomized)
+{
+    const int nsamples = 3000, len = 80, rank = 6;
+    RNG rng(12345);
+    Mat data = makeLowRankSamples(nsamples, len, rank, rng);
+
+    PCA ref(data, noArray(), PCA::DATA_AS_ROW, rank);
+    PCA rpca(data, noArray(), PCA::DATA_AS_ROW | PCA::RANDOMIZED, rank);
+    checkPCAModels(ref, rpca, rank, rank, 1e-4, 1e-4);
+
+    PCA cpca(data.t(), noArray(), PCA::DATA_AS_COL | PCA::RANDOMIZED, rank);
+    ASSERT_EQ(Size(1, len), cpca.mean.size());
+    EXPECT_LE(cvtest::norm(ref.mean, cpca.mean.t(), NORM_L2 | NORM_RELATIVE), 1e-4);
+    EXPECT_LE(cvtest::norm(ref.eigenvalues, cpca.eigenvalues, NORM_L2 | NORM_RELATIVE), 1e-4);
+
+    Mat prj = rpca.project(data.rowRange(0, 10)), refPrj = ref.project(data.rowRange(0, 10));
+    EXPECT_LE(cvtest::norm(cv::abs(prj), cv::abs(refPrj), NORM_L2 | NORM_RELATIVE), 1e-3);
+
+    EXPECT_ANY_THROW(PCA(data, noArray(), PCA::DATA_AS_ROW | PCA::RANDOMIZED, 0));
+}
+
+TEST(Core_PCA, incremental)
+{
+    const int nsamples = 2000, len = 40, rank = 5, nbatches = 4;
+    RNG rng(54321);
+    Mat data = makeLowRankSamples(nsamples, len, rank, rng);
+
+    PCA ref(data, noArray(), PCA::DATA_AS_ROW);
+    PCA ipca, ipcaTrunc;
+    int64 n = 0, nTrunc = 0;
+    for( int i = 0; i < nbatches; i++ )
+    {
+        Mat batch = data.rowRange(nsamples*i/nbatches, nsamples*(i + 1)/nbatches);
+        ipca.update(batch, n, PCA::DATA_AS_ROW);
+        ipcaTrunc.update(batch, nTrunc, PCA::DATA_AS_ROW, rank);
+    }
+    EXPECT_EQ(nsamples, (int)n);
+    checkPCAModels(ref, ipca, len, rank, 1e-4, 1e-3);
+    checkPCAModels(ref, ipcaTrunc, rank, rank, 1e-3, 1e-3);
+
+    // the update continues from the model computed in a single pass
+    PCA head(data.rowRange(0, nsamples/2), noArray(), PCA::DATA_AS_ROW);
+    int64 nhead = nsamples/2;
+    head.update(data.rowRange(nsamples/2, nsamples), nhead, PCA::DATA_AS_ROW);
+    EXPECT_EQ(nsamples, (int)nhead);
+    checkPCAModels(ref, head, len, rank, 1e-4, 1e-3);
+
+    // the number of samples must match the model
+    int64 nempty = 1;
+    EXPECT_THROW(PCA().update(data, nempty, PCA::DATA_AS_ROW), cv::Exception);
+}
+
+TEST(Core_PCA, incremental_update_of_stored_model)
+{
+    const int nsamples = 600, len = 12, rank = 3;
+    RNG rng(777);
+    Mat data = makeLowRankSamples(nsamples, len, rank, rng);
+    PCA ref(data, noArray(), PCA::DATA_AS_ROW);
+
+    // the model written by PCA::write, which has no number of samples in it
+    PCA head(data.rowRange(0, nsamples/3), noArray(), PCA::DATA_AS_ROW);
+    std::string content;
+    {
+        FileStorage fs("pca.yml", FileStorage::WRITE | FileStorage::MEMORY);
+        head.write(fs);
+        content = fs.releaseAndGetString();
+    }
+    ASSERT_EQ(std::string::npos, content.find("samples"));
+
+    PCA loaded;
+    {
+        FileStorage fs(content, FileStorage::READ | FileStorage::MEMORY);
+        loaded.read(fs.root());
+    }
+    int64 unknown = 0;
+    EXPECT_THROW(loaded.update(data.rowRange(nsamples/3, nsamples), unknown, PCA::DATA_AS_ROW), cv::Exception);
+    EXPECT_EQ(0, (int)unknown);
+    EXPECT_EQ(0, cvtest::norm(head.eigenvectors, loaded.eigenvectors, NORM_INF));
+
+    int64 n = nsamples/3;
+    loaded.update(data.rowRange(nsamples/3, nsamples), n, PCA::DATA_AS_ROW);
+    EXPECT_EQ(nsamples, (int)n);
+    checkPCAModels(ref, loaded, len, rank, 1e-4, 1e-3);
+}
+
 class Core_ArrayOpTest : public cvtest::BaseTest
 {
 public:
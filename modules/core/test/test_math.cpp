@@ -2977,6 +2977,82 @@ TEST(Core_KMeans, bad_input)
     }
 }
 
+static void generateBlobs(RNG& rng, int N, int K, int dims, Mat& data)
+{
+    Mat means(K, dims, CV_32F);
+    rng.fill(means, RNG::UNIFORM, -100, 100);
+    data.create(N, dims, CV_32F);
+    rng.fill(data, RNG::NORMAL, 0, 1);
+    for (int i = 0; i < N; i++)
+        data.row(i) += means.row(i % K);
+}
+
+TEST(Core_KMeans, accelerated_assignment)
+{
+    RNG& rng = cvtest::TS::ptr()->get_rng();
+    const int N = 2000, K = 16, dims = 8;
+    Mat data;
+    generateBlobs(rng, N, K, dims, data);
+    Mat initial_labels(N, 1, CV_32S);
+    rng.fill(initial_labels, RNG::UNIFORM, 0, K);
+
+    const TermCriteria crit(TermCriteria::MAX_ITER + TermCriteria::EPS, 30, 0);
+    Mat labels0 = initial_labels.clone(), labels1 = initial_labels.clone(), centers0, centers1;
+    double compactness0 = kmeans(data, K, labels0, crit, 1, KMEANS_USE_INITIAL_LABELS, centers0);
+    double compactness1 = kmeans(data, K, labels1, crit, 1, KMEANS_USE_INITIAL_LABELS | KMEANS_ACCELERATED, centers1);
+
+    EXPECT_NEAR(compactness0, compactness1, compactness0 * 1e-5);
+    EXPECT_LE(cvtest::norm(labels0, labels1, NORM_L1), 0);
+    EXPECT_LE(cvtest::norm(centers0, centers1, NORM_INF), 1e-3);
+}
+
+TEST(Core_KMeans, parallel_centers)
+{
+    RNG& rng = cvtest::TS::ptr()->get_rng();
+    const int N = 3000, K = 10, dims = 4;
+    Mat data;
+    generateBlobs(rng, N, K, dims, data);
+
+    Mat labels, centers;
+    double compactness = kmeans(data, K, labels, TermCriteria(TermCriteria::MAX_ITER + TermCriteria::EPS, 30, 0),
+                                3, KMEANS_PARALLEL_CENTERS | KMEANS_ACCELERATED, centers);
+    ASSERT_EQ(K, centers.rows);
+    // every sample is within a few sigmas from the mean of its blob
+    EXPECT_LT(compactness, 2.0 * N * dims);
+
+    // duplicated samples shouldn't break the initialization
+    Mat dup(N, dims, CV_32F, Scalar::all(1));
+    dup.rowRange(0, 2).setTo(Scalar::all(5));
+    EXPECT_NO_THROW(kmeans(dup, 3, labels, TermCriteria(TermCriteria::COUNT, 5, 0), 1, KMEANS_PARALLEL_CENTERS, centers));
+    EXPECT_EQ(3, centers.rows);
+
+    data.at<float>(10, 1) = std::numeric_limits<float>::quiet_NaN();
+    EXPECT_ANY_THROW(kmeans(data, K, labels, TermCriteria(TermCriteria::COUNT, 5, 0), 1, KMEANS_PARALLEL_CENTERS, centers));
+}
+
+TEST(Core_KMeans, mini_batch)
+{
+    RNG& rng = cvtest::TS::ptr()->get_rng();
+    const int N = 5000, K = 8, dims = 6;
+    Mat data;
+    generateBlobs(rng, N, K, dims, data);
+
+    MiniBatchKMeans mbk(K, KMEANS_PARALLEL_CENTERS);
+    Mat labels;
+    double compactness = mbk.fit(data, 256, TermCriteria(TermCriteria::COUNT, 200, 0), labels);
+    ASSERT_EQ(K, mbk.centers.rows);
+    ASSERT_EQ(N, labels.rows);
+    EXPECT_LT(compactness, 2.0 * N * dims);
+    EXPECT_EQ(256 * 200, (int)cv::sum(mbk.counts)[0]);
+
+    // streaming updates
+    MiniBatchKMeans stream(K);
+    for (int i = 0; i < N; i += 500)
+        stream.partialFit(data.rowRange(i, i + 500));
+    EXPECT_EQ(N, (int)cv::sum(stream.counts)[0]);
+    EXPECT_LT(stream.predict(data, labels), 2.0 * N * dims);
+}
+
 TEST(CovariationMatrixVectorOfMat, accuracy)
 {
     unsigned int col_problem_size = 8, row_problem_size = 8, vector_size = 16;
@@ -4005,5 +4081,145 @@ TEST(Core_FastMath, InlineIsInf)
     EXPECT_EQ( cvIsInf(0.0), 0);
 }
 
+typedef testing::TestWithParam<tuple<int, int, int> > Core_SolveBatch;
+
+TEST_P(Core_SolveBatch, accuracy)
+{
+    const int depth = get<0>(GetParam()), n = get<1>(GetParam()), method = get<2>(GetParam());
+    const int N = 37, k = 2;  // the last group of matrices is incomplete
+    const double eps = depth == CV_32F ? 1e-3 : 1e-9;
+    RNG& rng = theRNG();
+
+    int asizes[] = { N, n, n }, bsizes[] = { N, n, k };
+    Mat A(3, asizes, depth), B(3, bsizes, depth);
+    for (int i = 0; i < N; i++)
+    {
+        Mat a(n, n, depth, A.ptr(i)), b(n, k, depth, B.ptr(i)), t(n, n, depth);
+        rng.fill(t, RNG::UNIFORM, -1, 1);
+        if (method == DECOMP_CHOLESKY)
+            mulTransposed(t, a, false);
+        else
+            t.copyTo(a);
+        a += Mat::eye(n, n, depth)*n;
+        rng.fill(b, RNG::UNIFORM, -1, 1);
+    }
+    // the singular matrix (and not positive-definite one)
+    const int bad = 33;
+    Mat(n, n, depth, A.ptr(bad)).setTo(Scalar::all(0));
+
+    // SVD and QR give the least-squares solution instead of the failure
+    const bool detectsSingular = method == DECOMP_LU || method == DECOMP_CHOLESKY;
+
+    Mat X, status, Ainv;
+    EXPECT_EQ(!detectsSingular, solveBatch(A, B, X, status, method));
+    ASSERT_EQ(3, X.dims);
+    ASSERT_EQ(N, X.size[0]); ASSERT_EQ(n, X.size[1]); ASSERT_EQ(k, X.size[2]);
+    ASSERT_EQ(Size(1, N), status.size());
+    if (method != DECOMP_QR)
+        invertBatch(A, Ainv, noArray(), method);
+    for (int i = 0; i < N; i++)
+    {
+        SCOPED_TRACE(cv::format("i=%d", i));
+        Mat a(n, n, depth, A.ptr(i)), b(n, k, depth, B.ptr(i));
+        Mat x(n, k, depth, X.ptr(i));
+        if (i == bad)
+        {
+            EXPECT_EQ(!detectsSingular, status.at<uchar>(i) != 0);
+            EXPECT_EQ(0, cvtest::norm(x, NORM_INF));
+            continue;
+        }
+        EXPECT_EQ(1, status.at<uchar>(i));
+        Mat x0;
+        ASSERT_TRUE(solve(a, b, x0, method));
+        EXPECT_LE(cvtest::norm(x, x0, NORM_INF), eps);
+        if (!Ainv.empty())
+        {
+            EXPECT_LE(cvtest::norm(a*Mat(n, n, depth, Ainv.ptr(i)), Mat::eye(n, n, depth), NORM_INF), eps);
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Core_SolveBatch, testing::Combine(
+    testing::Values(CV_32F, CV_64F),
+    testing::Values(3, 4, 6),
+    testing::Values((int)DECOMP_LU, (int)DECOMP_CHOLESKY, (int)DECOMP_QR, (int)DECOMP_SVD)
+));
+
+TEST(Core_SolveBatchMatx, accuracy)
+{
+    RNG& rng = theRNG();
+    std::vector<Matx33d> A(100);
+    std::vector<Matx31d> b(A.size());
+    for (size_t i = 0; i < A.size(); i++)
+    {
+        rng.fill(A[i], RNG::UNIFORM, -1, 1);
+        A[i] += Matx33d::eye()*3;
+        rng.fill(b[i], RNG::UNIFORM, -1, 1);
+    }
+    std::vector<Matx31d> x;
+    std::vector<Matx33d> Ainv;
+    std::vector<uchar> status;
+    ASSERT_TRUE(solveBatch(A, b, x, status));
+    ASSERT_EQ(A.size(), x.size());
+    ASSERT_EQ(A.size(), status.size());
+    ASSERT_TRUE(invertBatch(A, Ainv, status));
+    for (size_t i = 0; i < A.size(); i++)
+    {
+        EXPECT_LE(cvtest::norm(A[i]*x[i], Mat(b[i]), NORM_INF), 1e-12);
+        EXPECT_LE(cvtest::norm(A[i]*Ainv[i], Matx33d::eye(), NORM_INF), 1e-12);
+    }
+}
+
+TEST(Core_SVDecompBatch, accuracy)
+{
+    RNG& rng = theRNG();
+    const int N = 20, m = 6, n = 4;
+    int sizes[] = { N, m, n };
+    Mat A(3, sizes, CV_64F);
+    rng.fill(A, RNG::UNIFORM, -1, 1);
+
+    Mat W, U, Vt, Wfull, Ufull, Vtfull;
+    SVDecompBatch(A, W, U, Vt);
+    ASSERT_EQ(n, W.size[1]);
+    ASSERT_EQ(m, U.size[1]); ASSERT_EQ(n, U.size[2]);
+    ASSERT_EQ(n, Vt.size[1]); ASSERT_EQ(n, Vt.size[2]);
+    SVDecompBatch(A, Wfull, Ufull, Vtfull, SVD::FULL_UV);
+    ASSERT_EQ(m, Ufull.size[2]);
+    for (int i = 0; i < N; i++)
+    {
+        Mat a(m, n, CV_64F, A.ptr(i)), w(n, 1, CV_64F, W.ptr(i));
+        Mat u(m, n, CV_64F, U.ptr(i)), vt(n, n, CV_64F, Vt.ptr(i));
+        Mat w0, u0, vt0;
+        SVDecomp(a, w0, u0, vt0);
+        EXPECT_LE(cvtest::norm(w, w0, NORM_INF), 1e-12);
+        EXPECT_LE(cvtest::norm(u*Mat::diag(w)*vt, a, NORM_INF), 1e-12);
+        EXPECT_LE(cvtest::norm(Mat(m, m, CV_64F, Ufull.ptr(i)), SVD(a, SVD::FULL_UV).u, NORM_INF), 1e-12);
+    }
+}
+
+TEST(Core_EigenBatch, accuracy)
+{
+    RNG& rng = theRNG();
+    const int N = 20, n = 5;
+    int sizes[] = { N, n, n };
+    Mat A(3, sizes, CV_32F);
+    for (int i = 0; i < N; i++)
+    {
+        Mat a(n, n, CV_32F, A.ptr(i));
+        rng.fill(a, RNG::UNIFORM, -1, 1);
+        completeSymm(a);
+    }
+    Mat E, V;
+    ASSERT_TRUE(eigenBatch(A, E, V));
+    for (int i = 0; i < N; i++)
+    {
+        Mat a(n, n, CV_32F, A.ptr(i)), e(n, 1, CV_32F, E.ptr(i)), v(n, n, CV_32F, V.ptr(i));
+        Mat e0;
+        ASSERT_TRUE(eigen(a, e0));
+        EXPECT_LE(cvtest::norm(e, e0, NORM_INF), 1e-4);
+        EXPECT_LE(cvtest::norm(a*v.t(), v.t()*Mat::diag(e), NORM_INF), 1e-4);
+    }
+}
+
 }} // namespace
 /* End of file. */
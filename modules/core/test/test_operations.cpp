@@ -1493,6 +1493,107 @@ INSTANTIATE_TEST_CASE_P(Core, sortIdx, Combine(
         ::testing::Bool()
 ));
 
+INSTANTIATE_TEST_CASE_P(Core_Long, sortIdx, Combine(  // radix sort path
+        Values(CV_8U, CV_8S, CV_16S, CV_32S, CV_32F, CV_64F), // depth
+        Values(SORT_EVERY_COLUMN, SORT_EVERY_ROW),
+        Values(SORT_ASCENDING, SORT_DESCENDING),
+        Values(Size(700, 5), Size(5, 700)),
+        ::testing::Bool()
+));
+
+TEST(Core_sort, radix_long)
+{
+    RNG& rng = theRNG();
+    const int depths[] = { CV_8U, CV_16S, CV_32S, CV_32F, CV_64F };
+    for (size_t d = 0; d < sizeof(depths)/sizeof(depths[0]); d++)
+    {
+        SCOPED_TRACE(cv::format("depth=%d", depths[d]));
+        const int len = 300000;  // exceeds the size of the chunk sorted by a single thread
+        Mat src(1, len, CV_64F), src_d;
+        rng.fill(src, RNG::UNIFORM, -1e6, 1e6);
+        if (depths[d] == CV_32F || depths[d] == CV_64F)
+        {
+            src.at<double>(0, 1) = -0.0;
+            src.at<double>(0, 2) = 0.0;
+            src.at<double>(0, 3) = -std::numeric_limits<double>::infinity();
+            src.at<double>(0, 4) = std::numeric_limits<double>::infinity();
+        }
+        src.convertTo(src_d, depths[d]);
+
+        Mat dst, idx, expected, values;
+        cv::sort(src_d, dst, SORT_EVERY_ROW | SORT_ASCENDING);
+        src_d.copyTo(expected);
+        if (depths[d] == CV_8U)
+            std::sort(expected.ptr<uchar>(), expected.ptr<uchar>() + len);
+        else if (depths[d] == CV_16S)
+            std::sort(expected.ptr<short>(), expected.ptr<short>() + len);
+        else if (depths[d] == CV_32S)
+            std::sort(expected.ptr<int>(), expected.ptr<int>() + len);
+        else if (depths[d] == CV_32F)
+            std::sort(expected.ptr<float>(), expected.ptr<float>() + len);
+        else
+            std::sort(expected.ptr<double>(), expected.ptr<double>() + len);
+        EXPECT_EQ(0, cvtest::norm(dst, expected, NORM_INF));
+
+        cv::sortIdx(src_d, idx, SORT_EVERY_ROW | SORT_DESCENDING);
+        values.create(1, len, src_d.type());
+        for (int i = 0; i < len; i++)
+            memcpy(values.ptr(0, i), src_d.ptr(0, idx.at<int>(i)), src_d.elemSize());
+        flip(expected, expected, 1);
+        EXPECT_EQ(0, cvtest::norm(values, expected, NORM_INF));
+    }
+}
+
+TEST(Core_topK, accuracy)
+{
+    RNG& rng = theRNG();
+    for (int iter = 0; iter < 20; iter++)
+    {
+        int rows = rng.uniform(1, 40), cols = rng.uniform(1, 400);
+        int depth = iter % 2 == 0 ? CV_32F : CV_16S;
+        bool byRow = rng.uniform(0, 2) != 0, descending = rng.uniform(0, 2) != 0;
+        int flags = (byRow ? SORT_EVERY_ROW : SORT_EVERY_COLUMN) | (descending ? SORT_DESCENDING : SORT_ASCENDING);
+        int len = byRow ? cols : rows;
+        int k = rng.uniform(0, len + 1);
+        SCOPED_TRACE(cv::format("size=%dx%d depth=%d flags=%d k=%d", cols, rows, depth, flags, k));
+
+        Mat src(rows, cols, depth);
+        rng.fill(src, RNG::UNIFORM, -20, 20);  // many ties
+        Mat values, indices, sorted, sortedIdx;
+        cv::topK(src, k, values, indices, flags);
+        ASSERT_EQ(byRow ? Size(k, rows) : Size(cols, k), values.size());
+        ASSERT_EQ(values.size(), indices.size());
+        ASSERT_EQ(CV_32S, indices.type());
+        if (k == 0)
+            continue;
+
+        cv::sort(src, sorted, flags);
+        Mat sortedK = byRow ? sorted.colRange(0, k) : sorted.rowRange(0, k);
+        EXPECT_EQ(0, cvtest::norm(values, sortedK, NORM_INF));
+
+        Mat src_d, values_d;
+        src.convertTo(src_d, CV_64F);
+        values.convertTo(values_d, CV_64F);
+        for (int i = 0; i < (byRow ? rows : cols); i++)
+        {
+            for (int j = 0; j < k; j++)
+            {
+                int r = byRow ? i : j, c = byRow ? j : i;
+                int pos = indices.at<int>(r, c);
+                ASSERT_EQ(values_d.at<double>(r, c), byRow ? src_d.at<double>(i, pos) : src_d.at<double>(pos, i));
+                if (j > 0)
+                {
+                    int pr = byRow ? i : j - 1, pc = byRow ? j - 1 : i;
+                    if (values_d.at<double>(pr, pc) == values_d.at<double>(r, c))
+                    {
+                        ASSERT_LT(indices.at<int>(pr, pc), pos) << "ties are ordered by position";
+                    }
+                }
+            }
+        }
+    }
+}
+
 
 TEST(Core_sortIdx, regression_8941)
 {
@@ -0,0 +1,107 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+#include "test_precomp.hpp"
+#include <opencv2/core/utils/trace.hpp>
+
+namespace opencv_test { namespace {
+
+// restores the default (disabled) in-memory trace sink
+struct ChromeTraceGuard
+{
+    ~ChromeTraceGuard() { cv::utils::trace::setChromeTraceParameters(0); }
+};
+
+// returns the number of the complete events, checks the format of all the events
+static int readChromeTrace(const std::string& filename)
+{
+    FileStorage fs(filename, FileStorage::READ);
+    EXPECT_TRUE(fs.isOpened());
+    FileNode events = fs["traceEvents"];
+    EXPECT_TRUE(events.isSeq());
+    int count = 0;
+    for (FileNodeIterator it = events.begin(); it != events.end(); ++it)
+    {
+        FileNode e = *it;
+        std::string ph = (std::string)e["ph"];
+        if (ph == "M")
+        {
+            EXPECT_EQ("thread_name", (std::string)e["name"]);
+            continue;
+        }
+        EXPECT_EQ("X", ph);
+        EXPECT_FALSE(((std::string)e["name"]).empty());
+        EXPECT_EQ("opencv", (std::string)e["cat"]);
+        EXPECT_GE((double)e["ts"], 0.);
+        EXPECT_GE((double)e["dur"], 0.);
+        EXPECT_FALSE(((std::string)e["args"]["file"]).empty());
+        EXPECT_GT((int)e["args"]["line"], 0);
+        count++;
+    }
+    return count;
+}
+
+static void callOpenCV(const Mat& a, int n)
+{
+    Mat b;
+    for (int i = 0; i < n; i++)
+        cv::add(a, a, b);
+}
+
+TEST(Core_Trace, ring_buffer)
+{
+    ChromeTraceGuard guard;
+    const std::string filename = cv::tempfile(".json");
+    Mat a(8, 8, CV_8UC1, Scalar::all(1));
+
+    // the ring keeps the last events only, the oldest slot of the full ring
+    // is not reported as it can be overwritten while the snapshot is copied
+    cv::utils::trace::setChromeTraceParameters(4);
+    callOpenCV(a, 10);
+    if (!cv::utils::trace::dumpChromeTrace(filename.c_str()))
+        throw SkipTestException("OpenCV is built without the trace support");
+    EXPECT_EQ(3, readChromeTrace(filename));
+
+    cv::utils::trace::setChromeTraceParameters(100);
+    callOpenCV(a, 10);
+    ASSERT_TRUE(cv::utils::trace::dumpChromeTrace(filename.c_str()));
+    EXPECT_EQ(10, readChromeTrace(filename));
+
+    // the short regions are dropped
+    cv::utils::trace::setChromeTraceParameters(100, 1, 10000000);
+    callOpenCV(a, 10);
+    ASSERT_TRUE(cv::utils::trace::dumpChromeTrace(filename.c_str()));
+    EXPECT_EQ(0, readChromeTrace(filename));
+
+    cv::utils::trace::setChromeTraceParameters(0);
+    EXPECT_FALSE(cv::utils::trace::dumpChromeTrace(filename.c_str()));
+    remove(filename.c_str());
+}
+
+TEST(Core_Trace, sampling)
+{
+    ChromeTraceGuard guard;
+    const std::string filename = cv::tempfile(".json");
+    Mat a(8, 8, CV_8UC1, Scalar::all(1));
+
+    cv::utils::trace::setChromeTraceParameters(100, 3);
+    callOpenCV(a, 10);
+    if (!cv::utils::trace::dumpChromeTrace(filename.c_str()))
+        throw SkipTestException("OpenCV is built without the trace support");
+    // the 1st, 4th, 7th and 10th calls
+    EXPECT_EQ(4, readChromeTrace(filename));
+
+    // the parallel_for_ bodies on the other threads follow the decision for the call
+    int nthreads = cv::getNumThreads();
+    cv::setNumThreads(4);
+    Mat src(1024, 1024, CV_8UC1, Scalar::all(7)), lut(1, 256, CV_8UC1, Scalar::all(3)), dst;
+    cv::utils::trace::setChromeTraceParameters(1000, 2);
+    for (int i = 0; i < 4; i++)
+        cv::LUT(src, lut, dst);
+    cv::setNumThreads(nthreads);
+    ASSERT_TRUE(cv::utils::trace::dumpChromeTrace(filename.c_str()));
+    EXPECT_EQ(2, readChromeTrace(filename));
+    remove(filename.c_str());
+}
+
+}} // namespace
@@ -208,6 +208,13 @@ enum SpecialFilter {
     FILTER_SCHARR = -1
 };
 
+//! type of the pyramid built by cv::buildPyramid
+enum PyramidTypes {
+    PYRAMID_GAUSSIAN  = 0, //!< the levels are the smoothed and down-sized images, see #pyrDown
+    PYRAMID_LAPLACIAN = 1  //!< the levels are the differences between the Gaussian levels and the
+                           //!< up-sized next levels, see #pyrUp; the last level is the Gaussian one
+};
+
 //! type of morphological operation
 enum MorphTypes{
     MORPH_ERODE    = 0, //!< see #erode
@@ -1427,7 +1434,8 @@ In-place operation is supported.
 @note The median filter uses #BORDER_REPLICATE internally to cope with border pixels, see #BorderTypes
 
 @param src input 1-, 3-, or 4-channel image; when ksize is 3 or 5, the image depth should be
-CV_8U, CV_16U, or CV_32F, for larger aperture sizes, it can only be CV_8U.
+CV_8U, CV_16U, CV_16S or CV_32F, for larger aperture sizes, it can be CV_8U, CV_16U or CV_32F
+(ksize up to 127 for CV_32F).
 @param dst destination array of the same size and type as src.
 @param ksize aperture linear size; it must be odd and greater than 1, for example: 3, 5, 7 ...
 @sa  bilateralFilter, blur, boxFilter, GaussianBlur
@@ -1458,6 +1466,32 @@ CV_EXPORTS_W void GaussianBlur( InputArray src, OutputArray dst, Size ksize,
                                 double sigmaX, double sigmaY = 0,
                                 int borderType = BORDER_DEFAULT );
 
+/** @brief Blurs an image using the recursive approximation of the Gaussian filter.
+
+The function filters every row and then every column of the image by the pair of causal and
+anti-causal 3rd order IIR filters of Young and van Vliet, which approximate the Gaussian with the
+given standard deviation. Unlike #GaussianBlur, the cost per pixel does not depend on sigma, so the
+function is much faster for large sigmas (starting from about 5). In-place filtering is supported.
+
+The approximation is less accurate than the explicit kernel: for sigma >= 3 the maximum deviation
+from #GaussianBlur with a wide enough kernel is about 1-2% of the signal range near the sharp edges,
+and the mean deviation is below 0.5%; for sigma < 2 the deviation grows up to several percent, so
+#GaussianBlur should be preferred there. The computations are done in single precision floating
+point, or in double precision for CV_64F images and for sigmas larger than 32.
+
+@param src input image; the image can have any number of channels, which are processed
+independently, but the depth should be CV_8U, CV_16U, CV_16S, CV_32F or CV_64F.
+@param dst output image of the same size and type as src.
+@param sigmaX Gaussian standard deviation in X direction; it must be at least 0.5.
+@param sigmaY Gaussian standard deviation in Y direction; if sigmaY is zero, it is set to be equal
+to sigmaX.
+@param borderType pixel extrapolation method, see #BorderTypes. #BORDER_WRAP is not supported.
+
+@sa  GaussianBlur, blur, boxFilter
+ */
+CV_EXPORTS_W void recursiveGaussianBlur( InputArray src, OutputArray dst, double sigmaX,
+                                         double sigmaY = 0, int borderType = BORDER_DEFAULT );
+
 /** @brief Applies the bilateral filter to an image.
 
 The function applies bilateral filtering to the input image, as described in
@@ -1490,6 +1524,35 @@ CV_EXPORTS_W void bilateralFilter( InputArray src, OutputArray dst, int d,
                                    double sigmaColor, double sigmaSpace,
                                    int borderType = BORDER_DEFAULT );
 
+/** @brief Applies the fast approximation of the bilateral filter using the bilateral grid.
+
+The function accumulates the image in the coarse 3D grid, whose axes are the pixel coordinates
+downsampled by sigmaSpace and the guide image values downsampled by sigmaColor, blurs the grid and
+interpolates the result back at every pixel @cite Chen2007. Unlike #bilateralFilter, the cost per
+pixel does not depend on sigmaSpace, so the function is suitable for large neighborhoods, while the
+memory and the time spent on the grid are proportional to
+\f$\texttt{src.cols} \cdot \texttt{src.rows} \cdot \texttt{range} / (\texttt{sigmaSpace}^2 \cdot \texttt{sigmaColor})\f$,
+where range is the difference of the maximum and the minimum guide values. The filter is
+approximate: the weights are piecewise linear interpolations of the Gaussians, and the edges may
+be smoothed slightly more than by #bilateralFilter.
+
+The range weights are computed from the single-channel guide image, which allows the joint (cross)
+bilateral filtering of one image with the edges of another. When the guide is not specified, the
+source image itself is used for 1-channel images, and its grayscale version for 3- and 4-channel ones.
+The pixels outside of the image are not used, i.e. the weights are normalized at the image border.
+In-place filtering is supported.
+
+@param src Source 8-bit or floating-point image with 1 to 4 channels.
+@param dst Destination image of the same size and type as src.
+@param sigmaColor Filter sigma in the guide value space.
+@param sigmaSpace Filter sigma in the coordinate space; it must be at least 1.
+@param guide Optional 8-bit or floating-point single-channel guide image of the same size as src.
+@sa bilateralFilter
+ */
+CV_EXPORTS_W void bilateralGridFilter( InputArray src, OutputArray dst,
+                                       double sigmaColor, double sigmaSpace,
+                                       InputArray guide = noArray() );
+
 /** @brief Blurs an image using the box filter.
 
 The function smooths an image using the kernel:
@@ -2066,6 +2129,32 @@ CV_EXPORTS_W void HoughLinesP( InputArray image, OutputArray lines,
                                double rho, double theta, int threshold,
                                double minLineLength = 0, double maxLineGap = 0 );
 
+/** @brief Finds line segments in a binary image using the standard Hough transform.
+
+This is a deterministic alternative to #HoughLinesP. The lines are found as in #HoughLines, the
+accumulator is filled in parallel. Then the points near each line, i.e. the ones that voted for the
+accumulator cell of the line or for its neighbors across rho, are ordered along the line and split
+into the segments at the gaps. The lines are processed from the strongest one, the points of the
+found segments are excluded from the weaker lines, and a line is skipped when less than threshold of
+its votes remain. Unlike #HoughLinesP, the result does not depend on the random processing order
+and on the number of threads, and the segment ends are the actual edge points.
+
+@param image 8-bit, single-channel binary source image.
+@param lines Output vector of lines, see #HoughLinesP. They are ordered by the number of votes of
+the line they belong to.
+@param rho Distance resolution of the accumulator in pixels.
+@param theta Angle resolution of the accumulator in radians.
+@param threshold Accumulator threshold parameter. Only the lines that get enough votes
+( \f$>\texttt{threshold}\f$ ) are split into the segments.
+@param minLineLength Minimum line length. Line segments shorter than that are rejected.
+@param maxLineGap Maximum allowed gap between points on the same line to link them.
+
+@sa HoughLinesP
+ */
+CV_EXPORTS_W void HoughLinesSegments( InputArray image, OutputArray lines,
+                                      double rho, double theta, int threshold,
+                                      double minLineLength = 0, double maxLineGap = 0 );
+
 /** @brief Finds lines in a set of points using the standard Hough transform.
 
 The function finds lines in a set of points using a modification of the Hough transform.
@@ -2282,6 +2371,28 @@ CV_EXPORTS_W void resize( InputArray src, OutputArray dst,
                           Size dsize, double fx = 0, double fy = 0,
                           int interpolation = INTER_LINEAR );
 
+/** @brief Resizes many regions of an image to the same size in one call.
+
+The function is equivalent to calling cv::resize for every region and stacking the results, but all
+the regions are processed in one parallel loop, so it's efficient even for many small regions, e.g.
+the detections passed to a classifier. The interpolation coefficients are computed once for all the
+regions of the same size.
+
+@param src input image.
+@param rois regions of the image; each must lie inside the image.
+@param dst output array of rois.size() images of the size dsize and the type of src, i.e. the 3-D
+array of the size rois.size() x dsize.height x dsize.width. With planar=true the channels are stored
+separately and dst is the 4-D array of the size rois.size() x src.channels() x dsize.height x
+dsize.width and the depth of src. A preallocated dst of the right size and type is reused.
+@param dsize size of the resized regions.
+@param interpolation interpolation method, see #InterpolationFlags.
+@param planar whether the channels of the resized regions are stored separately.
+
+@sa resize, cvtColorBatch
+ */
+CV_EXPORTS void resizeBatch( InputArray src, const std::vector<Rect>& rois, OutputArray dst,
+                             Size dsize, int interpolation = INTER_LINEAR, bool planar = false );
+
 /** @brief Applies an affine transformation to an image.
 
 The function warpAffine transforms the source image using the specified matrix:
@@ -2415,6 +2526,81 @@ CV_EXPORTS_W void convertMaps( InputArray map1, InputArray map2,
                                OutputArray dstmap1, OutputArray dstmap2,
                                int dstmap1type, bool nninterpolation = false );
 
+/** @brief Remapping with the maps prepared once for many images.
+
+When the same maps are applied to every frame of a video stream, e.g. to undistort or rectify it,
+cv::remap converts the floating-point maps to the fixed-point coordinates and the indices in the
+interpolation tables on every call. CompiledRemap does the conversion once and stores the result grouped
+by the tiles of the destination image, so the maps of each tile are read sequentially when the tile
+is processed.
+
+The smooth maps, e.g. the lens distortion correction maps, may also be compressed. In this case only
+the coordinates in the nodes of a regular grid are stored, and the coordinates of the pixels between
+the nodes are interpolated bilinearly when the image is remapped. The fixed-point maps take 6 bytes
+per pixel, the compressed maps take 8 bytes per grid cell of up to 64x64 pixels, so the memory
+traffic does not grow with the maps when the images of high resolution are processed. The grid step is
+the largest one, for which the interpolated coordinates deviate from the original maps by no more than
+the given error; if there is no such step, the maps are not compressed.
+
+@code
+    Mat map1, map2;
+    initUndistortRectifyMap(K, distCoeffs, Mat(), K, frameSize, CV_32FC1, map1, map2);
+    CompiledRemap undistortion(map1, map2, INTER_LINEAR, 0.01);
+    for(;;)
+    {
+        cap >> frame;
+        undistortion.apply(frame, undistorted);
+        ...
+    }
+@endcode
+
+@sa remap, convertMaps
+ */
+class CV_EXPORTS CompiledRemap
+{
+public:
+    //! creates an empty object, CompiledRemap::compile must be called before CompiledRemap::apply
+    CompiledRemap();
+
+    //! the constructor calls CompiledRemap::compile
+    CompiledRemap(InputArray map1, InputArray map2, int interpolation = INTER_LINEAR, double maxError = 0);
+
+    /** @brief Prepares the maps.
+
+    @param map1 The first map in any of the formats supported by remap.
+    @param map2 The second map, see remap.
+    @param interpolation Interpolation method: #INTER_NEAREST, #INTER_LINEAR, #INTER_CUBIC or
+    #INTER_LANCZOS4.
+    @param maxError Maximum deviation of the interpolated coordinates from the maps, in pixels, if the
+    maps are compressed. 0 disables the compression. Note that the coordinates are stored with the
+    precision of 1/32 pixel in any case.
+     */
+    void compile(InputArray map1, InputArray map2, int interpolation = INTER_LINEAR, double maxError = 0);
+
+    /** @brief Applies the maps to the image, the same as remap does.
+
+    @param src Source image.
+    @param dst Destination image of the size of the maps and the same type as src.
+    @param borderMode Pixel extrapolation method (see #BorderTypes).
+    @param borderValue Value used in case of a constant border.
+     */
+    void apply(InputArray src, OutputArray dst, int borderMode = BORDER_CONSTANT,
+               const Scalar& borderValue = Scalar()) const;
+
+    //! returns the size of the maps
+    Size size() const;
+    //! returns true if the maps are not compiled
+    bool empty() const;
+    //! returns the interpolation method
+    int getInterpolation() const;
+    //! returns the grid step of the compressed maps, or 0 if the coordinates are stored for every pixel
+    int getGridStep() const;
+
+protected:
+    struct Impl;
+    Ptr<Impl> p;
+};
+
 /** @brief Calculates an affine matrix of 2D rotation.
 
 The function calculates the following matrix:
@@ -3017,6 +3203,34 @@ same as src. dst[1] is the next pyramid layer, a smoothed and down-sized src, an
 CV_EXPORTS void buildPyramid( InputArray src, OutputArrayOfArrays dst,
                               int maxlevel, int borderType = BORDER_DEFAULT );
 
+/** @overload
+
+Builds all the pyramid levels in a single pass and stores them in one buffer.
+
+Unlike the function above, which calls pyrDown for one level after another and reads every level
+back from memory, this variant streams the rows: each new row of a level is immediately used to
+compute the next coarser level, while the row is still in the cache. The parallel version splits
+the levels into horizontal stripes, so it also works well for the small images. The results are
+the same as of pyrDown and pyrUp.
+
+@param src Source image. Check pyrDown for the list of supported types.
+@param dst Destination vector of maxlevel+1 images, the headers of the levels. For #PYRAMID_GAUSSIAN,
+dst[0] is the same as src and the other levels have the type of src. For #PYRAMID_LAPLACIAN,
+dst[i] = dst_gaussian[i] - pyrUp(dst_gaussian[i+1]) for i < maxlevel and dst[maxlevel] =
+dst_gaussian[maxlevel]; they are of #CV_16S depth for 8-bit source images, of #CV_64F depth for the
+double-precision ones and of #CV_32F depth otherwise.
+@param buf the buffer where the levels are stored. It's reused when it's a continuous #CV_8UC1 array
+of sufficient size, so the pyramids of the subsequent frames can be built without allocations.
+For #PYRAMID_LAPLACIAN it also holds the Gaussian levels.
+@param maxlevel 0-based index of the last (the smallest) pyramid layer. It must be non-negative.
+@param pyrType type of the pyramid, see #PyramidTypes.
+@param borderType Pixel extrapolation method of pyrDown, see #BorderTypes (#BORDER_CONSTANT isn't
+supported). The up-sizing of the Laplacian pyramid always uses #BORDER_DEFAULT as pyrUp does.
+ */
+CV_EXPORTS void buildPyramid( InputArray src, OutputArrayOfArrays dst, OutputArray buf,
+                              int maxlevel, int pyrType = PYRAMID_GAUSSIAN,
+                              int borderType = BORDER_DEFAULT );
+
 //! @} imgproc_filter
 
 //! @addtogroup imgproc_hist
@@ -3259,6 +3473,28 @@ size as image .
  */
 CV_EXPORTS_W void watershed( InputArray image, InputOutputArray markers );
 
+/** @brief Performs the marker-based watershed segmentation in parallel.
+
+The image is split into the tiles of the given size, which are flooded by different threads. The
+flooding advances level by level (the level is the color difference between the neighbor pixels)
+over the whole image: the next level starts only when all the tiles have finished the current one.
+Within a level, each pass advances the flooding by a few pixels, and the pixels a tile puts to the
+queue of its neighbor are passed to it after the pass. So the basins grow across the tiles about as
+fast as within them, and the segmentation follows the same image edges as the sequential one.
+
+The result does not depend on the number of threads. It differs from the result of the sequential
+function only in the order the pixels of the same level are processed in, which may move the
+boundaries between the basins, mostly within the plateaus. With a single tile covering the whole
+image the result is exactly the same.
+
+@param image Input 8-bit 3-channel image.
+@param markers Input/output 32-bit single-channel image (map) of markers, see #watershed.
+@param tileSize Size of the tiles, both sides must be greater than 1.
+
+@ingroup imgproc_misc
+ */
+CV_EXPORTS void watershed( InputArray image, InputOutputArray markers, Size tileSize );
+
 //! @addtogroup imgproc_filter
 //! @{
 
@@ -3344,7 +3580,8 @@ The function cv::distanceTransform calculates the approximate or precise distanc
 image pixel to the nearest zero pixel. For zero image pixels, the distance will obviously be zero.
 
 When maskSize == #DIST_MASK_PRECISE and distanceType == #DIST_L2 , the function runs the
-algorithm described in @cite Felzenszwalb04 . This algorithm is parallelized with the TBB library.
+algorithm described in @cite Felzenszwalb04 . This algorithm is parallelized over the columns and
+then over the rows of the image.
 
 In other cases, the algorithm @cite Borgefors86 is used. This means that for a pixel the function
 finds the shortest path to the nearest zero pixel consisting of basic shifts: horizontal, vertical,
@@ -3364,7 +3601,9 @@ uses the values suggested in the original paper:
 
 Typically, for a fast, coarse distance estimation #DIST_L2, a \f$3\times 3\f$ mask is used. For a
 more accurate distance estimation #DIST_L2, a \f$5\times 5\f$ mask or the precise algorithm is used.
-Note that both the precise and the approximate algorithms are linear on the number of pixels.
+Note that both the precise and the approximate algorithms are linear on the number of pixels. The
+raster scans of the approximate algorithm are done by tiles processed in parallel, when several
+threads are available.
 
 This variant of the function does not only compute the minimum distance for each pixel \f$(x, y)\f$
 but also identifies the nearest connected component consisting of zero pixels
@@ -3375,9 +3614,9 @@ distinct labels. When labelType==#DIST_LABEL_PIXEL, the function scans through t
 marks all the zero pixels with distinct labels.
 
 In this mode, the complexity is still linear. That is, the function provides a very fast way to
-compute the Voronoi diagram for a binary image. Currently, the second variant can use only the
-approximate distance transform algorithm, i.e. maskSize=#DIST_MASK_PRECISE is not supported
-yet.
+compute the Voronoi diagram for a binary image. With distanceType == #DIST_L2 and
+maskSize == #DIST_MASK_PRECISE the labels of the exact Voronoi diagram are computed, otherwise the
+\f$5\times 5\f$ mask is used.
 
 @param src 8-bit, single-channel (binary) source image.
 @param dst Output image with calculated distances. It is a 8-bit or 32-bit floating-point,
@@ -3385,10 +3624,9 @@ single-channel image of the same size as src.
 @param labels Output 2D array of labels (the discrete Voronoi diagram). It has the type
 CV_32SC1 and the same size as src.
 @param distanceType Type of distance, see #DistanceTypes
-@param maskSize Size of the distance transform mask, see #DistanceTransformMasks.
-#DIST_MASK_PRECISE is not supported by this variant. In case of the #DIST_L1 or #DIST_C distance type,
-the parameter is forced to 3 because a \f$3\times 3\f$ mask gives the same result as \f$5\times
-5\f$ or any larger aperture.
+@param maskSize Size of the distance transform mask, see #DistanceTransformMasks. The labels are
+computed with the \f$5\times 5\f$ mask unless the precise distance transform is requested for
+#DIST_L2.
 @param labelType Type of the label array to build, see #DistanceTransformLabelTypes.
  */
 CV_EXPORTS_AS(distanceTransformWithLabels) void distanceTransform( InputArray src, OutputArray dst,
@@ -3498,6 +3736,36 @@ CV_EXPORTS_W int floodFill( InputOutputArray image, InputOutputArray mask,
                             Scalar loDiff = Scalar(), Scalar upDiff = Scalar(),
                             int flags = 4 );
 
+/** @brief Fills the connected components of many seed points at once and computes their statistics.
+
+The function grows a region from each seed with the same criteria as #floodFill and labels it in the
+output map with the index of the seed plus one. The region of a seed does not take the pixels of the
+regions of the previous seeds, so the result is the same as of the successive #floodFill calls with the
+same mask, filling it with the different values. In particular, the region of a seed that lies within the
+region of a previous one is empty. The image is not modified.
+
+The regions are grown in parallel, and the statistics are accumulated while they are filled. The
+regions that meet each other are then grown again sequentially, so the function is the most efficient
+when the seeds are in the different components of the image.
+
+@param image Input 1- or 3-channel, 8-bit, 32-bit integer or floating-point image.
+@param seeds Seed points.
+@param labels Output 32-bit single-channel map of the same size as image. The pixels of the region of
+the i-th seed are set to i+1, the rest are set to 0.
+@param stats Optional output statistics of the regions, one row per seed, of the type CV_32S and the
+layout of #connectedComponentsWithStats (see #ConnectedComponentsTypes). Empty regions have zero
+bounding boxes.
+@param means Optional output mean values of the region pixels, one row per seed of the type CV_64F,
+with a column per image channel.
+@param loDiff Maximal lower brightness/color difference, see #floodFill.
+@param upDiff Maximal upper brightness/color difference, see #floodFill.
+@param flags Connectivity (4 or 8) and optionally #FLOODFILL_FIXED_RANGE. The mask fill value is ignored.
+@return the number of non-empty regions.
+ */
+CV_EXPORTS int floodFillRegions( InputArray image, const std::vector<Point>& seeds, OutputArray labels,
+                                 OutputArray stats = noArray(), OutputArray means = noArray(),
+                                 Scalar loDiff = Scalar(), Scalar upDiff = Scalar(), int flags = 4 );
+
 //! Performs linear blending of two images:
 //! \f[ \texttt{dst}(i,j) = \texttt{weights1}(i,j)*\texttt{src1}(i,j) + \texttt{weights2}(i,j)*\texttt{src2}(i,j) \f]
 //! @param src1 It has a type of CV_8UC(n) or CV_32FC(n), where n is a positive integer.
@@ -3555,6 +3823,28 @@ channels is derived automatically from src and code.
  */
 CV_EXPORTS_W void cvtColor( InputArray src, OutputArray dst, int code, int dstCn = 0 );
 
+/** @brief Converts the color space of many regions of an image in one call, optionally resizing them.
+
+The function is equivalent to resizing every region with cv::resize, converting it with cv::cvtColor
+and stacking the results, but all the regions are processed in one parallel loop and every region
+is converted while it's in the cache. See cv::resizeBatch for the details.
+
+@param src input image.
+@param rois regions of the image; each must lie inside the image.
+@param dst output array of rois.size() converted regions, see the description of the planar and
+non-planar layouts in cv::resizeBatch. The type is defined by the conversion.
+@param code color space conversion code (see #ColorConversionCodes). The conversions that change the
+image size are not supported, the demosaicing is supported only without resizing.
+@param dsize size of the converted regions. When it's empty, the regions are not resized and must
+have the same size.
+@param interpolation interpolation method, see #InterpolationFlags.
+@param planar whether the channels of the converted regions are stored separately.
+
+@sa cvtColor, resizeBatch
+ */
+CV_EXPORTS void cvtColorBatch( InputArray src, const std::vector<Rect>& rois, OutputArray dst, int code,
+                               Size dsize = Size(), int interpolation = INTER_LINEAR, bool planar = false );
+
 /** @brief Converts an image from one color space to another where the source image is
 stored in two planes.
 
@@ -3607,6 +3897,47 @@ The function can do the following transformations:
 */
 CV_EXPORTS_W void demosaicing(InputArray src, OutputArray dst, int code, int dstCn = 0);
 
+//! the layouts of the raw frames, see #demosaicingRaw
+enum RawPackings {
+    RAW_UNPACKED       = 0, //!< one 8-bit or 16-bit sample per element
+    //! 12-bit samples, 2 pixels in 3 bytes: the high 8 bits of the first and the second pixel, then
+    //! the low 4 bits of the first pixel in the low nibble and of the second one in the high nibble (MIPI CSI-2 RAW12)
+    RAW_PACKED_12_MIPI = 1,
+    //! 12-bit samples, 2 pixels in 3 bytes, the bits of the pixels go from the least significant one
+    //! (GenICam PFNC "12p" formats, e.g. BayerRG12p)
+    RAW_PACKED_12_LSB  = 2
+};
+
+/** @brief Converts the raw Bayer frame to the color image applying the white balance, the color
+correction matrix and the tone curve in a single pass.
+
+The function gives the same result as #demosaicing followed by the multiplication of the channels by
+the white balance gains, #transform with the color correction matrix and #LUT, up to the rounding of
+the intermediate values, but it makes a single pass over the frame. The frame is processed in parallel
+by the horizontal stripes: the raw rows are unpacked and demosaiced into a small buffer, and the color
+correction and the tone curve are applied to the buffered rows while they are in the cache.
+
+@param src raw frame: 8-bit or 16-bit single-channel image for #RAW_UNPACKED, 8-bit single-channel
+image with 3 bytes per 2 pixels in each row for the packed formats.
+@param dst output BGR image. Its depth is the depth of lut, if it is set, otherwise 8-bit for the
+8-bit source and 16-bit for the others.
+@param code bilinear (#COLOR_BayerBG2BGR, ...) or edge-aware (#COLOR_BayerBG2BGR_EA, ...) demosaicing code.
+@param wbGains white balance gains of the blue, green and red channels.
+@param ccm optional 3x3 color correction matrix applied to the BGR vectors of the white-balanced pixels,
+as #transform does.
+@param lut optional tone curve (e.g. the gamma correction): 8-bit or 16-bit single-channel table of
+\f$2^{bitDepth}\f$ elements. The color-corrected values are rounded and clipped to
+\f$[0, 2^{bitDepth}-1]\f$ and then looked up in the table.
+@param bitDepth number of the significant bits of the raw samples, 0 means the full range of the
+source depth (12 bits for the packed formats).
+@param packing the layout of the raw samples, see #RawPackings.
+
+@sa demosaicing
+*/
+CV_EXPORTS void demosaicingRaw(InputArray src, OutputArray dst, int code,
+                               const Scalar& wbGains = Scalar::all(1), InputArray ccm = noArray(),
+                               InputArray lut = noArray(), int bitDepth = 0, int packing = RAW_UNPACKED);
+
 //! @} imgproc_color_conversions
 
 //! @addtogroup imgproc_shape
@@ -4248,6 +4579,71 @@ at most 8 vertices. Stored as std::vector\<cv::Point2f\> or cv::Mat as Mx1 of ty
  */
 CV_EXPORTS_W int rotatedRectangleIntersection( const RotatedRect& rect1, const RotatedRect& rect2, OutputArray intersectingRegion  );
 
+/** @brief Calculates the up-right bounding rectangles of many contours at once.
+
+The batch functions below process a set of contours stored in the flattened form: all the points are
+stored in one array and contour i consists of the points points[offsets[i]], ..., points[offsets[i+1]-1].
+This is the layout of the contours of, e.g., a big connected component analysis. The contours are
+processed in parallel and the temporary buffers are allocated once per thread, so it's much faster
+than calling the single-contour function in a loop when there are many small contours. The results
+are the same as the ones of the single-contour functions; an empty contour gives the default-constructed
+result.
+
+@param points Continuous array of the 2D points of all the contours, of type CV_32SC2 or CV_32FC2.
+@param offsets Array of ncontours+1 non-decreasing integer offsets of the contours in points, of type CV_32S.
+@param rects Output vector of the bounding rectangles, see cv::boundingRect.
+ */
+CV_EXPORTS void boundingRectBatch( InputArray points, InputArray offsets, std::vector<Rect>& rects );
+
+/** @brief Calculates the areas of many contours at once, see cv::boundingRectBatch and cv::contourArea.
+
+@param points Flattened points of the contours.
+@param offsets Offsets of the contours in points.
+@param areas Output ncontours x 1 array of the areas, of type CV_64F.
+@param oriented Oriented area flag, see cv::contourArea.
+ */
+CV_EXPORTS void contourAreaBatch( InputArray points, InputArray offsets, OutputArray areas, bool oriented = false );
+
+/** @brief Calculates the moments of many contours at once, see cv::boundingRectBatch and cv::moments.
+
+@param points Flattened points of the contours.
+@param offsets Offsets of the contours in points.
+@param moments Output vector of the contour moments.
+ */
+CV_EXPORTS void momentsBatch( InputArray points, InputArray offsets, std::vector<Moments>& moments );
+
+/** @brief Finds the minimum area rotated rectangles of many contours at once, see cv::boundingRectBatch
+and cv::minAreaRect.
+
+@param points Flattened points of the contours.
+@param offsets Offsets of the contours in points.
+@param boxes Output vector of the rectangles.
+ */
+CV_EXPORTS void minAreaRectBatch( InputArray points, InputArray offsets, std::vector<RotatedRect>& boxes );
+
+/** @brief Finds the convex hulls of many contours at once, see cv::boundingRectBatch and cv::convexHull.
+
+@param points Flattened points of the contours.
+@param offsets Offsets of the contours in points.
+@param hullPoints Output flattened points of the hulls, of the same type as points.
+@param hullOffsets Output ncontours+1 offsets of the hulls in hullPoints, of type CV_32S.
+@param clockwise Orientation flag, see cv::convexHull.
+ */
+CV_EXPORTS void convexHullBatch( InputArray points, InputArray offsets, OutputArray hullPoints,
+                                 OutputArray hullOffsets, bool clockwise = false );
+
+/** @brief Approximates many polygonal curves at once, see cv::boundingRectBatch and cv::approxPolyDP.
+
+@param points Flattened points of the curves.
+@param offsets Offsets of the curves in points.
+@param approxPoints Output flattened points of the approximated curves, of the same type as points.
+@param approxOffsets Output ncontours+1 offsets of the approximated curves in approxPoints, of type CV_32S.
+@param epsilon Approximation accuracy, see cv::approxPolyDP.
+@param closed If true, the curves are closed.
+ */
+CV_EXPORTS void approxPolyDPBatch( InputArray points, InputArray offsets, OutputArray approxPoints,
+                                   OutputArray approxOffsets, double epsilon, bool closed );
+
 /** @brief Creates a smart pointer to a cv::GeneralizedHoughBallard class and initializes it.
 */
 CV_EXPORTS_W Ptr<GeneralizedHoughBallard> createGeneralizedHoughBallard();
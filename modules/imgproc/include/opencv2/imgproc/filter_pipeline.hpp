@@ -0,0 +1,148 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_IMGPROC_FILTER_PIPELINE_HPP
+#define OPENCV_IMGPROC_FILTER_PIPELINE_HPP
+
+#include "opencv2/imgproc.hpp"
+
+#include <functional>
+
+namespace cv
+{
+
+//! @addtogroup imgproc_filter
+//! @{
+
+/** @brief Chain of filters, color conversions and per-pixel operations executed stripe by stripe.
+
+Calling cv::cvtColor, cv::GaussianBlur, cv::Sobel etc. one after another streams every intermediate
+image through the main memory. FilterPipeline records the same chain of operations and executes it
+on horizontal stripes of the destination image instead: every stage produces just the rows that
+the next stage needs for the current stripe (the stripe itself plus the rows of the vertical
+kernel apertures of the following stages), so the intermediate buffers stay in the cache. The
+stripes are processed in parallel.
+
+The filtering stages use the same row and column filters as the corresponding functions, so the
+result is the same as of the sequence of calls, with the following differences:
+- the source image is always treated as isolated, i.e. the pixels outside of a source ROI are never used;
+- 8-bit and 16-bit GaussianBlur uses the generic floating-point kernels, not the bit-exact
+  implementation of cv::GaussianBlur, so the results may differ by 1.
+
+The height of the stripes is chosen so that the buffers of all the stages fit into
+`OPENCV_IMGPROC_FILTER_PIPELINE_CACHE_SIZE` bytes (256Kb by default), unless it is set explicitly
+with FilterPipeline::setStripeHeight. The rows in the vertical apertures are recomputed by the
+neighbor stripes, so the chains of large kernels benefit from higher stripes.
+
+@code
+    FilterPipeline edges;
+    edges.cvtColor(COLOR_BGR2GRAY)
+         .GaussianBlur(Size(5, 5), 1.5)
+         .gradient(CV_32F, 3)
+         .magnitude()
+         .threshold(100, 255, THRESH_BINARY);
+    edges.apply(frame, mask);
+@endcode
+ */
+class CV_EXPORTS FilterPipeline
+{
+public:
+    /** @brief Per-pixel operation on a block of rows.
+
+    The destination is preallocated and must not be reallocated by the operation.
+     */
+    typedef std::function<void(const Mat& src, Mat& dst)> PointwiseOp;
+
+    //! creates an empty pipeline; applying it copies the source to the destination
+    FilterPipeline();
+
+    //! appends cv::cvtColor; only the conversions that map each pixel independently are supported
+    FilterPipeline& cvtColor(int code);
+
+    //! appends Mat::convertTo; negative ddepth keeps the depth of the previous stage
+    FilterPipeline& convertTo(int ddepth, double alpha = 1, double beta = 0);
+
+    //! appends cv::threshold; THRESH_OTSU and THRESH_TRIANGLE are not supported
+    FilterPipeline& threshold(double thresh, double maxval, int type);
+
+    //! appends cv::sepFilter2D
+    FilterPipeline& sepFilter2D(int ddepth, InputArray kernelX, InputArray kernelY,
+                                Point anchor = Point(-1,-1), double delta = 0,
+                                int borderType = BORDER_DEFAULT);
+
+    //! appends cv::filter2D
+    FilterPipeline& filter2D(int ddepth, InputArray kernel, Point anchor = Point(-1,-1),
+                             double delta = 0, int borderType = BORDER_DEFAULT);
+
+    //! appends cv::boxFilter
+    FilterPipeline& boxFilter(int ddepth, Size ksize, Point anchor = Point(-1,-1),
+                              bool normalize = true, int borderType = BORDER_DEFAULT);
+
+    //! appends cv::GaussianBlur
+    FilterPipeline& GaussianBlur(Size ksize, double sigmaX, double sigmaY = 0,
+                                 int borderType = BORDER_DEFAULT);
+
+    //! appends cv::Sobel (cv::Scharr if ksize == FILTER_SCHARR)
+    FilterPipeline& Sobel(int ddepth, int dx, int dy, int ksize = 3,
+                          double scale = 1, double delta = 0,
+                          int borderType = BORDER_DEFAULT);
+
+    /** @brief appends the first order derivatives of a single-channel image.
+
+    The stage produces a 2-channel image with the x- and y-derivatives computed as by cv::Sobel.
+     */
+    FilterPipeline& gradient(int ddepth = CV_32F, int ksize = 3, double scale = 1,
+                             int borderType = BORDER_DEFAULT);
+
+    //! appends cv::magnitude of a 2-channel floating-point image, e.g. the FilterPipeline::gradient output
+    FilterPipeline& magnitude();
+
+    //! appends cv::erode; every iteration is a separate stage
+    FilterPipeline& erode(InputArray kernel, Point anchor = Point(-1,-1), int iterations = 1,
+                          int borderType = BORDER_CONSTANT,
+                          const Scalar& borderValue = morphologyDefaultBorderValue());
+
+    //! appends cv::dilate; every iteration is a separate stage
+    FilterPipeline& dilate(InputArray kernel, Point anchor = Point(-1,-1), int iterations = 1,
+                           int borderType = BORDER_CONSTANT,
+                           const Scalar& borderValue = morphologyDefaultBorderValue());
+
+    /** @brief appends a user-defined per-pixel operation.
+
+    @param op the operation; it may be called concurrently for different blocks of rows.
+    @param dtype type of the operation result; a negative value means the type of the previous stage.
+     */
+    FilterPipeline& pointwise(const PointwiseOp& op, int dtype = -1);
+
+    /** @brief sets the number of destination rows processed at once.
+
+    @param rows stripe height; 0 (default) selects it automatically from the cache size.
+     */
+    FilterPipeline& setStripeHeight(int rows);
+
+    //! returns the number of stages
+    size_t size() const;
+    //! returns true if the pipeline has no stages
+    bool empty() const;
+    //! removes all the stages
+    void clear();
+
+    /** @brief executes the pipeline.
+
+    @param src source image.
+    @param dst destination image of the same size as src and of the type produced by the last stage.
+    It may be the same as src.
+     */
+    void apply(InputArray src, OutputArray dst) const;
+
+protected:
+    struct Impl;
+    Ptr<Impl> p;
+};
+
+//! @} imgproc_filter
+
+} // cv
+
+#endif // OPENCV_IMGPROC_FILTER_PIPELINE_HPP
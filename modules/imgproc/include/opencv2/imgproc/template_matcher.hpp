@@ -0,0 +1,122 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_IMGPROC_TEMPLATE_MATCHER_HPP
+#define OPENCV_IMGPROC_TEMPLATE_MATCHER_HPP
+
+#include "opencv2/imgproc.hpp"
+
+namespace cv
+{
+
+//! @addtogroup imgproc_object
+//! @{
+
+/** @brief Matches many templates against the same image, reusing the image transforms between the calls.
+
+cv::matchTemplate computes the discrete Fourier transform of the whole image and its integral images
+on every call. When many templates are searched in the same frame, most of that work is repeated.
+TemplateMatcher keeps the image and computes these data once, when they are first needed:
+- the spectra of the image blocks are computed for a DFT size that fits the templates and are reused
+  by all the following calls with the templates of the same or smaller size. The correlation with each
+  template then takes one spectrum multiplication per channel and one inverse transform per block;
+- the integral images of the pixel values and of their squares, used by all the methods except #TM_CCORR;
+- the Gaussian pyramid of the image, used by TemplateMatcher::search.
+
+TemplateMatcher::match and TemplateMatcher::matchBatch compute the same score maps as cv::matchTemplate
+without the mask, within the floating-point accuracy. The batch variant processes all the templates
+in parallel.
+
+TemplateMatcher::search finds the locations where the normalized score passes the threshold using a
+coarse-to-fine search in the image pyramid. The full score map is computed only at the coarsest
+level, where the template is still reasonably large. The locations that pass the relaxed threshold
+there are refined at the finer levels, where the score is computed directly and only around them.
+This is much faster than the full match of a large image, but it may miss the matches whose score
+drops too much at the coarse levels, e.g. the ones of the templates with fine texture; increase
+coarseMargin or decrease maxLevel in this case.
+
+The cached data take memory comparable to a few copies of the image converted to the floating-point
+type. The object is not thread-safe: the caches are updated by the matching methods.
+
+@code
+    TemplateMatcher matcher(frame);
+    std::vector<TemplateMatcher::Match> matches;
+    matcher.search(parts, matches, TM_CCOEFF_NORMED, 0.9);
+@endcode
+ */
+class CV_EXPORTS TemplateMatcher
+{
+public:
+    //! the location of the template found by TemplateMatcher::search
+    struct Match
+    {
+        Match() : templateIdx(-1), score(0.f) {}
+        Match(int _templateIdx, Point _location, float _score)
+            : templateIdx(_templateIdx), location(_location), score(_score) {}
+
+        int templateIdx; //!< index of the template in the input array
+        Point location;  //!< top-left corner of the matched image region
+        float score;     //!< the score of the match, see #TemplateMatchModes
+    };
+
+    //! creates an empty matcher; TemplateMatcher::setImage must be called before matching
+    TemplateMatcher();
+
+    //! creates the matcher for the image, see TemplateMatcher::setImage
+    explicit TemplateMatcher(InputArray image);
+
+    /** @brief sets the image where the templates are searched and discards the cached data.
+
+    @param image 8-bit or 32-bit floating-point image with 1 to 4 channels. It's copied.
+     */
+    void setImage(InputArray image);
+
+    //! returns the size of the image
+    Size getImageSize() const;
+
+    //! returns true if the image is not set
+    bool empty() const;
+
+    /** @brief compares the template against the overlapped image regions, see cv::matchTemplate.
+
+    @param templ template of the same type as the image and not greater than it.
+    @param result map of the comparison results of the size \f$(W-w+1) \times (H-h+1)\f$ and type #CV_32FC1.
+    @param method comparison method, see #TemplateMatchModes.
+     */
+    void match(InputArray templ, OutputArray result, int method);
+
+    /** @brief matches many templates at once.
+
+    @param templs vector of the templates of the same type as the image. They may have different sizes.
+    @param results vector of the score maps, one per template.
+    @param method comparison method, see #TemplateMatchModes.
+     */
+    void matchBatch(InputArrayOfArrays templs, OutputArrayOfArrays results, int method);
+
+    /** @brief finds the locations where the templates match the image using the coarse-to-fine search.
+
+    @param templs vector of the templates of the same type as the image.
+    @param matches output vector of the matches, ordered by the template index and then by the location
+    in the raster order. Only the local extrema of the score in the 3x3 neighborhood are reported.
+    @param method #TM_SQDIFF_NORMED, #TM_CCORR_NORMED or #TM_CCOEFF_NORMED.
+    @param threshold the score a match must pass: not greater than the threshold for #TM_SQDIFF_NORMED
+    and not less than it for the other methods.
+    @param maxLevel the maximal pyramid level where the search starts. Each template starts at the
+    level where both its sides are not less than 16 pixels; with maxLevel=0 the full score map of the
+    original image is thresholded.
+    @param coarseMargin the relaxation of the threshold at the coarse levels.
+     */
+    void search(InputArrayOfArrays templs, std::vector<Match>& matches, int method,
+                double threshold, int maxLevel = 3, double coarseMargin = 0.1);
+
+protected:
+    struct Impl;
+    Ptr<Impl> p;
+};
+
+//! @} imgproc_object
+
+} // cv
+
+#endif // OPENCV_IMGPROC_TEMPLATE_MATCHER_HPP
@@ -0,0 +1,129 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_IMGPROC_WARP_PIPELINE_HPP
+#define OPENCV_IMGPROC_WARP_PIPELINE_HPP
+
+#include "opencv2/imgproc.hpp"
+
+namespace cv
+{
+
+//! @addtogroup imgproc_transform
+//! @{
+
+/** @brief Chain of geometric transformations and per-pixel conversions executed in a single resampling pass.
+
+Extracting a rectified patch usually takes several calls: cv::warpPerspective, then cv::cvtColor,
+then cv::resize. Every call walks the whole intermediate image and every geometric step interpolates
+the pixels once more. WarpPipeline records the same chain and composes the coordinate transformations
+of all the geometric stages, so every destination pixel is interpolated from the source image just
+once. The per-pixel stages (color and type conversions) are then applied to the small blocks of the
+resampled rows, while they are in the cache.
+
+The geometric stages are cv::warpAffine, cv::warpPerspective, cv::remap with the precomputed maps,
+cropping and cv::resize. Each stage defines the size of its output, which is the input of the next
+stage. The per-pixel stages may be specified in any position of the chain, but they are always applied
+after the resampling, in the order they were added. So the result is the same as of the sequence of
+calls with the following differences:
+- the source is interpolated only once, with the interpolation method and the border mode of the whole
+  pipeline (see WarpPipeline::setInterpolation and WarpPipeline::setBorder); the intermediate images
+  have no borders, so the pixels outside of them come from the source image, if it has them;
+- resize samples the pixel centers as #INTER_LINEAR does, #INTER_AREA decimation is not done;
+- the per-pixel conversions are applied to the interpolated values.
+
+Many pipelines may be applied to the same source image at once with WarpPipeline::applyBatch, which
+processes all the destination images in parallel, so it's efficient even for many small patches.
+
+@code
+    WarpPipeline patch;
+    patch.warpPerspective(H, Size(256, 256))
+         .cvtColor(COLOR_BGR2GRAY)
+         .resize(Size(64, 64));
+    patch.apply(frame, dst);
+@endcode
+ */
+class CV_EXPORTS WarpPipeline
+{
+public:
+    //! creates an empty pipeline; applying it copies the source to the destination
+    WarpPipeline();
+
+    /** @brief appends cv::warpAffine.
+
+    @param M 2x3 transformation matrix.
+    @param dsize size of the stage output.
+    @param flags 0 or #WARP_INVERSE_MAP, the interpolation method is set for the whole pipeline.
+     */
+    WarpPipeline& warpAffine(InputArray M, Size dsize, int flags = 0);
+
+    /** @brief appends cv::warpPerspective.
+
+    @param M 3x3 transformation matrix.
+    @param dsize size of the stage output.
+    @param flags 0 or #WARP_INVERSE_MAP, the interpolation method is set for the whole pipeline.
+     */
+    WarpPipeline& warpPerspective(InputArray M, Size dsize, int flags = 0);
+
+    /** @brief appends cv::remap with the precomputed maps.
+
+    The maps may be in any format supported by cv::convertMaps; the stage output has the size of the maps.
+     */
+    WarpPipeline& remap(InputArray map1, InputArray map2 = noArray());
+
+    //! appends extraction of the rectangle; it may lie partially outside of the stage input
+    WarpPipeline& crop(const Rect& roi);
+
+    //! appends cv::resize; either dsize or both fx and fy must be non-zero
+    WarpPipeline& resize(Size dsize, double fx = 0, double fy = 0);
+
+    //! appends cv::cvtColor; only the conversions that map each pixel independently are supported
+    WarpPipeline& cvtColor(int code);
+
+    //! appends Mat::convertTo; negative ddepth keeps the depth of the previous stage
+    WarpPipeline& convertTo(int ddepth, double alpha = 1, double beta = 0);
+
+    //! sets the interpolation method: #INTER_NEAREST, #INTER_LINEAR (default), #INTER_CUBIC or #INTER_LANCZOS4
+    WarpPipeline& setInterpolation(int interpolation);
+
+    //! sets the pixel extrapolation method of the source image (#BORDER_CONSTANT by default), see cv::remap
+    WarpPipeline& setBorder(int borderMode, const Scalar& borderValue = Scalar());
+
+    //! returns the number of stages
+    size_t size() const;
+    //! returns true if the pipeline has no stages
+    bool empty() const;
+    //! removes all the stages
+    void clear();
+
+    //! returns the size of the destination image for the source image of the given size
+    Size getDstSize(Size srcSize) const;
+
+    /** @brief executes the pipeline.
+
+    @param src source image.
+    @param dst destination image of the size WarpPipeline::getDstSize and of the type produced by the
+    last stage. It may be the same as src.
+     */
+    void apply(InputArray src, OutputArray dst) const;
+
+    /** @brief executes many pipelines on the same source image in parallel.
+
+    @param src source image.
+    @param pipelines the pipelines, e.g. the patch extractions that differ by the transformation matrices.
+    @param dst vector of the destination images, one per pipeline.
+     */
+    static void applyBatch(InputArray src, const std::vector<WarpPipeline>& pipelines,
+                           OutputArrayOfArrays dst);
+
+protected:
+    struct Impl;
+    Ptr<Impl> p;
+};
+
+//! @} imgproc_transform
+
+} // cv
+
+#endif // OPENCV_IMGPROC_WARP_PIPELINE_HPP
@@ -55,6 +55,26 @@ CV_INLINE  float  icvDistanceL2_32f( CvPoint2D32f pt1, CvPoint2D32f pt2 )
 /* curvature: 0 - 1-curvature, 1 - k-cosine curvature. */
 CvSeq* icvApproximateChainTC89( CvChain* chain, int header_size, CvMemStorage* storage, int method );
 
+namespace cv
+{
+
+/* Checks the contours stored one after another in the point array: the contour i consists of
+   points[offsets[i]] ... points[offsets[i+1]-1]. Returns the number of the contours. */
+int checkContourBatch( const Mat& points, const Mat& offsets );
+
+/* The number of the parallel stripes for processing the contour batch. */
+CV_INLINE double contourBatchStripes( const Mat& points, int ncontours )
+{
+    return std::min((double)ncontours, points.total()/4096. + 1);
+}
+
+/* Finds the convex hull indices of the continuous point array. The buffers pointer, stack and hull
+   must hold total, total+2 and total elements. Returns the number of the hull points. */
+int convexHullIndices( const Point* data, int total, bool is_float, bool clockwise,
+                       Point** pointer, int* stack, int* hull );
+
+}
+
 #endif /*_IPCVGEOM_H_*/
 
 /* End of file. */
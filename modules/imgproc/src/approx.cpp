@@ -710,6 +710,50 @@ void cv::approxPolyDP( InputArray _curve, OutputArray _approxCurve,
 }
 
 
+
+void cv::approxPolyDPBatch( InputArray _points, InputArray _offsets, OutputArray _approxPoints,
+                            OutputArray _approxOffsets, double epsilon, bool closed )
+{
+    CV_INSTRUMENT_REGION();
+
+    if (epsilon < 0.0 || !(epsilon < 1e30))
+    {
+        CV_Error(CV_StsOutOfRange, "Epsilon not valid.");
+    }
+
+    Mat points = _points.getMat(), offsets = _offsets.getMat();
+    int ncontours = checkContourBatch(points, offsets);
+    const int* ofs = offsets.ptr<int>();
+    const Point* data = points.ptr<Point>();
+    bool is_float = points.depth() == CV_32F;
+
+    // the approximation of each contour is stored in place of the contour, then they are packed
+    std::vector<Point> buf(points.total());
+    std::vector<int> counts(ncontours);
+    parallel_for_(Range(0, ncontours), [&](const Range& r)
+    {
+        AutoBuffer<Range> stack(128);
+        for( int i = r.start; i < r.end; i++ )
+        {
+            int n = ofs[i+1] - ofs[i];
+            counts[i] = n == 0 ? 0 : !is_float ?
+                approxPolyDP_(data + ofs[i], n, &buf[ofs[i]], closed, epsilon, stack) :
+                approxPolyDP_((const Point2f*)(data + ofs[i]), n, (Point2f*)&buf[ofs[i]], closed, epsilon, stack);
+        }
+    }, contourBatchStripes(points, ncontours));
+
+    _approxOffsets.create(ncontours + 1, 1, CV_32S);
+    int* aofs = _approxOffsets.getMat().ptr<int>();
+    aofs[0] = 0;
+    for( int i = 0; i < ncontours; i++ )
+        aofs[i+1] = aofs[i] + counts[i];
+
+    _approxPoints.create(aofs[ncontours], 1, CV_MAKETYPE(points.depth(), 2));
+    Point* dst = _approxPoints.getMat().ptr<Point>();
+    for( int i = 0; i < ncontours; i++ )
+        std::copy(buf.begin() + ofs[i], buf.begin() + ofs[i] + counts[i], dst + aofs[i]);
+}
+
 CV_IMPL CvSeq*
 cvApproxPoly( const void* array, int header_size,
              CvMemStorage* storage, int method,
@@ -0,0 +1,309 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+/*
+ * Bilateral grid:
+ *
+ * J. Chen, S. Paris, F. Durand. "Real-time edge-aware image processing with the bilateral grid",
+ * ACM Transactions on Graphics 26(3), 2007.
+ *
+ * The pixels are accumulated in the 3D grid (y, x, guide value) downsampled by sigmaSpace and
+ * sigmaColor, the grid is blurred by the small Gaussian along every axis, and the result is
+ * interpolated back at the pixel positions. The cost per pixel does not depend on sigmaSpace.
+ */
+
+namespace cv
+{
+
+namespace
+{
+
+// the number of the empty cells around the grid, that are enough for the blur kernel
+static const int BILATERAL_GRID_BORDER = 2;
+
+struct BilateralGrid
+{
+    BilateralGrid( int _ny, int _nx, int _nz, int _cn ) :
+        ny(_ny), nx(_nx), nz(_nz), cn(_cn)
+    {
+        // every cell keeps the sum of the values of every channel and the number of pixels
+        int P = BILATERAL_GRID_BORDER;
+        cstep = cn + 1;
+        xstep = (nz + P*2)*cstep;
+        ystep = (nx + P*2)*xstep;
+        size_t total = (size_t)(ny + P*2)*ystep;
+        buf[0].allocate(total);
+        buf[1].allocate(total);
+        memset(buf[0].data(), 0, total*sizeof(float));
+        memset(buf[1].data(), 0, total*sizeof(float));
+    }
+
+    float* cell( int k, int y, int x, int z )
+    {
+        int P = BILATERAL_GRID_BORDER;
+        return buf[k].data() + (size_t)(y + P)*ystep + (x + P)*xstep + (z + P)*cstep;
+    }
+
+    int ny, nx, nz, cn;
+    int cstep, xstep, ystep;
+    AutoBuffer<float> buf[2];
+};
+
+// dst[i] = src[i - 2*s] + 4*src[i - s] + 6*src[i] + 4*src[i + s] + src[i + 2*s], i.e. the
+// Gaussian with sigma = 1 cell; the normalization is not needed, since it's cancelled out
+// by the division by the blurred weights
+static void bilateralGridBlurLine( const float* src, float* dst, int n, int s )
+{
+    int i = 0;
+#if CV_SIMD
+    v_float32 v4 = vx_setall_f32(4.f), v6 = vx_setall_f32(6.f);
+    for( ; i <= n - v_float32::nlanes; i += v_float32::nlanes )
+    {
+        v_float32 a = vx_load(src + i - s*2) + vx_load(src + i + s*2);
+        v_float32 b = vx_load(src + i - s) + vx_load(src + i + s);
+        v_store(dst + i, v_muladd(b, v4, v_muladd(vx_load(src + i), v6, a)));
+    }
+#endif
+    for( ; i < n; i++ )
+        dst[i] = src[i - s*2] + src[i + s*2] + (src[i - s] + src[i + s])*4 + src[i]*6;
+}
+
+template<typename T, typename GT>
+class BilateralGridSplatInvoker : public ParallelLoopBody
+{
+public:
+    BilateralGridSplatInvoker( const Mat& _src, const Mat& _guide, BilateralGrid& _grid,
+                               const std::vector<int>& _rowOfs, float _scaleSpace,
+                               float _scaleColor, float _minColor ) :
+        src(_src), guide(_guide), grid(_grid), rowOfs(_rowOfs), scaleSpace(_scaleSpace),
+        scaleColor(_scaleColor), minColor(_minColor)
+    {
+    }
+
+    // every grid row accumulates its own block of the image rows, so there are no races
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int cn = src.channels();
+        for( int gy = range.start; gy < range.end; gy++ )
+            for( int y = rowOfs[gy]; y < rowOfs[gy + 1]; y++ )
+            {
+                const T* S = src.ptr<T>(y);
+                const GT* G = guide.ptr<GT>(y);
+                for( int x = 0; x < src.cols; x++, S += cn )
+                {
+                    int gz = std::min(cvRound((G[x] - minColor)*scaleColor), grid.nz - 1);
+                    float* C = grid.cell(0, gy, cvRound(x*scaleSpace), gz);
+                    for( int k = 0; k < cn; k++ )
+                        C[k] += S[k];
+                    C[cn] += 1.f;
+                }
+            }
+    }
+
+private:
+    const Mat& src;
+    const Mat& guide;
+    BilateralGrid& grid;
+    const std::vector<int>& rowOfs;
+    float scaleSpace, scaleColor, minColor;
+
+    BilateralGridSplatInvoker& operator=(const BilateralGridSplatInvoker&); // = delete
+};
+
+// blurs the inner part of the grid along one axis: 0 - along the guide values, 1 - along x, 2 - along y
+class BilateralGridBlurInvoker : public ParallelLoopBody
+{
+public:
+    BilateralGridBlurInvoker( BilateralGrid& _grid, int _axis, int _srcIdx ) :
+        grid(_grid), axis(_axis), srcIdx(_srcIdx)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        for( int gy = range.start; gy < range.end; gy++ )
+        {
+            if( axis == 0 )
+            {
+                for( int gx = 0; gx < grid.nx; gx++ )
+                    bilateralGridBlurLine(grid.cell(srcIdx, gy, gx, 0), grid.cell(srcIdx ^ 1, gy, gx, 0),
+                                          grid.nz*grid.cstep, grid.cstep);
+            }
+            else if( axis == 1 )
+                bilateralGridBlurLine(grid.cell(srcIdx, gy, 0, 0), grid.cell(srcIdx ^ 1, gy, 0, 0),
+                                      grid.nx*grid.xstep, grid.xstep);
+            else
+            {
+                // the whole rows including the empty cells, which stay empty
+                int P = BILATERAL_GRID_BORDER;
+                bilateralGridBlurLine(grid.cell(srcIdx, gy, -P, -P), grid.cell(srcIdx ^ 1, gy, -P, -P),
+                                      grid.ystep, grid.ystep);
+            }
+        }
+    }
+
+private:
+    BilateralGrid& grid;
+    int axis, srcIdx;
+
+    BilateralGridBlurInvoker& operator=(const BilateralGridBlurInvoker&); // = delete
+};
+
+template<typename T, typename GT>
+class BilateralGridSliceInvoker : public ParallelLoopBody
+{
+public:
+    BilateralGridSliceInvoker( const Mat& _src, const Mat& _guide, Mat& _dst, BilateralGrid& _grid,
+                               int _gridIdx, float _scaleSpace, float _scaleColor, float _minColor ) :
+        src(_src), guide(_guide), dst(_dst), grid(_grid), gridIdx(_gridIdx),
+        scaleSpace(_scaleSpace), scaleColor(_scaleColor), minColor(_minColor)
+    {
+    }
+
+    // trilinear interpolation of the blurred grid
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int cn = src.channels(), cstep = grid.cstep, xstep = grid.xstep, ystep = grid.ystep;
+        float sum[5];
+
+        for( int y = range.start; y < range.end; y++ )
+        {
+            const T* S = src.ptr<T>(y);
+            const GT* G = guide.ptr<GT>(y);
+            T* D = dst.ptr<T>(y);
+            float fy = y*scaleSpace;
+            int gy = cvFloor(fy);
+            float wy = fy - gy;
+
+            for( int x = 0; x < src.cols; x++, S += cn, D += cn )
+            {
+                float fx = x*scaleSpace, fz = (G[x] - minColor)*scaleColor;
+                int gx = cvFloor(fx), gz = cvFloor(fz);
+                float wx = fx - gx, wz = fz - gz;
+                float w00 = (1 - wy)*(1 - wx), w01 = (1 - wy)*wx, w10 = wy*(1 - wx), w11 = wy*wx;
+                const float* C = grid.cell(gridIdx, gy, gx, gz);
+
+                for( int k = 0; k <= cn; k++ )
+                {
+                    const float* c = C + k;
+                    float s0 = c[0]*w00 + c[xstep]*w01 + c[ystep]*w10 + c[ystep + xstep]*w11;
+                    c += cstep;
+                    float s1 = c[0]*w00 + c[xstep]*w01 + c[ystep]*w10 + c[ystep + xstep]*w11;
+                    sum[k] = s0 + (s1 - s0)*wz;
+                }
+
+                // the weight includes the pixel itself, so it can only vanish due to the rounding errors
+                if( sum[cn] > FLT_EPSILON )
+                {
+                    float scale = 1.f/sum[cn];
+                    for( int k = 0; k < cn; k++ )
+                        D[k] = saturate_cast<T>(sum[k]*scale);
+                }
+                else
+                {
+                    for( int k = 0; k < cn; k++ )
+                        D[k] = S[k];
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    const Mat& guide;
+    Mat& dst;
+    BilateralGrid& grid;
+    int gridIdx;
+    float scaleSpace, scaleColor, minColor;
+
+    BilateralGridSliceInvoker& operator=(const BilateralGridSliceInvoker&); // = delete
+};
+
+template<typename T, typename GT> static void
+bilateralGridFilter_( const Mat& src, const Mat& guide, Mat& dst, double sigmaColor, double sigmaSpace )
+{
+    double minColor = 0, maxColor = 0;
+    minMaxIdx(guide, &minColor, &maxColor);
+    CV_Assert( cvIsInf(minColor) == 0 && cvIsInf(maxColor) == 0 &&
+               cvIsNaN(minColor) == 0 && cvIsNaN(maxColor) == 0 );
+
+    float scaleSpace = (float)(1./sigmaSpace), scaleColor = (float)(1./sigmaColor);
+    int ny = cvRound((src.rows - 1)*scaleSpace) + 1;
+    int nx = cvRound((src.cols - 1)*scaleSpace) + 1;
+    int nz = cvRound((maxColor - minColor)*scaleColor) + 1;
+    CV_Assert( (double)ny*nx*nz*(src.channels() + 1) < (double)INT_MAX );
+    BilateralGrid grid(ny, nx, nz, src.channels());
+
+    // the image rows, which are the nearest to every grid row
+    std::vector<int> rowOfs(ny + 1, src.rows);
+    for( int y = src.rows - 1; y >= 0; y-- )
+        rowOfs[cvRound(y*scaleSpace)] = y;
+
+    BilateralGridSplatInvoker<T, GT> splat(src, guide, grid, rowOfs, scaleSpace, scaleColor, (float)minColor);
+    parallel_for_(Range(0, ny), splat);
+
+    int gridIdx = 0;
+    for( int axis = 0; axis < 3; axis++, gridIdx ^= 1 )
+    {
+        BilateralGridBlurInvoker blur(grid, axis, gridIdx);
+        parallel_for_(Range(0, ny), blur);
+    }
+
+    BilateralGridSliceInvoker<T, GT> slice(src, guide, dst, grid, gridIdx, scaleSpace, scaleColor, (float)minColor);
+    parallel_for_(Range(0, src.rows), slice, src.total()/(double)(1 << 16));
+}
+
+} // namespace anon
+
+void bilateralGridFilter( InputArray _src, OutputArray _dst, double sigmaColor, double sigmaSpace,
+                          InputArray _guide )
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !_src.empty() );
+    CV_CheckGT(sigmaColor, 0., "");
+    CV_CheckGE(sigmaSpace, 1., "");
+
+    Mat src = _src.getMat(), guide;
+    int depth = src.depth(), cn = src.channels();
+    CV_CheckType(src.type(), (depth == CV_8U || depth == CV_32F) && cn <= 4, "");
+
+    // the source may be the same as the destination
+    _dst.create(src.size(), src.type());
+    Mat dst = _dst.getMat();
+    if( src.data == dst.data )
+        src = src.clone();
+
+    if( !_guide.empty() )
+    {
+        guide = _guide.getMat();
+        CV_CheckEQ(guide.channels(), 1, "");
+        CV_CheckDepth(guide.depth(), guide.depth() == CV_8U || guide.depth() == CV_32F, "");
+        CV_Assert( guide.size() == src.size() );
+    }
+    else if( cn == 1 )
+        guide = src;
+    else
+    {
+        CV_CheckGE(cn, 3, "the guide image is required for 2-channel images");
+        cvtColor(src, guide, cn == 3 ? COLOR_BGR2GRAY : COLOR_BGRA2GRAY);
+    }
+
+    if( guide.data == dst.data )
+        guide = guide.clone();
+
+    typedef void (*BilateralGridFunc)(const Mat& src, const Mat& guide, Mat& dst,
+                                      double sigmaColor, double sigmaSpace);
+    BilateralGridFunc func = 0;
+    if( depth == CV_8U )
+        func = guide.depth() == CV_8U ? bilateralGridFilter_<uchar, uchar> : bilateralGridFilter_<uchar, float>;
+    else
+        func = guide.depth() == CV_8U ? bilateralGridFilter_<float, uchar> : bilateralGridFilter_<float, float>;
+    func(src, guide, dst, sigmaColor, sigmaSpace);
+}
+
+} // namespace cv
@@ -5,6 +5,7 @@
 #include "precomp.hpp"
 #include "opencl_kernels_imgproc.hpp"
 #include "color.hpp"
+#include "resize.hpp"
 
 namespace cv
 {
@@ -355,6 +356,61 @@ void cvtColor( InputArray _src, OutputArray _dst, int code, int dcn )
             CV_Error( CV_StsBadFlag, "Unknown/unsupported color conversion code" );
     }
 }
+
+namespace impl {
+
+int cvtColorDstType(int srcType, int code)
+{
+    if( isYUV420(code) )
+        CV_Error( CV_StsBadArg, "The YUV 4:2:0 color conversions change the image size" );
+
+    // the size-preserving conversions check the source type themselves;
+    // the conversion tables are initialized once, so a tiny probe is cheap
+    Mat probe(2, 2, srcType, Scalar::all(0)), res;
+    cvtColor(probe, res, code);
+    CV_Assert( res.size() == probe.size() );
+    return res.type();
+}
+
+} // namespace impl
+
+void cvtColorBatch( InputArray _src, const std::vector<Rect>& rois, OutputArray _dst, int code,
+                    Size dsize, int interpolation, bool planar )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = _src.getMat();
+    CV_Assert( !src.empty() && src.dims <= 2 );
+    if( rois.empty() )
+    {
+        _dst.release();
+        return;
+    }
+
+    if( dsize.empty() )
+    {
+        dsize = rois[0].size();
+        for( size_t i = 1; i < rois.size(); i++ )
+            CV_Assert( rois[i].size() == dsize );
+    }
+    else if( isBayer(code) )
+        CV_Error( CV_StsBadArg, "Demosaicing of the resized regions is not supported" );
+
+    int dtype = cvtColorDstType(src.type(), code);
+    int n = (int)rois.size();
+    if( planar )
+    {
+        int sz[] = { n, CV_MAT_CN(dtype), dsize.height, dsize.width };
+        _dst.create(4, sz, CV_MAT_DEPTH(dtype));
+    }
+    else
+    {
+        int sz[] = { n, dsize.height, dsize.width };
+        _dst.create(3, sz, dtype);
+    }
+    Mat dst = _dst.getMat();
+    resizeBatchROIs(src, rois, dsize, interpolation, code, planar, dst);
+}
 } //namespace cv
 
 
@@ -1790,6 +1790,260 @@ cvFindContours( void*  img,  CvMemStorage*  storage,
     return cvFindContours_Impl(img, storage, firstContour, cntHeaderSize, mode, method, offset, 1);
 }
 
+/****************************************************************************************\
+*               Parallel retrieval of external contours and connected components         *
+\****************************************************************************************/
+
+/*
+   For RETR_EXTERNAL and RETR_CCOMP the border tree of Suzuki's algorithm is fully determined by
+   the connected components: every 8-connected component of non-zero pixels has exactly one outer
+   border, which starts at its first pixel in the raster order, and every 4-connected component of
+   zero pixels, except the one around the image, is a hole with exactly one border, which belongs
+   to the component to the left of its first pixel. So the components are labeled first (in
+   parallel), and then all the borders are traced independently, without marking the image, and
+   stored in the order of the sequential algorithm.
+*/
+namespace cv
+{
+
+struct ContourStart
+{
+    Point pt;           // first border pixel in the padded image
+    int parent;         // index of the outer border of a hole, -1 for the outer borders
+    bool isHole;
+};
+
+static void traceContourBorder( const uchar* ptr, int step, Point pt, bool isHole,
+                                int method, std::vector<Point>& points )
+{
+    int deltas[MAX_SIZE];
+    const uchar *i0 = ptr, *i1, *i3, *i4 = 0;
+    int prev_s = -1, s, s_end;
+
+    CV_INIT_3X3_DELTAS( deltas, step, 1 );
+    memcpy( deltas + 8, deltas, 8 * sizeof( deltas[0] ));
+
+    points.clear();
+    s_end = s = isHole ? 0 : 4;
+
+    do
+    {
+        s = (s - 1) & 7;
+        i1 = i0 + deltas[s];
+    }
+    while( *i1 == 0 && s != s_end );
+
+    if( s == s_end )            /* single pixel domain */
+    {
+        points.push_back(pt);
+        return;
+    }
+
+    i3 = i0;
+    prev_s = s ^ 4;
+
+    /* follow border, the same way as icvFetchContour does */
+    for( ;; )
+    {
+        s_end = s;
+        s = std::min(s, MAX_SIZE - 1);
+
+        while( s < MAX_SIZE - 1 )
+        {
+            i4 = i3 + deltas[++s];
+            if( *i4 != 0 )
+                break;
+        }
+        s &= 7;
+
+        if( s != prev_s || method == CV_CHAIN_APPROX_NONE )
+        {
+            points.push_back(pt);
+            prev_s = s;
+        }
+
+        pt.x += icvCodeDeltas[s].x;
+        pt.y += icvCodeDeltas[s].y;
+
+        if( i4 == i0 && i3 == i1 )
+            break;
+
+        i3 = i4;
+        s = (s + 4) & 7;
+    }
+}
+
+// position of the first pixel of every component in the raster order
+class ComponentStartInvoker : public ParallelLoopBody
+{
+public:
+    ComponentStartInvoker( const Mat& _labels, const Mat& _stats, std::vector<Point>& _starts )
+        : labels(_labels), stats(_stats), starts(_starts) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( int label = range.start; label < range.end; label++ )
+        {
+            const int* s = stats.ptr<int>(label);
+            int y = s[CC_STAT_TOP], x = s[CC_STAT_LEFT], x1 = x + s[CC_STAT_WIDTH];
+            const int* row = labels.ptr<int>(y);
+            while( x < x1 && row[x] != label )
+                x++;
+            CV_DbgAssert( x < x1 );
+            starts[label] = Point(x, y);
+        }
+    }
+
+private:
+    const Mat& labels;
+    const Mat& stats;
+    std::vector<Point>& starts;
+
+    ComponentStartInvoker& operator=(const ComponentStartInvoker&); // = delete
+};
+
+static int labelComponentStarts( const Mat& img, int connectivity, Mat& labels, std::vector<Point>& starts )
+{
+    Mat stats, centroids;
+    int n = connectedComponentsWithStats(img, labels, stats, centroids, connectivity, CV_32S);
+    starts.resize(n);
+    parallel_for_(Range(0, n), ComponentStartInvoker(labels, stats, starts), n/(double)(1 << 10));
+    return n;
+}
+
+class ContourTraceInvoker : public ParallelLoopBody
+{
+public:
+    ContourTraceInvoker( const Mat& _img, const std::vector<ContourStart>& _starts, int _method,
+                         Point _offset, const _OutputArray& _contours )
+        : img(_img), starts(_starts), method(_method), offset(_offset), contours(_contours) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        std::vector<Point> points;
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const ContourStart& cs = starts[i];
+            traceContourBorder(img.ptr(cs.pt.y, cs.pt.x), (int)img.step, cs.pt + offset,
+                               cs.isHole, method, points);
+            contours.create((int)points.size(), 1, CV_32SC2, i, true);
+            Mat ci = contours.getMat(i);
+            CV_Assert( ci.isContinuous() );
+            memcpy(ci.ptr(), &points[0], points.size()*sizeof(points[0]));
+        }
+    }
+
+private:
+    const Mat& img;
+    const std::vector<ContourStart>& starts;
+    int method;
+    Point offset;
+    const _OutputArray& contours;
+
+    ContourTraceInvoker& operator=(const ContourTraceInvoker&); // = delete
+};
+
+static bool isRasterBefore( const ContourStart& a, const ContourStart& b )
+{
+    return a.pt.y < b.pt.y || (a.pt.y == b.pt.y && a.pt.x < b.pt.x);
+}
+
+// img is the binary image with the 1-pixel zero border
+static void findContoursParallel( const Mat& img, OutputArrayOfArrays _contours, OutputArray _hierarchy,
+                                  int mode, int method, Point offset )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat fgLabels, bgLabels;
+    std::vector<Point> fgStarts, bgStarts;
+    int nfg = labelComponentStarts(img, 8, fgLabels, fgStarts);
+    int nbg = labelComponentStarts(img == 0, 4, bgLabels, bgStarts);
+    int outerBg = bgLabels.at<int>(0, 0);
+
+    // the outer borders and the holes, in the raster order of the sequential scan
+    std::vector<ContourStart> outer;
+    outer.reserve(nfg);
+    for( int label = 1; label < nfg; label++ )
+    {
+        Point pt = fgStarts[label];
+        if( mode == RETR_EXTERNAL && bgLabels.at<int>(pt.y, pt.x - 1) != outerBg )
+            continue;
+        ContourStart cs = { pt, -1, false };
+        outer.push_back(cs);
+    }
+    std::sort(outer.begin(), outer.end(), isRasterBefore);
+
+    std::vector<std::vector<ContourStart> > holes;
+    if( mode == RETR_CCOMP )
+    {
+        // the holes of every component; a hole border starts at the pixel before the first hole pixel
+        std::vector<int> outerIdx(nfg, -1);
+        for( size_t i = 0; i < outer.size(); i++ )
+            outerIdx[fgLabels.at<int>(outer[i].pt.y, outer[i].pt.x)] = (int)i;
+        holes.resize(outer.size());
+        for( int label = 1; label < nbg; label++ )
+        {
+            if( label == outerBg )
+                continue;
+            Point pt = bgStarts[label];
+            int parent = outerIdx[fgLabels.at<int>(pt.y, pt.x - 1)];
+            CV_DbgAssert( parent >= 0 );
+            ContourStart cs = { Point(pt.x - 1, pt.y), parent, true };
+            holes[parent].push_back(cs);
+        }
+        for( size_t i = 0; i < holes.size(); i++ )
+            std::sort(holes[i].begin(), holes[i].end(), isRasterBefore);
+    }
+
+    // the sequential algorithm prepends every new contour to the list of its siblings,
+    // and the tree is output depth-first
+    std::vector<ContourStart> starts;
+    std::vector<Vec4i> hierarchy;
+    int total = (int)outer.size();
+    for( size_t i = 0; i < holes.size(); i++ )
+        total += (int)holes[i].size();
+    starts.reserve(total);
+    hierarchy.reserve(total);
+
+    int prevOuter = -1;
+    for( int i = (int)outer.size() - 1; i >= 0; i-- )
+    {
+        int idx = (int)starts.size();
+        starts.push_back(outer[i]);
+        hierarchy.push_back(Vec4i(-1, prevOuter, -1, -1));
+        if( prevOuter >= 0 )
+            hierarchy[prevOuter][0] = idx;
+        prevOuter = idx;
+
+        if( !holes.empty() && !holes[i].empty() )
+        {
+            const std::vector<ContourStart>& h = holes[i];
+            hierarchy[idx][2] = idx + 1;
+            for( int j = (int)h.size() - 1; j >= 0; j-- )
+            {
+                int hidx = (int)starts.size();
+                starts.push_back(h[j]);
+                hierarchy.push_back(Vec4i(j > 0 ? hidx + 1 : -1, hidx > idx + 1 ? hidx - 1 : -1, -1, idx));
+            }
+        }
+    }
+
+    if( total == 0 )
+    {
+        _contours.clear();
+        return;
+    }
+
+    _contours.create(total, 1, 0, -1, true);
+    parallel_for_(Range(0, total), ContourTraceInvoker(img, starts, method, offset, _contours),
+                  total/(double)(1 << 6));
+
+    if( _hierarchy.needed() )
+        Mat(hierarchy).reshape(4, 1).copyTo(_hierarchy);
+}
+
+}
+
 void cv::findContours( InputArray _image, OutputArrayOfArrays _contours,
                    OutputArray _hierarchy, int mode, int method, Point offset )
 {
@@ -1812,6 +2066,16 @@ void cv::findContours( InputArray _image, OutputArrayOfArrays _contours,
     {
         image = image0;
     }
+
+    if( image0.type() == CV_8UC1 && (mode == RETR_EXTERNAL || mode == RETR_CCOMP) &&
+        (method == CHAIN_APPROX_NONE || method == CHAIN_APPROX_SIMPLE) )
+    {
+        if( _hierarchy.needed() )
+            _hierarchy.clear();
+        threshold(image, image, 0, 1, THRESH_BINARY);
+        findContoursParallel(image, _contours, _hierarchy, mode, method, offset0 + offset);
+        return;
+    }
     MemStorage storage(cvCreateMemStorage());
     CvMat _cimage = cvMat(image);
     CvSeq* _ccontours = 0;
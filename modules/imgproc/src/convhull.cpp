@@ -132,37 +132,15 @@ struct CHullCmpPoints
 };
 
 
-void convexHull( InputArray _points, OutputArray _hull, bool clockwise, bool returnPoints )
+int convexHullIndices( const Point* data0, int total, bool is_float, bool clockwise,
+                       Point** pointer, int* stack, int* hullbuf )
 {
-    CV_INSTRUMENT_REGION();
-
-    CV_Assert(_points.getObj() != _hull.getObj());
-    Mat points = _points.getMat();
-    int i, total = points.checkVector(2), depth = points.depth(), nout = 0;
+    int i, nout = 0;
     int miny_ind = 0, maxy_ind = 0;
-    CV_Assert(total >= 0 && (depth == CV_32F || depth == CV_32S));
-
-    if( total == 0 )
-    {
-        _hull.release();
-        return;
-    }
-
-    returnPoints = !_hull.fixedType() ? returnPoints : _hull.type() != CV_32S;
-
-    bool is_float = depth == CV_32F;
-    AutoBuffer<Point*> _pointer(total);
-    AutoBuffer<int> _stack(total + 2), _hullbuf(total);
-    Point** pointer = _pointer.data();
     Point2f** pointerf = (Point2f**)pointer;
-    Point* data0 = points.ptr<Point>();
-    int* stack = _stack.data();
-    int* hullbuf = _hullbuf.data();
-
-    CV_Assert(points.isContinuous());
 
     for( i = 0; i < total; i++ )
-        pointer[i] = &data0[i];
+        pointer[i] = (Point*)&data0[i];
 
     // sort the point set by x-coordinate, find min and max y
     if( !is_float )
@@ -297,6 +275,37 @@ void convexHull( InputArray _points, OutputArray _hull, bool clockwise, bool ret
         }
     }
 
+    return nout;
+}
+
+
+void convexHull( InputArray _points, OutputArray _hull, bool clockwise, bool returnPoints )
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert(_points.getObj() != _hull.getObj());
+    Mat points = _points.getMat();
+    int i, total = points.checkVector(2), depth = points.depth(), nout = 0;
+    CV_Assert(total >= 0 && (depth == CV_32F || depth == CV_32S));
+
+    if( total == 0 )
+    {
+        _hull.release();
+        return;
+    }
+
+    returnPoints = !_hull.fixedType() ? returnPoints : _hull.type() != CV_32S;
+
+    bool is_float = depth == CV_32F;
+    AutoBuffer<Point*> _pointer(total);
+    AutoBuffer<int> _stack(total + 2), _hullbuf(total);
+    Point* data0 = points.ptr<Point>();
+    int* hullbuf = _hullbuf.data();
+
+    CV_Assert(points.isContinuous());
+
+    nout = convexHullIndices(data0, total, is_float, clockwise, _pointer.data(), _stack.data(), hullbuf);
+
     if( !returnPoints )
         Mat(nout, 1, CV_32S, hullbuf).copyTo(_hull);
     else
@@ -310,6 +319,52 @@ void convexHull( InputArray _points, OutputArray _hull, bool clockwise, bool ret
 }
 
 
+void convexHullBatch( InputArray _points, InputArray _offsets, OutputArray _hullPoints,
+                      OutputArray _hullOffsets, bool clockwise )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat points = _points.getMat(), offsets = _offsets.getMat();
+    int ncontours = checkContourBatch(points, offsets);
+    const int* ofs = offsets.ptr<int>();
+    const Point* data = points.ptr<Point>();
+    bool is_float = points.depth() == CV_32F;
+
+    // the hull of each contour is stored in place of the contour, then the hulls are packed
+    std::vector<int> hullbuf(points.total()), counts(ncontours);
+    parallel_for_(Range(0, ncontours), [&](const Range& r)
+    {
+        std::vector<Point*> pointer;
+        std::vector<int> stack;
+        for( int i = r.start; i < r.end; i++ )
+        {
+            int n = ofs[i+1] - ofs[i];
+            counts[i] = 0;
+            if( n == 0 )
+                continue;
+            if( (int)pointer.size() < n )
+            {
+                pointer.resize(n);
+                stack.resize(n + 2);
+            }
+            counts[i] = convexHullIndices(data + ofs[i], n, is_float, clockwise,
+                                          &pointer[0], &stack[0], &hullbuf[ofs[i]]);
+        }
+    }, contourBatchStripes(points, ncontours));
+
+    _hullOffsets.create(ncontours + 1, 1, CV_32S);
+    int* hofs = _hullOffsets.getMat().ptr<int>();
+    hofs[0] = 0;
+    for( int i = 0; i < ncontours; i++ )
+        hofs[i+1] = hofs[i] + counts[i];
+
+    _hullPoints.create(hofs[ncontours], 1, CV_MAKETYPE(points.depth(), 2));
+    Point* hull = _hullPoints.getMat().ptr<Point>();
+    for( int i = 0; i < ncontours; i++ )
+        for( int j = 0; j < counts[i]; j++ )
+            hull[hofs[i] + j] = data[ofs[i] + hullbuf[ofs[i] + j]];
+}
+
 void convexityDefects( InputArray _points, InputArray _hull, OutputArray _defects )
 {
     CV_INSTRUMENT_REGION();
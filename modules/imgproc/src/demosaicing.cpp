@@ -1674,6 +1674,182 @@ static void Bayer2RGB_EdgeAware_T(const Mat& src, Mat& dst, int code)
             firstRow[x] = lastRow[x] = 0;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+//                               Fused raw frame processing                             //
+//////////////////////////////////////////////////////////////////////////////////////////
+
+// Unpacks the row of 12-bit samples stored as 2 pixels in 3 bytes
+static void unpackRaw12Row( const uchar* src, ushort* dst, int width, int packing )
+{
+    if( packing == RAW_PACKED_12_MIPI )
+        for( int x = 0; x < width; x += 2, src += 3 )
+        {
+            dst[x] = (ushort)((src[0] << 4) | (src[2] & 15));
+            dst[x+1] = (ushort)((src[1] << 4) | (src[2] >> 4));
+        }
+    else
+        for( int x = 0; x < width; x += 2, src += 3 )
+        {
+            dst[x] = (ushort)(src[0] | ((src[1] & 15) << 8));
+            dst[x+1] = (ushort)((src[1] >> 4) | (src[2] << 4));
+        }
+}
+
+#if CV_SIMD
+static inline void rawColorTransformBlock( const v_uint32& b, const v_uint32& g, const v_uint32& r,
+                                           int* dst, const float* m, const v_float32& vmax )
+{
+    v_float32 fb = v_cvt_f32(v_reinterpret_as_s32(b));
+    v_float32 fg = v_cvt_f32(v_reinterpret_as_s32(g));
+    v_float32 fr = v_cvt_f32(v_reinterpret_as_s32(r));
+    v_float32 z = vx_setzero_f32();
+    v_int32 o[3];
+    for( int k = 0; k < 3; k++ )
+    {
+        v_float32 v = v_fma(fb, vx_setall_f32(m[k*3]),
+                            v_fma(fg, vx_setall_f32(m[k*3+1]), fr*vx_setall_f32(m[k*3+2])));
+        o[k] = v_round(v_min(v_max(v, z), vmax));
+    }
+    v_store_interleave(dst, o[0], o[1], o[2]);
+}
+
+static int rawColorTransform_SIMD( const uchar* src, int* dst, int width, const float* m, float maxval )
+{
+    v_float32 vmax = vx_setall_f32(maxval);
+    const int n = v_uint32::nlanes;
+    int x = 0;
+    for( ; x <= width - v_uint8::nlanes; x += v_uint8::nlanes )
+    {
+        v_uint8 b, g, r;
+        v_load_deinterleave(src + x*3, b, g, r);
+        v_uint16 b0, b1, g0, g1, r0, r1;
+        v_expand(b, b0, b1); v_expand(g, g0, g1); v_expand(r, r0, r1);
+        v_uint32 b00, b01, g00, g01, r00, r01;
+        v_expand(b0, b00, b01); v_expand(g0, g00, g01); v_expand(r0, r00, r01);
+        rawColorTransformBlock(b00, g00, r00, dst + x*3, m, vmax);
+        rawColorTransformBlock(b01, g01, r01, dst + (x + n)*3, m, vmax);
+        v_expand(b1, b00, b01); v_expand(g1, g00, g01); v_expand(r1, r00, r01);
+        rawColorTransformBlock(b00, g00, r00, dst + (x + n*2)*3, m, vmax);
+        rawColorTransformBlock(b01, g01, r01, dst + (x + n*3)*3, m, vmax);
+    }
+    vx_cleanup();
+    return x;
+}
+
+static int rawColorTransform_SIMD( const ushort* src, int* dst, int width, const float* m, float maxval )
+{
+    v_float32 vmax = vx_setall_f32(maxval);
+    int x = 0;
+    for( ; x <= width - v_uint16::nlanes; x += v_uint16::nlanes )
+    {
+        v_uint16 b, g, r;
+        v_load_deinterleave(src + x*3, b, g, r);
+        v_uint32 b0, b1, g0, g1, r0, r1;
+        v_expand(b, b0, b1); v_expand(g, g0, g1); v_expand(r, r0, r1);
+        rawColorTransformBlock(b0, g0, r0, dst + x*3, m, vmax);
+        rawColorTransformBlock(b1, g1, r1, dst + (x + v_uint32::nlanes)*3, m, vmax);
+    }
+    vx_cleanup();
+    return x;
+}
+#endif
+
+// Applies the color matrix to the row of BGR pixels, then rounds and clips the values to [0, maxval]
+template<typename T>
+static void rawColorTransformRow( const T* src, int* dst, int width, const float* m, float maxval )
+{
+    int x = 0;
+#if CV_SIMD
+    x = rawColorTransform_SIMD(src, dst, width, m, maxval);
+#endif
+    for( ; x < width; x++ )
+    {
+        float b = src[x*3], g = src[x*3+1], r = src[x*3+2];
+        for( int k = 0; k < 3; k++ )
+            dst[x*3+k] = cvRound(std::min(std::max(m[k*3]*b + (m[k*3+1]*g + m[k*3+2]*r), 0.f), maxval));
+    }
+}
+
+template<typename DT>
+static void rawApplyLUTRow( const int* src, DT* dst, int n, const DT* lut )
+{
+    if( lut )
+        for( int i = 0; i < n; i++ )
+            dst[i] = lut[src[i]];
+    else
+        for( int i = 0; i < n; i++ )
+            dst[i] = (DT)src[i];
+}
+
+// Processes the frame in the horizontal stripes: unpacks the raw rows with the halo needed by the
+// interpolation, demosaics them into the buffer, then applies the color matrix and the LUT
+// to the buffered rows while they are in the cache
+template <typename T, typename SIMDInterpolator>
+class DemosaicingRaw_Invoker :
+    public cv::ParallelLoopBody
+{
+public:
+    DemosaicingRaw_Invoker(const Mat& _src, Mat& _dst, int _code, int _packing, const Matx33f& _m,
+                           int _maxval, const Mat& _lut, int _stripe) :
+        ParallelLoopBody(),
+        src(_src), dst(_dst), code(_code), packing(_packing), m(_m), maxval(_maxval), lut(_lut), stripe(_stripe)
+    {
+    }
+
+    virtual void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int width = dst.cols, height = dst.rows;
+        bool edgeAware = code == COLOR_BayerBG2BGR_EA || code == COLOR_BayerGB2BGR_EA ||
+                         code == COLOR_BayerRG2BGR_EA || code == COLOR_BayerGR2BGR_EA;
+        Mat rawbuf, bgr;
+        std::vector<int> idx(width*3);
+
+        for (int s = range.start; s < range.end; ++s)
+        {
+            // the buffer starts at the even row to keep the Bayer pattern
+            int y0 = s*stripe, y1 = std::min(y0 + stripe, height);
+            int b0 = std::max(y0 - 2, 0), b1 = std::min(y1 + 1, height);
+
+            Mat raw;
+            if (packing != RAW_UNPACKED)
+            {
+                rawbuf.create(b1 - b0, width, CV_16UC1);
+                for (int y = b0; y < b1; ++y)
+                    unpackRaw12Row(src.ptr(y), rawbuf.ptr<ushort>(y - b0), width, packing);
+                raw = rawbuf;
+            }
+            else
+                raw = src.rowRange(b0, b1);
+
+            bgr.create(b1 - b0, width, CV_MAKETYPE(DataType<T>::depth, 3));
+            if (edgeAware)
+                Bayer2RGB_EdgeAware_T<T, SIMDInterpolator>(raw, bgr, code);
+            else
+                Bayer2RGB_<T, SIMDInterpolator>(raw, bgr, code);
+
+            for (int y = y0; y < y1; ++y)
+            {
+                rawColorTransformRow(bgr.ptr<T>(y - b0), &idx[0], width, m.val, (float)maxval);
+                if (dst.depth() == CV_8U)
+                    rawApplyLUTRow(&idx[0], dst.ptr<uchar>(y), width*3, lut.empty() ? 0 : lut.ptr<uchar>());
+                else
+                    rawApplyLUTRow(&idx[0], dst.ptr<ushort>(y), width*3, lut.empty() ? 0 : lut.ptr<ushort>());
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    int code, packing;
+    Matx33f m;
+    int maxval;
+    const Mat& lut;
+    int stripe;
+
+    DemosaicingRaw_Invoker& operator=(const DemosaicingRaw_Invoker&); // = delete
+};
+
 } // end namespace cv
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1764,3 +1940,75 @@ void cv::demosaicing(InputArray _src, OutputArray _dst, int code, int dcn)
         CV_Error( CV_StsBadFlag, "Unknown / unsupported color conversion code" );
     }
 }
+
+void cv::demosaicingRaw(InputArray _src, OutputArray _dst, int code, const Scalar& wbGains,
+                        InputArray _ccm, InputArray _lut, int bitDepth, int packing)
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = _src.getMat(), lut = _lut.getMat();
+    CV_Assert(!src.empty() && src.channels() == 1);
+
+    switch (code)
+    {
+    case COLOR_BayerBG2BGR: case COLOR_BayerGB2BGR: case COLOR_BayerRG2BGR: case COLOR_BayerGR2BGR:
+    case COLOR_BayerBG2BGR_EA: case COLOR_BayerGB2BGR_EA: case COLOR_BayerRG2BGR_EA: case COLOR_BayerGR2BGR_EA:
+        break;
+    default:
+        CV_Error( CV_StsBadFlag, "Only the bilinear and the edge-aware Bayer->BGR conversions are supported" );
+    }
+
+    Size sz = src.size();
+    int depth = src.depth();
+    if (packing == RAW_PACKED_12_MIPI || packing == RAW_PACKED_12_LSB)
+    {
+        CV_Assert(depth == CV_8U && sz.width % 3 == 0);
+        sz.width = sz.width/3*2;
+        depth = CV_16U;
+        if (bitDepth <= 0)
+            bitDepth = 12;
+        CV_Assert(bitDepth <= 12);
+    }
+    else if (packing == RAW_UNPACKED)
+    {
+        CV_Assert(depth == CV_8U || depth == CV_16U);
+        if (bitDepth <= 0)
+            bitDepth = depth == CV_8U ? 8 : 16;
+        CV_Assert(bitDepth <= (depth == CV_8U ? 8 : 16));
+    }
+    else
+        CV_Error(CV_StsBadArg, "Unknown raw packing");
+    int maxval = (1 << bitDepth) - 1;
+
+    // the white balance gains applied to the demosaiced pixels are merged into the color matrix
+    Matx33f m = Matx33f::eye();
+    if (!_ccm.empty())
+    {
+        Mat ccm = _ccm.getMat();
+        CV_Assert(ccm.total() == 9 && ccm.channels() == 1);
+        ccm.reshape(1, 3).convertTo(m, CV_32F);
+    }
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            m(i, j) *= (float)wbGains[j];
+
+    int ddepth = depth;
+    if (!lut.empty())
+    {
+        ddepth = lut.depth();
+        CV_Assert((ddepth == CV_8U || ddepth == CV_16U) && lut.channels() == 1 && lut.isContinuous());
+        CV_Assert(lut.total() == (size_t)maxval + 1);
+    }
+
+    _dst.create(sz, CV_MAKETYPE(ddepth, 3));
+    Mat dst = _dst.getMat();
+
+    const int stripe = 32;
+    int nstripes = (sz.height + stripe - 1)/stripe;
+    if (depth == CV_8U)
+        parallel_for_(Range(0, nstripes), DemosaicingRaw_Invoker<uchar, SIMDBayerInterpolator_8u>(
+                      src, dst, code, packing, m, maxval, lut, stripe));
+    else
+        parallel_for_(Range(0, nstripes), DemosaicingRaw_Invoker<ushort, SIMDBayerStubInterpolator_<ushort> >(
+                      src, dst, code, packing, m, maxval, lut, stripe));
+}
@@ -40,6 +40,7 @@
 //
 //M*/
 #include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 namespace cv
 {
@@ -49,8 +50,13 @@ static const int INIT_DIST0 = INT_MAX;
 static const int DIST_MAX   = (INT_MAX >> 2);
 #define  CV_FLT_TO_FIX(x,n)  cvRound((x)*(1<<(n)))
 
+// the chamfer distance transform is done by tiles, so that the tiles of one diagonal wave are processed
+// in parallel; the small images are processed as a single tile
+static const int DIST_TILE_WIDTH = 128;
+static const int DIST_TILE_HEIGHT = 64;
+
 static void
-initTopBottom( Mat& temp, int border )
+initTempBorders( Mat& temp, int border )
 {
     Size size = temp.size();
     for( int i = 0; i < border; i++ )
@@ -64,11 +70,19 @@ initTopBottom( Mat& temp, int border )
             tbottom[j] = INIT_DIST0;
         }
     }
+
+    for( int i = border; i < size.height - border; i++ )
+    {
+        int* tmp = temp.ptr<int>(i);
+        for( int j = 0; j < border; j++ )
+            tmp[j] = tmp[size.width - j - 1] = INIT_DIST0;
+    }
 }
 
 
 static void
-distanceTransform_3x3( const Mat& _src, Mat& _temp, Mat& _dist, const float* metrics )
+distanceTransform_3x3( const Mat& _src, Mat& _temp, Mat& _dist, Mat& /*_labels*/, const float* metrics,
+                       const Rect& tile, int skew, bool forward )
 {
     const int BORDER = 1;
     int i, j;
@@ -82,20 +96,15 @@ distanceTransform_3x3( const Mat& _src, Mat& _temp, Mat& _dist, const float* met
     int srcstep = (int)(_src.step/sizeof(src[0]));
     int step = (int)(_temp.step/sizeof(temp[0]));
     int dststep = (int)(_dist.step/sizeof(dist[0]));
-    Size size = _src.size();
-
-    initTopBottom( _temp, BORDER );
 
     // forward pass
-    for( i = 0; i < size.height; i++ )
+    for( i = tile.y; forward && i < tile.y + tile.height; i++ )
     {
         const uchar* s = src + i*srcstep;
         unsigned int* tmp = (unsigned int*)(temp + (i+BORDER)*step) + BORDER;
 
-        for( j = 0; j < BORDER; j++ )
-            tmp[-j-1] = tmp[size.width + j] = INIT_DIST0;
-
-        for( j = 0; j < size.width; j++ )
+        int j0 = std::max(tile.x - skew*i, 0), j1 = std::min(tile.x + tile.width - skew*i, _src.cols);
+        for( j = j0; j < j1; j++ )
         {
             if( !s[j] )
                 tmp[j] = 0;
@@ -114,12 +123,13 @@ distanceTransform_3x3( const Mat& _src, Mat& _temp, Mat& _dist, const float* met
     }
 
     // backward pass
-    for( i = size.height - 1; i >= 0; i-- )
+    for( i = tile.y + tile.height - 1; !forward && i >= tile.y; i-- )
     {
         float* d = (float*)(dist + i*dststep);
         unsigned int* tmp = (unsigned int*)(temp + (i+BORDER)*step) + BORDER;
 
-        for( j = size.width - 1; j >= 0; j-- )
+        int j0 = std::max(tile.x - skew*i, 0), j1 = std::min(tile.x + tile.width - skew*i, _src.cols);
+        for( j = j1 - 1; j >= j0; j-- )
         {
             unsigned int t0 = tmp[j];
             if( t0 > HV_DIST )
@@ -142,7 +152,8 @@ distanceTransform_3x3( const Mat& _src, Mat& _temp, Mat& _dist, const float* met
 
 
 static void
-distanceTransform_5x5( const Mat& _src, Mat& _temp, Mat& _dist, const float* metrics )
+distanceTransform_5x5( const Mat& _src, Mat& _temp, Mat& _dist, Mat& /*_labels*/, const float* metrics,
+                       const Rect& tile, int skew, bool forward )
 {
     const int BORDER = 2;
     int i, j;
@@ -157,20 +168,15 @@ distanceTransform_5x5( const Mat& _src, Mat& _temp, Mat& _dist, const float* met
     int srcstep = (int)(_src.step/sizeof(src[0]));
     int step = (int)(_temp.step/sizeof(temp[0]));
     int dststep = (int)(_dist.step/sizeof(dist[0]));
-    Size size = _src.size();
-
-    initTopBottom( _temp, BORDER );
 
     // forward pass
-    for( i = 0; i < size.height; i++ )
+    for( i = tile.y; forward && i < tile.y + tile.height; i++ )
     {
         const uchar* s = src + i*srcstep;
         unsigned int* tmp = (unsigned int*)(temp + (i+BORDER)*step) + BORDER;
 
-        for( j = 0; j < BORDER; j++ )
-            tmp[-j-1] = tmp[size.width + j] = INIT_DIST0;
-
-        for( j = 0; j < size.width; j++ )
+        int j0 = std::max(tile.x - skew*i, 0), j1 = std::min(tile.x + tile.width - skew*i, _src.cols);
+        for( j = j0; j < j1; j++ )
         {
             if( !s[j] )
                 tmp[j] = 0;
@@ -197,12 +203,13 @@ distanceTransform_5x5( const Mat& _src, Mat& _temp, Mat& _dist, const float* met
     }
 
     // backward pass
-    for( i = size.height - 1; i >= 0; i-- )
+    for( i = tile.y + tile.height - 1; !forward && i >= tile.y; i-- )
     {
         float* d = (float*)(dist + i*dststep);
         unsigned int* tmp = (unsigned int*)(temp + (i+BORDER)*step) + BORDER;
 
-        for( j = size.width - 1; j >= 0; j-- )
+        int j0 = std::max(tile.x - skew*i, 0), j1 = std::min(tile.x + tile.width - skew*i, _src.cols);
+        for( j = j1 - 1; j >= j0; j-- )
         {
             unsigned int t0 = tmp[j];
             if( t0 > HV_DIST )
@@ -233,7 +240,8 @@ distanceTransform_5x5( const Mat& _src, Mat& _temp, Mat& _dist, const float* met
 
 
 static void
-distanceTransformEx_5x5( const Mat& _src, Mat& _temp, Mat& _dist, Mat& _labels, const float* metrics )
+distanceTransformEx_5x5( const Mat& _src, Mat& _temp, Mat& _dist, Mat& _labels, const float* metrics,
+                         const Rect& tile, int skew, bool forward )
 {
     const int BORDER = 2;
 
@@ -251,21 +259,16 @@ distanceTransformEx_5x5( const Mat& _src, Mat& _temp, Mat& _dist, Mat& _labels,
     int step = (int)(_temp.step/sizeof(temp[0]));
     int dststep = (int)(_dist.step/sizeof(dist[0]));
     int lstep = (int)(_labels.step/sizeof(labels[0]));
-    Size size = _src.size();
-
-    initTopBottom( _temp, BORDER );
 
     // forward pass
-    for( i = 0; i < size.height; i++ )
+    for( i = tile.y; forward && i < tile.y + tile.height; i++ )
     {
         const uchar* s = src + i*srcstep;
         unsigned int* tmp = (unsigned int*)(temp + (i+BORDER)*step) + BORDER;
         int* lls = (int*)(labels + i*lstep);
 
-        for( j = 0; j < BORDER; j++ )
-            tmp[-j-1] = tmp[size.width + j] = INIT_DIST0;
-
-        for( j = 0; j < size.width; j++ )
+        int j0 = std::max(tile.x - skew*i, 0), j1 = std::min(tile.x + tile.width - skew*i, _src.cols);
+        for( j = j0; j < j1; j++ )
         {
             if( !s[j] )
             {
@@ -333,13 +336,14 @@ distanceTransformEx_5x5( const Mat& _src, Mat& _temp, Mat& _dist, Mat& _labels,
     }
 
     // backward pass
-    for( i = size.height - 1; i >= 0; i-- )
+    for( i = tile.y + tile.height - 1; !forward && i >= tile.y; i-- )
     {
         float* d = (float*)(dist + i*dststep);
         unsigned int* tmp = (unsigned int*)(temp + (i+BORDER)*step) + BORDER;
         int* lls = (int*)(labels + i*lstep);
 
-        for( j = size.width - 1; j >= 0; j-- )
+        int j0 = std::max(tile.x - skew*i, 0), j1 = std::min(tile.x + tile.width - skew*i, _src.cols);
+        for( j = j1 - 1; j >= j0; j-- )
         {
             unsigned int t0 = tmp[j];
             int l0 = lls[j];
@@ -403,6 +407,85 @@ distanceTransformEx_5x5( const Mat& _src, Mat& _temp, Mat& _dist, Mat& _labels,
 }
 
 
+typedef void (*DistanceTransformFunc)( const Mat& _src, Mat& _temp, Mat& _dist, Mat& _labels,
+                                       const float* metrics, const Rect& tile, int skew, bool forward );
+
+// processes the tiles of one wave. The row i of the tile (tx, ty) consists of the pixels
+// tx*w - skew*i <= x < (tx+1)*w - skew*i, where skew is the radius of the mask, so the forward pass
+// of the tile depends only on the tiles (tx-1, ty), (tx-1, ty-1) and (tx, ty-1), and all the tiles
+// with the same tx + ty are independent. The backward pass goes in the opposite direction.
+struct DTChamferWaveInvoker : ParallelLoopBody
+{
+    DTChamferWaveInvoker( DistanceTransformFunc _func, const Mat* _src, Mat* _temp, Mat* _dist, Mat* _labels,
+                          const float* _metrics, Size _tileSize, int _ntx, int _nty, int _skew,
+                          int _wave, bool _forward )
+    {
+        func = _func;
+        src = _src;
+        temp = _temp;
+        dist = _dist;
+        labels = _labels;
+        metrics = _metrics;
+        tileSize = _tileSize;
+        ntx = _ntx;
+        nty = _nty;
+        skew = _skew;
+        wave = _wave;
+        forward = _forward;
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        for( int k = range.start; k < range.end; k++ )
+        {
+            int ty = k, tx = wave - k;
+            if( !forward )
+                ty = nty - 1 - ty, tx = ntx - 1 - tx;
+            int y = ty*tileSize.height;
+            Rect tile(tx*tileSize.width, y, tileSize.width, std::min(tileSize.height, src->rows - y));
+            func( *src, *temp, *dist, *labels, metrics, tile, skew, forward );
+        }
+    }
+
+    DistanceTransformFunc func;
+    const Mat* src;
+    Mat* temp;
+    Mat* dist;
+    Mat* labels;
+    const float* metrics;
+    Size tileSize;
+    int ntx, nty, skew;
+    int wave;
+    bool forward;
+};
+
+static void
+distanceTransformChamfer( DistanceTransformFunc func, const Mat& src, Mat& temp, Mat& dist, Mat& labels,
+                          const float* metrics, int border )
+{
+    Size size = src.size(), tileSize = size;
+    int skew = 0;
+    initTempBorders( temp, border );
+
+    if( getNumThreads() > 1 && size.area() >= (1 << 16) )
+    {
+        tileSize = Size(DIST_TILE_WIDTH, std::min(DIST_TILE_HEIGHT, size.height));
+        skew = border;
+    }
+    int ntx = (size.width + skew*(size.height - 1) + tileSize.width - 1)/tileSize.width;
+    int nty = (size.height + tileSize.height - 1)/tileSize.height;
+
+    for( int pass = 0; pass < 2; pass++ )
+    {
+        for( int wave = 0; wave < ntx + nty - 1; wave++ )
+        {
+            DTChamferWaveInvoker invoker(func, &src, &temp, &dist, &labels, metrics,
+                                         tileSize, ntx, nty, skew, wave, pass == 0);
+            parallel_for_(Range(std::max(wave - ntx + 1, 0), std::min(wave + 1, nty)), invoker);
+        }
+    }
+}
+
 static void getDistanceTransformMask( int maskType, float *metrics )
 {
     CV_Assert( metrics != 0 );
@@ -446,59 +529,138 @@ static void getDistanceTransformMask( int maskType, float *metrics )
     }
 }
 
+// computes the squared distance to the nearest zero pixel in the same column and its label;
+// the columns are processed by blocks, row by row
 struct DTColumnInvoker : ParallelLoopBody
 {
-    DTColumnInvoker( const Mat* _src, Mat* _dst, const int* _sat_tab, const float* _sqr_tab)
+    DTColumnInvoker( const Mat* _src, Mat* _dst, const Mat* _siteLabels, Mat* _colLabels )
     {
         src = _src;
         dst = _dst;
-        sat_tab = _sat_tab + src->rows*2 + 1;
-        sqr_tab = _sqr_tab;
+        siteLabels = _siteLabels;
+        colLabels = _colLabels;
     }
 
     void operator()(const Range& range) const CV_OVERRIDE
     {
-        int i, i1 = range.start, i2 = range.end;
+        const int BLOCK_SIZE = 256;
+        const float inf = 1e15f;
         int m = src->rows;
-        size_t sstep = src->step, dstep = dst->step/sizeof(float);
-        AutoBuffer<int> _d(m);
-        int* d = _d.data();
+        bool need_labels = colLabels != 0;
+        AutoBuffer<int> _buf(BLOCK_SIZE*2);
+        int *d = _buf.data(), *l = d + BLOCK_SIZE;
 
-        for( i = i1; i < i2; i++ )
+        for( int x0 = range.start; x0 < range.end; x0 += BLOCK_SIZE )
         {
-            const uchar* sptr = src->ptr(m-1) + i;
-            float* dptr = dst->ptr<float>() + i;
-            int j, dist = m-1;
+            int i, j, n = std::min(BLOCK_SIZE, range.end - x0);
 
-            for( j = m-1; j >= 0; j--, sptr -= sstep )
+            // the distance to the nearest zero pixel below, it's stored in dst temporarily
+            for( i = 0; i < n; i++ )
+                d[i] = m, l[i] = 0;
+            for( j = m - 1; j >= 0; j-- )
             {
-                dist = (dist + 1) & (sptr[0] == 0 ? 0 : -1);
-                d[j] = dist;
+                const uchar* sptr = src->ptr(j) + x0;
+                int* dptr = dst->ptr<int>(j) + x0;
+                i = 0;
+#if CV_SIMD
+                if( !need_labels )
+                {
+                    v_int32 v_one = vx_setall_s32(1), v_zero = vx_setzero_s32();
+                    for( ; i <= n - v_int32::nlanes; i += v_int32::nlanes )
+                    {
+                        v_int32 v_s = v_reinterpret_as_s32(vx_load_expand_q(sptr + i));
+                        v_int32 v_d = v_select(v_s == v_zero, v_zero, vx_load(d + i) + v_one);
+                        v_store(d + i, v_d);
+                        v_store(dptr + i, v_d);
+                    }
+                }
+#endif
+                for( ; i < n; i++ )
+                {
+                    d[i] = sptr[i] == 0 ? 0 : d[i] + 1;
+                    dptr[i] = d[i];
+                }
+                if( need_labels )
+                {
+                    const int* sl = siteLabels->ptr<int>(j) + x0;
+                    int* lptr = colLabels->ptr<int>(j) + x0;
+                    for( i = 0; i < n; i++ )
+                    {
+                        if( sptr[i] == 0 )
+                            l[i] = sl[i];
+                        lptr[i] = l[i];
+                    }
+                }
             }
 
-            dist = m-1;
-            for( j = 0; j < m; j++, dptr += dstep )
+            // the distance to the nearest zero pixel above, the minimum is squared
+            for( i = 0; i < n; i++ )
+                d[i] = m, l[i] = 0;
+            for( j = 0; j < m; j++ )
             {
-                dist = dist + 1 - sat_tab[dist - d[j]];
-                d[j] = dist;
-                dptr[0] = sqr_tab[dist];
+                const uchar* sptr = src->ptr(j) + x0;
+                float* dptr = dst->ptr<float>(j) + x0;
+                const int* iptr = (const int*)dptr;
+                i = 0;
+#if CV_SIMD
+                if( !need_labels )
+                {
+                    v_int32 v_one = vx_setall_s32(1), v_zero = vx_setzero_s32(), v_m = vx_setall_s32(m);
+                    v_float32 v_inf = vx_setall_f32(inf);
+                    for( ; i <= n - v_int32::nlanes; i += v_int32::nlanes )
+                    {
+                        v_int32 v_s = v_reinterpret_as_s32(vx_load_expand_q(sptr + i));
+                        v_int32 v_d = v_select(v_s == v_zero, v_zero, vx_load(d + i) + v_one);
+                        v_store(d + i, v_d);
+                        v_d = v_min(v_d, vx_load(iptr + i));
+                        v_store(dptr + i, v_select(v_reinterpret_as_f32(v_d < v_m),
+                                                   v_cvt_f32(v_d*v_d), v_inf));
+                    }
+                }
+#endif
+                if( need_labels )
+                {
+                    const int* sl = siteLabels->ptr<int>(j) + x0;
+                    int* lptr = colLabels->ptr<int>(j) + x0;
+                    for( ; i < n; i++ )
+                    {
+                        int dist;
+                        if( sptr[i] == 0 )
+                            d[i] = 0, l[i] = sl[i];
+                        else
+                            d[i]++;
+                        if( d[i] <= iptr[i] )
+                            dist = d[i], lptr[i] = l[i];
+                        else
+                            dist = iptr[i];
+                        dptr[i] = dist < m ? (float)(dist*dist) : inf;
+                    }
+                }
+                for( ; i < n; i++ )
+                {
+                    d[i] = sptr[i] == 0 ? 0 : d[i] + 1;
+                    int dist = std::min(d[i], iptr[i]);
+                    dptr[i] = dist < m ? (float)(dist*dist) : inf;
+                }
             }
         }
     }
 
     const Mat* src;
     Mat* dst;
-    const int* sat_tab;
-    const float* sqr_tab;
+    const Mat* siteLabels;
+    Mat* colLabels;
 };
 
 struct DTRowInvoker : ParallelLoopBody
 {
-    DTRowInvoker( Mat* _dst, const float* _sqr_tab, const float* _inv_tab )
+    DTRowInvoker( Mat* _dst, const float* _sqr_tab, const float* _inv_tab, const Mat* _colLabels, Mat* _labels )
     {
         dst = _dst;
         sqr_tab = _sqr_tab;
         inv_tab = _inv_tab;
+        colLabels = _colLabels;
+        labels = _labels;
     }
 
     void operator()(const Range& range) const CV_OVERRIDE
@@ -541,12 +703,16 @@ struct DTRowInvoker : ParallelLoopBody
                 }
             }
 
+            const int* cl = colLabels ? colLabels->ptr<int>(i) : 0;
+            int* l = labels ? labels->ptr<int>(i) : 0;
             for( q = 0, k = 0; q < n; q++ )
             {
                 while( z[k+1] < q )
                     k++;
                 p = v[k];
                 d[q] = std::sqrt(sqr_tab[std::abs(q - p)] + f[p]);
+                if( l )
+                    l[q] = cl[p];
             }
         }
     }
@@ -554,36 +720,28 @@ struct DTRowInvoker : ParallelLoopBody
     Mat* dst;
     const float* sqr_tab;
     const float* inv_tab;
+    const Mat* colLabels;
+    Mat* labels;
 };
 
 static void
-trueDistTrans( const Mat& src, Mat& dst )
+trueDistTrans( const Mat& src, Mat& dst, Mat* labels )
 {
-    const float inf = 1e15f;
-
     CV_Assert( src.size() == dst.size() );
 
     CV_Assert( src.type() == CV_8UC1 && dst.type() == CV_32FC1 );
     int i, m = src.rows, n = src.cols;
 
-    cv::AutoBuffer<uchar> _buf(std::max(m*2*sizeof(float) + (m*3+1)*sizeof(int), n*2*sizeof(float)));
     // stage 1: compute 1d distance transform of each column
-    float* sqr_tab = (float*)_buf.data();
-    int* sat_tab = cv::alignPtr((int*)(sqr_tab + m*2), sizeof(int));
-    int shift = m*2;
-
-    for( i = 0; i < m; i++ )
-        sqr_tab[i] = (float)(i*i);
-    for( i = m; i < m*2; i++ )
-        sqr_tab[i] = inf;
-    for( i = 0; i < shift; i++ )
-        sat_tab[i] = 0;
-    for( ; i <= m*3; i++ )
-        sat_tab[i] = i - shift;
-
-    cv::parallel_for_(cv::Range(0, n), cv::DTColumnInvoker(&src, &dst, sat_tab, sqr_tab), src.total()/(double)(1<<16));
+    Mat colLabels;
+    if( labels )
+        colLabels.create(src.size(), CV_32S);
+    cv::parallel_for_(cv::Range(0, n), cv::DTColumnInvoker(&src, &dst, labels, labels ? &colLabels : 0),
+                      src.total()/(double)(1<<16));
 
     // stage 2: compute modified distance transform for each row
+    cv::AutoBuffer<float> _buf(n*2);
+    float* sqr_tab = _buf.data();
     float* inv_tab = sqr_tab + n;
 
     inv_tab[0] = sqr_tab[0] = 0.f;
@@ -593,7 +751,7 @@ trueDistTrans( const Mat& src, Mat& dst )
         sqr_tab[i] = (float)(i*i);
     }
 
-    cv::parallel_for_(cv::Range(0, m), cv::DTRowInvoker(&dst, sqr_tab, inv_tab));
+    cv::parallel_for_(cv::Range(0, m), cv::DTRowInvoker(&dst, sqr_tab, inv_tab, labels ? &colLabels : 0, labels));
 }
 
 
@@ -710,6 +868,30 @@ static void distanceTransform_L1_8U(InputArray _src, OutputArray _dst)
 
     distanceATS_L1_8u(src, dst);
 }
+// marks the zero pixels or their connected components with distinct labels
+static void initDistanceTransformLabels( const Mat& src, Mat& labels, int labelType )
+{
+    labels.setTo(Scalar::all(0));
+
+    if( labelType == CV_DIST_LABEL_CCOMP )
+    {
+        Mat zpix = src == 0;
+        connectedComponents(zpix, labels, 8, CV_32S, CCL_WU);
+    }
+    else
+    {
+        int k = 1;
+        for( int i = 0; i < src.rows; i++ )
+        {
+            const uchar* srcptr = src.ptr(i);
+            int* labelptr = labels.ptr<int>(i);
+
+            for( int j = 0; j < src.cols; j++ )
+                if( srcptr[j] == 0 )
+                    labelptr[j] = k++;
+        }
+    }
+}
 }
 
 // Wrapper function for distance transform group
@@ -732,7 +914,8 @@ void cv::distanceTransform( InputArray _src, OutputArray _dst, OutputArray _labe
 
         _labels.create(src.size(), CV_32S);
         labels = _labels.getMat();
-        maskSize = CV_DIST_MASK_5;
+        if( maskSize != CV_DIST_MASK_PRECISE )
+            maskSize = CV_DIST_MASK_5;
     }
 
     float _mask[5] = {0};
@@ -742,11 +925,15 @@ void cv::distanceTransform( InputArray _src, OutputArray _dst, OutputArray _labe
 
     if( distType == CV_DIST_C || distType == CV_DIST_L1 )
         maskSize = !need_labels ? CV_DIST_MASK_3 : CV_DIST_MASK_5;
-    else if( distType == CV_DIST_L2 && need_labels )
-        maskSize = CV_DIST_MASK_5;
 
     if( maskSize == CV_DIST_MASK_PRECISE )
     {
+        if( need_labels )
+        {
+            initDistanceTransformLabels( src, labels, labelType );
+            trueDistTrans( src, dst, &labels );
+            return;
+        }
 
 #ifdef HAVE_IPP
         CV_IPP_CHECK()
@@ -777,7 +964,7 @@ void cv::distanceTransform( InputArray _src, OutputArray _dst, OutputArray _labe
         }
 #endif
 
-        trueDistTrans( src, dst );
+        trueDistTrans( src, dst, 0 );
         return;
     }
 
@@ -808,7 +995,7 @@ void cv::distanceTransform( InputArray _src, OutputArray _dst, OutputArray _labe
             }
 #endif
 
-            distanceTransform_3x3(src, temp, dst, _mask);
+            distanceTransformChamfer(distanceTransform_3x3, src, temp, dst, labels, _mask, border);
         }
         else
         {
@@ -825,33 +1012,13 @@ void cv::distanceTransform( InputArray _src, OutputArray _dst, OutputArray _labe
             }
 #endif
 
-            distanceTransform_5x5(src, temp, dst, _mask);
+            distanceTransformChamfer(distanceTransform_5x5, src, temp, dst, labels, _mask, border);
         }
     }
     else
     {
-        labels.setTo(Scalar::all(0));
-
-        if( labelType == CV_DIST_LABEL_CCOMP )
-        {
-            Mat zpix = src == 0;
-            connectedComponents(zpix, labels, 8, CV_32S, CCL_WU);
-        }
-        else
-        {
-            int k = 1;
-            for( int i = 0; i < src.rows; i++ )
-            {
-                const uchar* srcptr = src.ptr(i);
-                int* labelptr = labels.ptr<int>(i);
-
-                for( int j = 0; j < src.cols; j++ )
-                    if( srcptr[j] == 0 )
-                        labelptr[j] = k++;
-            }
-        }
-
-       distanceTransformEx_5x5( src, temp, dst, labels, _mask );
+        initDistanceTransformLabels( src, labels, labelType );
+        distanceTransformChamfer( distanceTransformEx_5x5, src, temp, dst, labels, _mask, border );
     }
 }
 
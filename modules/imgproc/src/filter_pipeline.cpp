@@ -0,0 +1,507 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "filterengine.hpp"
+#include "color.hpp"
+#include "opencv2/imgproc/filter_pipeline.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+/****************************************************************************************\
+*                          Stripe-based execution of filter chains                       *
+\****************************************************************************************/
+
+namespace cv
+{
+
+namespace
+{
+
+// per-thread state of a stage
+class PipelineWorker
+{
+public:
+    PipelineWorker(int _dstType, int _top = 0, int _bottom = 0)
+        : dstType(_dstType), top(_top), bottom(_bottom) {}
+    virtual ~PipelineWorker() {}
+
+    // computes the rows [y, y + dst.rows) of the stage output. src is the same rows of the stage input,
+    // the input rows [y - top, y + dst.rows + bottom), clipped to the image, are available around it
+    virtual void operator()(const Mat& src, Mat& dst, const Size& wholeSize, int y) = 0;
+
+    int dstType;
+    int top, bottom;
+};
+
+class PipelineStage
+{
+public:
+    virtual ~PipelineStage() {}
+    virtual Ptr<PipelineWorker> createWorker(int srcType) const = 0;
+};
+
+class FilterWorker CV_FINAL : public PipelineWorker
+{
+public:
+    FilterWorker(const Ptr<FilterEngine>& _engine)
+        : PipelineWorker(_engine->dstType, _engine->anchor.y, _engine->ksize.height - _engine->anchor.y - 1),
+          engine(_engine) {}
+
+    void operator()(const Mat& src, Mat& dst, const Size& wholeSize, int y) CV_OVERRIDE
+    {
+        engine->apply(src, dst, wholeSize, Point(0, y));
+    }
+
+    Ptr<FilterEngine> engine;
+};
+
+typedef std::function<Ptr<FilterEngine>(int)> FilterEngineFactory;
+
+class FilterStage CV_FINAL : public PipelineStage
+{
+public:
+    FilterStage(const FilterEngineFactory& _factory) : factory(_factory) {}
+
+    Ptr<PipelineWorker> createWorker(int srcType) const CV_OVERRIDE
+    {
+        return makePtr<FilterWorker>(factory(srcType));
+    }
+
+    FilterEngineFactory factory;
+};
+
+class GradientWorker CV_FINAL : public PipelineWorker
+{
+public:
+    GradientWorker(const Ptr<FilterEngine>& _fx, const Ptr<FilterEngine>& _fy)
+        : PipelineWorker(CV_MAKETYPE(CV_MAT_DEPTH(_fx->dstType), 2),
+                         _fx->anchor.y, _fx->ksize.height - _fx->anchor.y - 1),
+          fx(_fx), fy(_fy) {}
+
+    void operator()(const Mat& src, Mat& dst, const Size& wholeSize, int y) CV_OVERRIDE
+    {
+        if( bufx.rows < dst.rows || bufx.cols != dst.cols )
+        {
+            bufx.create(dst.rows, dst.cols, fx->dstType);
+            bufy.create(dst.rows, dst.cols, fy->dstType);
+        }
+        Mat d[] = { bufx.rowRange(0, dst.rows), bufy.rowRange(0, dst.rows) };
+        fx->apply(src, d[0], wholeSize, Point(0, y));
+        fy->apply(src, d[1], wholeSize, Point(0, y));
+        merge(d, 2, dst);
+    }
+
+    Ptr<FilterEngine> fx, fy;
+    Mat bufx, bufy;
+};
+
+static void getDerivFilterKernels(int srcType, int ddepth, int dx, int dy, int ksize, double scale,
+                                  Mat& kx, Mat& ky)
+{
+    int ktype = std::max(CV_32F, std::max(ddepth, CV_MAT_DEPTH(srcType)));
+    getDerivKernels(kx, ky, dx, dy, ksize, false, ktype);
+    if( scale != 1 )
+    {
+        // the same as in cv::Sobel: scale the smoothing part
+        if( dx == 0 )
+            kx *= scale;
+        else
+            ky *= scale;
+    }
+}
+
+class GradientStage CV_FINAL : public PipelineStage
+{
+public:
+    GradientStage(int _ddepth, int _ksize, double _scale, int _borderType)
+        : ddepth(_ddepth), ksize(_ksize), scale(_scale), borderType(_borderType) {}
+
+    Ptr<PipelineWorker> createWorker(int srcType) const CV_OVERRIDE
+    {
+        CV_CheckEQ(CV_MAT_CN(srcType), 1, "gradient stage expects a single-channel image");
+        int dtype = CV_MAKETYPE(ddepth < 0 ? CV_MAT_DEPTH(srcType) : ddepth, 1);
+        // the filters keep references to the kernels, so they must not share them
+        Mat kx[2], ky[2];
+        getDerivFilterKernels(srcType, CV_MAT_DEPTH(dtype), 1, 0, ksize, scale, kx[0], ky[0]);
+        getDerivFilterKernels(srcType, CV_MAT_DEPTH(dtype), 0, 1, ksize, scale, kx[1], ky[1]);
+        Ptr<FilterEngine> fx = createSeparableLinearFilter(srcType, dtype, kx[0], ky[0], Point(-1,-1), 0, borderType);
+        Ptr<FilterEngine> fy = createSeparableLinearFilter(srcType, dtype, kx[1], ky[1], Point(-1,-1), 0, borderType);
+        return makePtr<GradientWorker>(fx, fy);
+    }
+
+    int ddepth, ksize;
+    double scale;
+    int borderType;
+};
+
+class PointwiseWorker CV_FINAL : public PipelineWorker
+{
+public:
+    PointwiseWorker(int _dstType, const FilterPipeline::PointwiseOp& _op)
+        : PipelineWorker(_dstType), op(_op) {}
+
+    void operator()(const Mat& src, Mat& dst, const Size&, int) CV_OVERRIDE
+    {
+        const uchar* data = dst.data;
+        op(src, dst);
+        CV_Assert( dst.data == data && dst.type() == dstType );
+    }
+
+    FilterPipeline::PointwiseOp op;
+};
+
+typedef std::function<int(int)> PointwiseTypeFunc;
+
+class PointwiseStage CV_FINAL : public PipelineStage
+{
+public:
+    PointwiseStage(const PointwiseTypeFunc& _dstType, const FilterPipeline::PointwiseOp& _op)
+        : dstType(_dstType), op(_op) {}
+
+    Ptr<PipelineWorker> createWorker(int srcType) const CV_OVERRIDE
+    {
+        return makePtr<PointwiseWorker>(dstType(srcType), op);
+    }
+
+    PointwiseTypeFunc dstType;
+    FilterPipeline::PointwiseOp op;
+};
+
+template<typename T> static void
+magnitude2_(const Mat& src, Mat& dst)
+{
+    for( int y = 0; y < src.rows; y++ )
+    {
+        const T* s = src.ptr<T>(y);
+        T* d = dst.ptr<T>(y);
+        for( int x = 0; x < src.cols; x++ )
+            d[x] = std::sqrt(s[x*2]*s[x*2] + s[x*2+1]*s[x*2+1]);
+    }
+}
+
+template<> void
+magnitude2_<float>(const Mat& src, Mat& dst)
+{
+    for( int y = 0; y < src.rows; y++ )
+    {
+        const float* s = src.ptr<float>(y);
+        float* d = dst.ptr<float>(y);
+        int x = 0;
+#if CV_SIMD
+        for( ; x <= src.cols - v_float32::nlanes; x += v_float32::nlanes )
+        {
+            v_float32 a, b;
+            v_load_deinterleave(s + x*2, a, b);
+            v_store(d + x, v_magnitude(a, b));
+        }
+#endif
+        for( ; x < src.cols; x++ )
+            d[x] = std::sqrt(s[x*2]*s[x*2] + s[x*2+1]*s[x*2+1]);
+    }
+}
+
+// the stripe processing: every thread runs its own set of workers, because the filter
+// engines keep the state, and the intermediate results live in its small stripe buffers
+class FilterPipelineInvoker : public ParallelLoopBody
+{
+public:
+    FilterPipelineInvoker(const std::vector<Ptr<PipelineStage> >& _stages, const Mat& _src, Mat& _dst,
+                          int _stripeHeight, int _maxHalo)
+        : stages(_stages), src(_src), dst(_dst), stripeHeight(_stripeHeight), maxHalo(_maxHalo)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int nstages = (int)stages.size(), height = src.rows;
+        std::vector<Ptr<PipelineWorker> > workers(nstages);
+        std::vector<Mat> bufs(nstages - 1);
+        std::vector<Range> rows(nstages);
+
+        int type = src.type();
+        for( int i = 0; i < nstages; i++ )
+        {
+            workers[i] = stages[i]->createWorker(type);
+            type = workers[i]->dstType;
+            if( i < nstages - 1 )
+                bufs[i].create(std::min(stripeHeight + maxHalo, height), src.cols, type);
+        }
+
+        for( int s = range.start; s < range.end; s++ )
+        {
+            int y0 = s*stripeHeight, y1 = std::min(y0 + stripeHeight, height);
+
+            // the rows every stage must produce, from the last stage to the first one
+            rows[nstages - 1] = Range(y0, y1);
+            for( int i = nstages - 1; i > 0; i-- )
+                rows[i - 1] = Range(std::max(rows[i].start - workers[i]->top, 0),
+                                    std::min(rows[i].end + workers[i]->bottom, height));
+
+            for( int i = 0; i < nstages; i++ )
+            {
+                Mat in = i == 0 ? src.rowRange(rows[0]) :
+                    bufs[i - 1].rowRange(rows[i].start - rows[i - 1].start, rows[i].end - rows[i - 1].start);
+                Mat out = i == nstages - 1 ? dst.rowRange(rows[i]) : bufs[i].rowRange(0, rows[i].size());
+                (*workers[i])(in, out, src.size(), rows[i].start);
+            }
+        }
+    }
+
+private:
+    const std::vector<Ptr<PipelineStage> >& stages;
+    const Mat& src;
+    Mat& dst;
+    int stripeHeight, maxHalo;
+
+    FilterPipelineInvoker& operator=(const FilterPipelineInvoker&); // = delete
+};
+
+} // namespace
+
+struct FilterPipeline::Impl
+{
+    Impl() : stripeHeight(0) {}
+
+    std::vector<Ptr<PipelineStage> > stages;
+    int stripeHeight;
+};
+
+FilterPipeline::FilterPipeline() : p(makePtr<Impl>()) {}
+
+FilterPipeline& FilterPipeline::cvtColor(int code)
+{
+    if( impl::isBayer(code) )
+        CV_Error(Error::StsBadArg, "Demosaicing is not a per-pixel operation and can not be a pipeline stage");
+
+    p->stages.push_back(makePtr<PointwiseStage>(
+        [code](int srcType) { return impl::cvtColorDstType(srcType, code); },
+        [code](const Mat& src, Mat& dst) { cv::cvtColor(src, dst, code); }));
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::convertTo(int ddepth, double alpha, double beta)
+{
+    p->stages.push_back(makePtr<PointwiseStage>(
+        [ddepth](int srcType) { return CV_MAKETYPE(ddepth < 0 ? CV_MAT_DEPTH(srcType) : ddepth, CV_MAT_CN(srcType)); },
+        [alpha, beta](const Mat& src, Mat& dst) { src.convertTo(dst, dst.type(), alpha, beta); }));
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::threshold(double thresh, double maxval, int type)
+{
+    CV_Assert( (type & (THRESH_OTSU | THRESH_TRIANGLE)) == 0 );
+
+    p->stages.push_back(makePtr<PointwiseStage>(
+        [](int srcType) { return srcType; },
+        [thresh, maxval, type](const Mat& src, Mat& dst) { cv::threshold(src, dst, thresh, maxval, type); }));
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::sepFilter2D(int ddepth, InputArray _kernelX, InputArray _kernelY,
+                                            Point anchor, double delta, int borderType)
+{
+    Mat kernelX = _kernelX.getMat().clone(), kernelY = _kernelY.getMat().clone();
+    borderType &= ~BORDER_ISOLATED;
+
+    p->stages.push_back(makePtr<FilterStage>(
+        [=](int srcType)
+        {
+            int dtype = CV_MAKETYPE(ddepth < 0 ? CV_MAT_DEPTH(srcType) : ddepth, CV_MAT_CN(srcType));
+            return createSeparableLinearFilter(srcType, dtype, kernelX, kernelY, anchor, delta, borderType);
+        }));
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::filter2D(int ddepth, InputArray _kernel, Point anchor,
+                                         double delta, int borderType)
+{
+    Mat kernel = _kernel.getMat().clone();
+    borderType &= ~BORDER_ISOLATED;
+
+    p->stages.push_back(makePtr<FilterStage>(
+        [=](int srcType)
+        {
+            int dtype = CV_MAKETYPE(ddepth < 0 ? CV_MAT_DEPTH(srcType) : ddepth, CV_MAT_CN(srcType));
+            return createLinearFilter(srcType, dtype, kernel, anchor, delta, borderType);
+        }));
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::boxFilter(int ddepth, Size ksize, Point anchor,
+                                          bool normalize, int borderType)
+{
+    borderType &= ~BORDER_ISOLATED;
+
+    p->stages.push_back(makePtr<FilterStage>(
+        [=](int srcType)
+        {
+            int dtype = CV_MAKETYPE(ddepth < 0 ? CV_MAT_DEPTH(srcType) : ddepth, CV_MAT_CN(srcType));
+            return createBoxFilter(srcType, dtype, ksize, anchor, normalize, borderType);
+        }));
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::GaussianBlur(Size ksize, double sigmaX, double sigmaY, int borderType)
+{
+    borderType &= ~BORDER_ISOLATED;
+
+    p->stages.push_back(makePtr<FilterStage>(
+        [=](int srcType) { return createGaussianFilter(srcType, ksize, sigmaX, sigmaY, borderType); }));
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::Sobel(int ddepth, int dx, int dy, int ksize,
+                                      double scale, double delta, int borderType)
+{
+    borderType &= ~BORDER_ISOLATED;
+
+    p->stages.push_back(makePtr<FilterStage>(
+        [=](int srcType)
+        {
+            int dtype = CV_MAKETYPE(ddepth < 0 ? CV_MAT_DEPTH(srcType) : ddepth, CV_MAT_CN(srcType));
+            Mat kx, ky;
+            getDerivFilterKernels(srcType, CV_MAT_DEPTH(dtype), dx, dy, ksize, scale, kx, ky);
+            return createSeparableLinearFilter(srcType, dtype, kx, ky, Point(-1,-1), delta, borderType);
+        }));
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::gradient(int ddepth, int ksize, double scale, int borderType)
+{
+    p->stages.push_back(makePtr<GradientStage>(ddepth, ksize, scale, borderType & ~BORDER_ISOLATED));
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::magnitude()
+{
+    p->stages.push_back(makePtr<PointwiseStage>(
+        [](int srcType)
+        {
+            int depth = CV_MAT_DEPTH(srcType);
+            CV_Check(srcType, CV_MAT_CN(srcType) == 2 && (depth == CV_32F || depth == CV_64F),
+                     "magnitude stage expects a 2-channel floating-point image");
+            return CV_MAKETYPE(depth, 1);
+        },
+        [](const Mat& src, Mat& dst)
+        {
+            if( src.depth() == CV_32F )
+                magnitude2_<float>(src, dst);
+            else
+                magnitude2_<double>(src, dst);
+        }));
+    return *this;
+}
+
+static void addMorphologyStages(std::vector<Ptr<PipelineStage> >& stages, int op, InputArray _kernel,
+                                Point anchor, int iterations, int borderType, const Scalar& borderValue)
+{
+    Mat kernel = _kernel.getMat();
+    if( kernel.empty() )
+        kernel = getStructuringElement(MORPH_RECT, Size(3, 3));
+    else
+        kernel = kernel.clone();
+    anchor = normalizeAnchor(anchor, kernel.size());
+    borderType &= ~BORDER_ISOLATED;
+
+    for( int i = 0; i < iterations; i++ )
+        stages.push_back(makePtr<FilterStage>(
+            [=](int srcType) { return createMorphologyFilter(op, srcType, kernel, anchor, borderType, borderType, borderValue); }));
+}
+
+FilterPipeline& FilterPipeline::erode(InputArray kernel, Point anchor, int iterations,
+                                      int borderType, const Scalar& borderValue)
+{
+    addMorphologyStages(p->stages, MORPH_ERODE, kernel, anchor, iterations, borderType, borderValue);
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::dilate(InputArray kernel, Point anchor, int iterations,
+                                       int borderType, const Scalar& borderValue)
+{
+    addMorphologyStages(p->stages, MORPH_DILATE, kernel, anchor, iterations, borderType, borderValue);
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::pointwise(const PointwiseOp& op, int dtype)
+{
+    CV_Assert( op );
+
+    p->stages.push_back(makePtr<PointwiseStage>(
+        [dtype](int srcType) { return dtype < 0 ? srcType : dtype; }, op));
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::setStripeHeight(int rows)
+{
+    CV_Assert( rows >= 0 );
+    p->stripeHeight = rows;
+    return *this;
+}
+
+size_t FilterPipeline::size() const
+{
+    return p->stages.size();
+}
+
+bool FilterPipeline::empty() const
+{
+    return p->stages.empty();
+}
+
+void FilterPipeline::clear()
+{
+    p->stages.clear();
+}
+
+void FilterPipeline::apply(InputArray _src, OutputArray _dst) const
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !_src.empty() && _src.dims() <= 2 );
+
+    const std::vector<Ptr<PipelineStage> >& stages = p->stages;
+    if( stages.empty() )
+    {
+        _src.copyTo(_dst);
+        return;
+    }
+
+    Mat src = _src.getMat();
+
+    // validate the chain and collect the buffer sizes. The first stage reads the source directly,
+    // every intermediate buffer holds a stripe plus the apertures of the stages after it
+    int type = src.type(), halo = 0;
+    size_t rowSize = src.cols*src.elemSize();
+    for( size_t i = 0; i < stages.size(); i++ )
+    {
+        Ptr<PipelineWorker> w = stages[i]->createWorker(type);
+        type = w->dstType;
+        rowSize += src.cols*CV_ELEM_SIZE(type);
+        if( i > 0 )
+            halo += w->top + w->bottom;
+    }
+
+    _dst.create(src.size(), type);
+    Mat dst = _dst.getMat();
+    if( src.data == dst.data )
+        src = src.clone();
+
+    int stripeHeight = p->stripeHeight;
+    if( stripeHeight <= 0 )
+    {
+        static size_t cacheSize = utils::getConfigurationParameterSizeT("OPENCV_IMGPROC_FILTER_PIPELINE_CACHE_SIZE", 256*1024);
+        stripeHeight = (int)std::min(cacheSize/std::max(rowSize, (size_t)1), (size_t)src.rows) - halo;
+        // give every thread a stripe, but do not let the recomputed rows dominate
+        stripeHeight = std::min(stripeHeight, (src.rows + getNumThreads() - 1)/getNumThreads());
+        stripeHeight = std::max(stripeHeight, std::max(halo, 16));
+    }
+    stripeHeight = std::max(std::min(stripeHeight, src.rows), 1);
+
+    int nstripes = (src.rows + stripeHeight - 1)/stripeHeight;
+    parallel_for_(Range(0, nstripes), FilterPipelineInvoker(stages, src, dst, stripeHeight, halo),
+                  std::min(nstripes, getNumThreads()*4));
+}
+
+}
@@ -41,6 +41,7 @@
 //M*/
 
 #include "precomp.hpp"
+#include <atomic>
 
 #if defined(__GNUC__) && (__GNUC__ == 4) && (__GNUC_MINOR__ == 8)
 # pragma GCC diagnostic ignored "-Warray-bounds"
@@ -449,6 +450,176 @@ floodFillGrad_CnIR( Mat& image, Mat& msk,
     }
 }
 
+
+/****************************************************************************************\
+*                                  Multi-seed Floodfill                                  *
+\****************************************************************************************/
+
+struct FFillRegionStat
+{
+    FFillRegionStat() : area(0), xmin(0), ymin(0), xmax(-1), ymax(-1) {}
+
+    int area;
+    int xmin, ymin, xmax, ymax;
+    Vec3d sum;
+};
+
+template<typename _Tp> static inline void
+accumFFillSum( Vec3d& sum, const _Tp& v ) { sum[0] += v; }
+
+template<typename _Tp> static inline void
+accumFFillSum( Vec3d& sum, const Vec<_Tp, 3>& v ) { sum[0] += v[0]; sum[1] += v[1]; sum[2] += v[2]; }
+
+// Grows the region with the label lab from the seed over the pixels with zero labels.
+// The labels are claimed atomically, so many regions may be grown at once. The labels of the other
+// regions met by the region, i.e. the ones of the pixels that pass the criterion, are added to 'touched'
+template<typename _Tp, class Diff> static void
+fillRegion( const Mat& img, Mat& labels, Point seed, int lab, const Diff& diff, int flags,
+            FFillRegionStat& st, std::vector<Point>& stack, std::vector<int>& touched )
+{
+    static const int dx[] = { -1, 1, 0, 0, -1, 1, -1, 1 }, dy[] = { 0, 0, -1, 1, -1, -1, 1, 1 };
+    int nneighbors = (flags & 255) == 8 ? 8 : 4;
+    bool fixedRange = (flags & FLOODFILL_FIXED_RANGE) != 0;
+    int width = img.cols, height = img.rows;
+
+    st = FFillRegionStat();
+    std::atomic<int>* seedLabel = (std::atomic<int>*)labels.ptr<int>(seed.y) + seed.x;
+    int v = 0;
+    if( !seedLabel->compare_exchange_strong(v, lab, std::memory_order_relaxed) )
+    {
+        touched.push_back(v);
+        return;
+    }
+
+    const _Tp val0 = img.at<_Tp>(seed);
+    stack.clear();
+    stack.push_back(seed);
+    st.area = 1;
+    st.xmin = st.xmax = seed.x;
+    st.ymin = st.ymax = seed.y;
+    accumFFillSum(st.sum, val0);
+
+    while( !stack.empty() )
+    {
+        Point p = stack.back();
+        stack.pop_back();
+        const _Tp* ref = fixedRange ? &val0 : &img.at<_Tp>(p);
+
+        for( int k = 0; k < nneighbors; k++ )
+        {
+            int x = p.x + dx[k], y = p.y + dy[k];
+            if( (unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height )
+                continue;
+            std::atomic<int>* l = (std::atomic<int>*)labels.ptr<int>(y) + x;
+            v = l->load(std::memory_order_relaxed);
+            if( v == lab )
+                continue;
+            const _Tp* val = &img.at<_Tp>(y, x);
+            if( !diff(val, ref) )
+                continue;
+            if( v != 0 || !l->compare_exchange_strong(v, lab, std::memory_order_relaxed) )
+            {
+                touched.push_back(v);
+                continue;
+            }
+            stack.push_back(Point(x, y));
+            st.area++;
+            st.xmin = std::min(st.xmin, x); st.xmax = std::max(st.xmax, x);
+            st.ymin = std::min(st.ymin, y); st.ymax = std::max(st.ymax, y);
+            accumFFillSum(st.sum, *val);
+        }
+    }
+}
+
+template<typename _Tp, class Diff>
+class FloodFillRegions_Invoker : public ParallelLoopBody
+{
+public:
+    FloodFillRegions_Invoker( const Mat& _img, Mat& _labels, const std::vector<Point>& _seeds,
+                              const Diff& _diff, int _flags, std::vector<FFillRegionStat>& _stats,
+                              std::vector<uchar>& _conflict, Mutex& _mutex )
+        : img(_img), labels(_labels), seeds(_seeds), diff(_diff), flags(_flags),
+          stats(_stats), conflict(_conflict), mutex(_mutex) {}
+
+    virtual void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        std::vector<Point> stack;
+        std::vector<int> touched;
+        for( int i = range.start; i < range.end; i++ )
+        {
+            touched.clear();
+            fillRegion<_Tp, Diff>(img, labels, seeds[i], i + 1, diff, flags, stats[i], stack, touched);
+            if( touched.empty() )
+                continue;
+            AutoLock lock(mutex);
+            conflict[i] = 1;
+            for( size_t k = 0; k < touched.size(); k++ )
+                conflict[touched[k] - 1] = 1;
+        }
+    }
+
+private:
+    const Mat& img;
+    Mat& labels;
+    const std::vector<Point>& seeds;
+    Diff diff;
+    int flags;
+    std::vector<FFillRegionStat>& stats;
+    std::vector<uchar>& conflict;
+    Mutex& mutex;
+
+    FloodFillRegions_Invoker& operator=(const FloodFillRegions_Invoker&); // = delete
+};
+
+// The regions are grown in parallel. The ones that have not met the others are final. The rest are
+// cleared and grown again sequentially, in the order of the seeds, as the successive floodFill calls
+// with the same mask would do. When such a region reaches a final region of a later seed, that one
+// has to be regrown too, and the sequential pass is restarted.
+template<typename _Tp, class Diff> static void
+floodFillRegions_( const Mat& img, Mat& labels, const std::vector<Point>& seeds,
+                   const Diff& diff, int flags, std::vector<FFillRegionStat>& stats )
+{
+    int nseeds = (int)seeds.size();
+    std::vector<uchar> conflict(nseeds, (uchar)0);
+    Mutex mutex;
+    parallel_for_(Range(0, nseeds),
+                  FloodFillRegions_Invoker<_Tp, Diff>(img, labels, seeds, diff, flags, stats, conflict, mutex));
+
+    std::vector<Point> stack;
+    std::vector<int> touched;
+    for( bool restart = true; restart; )
+    {
+        restart = false;
+        for( int i = 0; i < nseeds; i++ )
+        {
+            const FFillRegionStat& st = stats[i];
+            if( !conflict[i] )
+                continue;
+            for( int y = st.ymin; y <= st.ymax; y++ )
+            {
+                int* l = labels.ptr<int>(y);
+                for( int x = st.xmin; x <= st.xmax; x++ )
+                    if( l[x] == i + 1 )
+                        l[x] = 0;
+            }
+        }
+
+        for( int i = 0; i < nseeds && !restart; i++ )
+        {
+            if( !conflict[i] )
+                continue;
+            touched.clear();
+            fillRegion<_Tp, Diff>(img, labels, seeds[i], i + 1, diff, flags, stats[i], stack, touched);
+            for( size_t k = 0; k < touched.size(); k++ )
+            {
+                int j = touched[k] - 1;
+                if( j > i && !conflict[j] )
+                    conflict[j] = 1, restart = true;
+            }
+        }
+    }
+}
+
 }
 
 /****************************************************************************************\
@@ -636,6 +807,85 @@ int cv::floodFill( InputOutputArray _image, Point seedPoint,
 }
 
 
+int cv::floodFillRegions( InputArray _image, const std::vector<Point>& seeds, OutputArray _labels,
+                          OutputArray _stats, OutputArray _means,
+                          Scalar loDiff, Scalar upDiff, int flags )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat img = _image.getMat();
+    int type = img.type(), cn = img.channels();
+    if( cn != 1 && cn != 3 )
+        CV_Error( CV_StsBadArg, "Number of channels in input image must be 1 or 3" );
+
+    const int connectivity = flags & 255;
+    if( connectivity != 0 && connectivity != 4 && connectivity != 8 )
+        CV_Error( CV_StsBadFlag, "Connectivity must be 4, 0(=4) or 8" );
+
+    for( int i = 0; i < cn; i++ )
+        if( loDiff[i] < 0 || upDiff[i] < 0 )
+            CV_Error( CV_StsBadArg, "lo_diff and up_diff must be non-negative" );
+
+    Size size = img.size();
+    for( size_t i = 0; i < seeds.size(); i++ )
+        if( (unsigned)seeds[i].x >= (unsigned)size.width ||
+            (unsigned)seeds[i].y >= (unsigned)size.height )
+            CV_Error( CV_StsOutOfRange, "Seed point is outside of image" );
+
+    _labels.create(size, CV_32S);
+    Mat labels = _labels.getMat();
+    labels.setTo(Scalar::all(0));
+
+    struct { Vec3b b; Vec3i i; Vec3f f; } ld_buf, ud_buf;
+    for( int i = 0; i < cn; i++ )
+    {
+        ld_buf.b[i] = saturate_cast<uchar>(cvFloor(loDiff[i]));
+        ud_buf.b[i] = saturate_cast<uchar>(cvFloor(upDiff[i]));
+        ld_buf.i[i] = cvFloor(loDiff[i]);
+        ud_buf.i[i] = cvFloor(upDiff[i]);
+        ld_buf.f[i] = (float)loDiff[i];
+        ud_buf.f[i] = (float)upDiff[i];
+    }
+
+    std::vector<FFillRegionStat> stats(seeds.size());
+    if( type == CV_8UC1 )
+        floodFillRegions_<uchar>(img, labels, seeds, Diff8uC1(ld_buf.b[0], ud_buf.b[0]), flags, stats);
+    else if( type == CV_8UC3 )
+        floodFillRegions_<Vec3b>(img, labels, seeds, Diff8uC3(ld_buf.b, ud_buf.b), flags, stats);
+    else if( type == CV_32SC1 )
+        floodFillRegions_<int>(img, labels, seeds, Diff32sC1(ld_buf.i[0], ud_buf.i[0]), flags, stats);
+    else if( type == CV_32SC3 )
+        floodFillRegions_<Vec3i>(img, labels, seeds, Diff32sC3(ld_buf.i, ud_buf.i), flags, stats);
+    else if( type == CV_32FC1 )
+        floodFillRegions_<float>(img, labels, seeds, Diff32fC1(ld_buf.f[0], ud_buf.f[0]), flags, stats);
+    else if( type == CV_32FC3 )
+        floodFillRegions_<Vec3f>(img, labels, seeds, Diff32fC3(ld_buf.f, ud_buf.f), flags, stats);
+    else
+        CV_Error( CV_StsUnsupportedFormat, "" );
+
+    int nseeds = (int)seeds.size(), nregions = 0;
+    Mat statsMat(nseeds, CC_STAT_MAX, CV_32S), meansMat(nseeds, cn, CV_64F);
+    for( int i = 0; i < nseeds; i++ )
+    {
+        const FFillRegionStat& st = stats[i];
+        int* s = statsMat.ptr<int>(i);
+        double* m = meansMat.ptr<double>(i);
+        s[CC_STAT_LEFT] = st.area ? st.xmin : 0;
+        s[CC_STAT_TOP] = st.area ? st.ymin : 0;
+        s[CC_STAT_WIDTH] = st.area ? st.xmax - st.xmin + 1 : 0;
+        s[CC_STAT_HEIGHT] = st.area ? st.ymax - st.ymin + 1 : 0;
+        s[CC_STAT_AREA] = st.area;
+        for( int c = 0; c < cn; c++ )
+            m[c] = st.area ? st.sum[c]/st.area : 0.;
+        nregions += st.area > 0;
+    }
+    if( _stats.needed() )
+        statsMat.copyTo(_stats);
+    if( _means.needed() )
+        meansMat.copyTo(_means);
+    return nregions;
+}
+
 CV_IMPL void
 cvFloodFill( CvArr* arr, CvPoint seed_point,
              CvScalar newVal, CvScalar lo_diff, CvScalar up_diff,
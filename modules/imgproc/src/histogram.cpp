@@ -57,11 +57,11 @@ namespace cv
 static const size_t OUT_OF_RANGE = (size_t)1 << (sizeof(size_t)*8 - 2);
 
 static void
-calcHistLookupTables_8u( const Mat& hist, const SparseMat& shist,
-                         int dims, const float** ranges, const double* uniranges,
-                         bool uniform, bool issparse, std::vector<size_t>& _tab )
+calcHistLookupTables( const Mat& hist, const SparseMat& shist,
+                      int dims, const float** ranges, const double* uniranges,
+                      bool uniform, bool issparse, std::vector<size_t>& _tab, int high = 256 )
 {
-    const int low = 0, high = 256;
+    const int low = 0;
     int i, j;
     _tab.resize((high-low)*dims);
     size_t* tab = &_tab[0];
@@ -76,7 +76,7 @@ calcHistLookupTables_8u( const Mat& hist, const SparseMat& shist,
             size_t step = !issparse ? hist.step[i] : 1;
 
             double v_lo = ranges ? ranges[i][0] : 0;
-            double v_hi = ranges ? ranges[i][1] : 256;
+            double v_hi = ranges ? ranges[i][1] : high;
 
             for( j = low; j < high; j++ )
             {
@@ -533,7 +533,7 @@ calcHist_8u( std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
     int mstep = _deltas[dims*2 + 1];
     std::vector<size_t> _tab;
 
-    calcHistLookupTables_8u( hist, SparseMat(), dims, _ranges, _uniranges, uniform, false, _tab );
+    calcHistLookupTables( hist, SparseMat(), dims, _ranges, _uniranges, uniform, false, _tab );
     const size_t* tab = &_tab[0];
 
     if( dims == 1 )
@@ -688,6 +688,223 @@ calcHist_8u( std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
     }
 }
 
+typedef void (*CalcHistFunc)(std::vector<uchar*>& ptrs, const std::vector<int>& deltas,
+                             Size imsize, Mat& hist, int dims, const float** ranges,
+                             const double* uniranges, bool uniform);
+
+// 1D histogram of the uniform ranges for the floating-point images: the bin indices are computed
+// for a block of pixels at once, with the same double-precision arithmetic as in calcHist_
+static void
+calcHist1D_32f( std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
+                Size imsize, Mat& hist, int dims, const float** _ranges,
+                const double* _uniranges, bool uniform )
+{
+    CV_Assert( dims == 1 && uniform && _ranges );
+    const int BLOCK_SIZE = 256;
+    const float* p0 = (const float*)_ptrs[0];
+    const uchar* mask = _ptrs[1];
+    int d0 = _deltas[0], step0 = _deltas[1], mstep = _deltas[3];
+    int* H = hist.ptr<int>();
+    int sz = hist.size[0];
+    double a = _uniranges[0], b = _uniranges[1];
+    double v_lo = _ranges[0][0], v_hi = _ranges[0][1];
+    int idx[BLOCK_SIZE];
+
+#if CV_SIMD_64F
+    v_float64 v_a = vx_setall_f64(a), v_b = vx_setall_f64(b);
+    v_float64 v_vlo = vx_setall_f64(v_lo), v_vhi = vx_setall_f64(v_hi);
+    v_float64 v_zero = vx_setzero_f64(), v_last = vx_setall_f64(sz - 1), v_out = vx_setall_f64(sz);
+#endif
+
+    for( ; imsize.height--; p0 += imsize.width*d0 + step0, mask += mstep )
+    {
+        for( int x0 = 0; x0 < imsize.width; x0 += BLOCK_SIZE )
+        {
+            int n = std::min(BLOCK_SIZE, imsize.width - x0), x = 0;
+            const float* p = p0 + x0*d0;
+
+            // the bin index or sz for the values out of the range
+#if CV_SIMD_64F
+            if( d0 == 1 )
+            {
+                for( ; x <= n - v_float32::nlanes; x += v_float32::nlanes )
+                {
+                    v_float32 v = vx_load(p + x);
+                    v_float64 v0 = v_cvt_f64(v), v1 = v_cvt_f64_high(v);
+                    v_float64 t0 = v_min(v_max(v0*v_a + v_b, v_zero), v_last);
+                    v_float64 t1 = v_min(v_max(v1*v_a + v_b, v_zero), v_last);
+                    t0 = v_select((v0 < v_vlo) | (v0 >= v_vhi), v_out, t0);
+                    t1 = v_select((v1 < v_vlo) | (v1 >= v_vhi), v_out, t1);
+                    v_store(idx + x, v_combine_low(v_floor(t0), v_floor(t1)));
+                }
+            }
+#endif
+            for( ; x < n; x++ )
+            {
+                double v = (double)p[x*d0];
+                int i = cvFloor(v*a + b);
+                idx[x] = v < v_lo || v >= v_hi ? sz : CV_CLAMP_INT(i, 0, sz - 1);
+            }
+
+            if( !mask )
+            {
+                for( x = 0; x < n; x++ )
+                    if( idx[x] < sz )
+                        H[idx[x]]++;
+            }
+            else
+            {
+                for( x = 0; x < n; x++ )
+                    if( mask[x0 + x] && idx[x] < sz )
+                        H[idx[x]]++;
+            }
+        }
+    }
+#if CV_SIMD_64F
+    vx_cleanup();
+#endif
+}
+
+// counts the raw 16-bit values; hist is the 65536-element array
+static void
+calcHistRaw_16u( std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
+                 Size imsize, Mat& hist, int, const float**, const double*, bool )
+{
+    const ushort* p0 = (const ushort*)_ptrs[0];
+    const uchar* mask = _ptrs[1];
+    int d0 = _deltas[0], step0 = _deltas[1], mstep = _deltas[3];
+    int* H = hist.ptr<int>();
+    int x;
+
+    for( ; imsize.height--; p0 += step0, mask += mstep )
+    {
+        if( !mask )
+        {
+            for( x = 0; x <= imsize.width - 4; x += 4, p0 += d0*4 )
+            {
+                int t0 = p0[0], t1 = p0[d0];
+                H[t0]++; H[t1]++;
+                t0 = p0[d0*2]; t1 = p0[d0*3];
+                H[t0]++; H[t1]++;
+            }
+            for( ; x < imsize.width; x++, p0 += d0 )
+                H[*p0]++;
+        }
+        else
+            for( x = 0; x < imsize.width; x++, p0 += d0 )
+                if( mask[x] )
+                    H[*p0]++;
+    }
+}
+
+// the pointers and the size of the image part processed by one stripe: the rows, or the columns
+// of the single row of the continuous images
+static Size
+histStripe( const std::vector<uchar*>& ptrs, const std::vector<int>& deltas, Size imsize,
+            int dims, int esz, int auxEsz, int start, int end, std::vector<uchar*>& sptrs )
+{
+    bool byRows = imsize.height > 1;
+    sptrs = ptrs;
+    for( int i = 0; i < dims; i++ )
+        sptrs[i] += (size_t)start*(byRows ? imsize.width*deltas[i*2] + deltas[i*2+1] : deltas[i*2])*esz;
+    if( sptrs[dims] )
+        sptrs[dims] += (size_t)start*(byRows ? deltas[dims*2+1] : 1)*auxEsz;
+    return byRows ? Size(imsize.width, end - start) : Size(end - start, 1);
+}
+
+// the number of stripes so that every one processes enough pixels to pay for clearing and merging
+// its own histogram
+static int
+calcHistStripes( Size imsize, size_t histTotal )
+{
+    double npix = (double)imsize.area();
+    int nstripes = std::min(getNumThreads(), cvFloor(npix/(1 << 16)));
+    while( nstripes > 1 && (double)histTotal*nstripes*4 > npix )
+        nstripes--;
+    return std::max(nstripes, 1);
+}
+
+class CalcHistInvoker : public ParallelLoopBody
+{
+public:
+    CalcHistInvoker( CalcHistFunc _func, const std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
+                     Size _imsize, Mat& _hist, int _dims, const float** _ranges, const double* _uniranges,
+                     bool _uniform, int _esz, int _nstripes, Mutex* _histLock )
+        : func(_func), ptrs(_ptrs), deltas(_deltas), imsize(_imsize), hist(_hist), dims(_dims),
+          ranges(_ranges), uniranges(_uniranges), uniform(_uniform), esz(_esz), nstripes(_nstripes),
+          histLock(_histLock)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        int len = imsize.height > 1 ? imsize.height : imsize.width;
+        int start = (int)((int64)len*range.start/nstripes), end = (int)((int64)len*range.end/nstripes);
+        std::vector<uchar*> sptrs;
+        Size ssize = histStripe(ptrs, deltas, imsize, dims, esz, 1, start, end, sptrs);
+
+        Mat local = Mat::zeros(hist.dims, hist.size.p, CV_32S);
+        func(sptrs, deltas, ssize, local, dims, ranges, uniranges, uniform);
+
+        AutoLock lock(*histLock);
+        int* H = hist.ptr<int>();
+        const int* L = local.ptr<int>();
+        for( size_t i = 0, total = hist.total(); i < total; i++ )
+            H[i] += L[i];
+    }
+
+private:
+    CalcHistFunc func;
+    const std::vector<uchar*>& ptrs;
+    const std::vector<int>& deltas;
+    Size imsize;
+    Mat& hist;
+    int dims;
+    const float** ranges;
+    const double* uniranges;
+    bool uniform;
+    int esz, nstripes;
+    Mutex* histLock;
+
+    CalcHistInvoker& operator=(const CalcHistInvoker&); // = delete
+};
+
+// runs the histogram function in parallel, accumulating the per-stripe histograms in hist
+static void
+calcHistParallel( CalcHistFunc func, std::vector<uchar*>& ptrs, const std::vector<int>& deltas,
+                  Size imsize, Mat& hist, int dims, const float** ranges, const double* uniranges,
+                  bool uniform, int esz )
+{
+    int nstripes = calcHistStripes(imsize, hist.total());
+    if( nstripes <= 1 )
+    {
+        func(ptrs, deltas, imsize, hist, dims, ranges, uniranges, uniform);
+        return;
+    }
+
+    Mutex histLock;
+    parallel_for_(Range(0, nstripes), CalcHistInvoker(func, ptrs, deltas, imsize, hist, dims, ranges,
+                                                      uniranges, uniform, esz, nstripes, &histLock), nstripes);
+}
+
+// 1D histogram of the 16-bit image: the raw values are counted first and then mapped to the bins
+static void
+calcHist1D_16u( std::vector<uchar*>& ptrs, const std::vector<int>& deltas,
+                Size imsize, Mat& hist, const float** ranges, const double* uniranges, bool uniform )
+{
+    const int NVALUES = 1 << 16;
+    Mat raw = Mat::zeros(1, NVALUES, CV_32S);
+    calcHistParallel(calcHistRaw_16u, ptrs, deltas, imsize, raw, 1, ranges, uniranges, uniform, sizeof(ushort));
+
+    std::vector<size_t> tab;
+    calcHistLookupTables( hist, SparseMat(), 1, ranges, uniranges, uniform, false, tab, NVALUES );
+    const int* R = raw.ptr<int>();
+    uchar* H = hist.ptr();
+    for( int i = 0; i < NVALUES; i++ )
+        if( R[i] && tab[i] < OUT_OF_RANGE )
+            *(int*)(H + tab[i]) += R[i];
+}
+
 #ifdef HAVE_IPP
 
 typedef IppStatus(CV_STDCALL * IppiHistogram_C1)(const void* pSrc, int srcStep,
@@ -996,16 +1213,28 @@ void cv::calcHist( const Mat* images, int nimages, const int* channels,
     const double* _uniranges = uniform ? &uniranges[0] : 0;
 
     int depth = images[0].depth();
+    CalcHistFunc func = 0;
 
     if( depth == CV_8U )
-        calcHist_8u(ptrs, deltas, imsize, ihist, dims, ranges, _uniranges, uniform );
+        func = calcHist_8u;
     else if( depth == CV_16U )
-        calcHist_<ushort>(ptrs, deltas, imsize, ihist, dims, ranges, _uniranges, uniform );
+    {
+        // the lookup table of all the 16-bit values pays off only for the large images
+        if( dims == 1 && imsize.area() >= (1 << 16) )
+        {
+            calcHist1D_16u(ptrs, deltas, imsize, ihist, ranges, _uniranges, uniform);
+            ihist.convertTo(hist, CV_32F);
+            return;
+        }
+        func = calcHist_<ushort>;
+    }
     else if( depth == CV_32F )
-        calcHist_<float>(ptrs, deltas, imsize, ihist, dims, ranges, _uniranges, uniform );
+        func = dims == 1 && uniform ? calcHist1D_32f : calcHist_<float>;
     else
         CV_Error(CV_StsUnsupportedFormat, "");
 
+    calcHistParallel(func, ptrs, deltas, imsize, ihist, dims, ranges, _uniranges, uniform,
+                     (int)images[0].elemSize1());
     ihist.convertTo(hist, CV_32F);
 }
 
@@ -1114,7 +1343,7 @@ calcSparseHist_8u( std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
     int idx[CV_MAX_DIM];
     std::vector<size_t> _tab;
 
-    calcHistLookupTables_8u( Mat(), hist, dims, _ranges, _uniranges, uniform, true, _tab );
+    calcHistLookupTables( Mat(), hist, dims, _ranges, _uniranges, uniform, true, _tab );
     const size_t* tab = &_tab[0];
 
     for( ; imsize.height--; mask += mstep )
@@ -1495,7 +1724,7 @@ calcBackProj_8u( std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
     int bpstep = _deltas[dims*2 + 1];
     std::vector<size_t> _tab;
 
-    calcHistLookupTables_8u( hist, SparseMat(), dims, _ranges, _uniranges, uniform, false, _tab );
+    calcHistLookupTables( hist, SparseMat(), dims, _ranges, _uniranges, uniform, false, _tab );
     const size_t* tab = &_tab[0];
 
     if( dims == 1 )
@@ -1606,6 +1835,53 @@ calcBackProj_8u( std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
 
 }
 
+namespace cv
+{
+
+typedef void (*CalcBackProjFunc)(std::vector<uchar*>& ptrs, const std::vector<int>& deltas,
+                                 Size imsize, const Mat& hist, int dims, const float** ranges,
+                                 const double* uniranges, float scale, bool uniform);
+
+class CalcBackProjInvoker : public ParallelLoopBody
+{
+public:
+    CalcBackProjInvoker( CalcBackProjFunc _func, const std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
+                         Size _imsize, const Mat& _hist, int _dims, const float** _ranges,
+                         const double* _uniranges, float _scale, bool _uniform, int _esz, int _nstripes )
+        : func(_func), ptrs(_ptrs), deltas(_deltas), imsize(_imsize), hist(_hist), dims(_dims),
+          ranges(_ranges), uniranges(_uniranges), scale(_scale), uniform(_uniform), esz(_esz),
+          nstripes(_nstripes)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        int len = imsize.height > 1 ? imsize.height : imsize.width;
+        int start = (int)((int64)len*range.start/nstripes), end = (int)((int64)len*range.end/nstripes);
+        std::vector<uchar*> sptrs;
+        // the destination has the depth of the images
+        Size ssize = histStripe(ptrs, deltas, imsize, dims, esz, esz, start, end, sptrs);
+        func(sptrs, deltas, ssize, hist, dims, ranges, uniranges, scale, uniform);
+    }
+
+private:
+    CalcBackProjFunc func;
+    const std::vector<uchar*>& ptrs;
+    const std::vector<int>& deltas;
+    Size imsize;
+    const Mat& hist;
+    int dims;
+    const float** ranges;
+    const double* uniranges;
+    float scale;
+    bool uniform;
+    int esz, nstripes;
+
+    CalcBackProjInvoker& operator=(const CalcBackProjInvoker&); // = delete
+};
+
+}
+
 void cv::calcBackProject( const Mat* images, int nimages, const int* channels,
                           InputArray _hist, OutputArray _backProject,
                           const float** ranges, double scale, bool uniform )
@@ -1629,14 +1905,23 @@ void cv::calcBackProject( const Mat* images, int nimages, const int* channels,
     const double* _uniranges = uniform ? &uniranges[0] : 0;
 
     int depth = images[0].depth();
+    CalcBackProjFunc func = 0;
     if( depth == CV_8U )
-        calcBackProj_8u(ptrs, deltas, imsize, hist, dims, ranges, _uniranges, (float)scale, uniform);
+        func = calcBackProj_8u;
     else if( depth == CV_16U )
-        calcBackProj_<ushort, ushort>(ptrs, deltas, imsize, hist, dims, ranges, _uniranges, (float)scale, uniform );
+        func = calcBackProj_<ushort, ushort>;
     else if( depth == CV_32F )
-        calcBackProj_<float, float>(ptrs, deltas, imsize, hist, dims, ranges, _uniranges, (float)scale, uniform );
+        func = calcBackProj_<float, float>;
     else
         CV_Error(CV_StsUnsupportedFormat, "");
+
+    int nstripes = std::min(getNumThreads(), cvFloor((double)imsize.area()/(1 << 16)));
+    if( nstripes > 1 )
+        parallel_for_(Range(0, nstripes), CalcBackProjInvoker(func, ptrs, deltas, imsize, hist, dims, ranges,
+                                                              _uniranges, (float)scale, uniform,
+                                                              (int)images[0].elemSize1(), nstripes), nstripes);
+    else
+        func(ptrs, deltas, imsize, hist, dims, ranges, _uniranges, (float)scale, uniform);
 }
 
 
@@ -1745,7 +2030,7 @@ calcSparseBackProj_8u( std::vector<uchar*>& _ptrs, const std::vector<int>& _delt
     std::vector<size_t> _tab;
     int idx[CV_MAX_DIM];
 
-    calcHistLookupTables_8u( Mat(), hist, dims, _ranges, _uniranges, uniform, true, _tab );
+    calcHistLookupTables( Mat(), hist, dims, _ranges, _uniranges, uniform, true, _tab );
     const size_t* tab = &_tab[0];
 
     for( ; imsize.height--; bproj += bpstep )
@@ -95,6 +95,92 @@ findLocalMaximums( int numrho, int numangle, int threshold,
         }
 }
 
+static void
+collectHoughPoints( const Mat& img, std::vector<Point2f>& points )
+{
+    for( int i = 0; i < img.rows; i++ )
+    {
+        const uchar* row = img.ptr(i);
+        for( int j = 0; j < img.cols; j++ )
+            if( row[j] != 0 )
+                points.push_back(Point2f((float)j, (float)i));
+    }
+}
+
+/*
+Votes for the lines through the points: the point (x, y) increments the accumulator cell
+(n, cvRound(x*tabCos[n] + y*tabSin[n] - shift) + rhoOfs) for each angle n. The angles are split
+between the threads, so every thread updates its own rows of the accumulator and the result does
+not depend on the number of threads.
+*/
+class HoughLinesAccumInvoker : public ParallelLoopBody
+{
+public:
+    enum { BLOCK_SIZE = 8 };
+
+    HoughLinesAccumInvoker( const std::vector<Point2f>& _points, const float* _tabSin, const float* _tabCos,
+                            int _numangle, int _numrho, float _shift, int _rhoOfs, int* _accum )
+        : points(_points), tabSin(_tabSin), tabCos(_tabCos), numangle(_numangle), numrho(_numrho),
+          shift(_shift), rhoOfs(_rhoOfs), accum(_accum) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        const int astep = numrho + 2;
+        const Point2f* pts = points.empty() ? 0 : &points[0];
+        int i, npoints = (int)points.size();
+        int n = range.start*BLOCK_SIZE, nend = std::min(range.end*BLOCK_SIZE, numangle);
+
+#if CV_SIMD
+        const int vlanes = v_float32::nlanes;
+        int CV_DECL_ALIGNED(CV_SIMD_WIDTH) idx[v_int32::nlanes];
+        for( int k = 0; k < vlanes; k++ )
+            idx[k] = k*astep;
+        v_int32 vofs = vx_load_aligned(idx);
+        v_float32 vshift = vx_setall_f32(shift);
+
+        for( ; n <= nend - vlanes; n += vlanes )
+        {
+            v_float32 vcos = vx_load(tabCos + n), vsin = vx_load(tabSin + n);
+            v_int32 vbase = vx_setall_s32((n + 1)*astep + 1 + rhoOfs) + vofs;
+            for( i = 0; i < npoints; i++ )
+            {
+                v_int32 vr = v_round(vx_setall_f32(pts[i].x)*vcos + vx_setall_f32(pts[i].y)*vsin - vshift);
+                v_store_aligned(idx, vr + vbase);
+                for( int k = 0; k < vlanes; k++ )
+                    accum[idx[k]]++;
+            }
+        }
+        vx_cleanup();
+#endif
+        for( ; n < nend; n++ )
+        {
+            int* arow = accum + (n + 1)*astep + 1 + rhoOfs;
+            for( i = 0; i < npoints; i++ )
+                arow[cvRound(pts[i].x*tabCos[n] + pts[i].y*tabSin[n] - shift)]++;
+        }
+    }
+
+private:
+    const std::vector<Point2f>& points;
+    const float *tabSin, *tabCos;
+    int numangle, numrho;
+    float shift;
+    int rhoOfs;
+    int* accum;
+
+    HoughLinesAccumInvoker& operator=(const HoughLinesAccumInvoker&); // = delete
+};
+
+static void
+fillHoughAccum( const std::vector<Point2f>& points, const float* tabSin, const float* tabCos,
+                int numangle, int numrho, float shift, int rhoOfs, int* accum )
+{
+    int nblocks = (numangle + HoughLinesAccumInvoker::BLOCK_SIZE - 1)/HoughLinesAccumInvoker::BLOCK_SIZE;
+    parallel_for_(Range(0, nblocks),
+                  HoughLinesAccumInvoker(points, tabSin, tabCos, numangle, numrho, shift, rhoOfs, accum),
+                  (double)points.size()*numangle/(1 << 16));
+}
+
 /*
 Here image is an input raster;
 step is it's step; size characterizes it's ROI;
@@ -114,14 +200,12 @@ HoughLinesStandard( InputArray src, OutputArray lines, int type,
 
     Mat img = src.getMat();
 
-    int i, j;
+    int i;
     float irho = 1 / rho;
 
     CV_Assert( img.type() == CV_8UC1 );
     CV_Assert( linesMax > 0 );
 
-    const uchar* image = img.ptr();
-    int step = (int)img.step;
     int width = img.cols;
     int height = img.rows;
 
@@ -146,7 +230,7 @@ HoughLinesStandard( InputArray src, OutputArray lines, int type,
         std::vector<Vec2f> _lines(ipp_linesMax);
         IppStatus ok = ippiHoughLineGetSize_8u_C1R(srcSize, delta, ipp_linesMax, &bufferSize);
         Ipp8u* buffer = ippsMalloc_8u_L(bufferSize);
-        if (ok >= 0) {ok = CV_INSTRUMENT_FUN_IPP(ippiHoughLine_Region_8u32f_C1R, image, step, srcSize, (IppPointPolar*) &_lines[0], dstRoi, ipp_linesMax, &linesCount, delta, threshold, buffer);};
+        if (ok >= 0) {ok = CV_INSTRUMENT_FUN_IPP(ippiHoughLine_Region_8u32f_C1R, img.ptr(), (int)img.step, srcSize, (IppPointPolar*) &_lines[0], dstRoi, ipp_linesMax, &linesCount, delta, threshold, buffer);};
         ippsFree(buffer);
         if (ok >= 0)
         {
@@ -172,17 +256,9 @@ HoughLinesStandard( InputArray src, OutputArray lines, int type,
                      irho, tabSin, tabCos);
 
     // stage 1. fill accumulator
-    for( i = 0; i < height; i++ )
-        for( j = 0; j < width; j++ )
-        {
-            if( image[i * step + j] != 0 )
-                for(int n = 0; n < numangle; n++ )
-                {
-                    int r = cvRound( j * tabCos[n] + i * tabSin[n] );
-                    r += (numrho - 1) / 2;
-                    accum[(n+1) * (numrho+2) + r+1]++;
-                }
-        }
+    std::vector<Point2f> points;
+    collectHoughPoints( img, points );
+    fillHoughAccum( points, tabSin, tabCos, numangle, numrho, 0.f, (numrho - 1) / 2, accum );
 
     // stage 2. find local maximums
     findLocalMaximums( numrho, numangle, threshold, accum, _sort_buf );
@@ -705,6 +781,164 @@ HoughLinesProbabilistic( Mat& image,
     }
 }
 
+/****************************************************************************************\
+*                        Deterministic Hough Transform for Line Segments                 *
+\****************************************************************************************/
+
+// collects the points that voted for the accumulator peak or for its neighbors across rho
+// and sorts them along the line
+class HoughSegmentsCollectInvoker : public ParallelLoopBody
+{
+public:
+    HoughSegmentsCollectInvoker( const std::vector<Point2f>& _points, const std::vector<int>& _peaks,
+                                 const float* _tabSin, const float* _tabCos, int _numrho,
+                                 std::vector<std::vector<int> >& _bands )
+        : points(_points), peaks(_peaks), tabSin(_tabSin), tabCos(_tabCos), numrho(_numrho), bands(_bands) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        const Point2f* pts = points.empty() ? 0 : &points[0];
+        int npoints = (int)points.size();
+        double scale = 1./(numrho+2);
+        std::vector<std::pair<float, int> > buf;
+
+        for( int p = range.start; p < range.end; p++ )
+        {
+            int idx = peaks[p];
+            int n = cvFloor(idx*scale) - 1;
+            int r = idx - (n+1)*(numrho+2) - 1 - (numrho - 1)/2;
+            float c = tabCos[n], s = tabSin[n];
+            int i = 0;
+
+            buf.clear();
+#if CV_SIMD
+            const int vlanes = v_float32::nlanes;
+            v_float32 vc = vx_setall_f32(c), vs = vx_setall_f32(s);
+            v_int32 vlo = vx_setall_s32(r - 1), vhi = vx_setall_s32(r + 1);
+            for( ; i <= npoints - vlanes; i += vlanes )
+            {
+                v_float32 vx, vy;
+                v_load_deinterleave((const float*)(pts + i), vx, vy);
+                v_int32 vr = v_round(vx*vc + vy*vs);
+                if( !v_check_any((vr >= vlo) & (vr <= vhi)) )
+                    continue;
+                for( int k = i; k < i + vlanes; k++ )
+                    if( std::abs(cvRound(pts[k].x*c + pts[k].y*s) - r) <= 1 )
+                        buf.push_back(std::make_pair(pts[k].y*c - pts[k].x*s, k));
+            }
+            vx_cleanup();
+#endif
+            for( ; i < npoints; i++ )
+                if( std::abs(cvRound(pts[i].x*c + pts[i].y*s) - r) <= 1 )
+                    buf.push_back(std::make_pair(pts[i].y*c - pts[i].x*s, i));
+
+            std::sort(buf.begin(), buf.end());
+            std::vector<int>& band = bands[p];
+            band.resize(buf.size());
+            for( size_t k = 0; k < buf.size(); k++ )
+                band[k] = buf[k].second;
+        }
+    }
+
+private:
+    const std::vector<Point2f>& points;
+    const std::vector<int>& peaks;
+    const float *tabSin, *tabCos;
+    int numrho;
+    std::vector<std::vector<int> >& bands;
+
+    HoughSegmentsCollectInvoker& operator=(const HoughSegmentsCollectInvoker&); // = delete
+};
+
+static void
+HoughLinesSegmentsImpl( const Mat& image, float rho, float theta, int threshold,
+                        int lineLength, int lineGap, std::vector<Vec4i>& lines )
+{
+    CV_Assert( image.type() == CV_8UC1 );
+    CV_Assert( rho > 0 && theta > 0 );
+
+    float irho = 1 / rho;
+    int max_rho = image.cols + image.rows;
+    int numangle = cvRound(CV_PI / theta);
+    int numrho = cvRound((max_rho*2 + 1) / rho);
+    CV_Assert( numangle > 0 );
+
+    Mat _accum = Mat::zeros( (numangle+2), (numrho+2), CV_32SC1 );
+    std::vector<int> peaks;
+    AutoBuffer<float> _tabSin(numangle);
+    AutoBuffer<float> _tabCos(numangle);
+    int *accum = _accum.ptr<int>();
+    float *tabSin = _tabSin.data(), *tabCos = _tabCos.data();
+    double scale = 1./(numrho+2);
+
+    createTrigTable( numangle, 0, theta, irho, tabSin, tabCos );
+
+    // stage 1. fill accumulator and find the lines as in the standard transform
+    std::vector<Point2f> points;
+    collectHoughPoints( image, points );
+    fillHoughAccum( points, tabSin, tabCos, numangle, numrho, 0.f, (numrho - 1) / 2, accum );
+    findLocalMaximums( numrho, numangle, threshold, accum, peaks );
+    std::sort(peaks.begin(), peaks.end(), hough_cmp_gt(accum));
+
+    // stage 2. collect the points near each line
+    std::vector<std::vector<int> > bands(peaks.size());
+    parallel_for_(Range(0, (int)peaks.size()),
+                  HoughSegmentsCollectInvoker(points, peaks, tabSin, tabCos, numrho, bands));
+
+    // stage 3. split the lines into segments, from the strongest line to the weakest one;
+    // the points of the found segments are excluded from the weaker lines
+    std::vector<uchar> used(points.size(), 0);
+    for( size_t p = 0; p < peaks.size(); p++ )
+    {
+        const std::vector<int>& band = bands[p];
+        int n = cvFloor(peaks[p]*scale) - 1;
+        int r = peaks[p] - (n+1)*(numrho+2) - 1 - (numrho - 1)/2;
+        int k, nband = (int)band.size(), votes = 0;
+
+        // the line is skipped if the stronger ones took too many of its votes
+        for( k = 0; k < nband; k++ )
+        {
+            const Point2f& pt = points[band[k]];
+            votes += !used[band[k]] && cvRound(pt.x*tabCos[n] + pt.y*tabSin[n]) == r;
+        }
+        if( votes <= threshold )
+            continue;
+
+        // the gaps are measured along the major axis of the line
+        bool xmajor = std::abs(tabSin[n]) >= std::abs(tabCos[n]);
+        int start = -1, last = -1;
+        for( k = 0; k <= nband; k++ )
+        {
+            if( k < nband && used[band[k]] )
+                continue;
+            if( start >= 0 )
+            {
+                bool gap = k == nband;
+                if( !gap )
+                {
+                    const Point2f& a = points[band[last]], &b = points[band[k]];
+                    gap = cvRound(std::abs(xmajor ? b.x - a.x : b.y - a.y)) - 1 > lineGap;
+                }
+                if( gap )
+                {
+                    Point pt0(points[band[start]]), pt1(points[band[last]]);
+                    if( last > start && (std::abs(pt1.x - pt0.x) >= lineLength ||
+                                         std::abs(pt1.y - pt0.y) >= lineLength) )
+                    {
+                        lines.push_back(Vec4i(pt0.x, pt0.y, pt1.x, pt1.y));
+                        for( int j = start; j <= last; j++ )
+                            used[band[j]] = 1;
+                    }
+                    start = -1;
+                }
+            }
+            if( start < 0 )
+                start = k;
+            last = k;
+        }
+    }
+}
+
 #ifdef HAVE_OPENCL
 
 #define OCL_MAX_LINES 4096
@@ -929,6 +1163,18 @@ void HoughLinesP(InputArray _image, OutputArray _lines,
     Mat(lines).copyTo(_lines);
 }
 
+void HoughLinesSegments( InputArray _image, OutputArray _lines,
+                         double rho, double theta, int threshold,
+                         double minLineLength, double maxLineGap )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat image = _image.getMat();
+    std::vector<Vec4i> lines;
+    HoughLinesSegmentsImpl(image, (float)rho, (float)theta, threshold, cvRound(minLineLength), cvRound(maxLineGap), lines);
+    Mat(lines).copyTo(_lines);
+}
+
 void HoughLinesPointSet( InputArray _point, OutputArray _lines, int lines_max, int threshold,
                          double min_rho, double max_rho, double rho_step,
                          double min_theta, double max_theta, double theta_step )
@@ -969,12 +1215,7 @@ void HoughLinesPointSet( InputArray _point, OutputArray _lines, int lines_max, i
                      irho, tabSin, tabCos );
 
     // stage 1. fill accumulator
-    for( i = 0; i < (int)point.size(); i++ )
-        for(int n = 0; n < numangle; n++ )
-        {
-            int r = cvRound( point.at(i).x  * tabCos[n] + point.at(i).y * tabSin[n] - irho_min);
-            accum[(n+1) * (numrho+2) + r+1]++;
-        }
+    fillHoughAccum( point, tabSin, tabCos, numangle, numrho, irho_min, 0, accum );
 
     // stage 2. find local maximums
     findLocalMaximums( numrho, numangle, threshold, accum, _sort_buf );
@@ -1077,6 +1077,67 @@ typedef void (*RemapFunc)(const Mat& _src, Mat& _dst, const Mat& _xy,
                           const Mat& _fxy, const void* _wtab,
                           int borderType, const Scalar& _borderValue);
 
+// converts the row of the floating-point coordinates to the integer ones for INTER_NEAREST
+static void remapMapRowNN( const float* sX, const float* sY, short* XY, int n )
+{
+    int x = 0;
+#if CV_SIMD128
+    int span = v_float32x4::nlanes;
+    for( ; x <= n - span * 2; x += span * 2 )
+    {
+        v_int32x4 ix0 = v_round(v_load(sX + x));
+        v_int32x4 iy0 = v_round(v_load(sY + x));
+        v_int32x4 ix1 = v_round(v_load(sX + x + span));
+        v_int32x4 iy1 = v_round(v_load(sY + x + span));
+
+        v_int16x8 dx, dy;
+        dx = v_pack(ix0, ix1);
+        dy = v_pack(iy0, iy1);
+        v_store_interleave(XY + x * 2, dx, dy);
+    }
+#endif
+    for( ; x < n; x++ )
+    {
+        XY[x*2] = saturate_cast<short>(sX[x]);
+        XY[x*2+1] = saturate_cast<short>(sY[x]);
+    }
+}
+
+// converts the row of the floating-point coordinates to the integer ones and the indices in the interpolation tables
+static void remapMapRow( const float* sX, const float* sY, short* XY, ushort* A, int n )
+{
+    int x = 0;
+#if CV_SIMD128
+    v_float32x4 v_scale = v_setall_f32((float)INTER_TAB_SIZE);
+    v_int32x4 v_scale2 = v_setall_s32(INTER_TAB_SIZE - 1);
+    int span = v_float32x4::nlanes;
+    for( ; x <= n - span * 2; x += span * 2 )
+    {
+        v_int32x4 v_sx0 = v_round(v_scale * v_load(sX + x));
+        v_int32x4 v_sy0 = v_round(v_scale * v_load(sY + x));
+        v_int32x4 v_sx1 = v_round(v_scale * v_load(sX + x + span));
+        v_int32x4 v_sy1 = v_round(v_scale * v_load(sY + x + span));
+        v_uint16x8 v_sx8 = v_reinterpret_as_u16(v_pack(v_sx0 & v_scale2, v_sx1 & v_scale2));
+        v_uint16x8 v_sy8 = v_reinterpret_as_u16(v_pack(v_sy0 & v_scale2, v_sy1 & v_scale2));
+        v_uint16x8 v_v = v_shl<INTER_BITS>(v_sy8) | (v_sx8);
+        v_store(A + x, v_v);
+
+        v_int16x8 v_d0 = v_pack(v_shr<INTER_BITS>(v_sx0), v_shr<INTER_BITS>(v_sx1));
+        v_int16x8 v_d1 = v_pack(v_shr<INTER_BITS>(v_sy0), v_shr<INTER_BITS>(v_sy1));
+        v_store_interleave(XY + (x << 1), v_d0, v_d1);
+    }
+#endif
+    for( ; x < n; x++ )
+    {
+        int sx = cvRound(sX[x]*INTER_TAB_SIZE);
+        int sy = cvRound(sY[x]*INTER_TAB_SIZE);
+        int v = (sy & (INTER_TAB_SIZE-1))*INTER_TAB_SIZE + (sx & (INTER_TAB_SIZE-1));
+        XY[x*2] = saturate_cast<short>(sx >> INTER_BITS);
+        XY[x*2+1] = saturate_cast<short>(sy >> INTER_BITS);
+        A[x] = (ushort)v;
+    }
+}
+
 class RemapInvoker :
     public ParallelLoopBody
 {
@@ -1136,35 +1197,8 @@ public:
                     else
                     {
                         for( y1 = 0; y1 < brows; y1++ )
-                        {
-                            short* XY = bufxy.ptr<short>(y1);
-                            const float* sX = m1->ptr<float>(y+y1) + x;
-                            const float* sY = m2->ptr<float>(y+y1) + x;
-                            x1 = 0;
-
-                            #if CV_SIMD128
-                            {
-                                int span = v_float32x4::nlanes;
-                                for( ; x1 <= bcols - span * 2; x1 += span * 2 )
-                                {
-                                    v_int32x4 ix0 = v_round(v_load(sX + x1));
-                                    v_int32x4 iy0 = v_round(v_load(sY + x1));
-                                    v_int32x4 ix1 = v_round(v_load(sX + x1 + span));
-                                    v_int32x4 iy1 = v_round(v_load(sY + x1 + span));
-
-                                    v_int16x8 dx, dy;
-                                    dx = v_pack(ix0, ix1);
-                                    dy = v_pack(iy0, iy1);
-                                    v_store_interleave(XY + x1 * 2, dx, dy);
-                                }
-                            }
-                            #endif
-                            for( ; x1 < bcols; x1++ )
-                            {
-                                XY[x1*2] = saturate_cast<short>(sX[x1]);
-                                XY[x1*2+1] = saturate_cast<short>(sY[x1]);
-                            }
-                        }
+                            remapMapRowNN(m1->ptr<float>(y+y1) + x, m2->ptr<float>(y+y1) + x,
+                                          bufxy.ptr<short>(y1), bcols);
                     }
                     nnfunc( *src, dpart, bufxy, borderType, borderValue );
                     continue;
@@ -1195,43 +1229,7 @@ public:
                             A[x1] = (ushort)(sA[x1] & (INTER_TAB_SIZE2-1));
                     }
                     else if( planar_input )
-                    {
-                        const float* sX = m1->ptr<float>(y+y1) + x;
-                        const float* sY = m2->ptr<float>(y+y1) + x;
-
-                        x1 = 0;
-                        #if CV_SIMD128
-                        {
-                            v_float32x4 v_scale = v_setall_f32((float)INTER_TAB_SIZE);
-                            v_int32x4 v_scale2 = v_setall_s32(INTER_TAB_SIZE - 1);
-                            int span = v_float32x4::nlanes;
-                            for( ; x1 <= bcols - span * 2; x1 += span * 2 )
-                            {
-                                v_int32x4 v_sx0 = v_round(v_scale * v_load(sX + x1));
-                                v_int32x4 v_sy0 = v_round(v_scale * v_load(sY + x1));
-                                v_int32x4 v_sx1 = v_round(v_scale * v_load(sX + x1 + span));
-                                v_int32x4 v_sy1 = v_round(v_scale * v_load(sY + x1 + span));
-                                v_uint16x8 v_sx8 = v_reinterpret_as_u16(v_pack(v_sx0 & v_scale2, v_sx1 & v_scale2));
-                                v_uint16x8 v_sy8 = v_reinterpret_as_u16(v_pack(v_sy0 & v_scale2, v_sy1 & v_scale2));
-                                v_uint16x8 v_v = v_shl<INTER_BITS>(v_sy8) | (v_sx8);
-                                v_store(A + x1, v_v);
-
-                                v_int16x8 v_d0 = v_pack(v_shr<INTER_BITS>(v_sx0), v_shr<INTER_BITS>(v_sx1));
-                                v_int16x8 v_d1 = v_pack(v_shr<INTER_BITS>(v_sy0), v_shr<INTER_BITS>(v_sy1));
-                                v_store_interleave(XY + (x1 << 1), v_d0, v_d1);
-                            }
-                        }
-                        #endif
-                        for( ; x1 < bcols; x1++ )
-                        {
-                            int sx = cvRound(sX[x1]*INTER_TAB_SIZE);
-                            int sy = cvRound(sY[x1]*INTER_TAB_SIZE);
-                            int v = (sy & (INTER_TAB_SIZE-1))*INTER_TAB_SIZE + (sx & (INTER_TAB_SIZE-1));
-                            XY[x1*2] = saturate_cast<short>(sx >> INTER_BITS);
-                            XY[x1*2+1] = saturate_cast<short>(sy >> INTER_BITS);
-                            A[x1] = (ushort)v;
-                        }
-                    }
+                        remapMapRow(m1->ptr<float>(y+y1) + x, m2->ptr<float>(y+y1) + x, XY, A, bcols);
                     else
                     {
                         const float* sXY = m1->ptr<float>(y+y1) + x*2;
@@ -1290,6 +1288,70 @@ private:
     const void *ctab;
 };
 
+static void getRemapFuncs( int type, int interpolation, RemapNNFunc& nnfunc, RemapFunc& ifunc, const void*& ctab )
+{
+    static RemapNNFunc nn_tab[] =
+    {
+        remapNearest<uchar>, remapNearest<schar>, remapNearest<ushort>, remapNearest<short>,
+        remapNearest<int>, remapNearest<float>, remapNearest<double>, 0
+    };
+
+    static RemapFunc linear_tab[] =
+    {
+        remapBilinear<FixedPtCast<int, uchar, INTER_REMAP_COEF_BITS>, RemapVec_8u, short>, 0,
+        remapBilinear<Cast<float, ushort>, RemapNoVec, float>,
+        remapBilinear<Cast<float, short>, RemapNoVec, float>, 0,
+        remapBilinear<Cast<float, float>, RemapNoVec, float>,
+        remapBilinear<Cast<double, double>, RemapNoVec, float>, 0
+    };
+
+    static RemapFunc cubic_tab[] =
+    {
+        remapBicubic<FixedPtCast<int, uchar, INTER_REMAP_COEF_BITS>, short, INTER_REMAP_COEF_SCALE>, 0,
+        remapBicubic<Cast<float, ushort>, float, 1>,
+        remapBicubic<Cast<float, short>, float, 1>, 0,
+        remapBicubic<Cast<float, float>, float, 1>,
+        remapBicubic<Cast<double, double>, float, 1>, 0
+    };
+
+    static RemapFunc lanczos4_tab[] =
+    {
+        remapLanczos4<FixedPtCast<int, uchar, INTER_REMAP_COEF_BITS>, short, INTER_REMAP_COEF_SCALE>, 0,
+        remapLanczos4<Cast<float, ushort>, float, 1>,
+        remapLanczos4<Cast<float, short>, float, 1>, 0,
+        remapLanczos4<Cast<float, float>, float, 1>,
+        remapLanczos4<Cast<double, double>, float, 1>, 0
+    };
+
+    int depth = CV_MAT_DEPTH(type);
+    nnfunc = 0;
+    ifunc = 0;
+    ctab = 0;
+
+    if( interpolation == INTER_NEAREST )
+    {
+        nnfunc = nn_tab[depth];
+        CV_Assert( nnfunc != 0 );
+    }
+    else
+    {
+        if( interpolation == INTER_LINEAR )
+            ifunc = linear_tab[depth];
+        else if( interpolation == INTER_CUBIC ){
+            ifunc = cubic_tab[depth];
+            CV_Assert( CV_MAT_CN(type) <= 4 );
+        }
+        else if( interpolation == INTER_LANCZOS4 ){
+            ifunc = lanczos4_tab[depth];
+            CV_Assert( CV_MAT_CN(type) <= 4 );
+        }
+        else
+            CV_Error( CV_StsBadArg, "Unknown interpolation method" );
+        CV_Assert( ifunc != 0 );
+        ctab = initInterTab2D( interpolation, depth == CV_8U );
+    }
+}
+
 #ifdef HAVE_OPENCL
 
 static bool ocl_remap(InputArray _src, OutputArray _dst, InputArray _map1, InputArray _map2,
@@ -1667,39 +1729,6 @@ void cv::remap( InputArray _src, OutputArray _dst,
 {
     CV_INSTRUMENT_REGION();
 
-    static RemapNNFunc nn_tab[] =
-    {
-        remapNearest<uchar>, remapNearest<schar>, remapNearest<ushort>, remapNearest<short>,
-        remapNearest<int>, remapNearest<float>, remapNearest<double>, 0
-    };
-
-    static RemapFunc linear_tab[] =
-    {
-        remapBilinear<FixedPtCast<int, uchar, INTER_REMAP_COEF_BITS>, RemapVec_8u, short>, 0,
-        remapBilinear<Cast<float, ushort>, RemapNoVec, float>,
-        remapBilinear<Cast<float, short>, RemapNoVec, float>, 0,
-        remapBilinear<Cast<float, float>, RemapNoVec, float>,
-        remapBilinear<Cast<double, double>, RemapNoVec, float>, 0
-    };
-
-    static RemapFunc cubic_tab[] =
-    {
-        remapBicubic<FixedPtCast<int, uchar, INTER_REMAP_COEF_BITS>, short, INTER_REMAP_COEF_SCALE>, 0,
-        remapBicubic<Cast<float, ushort>, float, 1>,
-        remapBicubic<Cast<float, short>, float, 1>, 0,
-        remapBicubic<Cast<float, float>, float, 1>,
-        remapBicubic<Cast<double, double>, float, 1>, 0
-    };
-
-    static RemapFunc lanczos4_tab[] =
-    {
-        remapLanczos4<FixedPtCast<int, uchar, INTER_REMAP_COEF_BITS>, short, INTER_REMAP_COEF_SCALE>, 0,
-        remapLanczos4<Cast<float, ushort>, float, 1>,
-        remapLanczos4<Cast<float, short>, float, 1>, 0,
-        remapLanczos4<Cast<float, float>, float, 1>,
-        remapLanczos4<Cast<double, double>, float, 1>, 0
-    };
-
     CV_Assert( !_map1.empty() );
     CV_Assert( _map2.empty() || (_map2.size() == _map1.size()));
 
@@ -1729,7 +1758,7 @@ void cv::remap( InputArray _src, OutputArray _dst,
     if( interpolation == INTER_AREA )
         interpolation = INTER_LINEAR;
 
-    int type = src.type(), depth = CV_MAT_DEPTH(type);
+    int type = src.type();
 
 #if defined HAVE_IPP && !IPP_DISABLE_REMAP
     CV_IPP_CHECK()
@@ -1775,31 +1804,9 @@ void cv::remap( InputArray _src, OutputArray _dst,
     RemapNNFunc nnfunc = 0;
     RemapFunc ifunc = 0;
     const void* ctab = 0;
-    bool fixpt = depth == CV_8U;
     bool planar_input = false;
 
-    if( interpolation == INTER_NEAREST )
-    {
-        nnfunc = nn_tab[depth];
-        CV_Assert( nnfunc != 0 );
-    }
-    else
-    {
-        if( interpolation == INTER_LINEAR )
-            ifunc = linear_tab[depth];
-        else if( interpolation == INTER_CUBIC ){
-            ifunc = cubic_tab[depth];
-            CV_Assert( _src.channels() <= 4 );
-        }
-        else if( interpolation == INTER_LANCZOS4 ){
-            ifunc = lanczos4_tab[depth];
-            CV_Assert( _src.channels() <= 4 );
-        }
-        else
-            CV_Error( CV_StsBadArg, "Unknown interpolation method" );
-        CV_Assert( ifunc != 0 );
-        ctab = initInterTab2D( interpolation, fixpt );
-    }
+    getRemapFuncs(type, interpolation, nnfunc, ifunc, ctab);
 
     const Mat *m1 = &map1, *m2 = &map2;
 
@@ -2149,6 +2156,335 @@ void cv::convertMaps( InputArray _map1, InputArray _map2,
 }
 
 
+namespace cv
+{
+
+// the maps are grouped by the tiles of the destination image; the grid step of the compressed maps divides the tile size
+enum { COMPILED_REMAP_TILE = 64, COMPILED_REMAP_MIN_GRID_STEP = 8 };
+
+struct CompiledRemap::Impl
+{
+    Size size;
+    int interpolation;
+    int gridStep;
+    // either the fixed-point coordinates and the interpolation table indices of every pixel, tile by tile
+    Mat xy, alpha;
+    // or the coordinates in the grid nodes and the positions of the pixels between them
+    Mat gridX, gridY;
+    std::vector<float> ramp;
+};
+
+// interpolates the coordinates of the pixels x0 <= x < x0 + n in the first row of the grid cells j
+// and their increments from row to row; x0 is divisible by step
+static void interpolateRemapGridCells( const Mat& gridX, const Mat& gridY, const float* ramp, int step,
+                                       int j, int x0, int n, float* X, float* dX, float* Y, float* dY )
+{
+    float tstep = 1.f/step;
+    const float *gx0 = gridX.ptr<float>(j), *gx1 = gridX.ptr<float>(j+1);
+    const float *gy0 = gridY.ptr<float>(j), *gy1 = gridY.ptr<float>(j+1);
+
+    for( int x = 0, i = x0/step; x < n; x += step, i++ )
+    {
+        float ax = gx0[i], bx = gx0[i+1], dax = (gx1[i] - ax)*tstep, dbx = (gx1[i+1] - bx)*tstep;
+        float ay = gy0[i], by = gy0[i+1], day = (gy1[i] - ay)*tstep, dby = (gy1[i+1] - by)*tstep;
+        float kx = (bx - ax)*tstep, kdx = (dbx - dax)*tstep, ky = (by - ay)*tstep, kdy = (dby - day)*tstep;
+        for( int k = 0, len = std::min(step, n - x); k < len; k++ )
+        {
+            X[x + k] = ax + ramp[k]*kx;
+            dX[x + k] = dax + ramp[k]*kdx;
+            Y[x + k] = ay + ramp[k]*ky;
+            dY[x + k] = day + ramp[k]*kdy;
+        }
+    }
+}
+
+// computes the coordinates in the row t of the grid cells
+static void interpolateRemapGridRow( const float* X0, const float* dX, const float* Y0, const float* dY,
+                                     float t, int n, float* X, float* Y )
+{
+    int x = 0;
+#if CV_SIMD
+    v_float32 v_t = vx_setall_f32(t);
+    for( ; x <= n - v_float32::nlanes; x += v_float32::nlanes )
+    {
+        v_store(X + x, v_muladd(vx_load(dX + x), v_t, vx_load(X0 + x)));
+        v_store(Y + x, v_muladd(vx_load(dY + x), v_t, vx_load(Y0 + x)));
+    }
+#endif
+    for( ; x < n; x++ )
+    {
+        X[x] = X0[x] + dX[x]*t;
+        Y[x] = Y0[x] + dY[x]*t;
+    }
+}
+
+// computes the coordinates in the grid node (x, y) from the maps; the nodes outside of the maps are
+// extrapolated, so that the interpolation in the last cell is exact at the last column and row of the maps
+static inline Point2f remapGridNode( const Mat& mapX, const Mat& mapY, int x, int y, int step )
+{
+    int x1 = std::min(x, mapX.cols - 1), y1 = std::min(y, mapX.rows - 1);
+    int x0 = x > x1 ? x - step : x1, y0 = y > y1 ? y - step : y1;
+    float tx = x1 > x0 ? (float)step/(x1 - x0) : 0.f, ty = y1 > y0 ? (float)step/(y1 - y0) : 0.f;
+    Point2f v00(mapX.at<float>(y0, x0), mapY.at<float>(y0, x0)), v01(mapX.at<float>(y0, x1), mapY.at<float>(y0, x1));
+    Point2f v10(mapX.at<float>(y1, x0), mapY.at<float>(y1, x0)), v11(mapX.at<float>(y1, x1), mapY.at<float>(y1, x1));
+    Point2f v0 = v00 + (v01 - v00)*tx, v1 = v10 + (v11 - v10)*tx;
+    return v0 + (v1 - v0)*ty;
+}
+
+static bool compressRemapMaps( const Mat& mapX, const Mat& mapY, int step, double maxError,
+                               Mat& gridX, Mat& gridY, std::vector<float>& ramp )
+{
+    Size size = mapX.size();
+    int gw = std::max((size.width - 1 + step - 1)/step, 1) + 1;
+    int gh = std::max((size.height - 1 + step - 1)/step, 1) + 1;
+    gridX.create(gh, gw, CV_32F);
+    gridY.create(gh, gw, CV_32F);
+    for( int j = 0; j < gh; j++ )
+        for( int i = 0; i < gw; i++ )
+        {
+            Point2f v = remapGridNode(mapX, mapY, i*step, j*step, step);
+            gridX.at<float>(j, i) = v.x;
+            gridY.at<float>(j, i) = v.y;
+        }
+
+    ramp.resize(step);
+    for( int k = 0; k < step; k++ )
+        ramp[k] = (float)k;
+
+    AutoBuffer<float> _buf(size.width*6);
+    float *X0 = _buf.data(), *dX = X0 + size.width, *Y0 = dX + size.width, *dY = Y0 + size.width;
+    float *X = dY + size.width, *Y = X + size.width;
+    for( int y = 0; y < size.height; y++ )
+    {
+        if( y % step == 0 )
+            interpolateRemapGridCells(gridX, gridY, &ramp[0], step, y/step, 0, size.width, X0, dX, Y0, dY);
+        interpolateRemapGridRow(X0, dX, Y0, dY, (float)(y % step), size.width, X, Y);
+        const float* mx = mapX.ptr<float>(y);
+        const float* my = mapY.ptr<float>(y);
+        for( int x = 0; x < size.width; x++ )
+        {
+            // the maps with NaNs are not compressed
+            if( !(std::abs(X[x] - mx[x]) <= maxError && std::abs(Y[x] - my[x]) <= maxError) )
+                return false;
+        }
+    }
+    return true;
+}
+
+class CompiledRemapInvoker :
+    public ParallelLoopBody
+{
+public:
+    CompiledRemapInvoker(const Mat& _src, Mat& _dst, const Mat& _xy, const Mat& _alpha,
+                         const Mat& _gridX, const Mat& _gridY, const float* _ramp, int _gridStep,
+                         int _borderType, const Scalar& _borderValue,
+                         RemapNNFunc _nnfunc, RemapFunc _ifunc, const void* _ctab) :
+        ParallelLoopBody(), src(&_src), dst(&_dst), xy(&_xy), alpha(&_alpha),
+        gridX(&_gridX), gridY(&_gridY), ramp(_ramp), gridStep(_gridStep),
+        borderType(_borderType), borderValue(_borderValue),
+        nnfunc(_nnfunc), ifunc(_ifunc), ctab(_ctab)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        const int T = COMPILED_REMAP_TILE;
+        int width = dst->cols, height = dst->rows;
+        int tilesPerRow = (width + T - 1)/T;
+        Mat _bufxy, _bufa;
+        AutoBuffer<float> _bufXY;
+        if( gridStep > 0 )
+        {
+            _bufxy.create(T, T, CV_16SC2);
+            if( !nnfunc )
+                _bufa.create(T, T, CV_16UC1);
+            _bufXY.allocate(T*6);
+        }
+
+        for( int tile = range.start; tile < range.end; tile++ )
+        {
+            int y = (tile / tilesPerRow)*T, x = (tile % tilesPerRow)*T;
+            int bcols = std::min(T, width - x), brows = std::min(T, height - y);
+            Mat dpart(*dst, Rect(x, y, bcols, brows));
+            Mat bufxy, bufa;
+
+            if( gridStep > 0 )
+            {
+                bufxy = _bufxy(Rect(0, 0, bcols, brows));
+                if( !nnfunc )
+                    bufa = _bufa(Rect(0, 0, bcols, brows));
+                float *X0 = _bufXY.data(), *dX = X0 + T, *Y0 = dX + T, *dY = Y0 + T, *X = dY + T, *Y = X + T;
+                for( int y1 = 0; y1 < brows; y1++ )
+                {
+                    int t = (y + y1) % gridStep;
+                    if( y1 == 0 || t == 0 )
+                        interpolateRemapGridCells(*gridX, *gridY, ramp, gridStep, (y + y1)/gridStep, x, bcols,
+                                                  X0, dX, Y0, dY);
+                    interpolateRemapGridRow(X0, dX, Y0, dY, (float)t, bcols, X, Y);
+                    if( nnfunc )
+                        remapMapRowNN(X, Y, bufxy.ptr<short>(y1), bcols);
+                    else
+                        remapMapRow(X, Y, bufxy.ptr<short>(y1), bufa.ptr<ushort>(y1), bcols);
+                }
+            }
+            else
+            {
+                size_t ofs = (size_t)y*width + (size_t)x*brows;
+                bufxy = Mat(brows, bcols, CV_16SC2, (void*)xy->ptr<short>(0, (int)ofs));
+                if( !nnfunc )
+                    bufa = Mat(brows, bcols, CV_16UC1, (void*)alpha->ptr<ushort>(0, (int)ofs));
+            }
+
+            if( nnfunc )
+                nnfunc(*src, dpart, bufxy, borderType, borderValue);
+            else
+                ifunc(*src, dpart, bufxy, bufa, ctab, borderType, borderValue);
+        }
+    }
+
+private:
+    const Mat* src;
+    Mat* dst;
+    const Mat *xy, *alpha, *gridX, *gridY;
+    const float* ramp;
+    int gridStep;
+    int borderType;
+    Scalar borderValue;
+    RemapNNFunc nnfunc;
+    RemapFunc ifunc;
+    const void* ctab;
+
+    CompiledRemapInvoker& operator=(const CompiledRemapInvoker&); // = delete
+};
+
+CompiledRemap::CompiledRemap()
+{
+}
+
+CompiledRemap::CompiledRemap(InputArray map1, InputArray map2, int interpolation, double maxError)
+{
+    compile(map1, map2, interpolation, maxError);
+}
+
+void CompiledRemap::compile(InputArray _map1, InputArray _map2, int interpolation, double maxError)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !_map1.empty() );
+    CV_Assert( _map2.empty() || (_map2.size() == _map1.size()) );
+    if( interpolation == INTER_AREA )
+        interpolation = INTER_LINEAR;
+    CV_Check(interpolation, interpolation == INTER_NEAREST || interpolation == INTER_LINEAR ||
+                 interpolation == INTER_CUBIC || interpolation == INTER_LANCZOS4,
+                 "Unsupported interpolation method");
+    CV_Assert( maxError >= 0 );
+
+    Mat map1 = _map1.getMat(), map2 = _map2.getMat(), mapX, mapY;
+    if( map1.type() == CV_32FC1 && map2.type() == CV_32FC1 )
+        mapX = map1, mapY = map2;
+    else if( map1.type() == CV_32FC2 && map2.empty() )
+    {
+        Mat planes[2];
+        split(map1, planes);
+        mapX = planes[0], mapY = planes[1];
+    }
+    else
+        convertMaps(map1, map2, mapX, mapY, CV_32FC1, map1.type() == CV_16SC2 ? map2.empty() : map1.empty());
+
+    Ptr<Impl> impl = makePtr<Impl>();
+    impl->size = mapX.size();
+    impl->interpolation = interpolation;
+    impl->gridStep = 0;
+    CV_Assert( impl->size.width < SHRT_MAX && impl->size.height < SHRT_MAX );
+
+    if( maxError > 0 )
+    {
+        for( int step = COMPILED_REMAP_TILE; step >= COMPILED_REMAP_MIN_GRID_STEP; step /= 2 )
+            if( compressRemapMaps(mapX, mapY, step, maxError, impl->gridX, impl->gridY, impl->ramp) )
+            {
+                impl->gridStep = step;
+                break;
+            }
+    }
+
+    if( impl->gridStep == 0 )
+    {
+        const int T = COMPILED_REMAP_TILE;
+        Size size = impl->size;
+        bool nn = interpolation == INTER_NEAREST;
+        impl->gridX.release();
+        impl->gridY.release();
+        impl->xy.create(1, (int)mapX.total(), CV_16SC2);
+        if( !nn )
+            impl->alpha.create(1, (int)mapX.total(), CV_16UC1);
+        short* XY = impl->xy.ptr<short>();
+        ushort* A = nn ? 0 : impl->alpha.ptr<ushort>();
+
+        for( int y = 0; y < size.height; y += T )
+            for( int x = 0; x < size.width; x += T )
+            {
+                int bcols = std::min(T, size.width - x), brows = std::min(T, size.height - y);
+                for( int y1 = 0; y1 < brows; y1++, XY += bcols*2, A += nn ? 0 : bcols )
+                {
+                    if( nn )
+                        remapMapRowNN(mapX.ptr<float>(y + y1) + x, mapY.ptr<float>(y + y1) + x, XY, bcols);
+                    else
+                        remapMapRow(mapX.ptr<float>(y + y1) + x, mapY.ptr<float>(y + y1) + x, XY, A, bcols);
+                }
+            }
+    }
+    p = impl;
+}
+
+void CompiledRemap::apply(InputArray _src, OutputArray _dst, int borderMode, const Scalar& borderValue) const
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !empty() );
+    Mat src = _src.getMat();
+    CV_Assert( !src.empty() && src.cols < SHRT_MAX && src.rows < SHRT_MAX );
+    _dst.create(p->size, src.type());
+    Mat dst = _dst.getMat();
+    if( dst.data == src.data )
+        src = src.clone();
+
+    RemapNNFunc nnfunc = 0;
+    RemapFunc ifunc = 0;
+    const void* ctab = 0;
+    getRemapFuncs(src.type(), p->interpolation, nnfunc, ifunc, ctab);
+
+    const int T = COMPILED_REMAP_TILE;
+    int ntiles = ((dst.cols + T - 1)/T)*((dst.rows + T - 1)/T);
+    CompiledRemapInvoker invoker(src, dst, p->xy, p->alpha, p->gridX, p->gridY,
+                                 p->ramp.empty() ? 0 : &p->ramp[0], p->gridStep,
+                                 borderMode, borderValue, nnfunc, ifunc, ctab);
+    parallel_for_(Range(0, ntiles), invoker, dst.total()/(double)(1<<16));
+}
+
+Size CompiledRemap::size() const
+{
+    return p ? p->size : Size();
+}
+
+bool CompiledRemap::empty() const
+{
+    return !p;
+}
+
+int CompiledRemap::getInterpolation() const
+{
+    CV_Assert( !empty() );
+    return p->interpolation;
+}
+
+int CompiledRemap::getGridStep() const
+{
+    CV_Assert( !empty() );
+    return p->gridStep;
+}
+
+}
+
 namespace cv
 {
 
@@ -943,6 +943,260 @@ medianBlur_SortNet( const Mat& _src, Mat& _dst, int m )
     }
 }
 
+/*
+ * Median filter for 16-bit and floating-point images with large apertures.
+ *
+ * The aperture histogram of 16-bit keys is kept in four levels (by 4, 8, 12 and 16 upper bits
+ * of the keys), so the median is found by scanning at most 16 bins on every level. The aperture
+ * moves in zigzag through a block of rows (Huang's algorithm), so each step adds and removes
+ * a single aperture column or row. The cost per pixel is O(ksize) for the histogram updates
+ * plus a constant for the search.
+ *
+ * Floating-point images are processed in tiles small enough for the ranks of their values to
+ * fit into 16 bits: the values of a tile are sorted, replaced by the ranks, filtered and mapped back.
+ */
+class MedianHist16u
+{
+public:
+    MedianHist16u()
+    {
+        for( int l = 0; l < LEVELS; l++ )
+            h[l].resize(1 << (16 - l*4));
+    }
+
+    void reset()
+    {
+        for( int l = 0; l < LEVELS; l++ )
+            std::fill(h[l].begin(), h[l].end(), 0);
+    }
+
+    inline void add(int v)
+    {
+        h[0][v]++;
+        h[1][v >> 4]++;
+        h[2][v >> 8]++;
+        h[3][v >> 12]++;
+    }
+
+    inline void remove(int v)
+    {
+        h[0][v]--;
+        h[1][v >> 4]--;
+        h[2][v >> 8]--;
+        h[3][v >> 12]--;
+    }
+
+    // returns the key of the given (0-based) rank
+    inline int kth(int t) const
+    {
+        int v = 0;
+        for( int l = LEVELS - 1; l >= 0; l-- )
+        {
+            // the 16 bins of the level inside the bin v of the coarser level
+            const int* H = &h[l][v << 4];
+            int i = 0;
+            for( ; t >= H[i]; i++ )
+                t -= H[i];
+            v = (v << 4) + i;
+        }
+        return v;
+    }
+
+protected:
+    // the histograms of the keys and of their upper 12, 8 and 4 bits
+    enum { LEVELS = 4 };
+    std::vector<int> h[LEVELS];
+};
+
+// rows[i] points to the leftmost element of the i-th source row, including the left border of ksize/2 pixels;
+// there are height + ksize - 1 rows
+static void
+medianBlur_16u_Huang( const ushort** rows, int cn, int width, int height, int ksize,
+                      ushort* dst, size_t dstep, MedianHist16u& hist )
+{
+    int t = ksize*ksize/2;
+
+    for( int c = 0; c < cn; c++ )
+    {
+        int i, j, x = 0;
+
+        hist.reset();
+        for( i = 0; i < ksize; i++ )
+            for( j = 0; j < ksize; j++ )
+                hist.add(rows[i][j*cn + c]);
+
+        for( int y = 0; y < height; y++ )
+        {
+            if( y > 0 )
+            {
+                const ushort* r0 = rows[y - 1] + x*cn + c;
+                const ushort* r1 = rows[y + ksize - 1] + x*cn + c;
+                for( j = 0; j < ksize*cn; j += cn )
+                {
+                    hist.remove(r0[j]);
+                    hist.add(r1[j]);
+                }
+            }
+
+            int dx = y % 2 == 0 ? 1 : -1;
+            ushort* d = dst + dstep*y + c;
+            for( ;; x += dx )
+            {
+                d[x*cn] = (ushort)hist.kth(t);
+                if( x + dx < 0 || x + dx >= width )
+                    break;
+
+                int xr = (dx > 0 ? x : x + ksize - 1)*cn + c;
+                int xa = (dx > 0 ? x + ksize : x - 1)*cn + c;
+                for( i = 0; i < ksize; i++ )
+                {
+                    const ushort* r = rows[y + i];
+                    hist.remove(r[xr]);
+                    hist.add(r[xa]);
+                }
+            }
+        }
+    }
+}
+
+class MedianBlur16uInvoker : public ParallelLoopBody
+{
+public:
+    MedianBlur16uInvoker(const Mat& _src, Mat& _dst, int _ksize, int _nstripes) :
+        src(_src), dst(_dst), ksize(_ksize), nstripes(_nstripes)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int height = dst.rows, r = ksize/2;
+        int y0 = (int)((int64)range.start*height/nstripes);
+        int y1 = (int)((int64)range.end*height/nstripes);
+
+        std::vector<const ushort*> rows(y1 - y0 + ksize - 1);
+        for( int i = 0; i < (int)rows.size(); i++ )
+            rows[i] = src.ptr<ushort>(std::min(std::max(y0 + i - r, 0), height - 1));
+
+        MedianHist16u hist;
+        medianBlur_16u_Huang(&rows[0], dst.channels(), dst.cols, y1 - y0, ksize,
+                             dst.ptr<ushort>(y0), dst.step1(), hist);
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    int ksize;
+    int nstripes;
+
+    MedianBlur16uInvoker& operator=(const MedianBlur16uInvoker&); // = delete
+};
+
+class MedianBlur32fInvoker : public ParallelLoopBody
+{
+public:
+    MedianBlur32fInvoker(const Mat& _src, Mat& _dst, int _ksize, int _tileSize) :
+        src(_src), dst(_dst), ksize(_ksize), tileSize(_tileSize)
+    {
+        tilesX = (dst.cols + tileSize - 1)/tileSize;
+    }
+
+    // maps the floating-point values to the unsigned integers of the same order
+    static inline unsigned floatToKey(unsigned u)
+    {
+        return u ^ ((u & 0x80000000u) ? 0xffffffffu : 0x80000000u);
+    }
+
+    static inline unsigned keyToFloat(unsigned k)
+    {
+        return k ^ ((k & 0x80000000u) ? 0x80000000u : 0xffffffffu);
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int cn = dst.channels(), r = ksize/2;
+        int maxSize = tileSize + ksize - 1;
+        std::vector<uint64> keys(maxSize*maxSize);
+        std::vector<ushort> ranks(maxSize*maxSize), result(tileSize*tileSize);
+        std::vector<unsigned> values(maxSize*maxSize);
+        std::vector<const ushort*> rows(maxSize);
+        MedianHist16u hist;
+
+        for( int tile = range.start; tile < range.end; tile++ )
+        {
+            int x0 = (tile % tilesX)*tileSize, y0 = (tile / tilesX)*tileSize;
+            int tw = std::min(tileSize, dst.cols - x0), th = std::min(tileSize, dst.rows - y0);
+            int pw = tw + ksize - 1, ph = th + ksize - 1, n = pw*ph;
+
+            for( int i = 0; i < ph; i++ )
+                rows[i] = &ranks[i*pw];
+
+            for( int c = 0; c < cn; c++ )
+            {
+                int i, j, k, nvals = 0;
+
+                for( i = 0; i < ph; i++ )
+                {
+                    const unsigned* s = src.ptr<unsigned>(std::min(std::max(y0 + i - r, 0), dst.rows - 1)) + x0*cn + c;
+                    for( j = 0; j < pw; j++ )
+                        keys[i*pw + j] = ((uint64)floatToKey(s[j*cn]) << 32) | (unsigned)(i*pw + j);
+                }
+                std::sort(keys.begin(), keys.begin() + n);
+
+                for( k = 0; k < n; k++ )
+                {
+                    unsigned key = (unsigned)(keys[k] >> 32);
+                    if( k == 0 || key != values[nvals - 1] )
+                        values[nvals++] = key;
+                    ranks[(unsigned)keys[k]] = (ushort)(nvals - 1);
+                }
+
+                medianBlur_16u_Huang(&rows[0], 1, tw, th, ksize, &result[0], tw, hist);
+
+                for( i = 0; i < th; i++ )
+                {
+                    unsigned* d = dst.ptr<unsigned>(y0 + i) + x0*cn + c;
+                    const ushort* res = &result[i*tw];
+                    for( j = 0; j < tw; j++ )
+                        d[j*cn] = keyToFloat(values[res[j]]);
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    int ksize;
+    int tileSize;
+    int tilesX;
+
+    MedianBlur32fInvoker& operator=(const MedianBlur32fInvoker&); // = delete
+};
+
+// src is padded by ksize/2 pixels on the left and on the right
+static void
+medianBlur_16u32f_Hist( const Mat& src, Mat& dst, int ksize )
+{
+    CV_INSTRUMENT_REGION();
+
+    int nthreads = std::max(getNumThreads(), 1);
+    if( src.depth() == CV_16U )
+    {
+        int nstripes = std::max(std::min(dst.rows, nthreads*4), 1);
+        parallel_for_(Range(0, nstripes), MedianBlur16uInvoker(src, dst, ksize, nstripes), nstripes);
+    }
+    else
+    {
+        CV_Assert( src.depth() == CV_32F );
+        // (tileSize + ksize - 1)^2 ranks must fit into 16 bits. Every tile sorts up to 65536 keys, so
+        // the aperture is limited to keep at least a half of the 256x256 window for the output pixels
+        CV_CheckLE(ksize, 127, "Floating-point median filter supports apertures up to 127");
+        int tileSize = 257 - ksize;
+        int ntiles = ((dst.cols + tileSize - 1)/tileSize)*((dst.rows + tileSize - 1)/tileSize);
+        parallel_for_(Range(0, ntiles), MedianBlur32fInvoker(src, dst, ksize, tileSize));
+    }
+}
+
 } // namespace anon
 
 void medianBlur(const Mat& src0, /*const*/ Mat& dst, int ksize)
@@ -981,6 +1235,12 @@ void medianBlur(const Mat& src0, /*const*/ Mat& dst, int ksize)
         // TODO AVX guard (external call)
         cv::copyMakeBorder( src0, src, 0, 0, ksize/2, ksize/2, BORDER_REPLICATE|BORDER_ISOLATED);
 
+        if( src.depth() == CV_16U || src.depth() == CV_32F )
+        {
+            medianBlur_16u32f_Hist( src, dst, ksize );
+            return;
+        }
+
         int cn = src0.channels();
         CV_Assert( src.depth() == CV_8U && (cn == 1 || cn == 3 || cn == 4) );
 
@@ -670,6 +670,27 @@ cv::Moments cv::moments( InputArray _src, bool binary )
     return m;
 }
 
+void cv::momentsBatch( InputArray _points, InputArray _offsets, std::vector<Moments>& moments )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat points = _points.getMat(), offsets = _offsets.getMat();
+    int ncontours = checkContourBatch(points, offsets);
+    const int* ofs = offsets.ptr<int>();
+    const Point* data = points.ptr<Point>();
+    int type = points.depth() == CV_32F ? CV_32FC2 : CV_32SC2;
+
+    moments.resize(ncontours);
+    parallel_for_(Range(0, ncontours), [&](const Range& r)
+    {
+        for( int i = r.start; i < r.end; i++ )
+        {
+            int n = ofs[i+1] - ofs[i];
+            moments[i] = n == 0 ? Moments() : contourMoments(Mat(n, 1, type, (void*)(data + ofs[i])));
+        }
+    }, contourBatchStripes(points, ncontours));
+}
+
 
 void cv::HuMoments( const Moments& m, double hu[7] )
 {
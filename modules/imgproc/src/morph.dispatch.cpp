@@ -87,6 +87,35 @@ Ptr<BaseFilter> getMorphologyFilter(int op, int type, InputArray _kernel, Point
 }
 
 
+static bool morphVHGW(int op, const Mat& src, Mat& dst, Size wholeSize, Point ofs,
+                      const Mat& kernel, Point anchor, int borderType, const Scalar& borderValue)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_CPU_DISPATCH(morphVHGW, (op, src, dst, wholeSize, ofs, kernel, anchor, borderType, borderValue),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+// replaces morphologyDefaultBorderValue() with the value that does not affect the result
+static Scalar morphBorderValue(int op, int type, const Scalar& borderValue)
+{
+    if( borderValue != morphologyDefaultBorderValue() )
+        return borderValue;
+
+    int depth = CV_MAT_DEPTH(type);
+    CV_Assert( depth == CV_8U || depth == CV_16U || depth == CV_16S ||
+               depth == CV_32F || depth == CV_64F );
+    if( op == MORPH_ERODE )
+        return Scalar::all( depth == CV_8U ? (double)UCHAR_MAX :
+                            depth == CV_16U ? (double)USHRT_MAX :
+                            depth == CV_16S ? (double)SHRT_MAX :
+                            depth == CV_32F ? (double)FLT_MAX : DBL_MAX);
+    return Scalar::all( depth == CV_8U || depth == CV_16U ?
+                            0. :
+                        depth == CV_16S ? (double)SHRT_MIN :
+                        depth == CV_32F ? (double)-FLT_MAX : -DBL_MAX);
+}
+
 Ptr<FilterEngine> createMorphologyFilter(
         int op, int type, InputArray _kernel,
         Point anchor, int _rowBorderType, int _columnBorderType,
@@ -109,23 +138,8 @@ Ptr<FilterEngine> createMorphologyFilter(
         filter2D = getMorphologyFilter(op, type, kernel, anchor);
 
     Scalar borderValue = _borderValue;
-    if( (_rowBorderType == BORDER_CONSTANT || _columnBorderType == BORDER_CONSTANT) &&
-            borderValue == morphologyDefaultBorderValue() )
-    {
-        int depth = CV_MAT_DEPTH(type);
-        CV_Assert( depth == CV_8U || depth == CV_16U || depth == CV_16S ||
-                   depth == CV_32F || depth == CV_64F );
-        if( op == MORPH_ERODE )
-            borderValue = Scalar::all( depth == CV_8U ? (double)UCHAR_MAX :
-                                       depth == CV_16U ? (double)USHRT_MAX :
-                                       depth == CV_16S ? (double)SHRT_MAX :
-                                       depth == CV_32F ? (double)FLT_MAX : DBL_MAX);
-        else
-            borderValue = Scalar::all( depth == CV_8U || depth == CV_16U ?
-                                           0. :
-                                       depth == CV_16S ? (double)SHRT_MIN :
-                                       depth == CV_32F ? (double)-FLT_MAX : -DBL_MAX);
-    }
+    if( _rowBorderType == BORDER_CONSTANT || _columnBorderType == BORDER_CONSTANT )
+        borderValue = morphBorderValue(op, type, borderValue);
 
     return makePtr<FilterEngine>(filter2D, rowFilter, columnFilter,
                                  type, type, type, _rowBorderType, _columnBorderType, borderValue );
@@ -444,6 +458,22 @@ static void ocvMorph(int op, int src_type, int dst_type,
     Mat kernel(Size(kernel_width, kernel_height), kernel_type, kernel_data, kernel_step);
     Point anchor(anchor_x, anchor_y);
     Vec<double, 4> borderVal(borderValue);
+    {
+        // large rectangles and shapes made of them, e.g. ellipses, are processed
+        // by the van Herk/Gil-Werman filters
+        Mat src(Size(width, height), src_type, src_data, src_step);
+        Mat dst(Size(width, height), dst_type, dst_data, dst_step);
+        Scalar bval = borderType == BORDER_CONSTANT ? morphBorderValue(op, src_type, borderVal) : Scalar(borderVal);
+        if( src_type == dst_type &&
+            morphVHGW(op, src, dst, Size(roi_width, roi_height), Point(roi_x, roi_y),
+                      kernel, anchor, borderType, bval) )
+        {
+            for( int i = 1; i < iterations; i++ )
+                morphVHGW(op, dst, dst, Size(roi_width2, roi_height2), Point(roi_x2, roi_y2),
+                          kernel, anchor, borderType, bval);
+            return;
+        }
+    }
     Ptr<FilterEngine> f = createMorphologyFilter(op, src_type, kernel, anchor, borderType, borderType, borderVal);
     Mat src(Size(width, height), src_type, src_data, src_step);
     Mat dst(Size(width, height), dst_type, dst_data, dst_step);
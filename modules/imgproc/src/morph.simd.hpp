@@ -54,6 +54,8 @@ CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
 Ptr<BaseRowFilter> getMorphologyRowFilter(int op, int type, int ksize, int anchor);
 Ptr<BaseColumnFilter> getMorphologyColumnFilter(int op, int type, int ksize, int anchor);
 Ptr<BaseFilter> getMorphologyFilter(int op, int type, const Mat& kernel, Point anchor);
+bool morphVHGW(int op, const Mat& src, Mat& dst, Size wholeSize, Point ofs,
+               const Mat& kernel, Point anchor, int borderType, const Scalar& borderValue);
 
 #ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
 
@@ -106,6 +108,11 @@ struct MorphNoVec
     int operator()(uchar**, int, uchar*, int) const { return 0; }
 };
 
+struct MorphLineNoVec
+{
+    int operator()(const uchar*, const uchar*, uchar*, int) const { return 0; }
+};
+
 #if CV_SIMD
 
 template<class VecUpdate> struct MorphRowVec
@@ -406,6 +413,23 @@ template<class VecUpdate> struct MorphVec
     }
 };
 
+template<class VecUpdate> struct MorphLineVec
+{
+    typedef typename VecUpdate::vtype vtype;
+    typedef typename vtype::lane_type stype;
+    int operator()(const uchar* _a, const uchar* _b, uchar* _d, int len) const
+    {
+        const stype* a = (const stype*)_a;
+        const stype* b = (const stype*)_b;
+        stype* d = (stype*)_d;
+        VecUpdate updateOp;
+        int i = 0;
+        for( ; i <= len - vtype::nlanes; i += vtype::nlanes )
+            v_store(d + i, updateOp(vx_load(a + i), vx_load(b + i)));
+        return i;
+    }
+};
+
 template <typename T> struct VMin
 {
     typedef T vtype;
@@ -444,6 +468,15 @@ typedef MorphVec<VMax<v_int16> > DilateVec16s;
 typedef MorphVec<VMin<v_float32> > ErodeVec32f;
 typedef MorphVec<VMax<v_float32> > DilateVec32f;
 
+typedef MorphLineVec<VMin<v_uint8> > ErodeLineVec8u;
+typedef MorphLineVec<VMax<v_uint8> > DilateLineVec8u;
+typedef MorphLineVec<VMin<v_uint16> > ErodeLineVec16u;
+typedef MorphLineVec<VMax<v_uint16> > DilateLineVec16u;
+typedef MorphLineVec<VMin<v_int16> > ErodeLineVec16s;
+typedef MorphLineVec<VMax<v_int16> > DilateLineVec16s;
+typedef MorphLineVec<VMin<v_float32> > ErodeLineVec32f;
+typedef MorphLineVec<VMax<v_float32> > DilateLineVec32f;
+
 #else
 
 typedef MorphRowNoVec ErodeRowVec8u;
@@ -475,6 +508,15 @@ typedef MorphNoVec DilateVec16s;
 typedef MorphNoVec ErodeVec32f;
 typedef MorphNoVec DilateVec32f;
 
+typedef MorphLineNoVec ErodeLineVec8u;
+typedef MorphLineNoVec DilateLineVec8u;
+typedef MorphLineNoVec ErodeLineVec16u;
+typedef MorphLineNoVec DilateLineVec16u;
+typedef MorphLineNoVec ErodeLineVec16s;
+typedef MorphLineNoVec DilateLineVec16s;
+typedef MorphLineNoVec ErodeLineVec32f;
+typedef MorphLineNoVec DilateLineVec32f;
+
 #endif
 
 typedef MorphRowNoVec ErodeRowVec64f;
@@ -483,6 +525,8 @@ typedef MorphColumnNoVec ErodeColumnVec64f;
 typedef MorphColumnNoVec DilateColumnVec64f;
 typedef MorphNoVec ErodeVec64f;
 typedef MorphNoVec DilateVec64f;
+typedef MorphLineNoVec ErodeLineVec64f;
+typedef MorphLineNoVec DilateLineVec64f;
 
 
 template<class Op, class VecOp> struct MorphRowFilter : public BaseRowFilter
@@ -704,6 +748,369 @@ template<class Op, class VecOp> struct MorphFilter : BaseFilter
     VecOp vecOp;
 };
 
+/*
+ * van Herk/Gil-Werman filters. The running minimum/maximum over ksize elements is composed
+ * of the suffixes and the prefixes of the blocks of ksize elements, so it takes 3 operations
+ * per element regardless of ksize.
+ */
+
+// the number of elements processed by one operation of the direct filters
+static inline int morphVecLanes(int depth)
+{
+#if CV_SIMD
+    if( depth != CV_64F )
+        return v_uint8::nlanes/CV_ELEM_SIZE1(depth);
+#else
+    CV_UNUSED(depth);
+#endif
+    return 1;
+}
+
+// the aperture sizes starting from which the van Herk/Gil-Werman filters are used (chosen empirically)
+static inline int morphRowVHGWKSize(int depth)
+{
+    // the scalar van Herk/Gil-Werman row filter against the vectorized direct one
+    return std::max(morphVecLanes(depth)*8, 8);
+}
+
+static inline int morphColumnVHGWKSize(int depth)
+{
+    // the direct column filter works in the cache, while the van Herk/Gil-Werman one
+    // makes several passes over the rows
+    return CV_ELEM_SIZE1(depth)*8;
+}
+
+// d = op(a, b) for len elements
+template<class Op, class VecOp> static inline void
+morphUpdateLine( const uchar* a, const uchar* b, uchar* d, int len )
+{
+    typedef typename Op::rtype T;
+    Op op;
+    int i = VecOp()(a, b, d, len);
+    const T* A = (const T*)a;
+    const T* B = (const T*)b;
+    T* D = (T*)d;
+    for( ; i < len; i++ )
+        D[i] = op(A[i], B[i]);
+}
+
+template<class Op> struct MorphRowFilterVHGW : public BaseRowFilter
+{
+    typedef typename Op::rtype T;
+
+    MorphRowFilterVHGW( int _ksize, int _anchor )
+    {
+        ksize = _ksize;
+        anchor = _anchor;
+    }
+
+    void operator()(const uchar* src, uchar* dst, int width, int cn) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        const T* S = (const T*)src;
+        T* D = (T*)dst;
+        Op op;
+
+        for( int x0 = 0; x0 < width; x0 += ksize )
+        {
+            int x1 = std::min(x0 + ksize, width);
+            for( int c = 0; c < cn; c++ )
+            {
+                // suffixes of the block [x0, x0 + ksize)
+                int x = x0 + ksize - 1;
+                T m = S[x*cn + c];
+                for( ;; )
+                {
+                    if( x < x1 )
+                        D[x*cn + c] = m;
+                    if( --x < x0 )
+                        break;
+                    m = op(m, S[x*cn + c]);
+                }
+
+                // prefixes of the next block
+                if( x0 + 1 < x1 )
+                {
+                    m = S[(x0 + ksize)*cn + c];
+                    D[(x0 + 1)*cn + c] = op(D[(x0 + 1)*cn + c], m);
+                    for( x = x0 + 2; x < x1; x++ )
+                    {
+                        m = op(m, S[(x + ksize - 1)*cn + c]);
+                        D[x*cn + c] = op(D[x*cn + c], m);
+                    }
+                }
+            }
+        }
+    }
+};
+
+// unlike MorphColumnFilter, the cost per row is constant only if count is large compared to ksize
+template<class Op, class VecOp> struct MorphColumnFilterVHGW : public BaseColumnFilter
+{
+    typedef typename Op::rtype T;
+
+    MorphColumnFilterVHGW( int _ksize, int _anchor )
+    {
+        ksize = _ksize;
+        anchor = _anchor;
+    }
+
+    void operator()(const uchar** src, uchar* dst, int dststep, int count, int width) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        AutoBuffer<T> _buf(width);
+        uchar* buf = (uchar*)_buf.data();
+
+        for( int y0 = 0; y0 < count; y0 += ksize )
+        {
+            int y1 = std::min(y0 + ksize, count);
+
+            // suffixes of the block [y0, y0 + ksize)
+            int y = y0 + ksize - 1;
+            const uchar* prev = src[y];
+            if( y < y1 )
+                memcpy(dst + (size_t)dststep*y, prev, width*sizeof(T));
+            for( y--; y >= y0; y-- )
+            {
+                uchar* target = y < y1 ? dst + (size_t)dststep*y : buf;
+                morphUpdateLine<Op, VecOp>(src[y], prev, target, width);
+                prev = target;
+            }
+
+            // prefixes of the next block
+            if( y0 + 1 < y1 )
+            {
+                prev = src[y0 + ksize];
+                for( y = y0 + 1; y < y1; y++ )
+                {
+                    if( y > y0 + 1 )
+                    {
+                        morphUpdateLine<Op, VecOp>(prev, src[y + ksize - 1], buf, width);
+                        prev = buf;
+                    }
+                    uchar* D = dst + (size_t)dststep*y;
+                    morphUpdateLine<Op, VecOp>(D, prev, D, width);
+                }
+            }
+        }
+    }
+};
+
+static Ptr<BaseColumnFilter> getMorphologyColumnFilterVHGW(int op, int type, int ksize)
+{
+    int depth = CV_MAT_DEPTH(type);
+    if( op == MORPH_ERODE )
+    {
+        if( depth == CV_8U )
+            return makePtr<MorphColumnFilterVHGW<MinOp<uchar>, ErodeLineVec8u> >(ksize, 0);
+        if( depth == CV_16U )
+            return makePtr<MorphColumnFilterVHGW<MinOp<ushort>, ErodeLineVec16u> >(ksize, 0);
+        if( depth == CV_16S )
+            return makePtr<MorphColumnFilterVHGW<MinOp<short>, ErodeLineVec16s> >(ksize, 0);
+        if( depth == CV_32F )
+            return makePtr<MorphColumnFilterVHGW<MinOp<float>, ErodeLineVec32f> >(ksize, 0);
+        if( depth == CV_64F )
+            return makePtr<MorphColumnFilterVHGW<MinOp<double>, ErodeLineVec64f> >(ksize, 0);
+    }
+    else
+    {
+        if( depth == CV_8U )
+            return makePtr<MorphColumnFilterVHGW<MaxOp<uchar>, DilateLineVec8u> >(ksize, 0);
+        if( depth == CV_16U )
+            return makePtr<MorphColumnFilterVHGW<MaxOp<ushort>, DilateLineVec16u> >(ksize, 0);
+        if( depth == CV_16S )
+            return makePtr<MorphColumnFilterVHGW<MaxOp<short>, DilateLineVec16s> >(ksize, 0);
+        if( depth == CV_32F )
+            return makePtr<MorphColumnFilterVHGW<MaxOp<float>, DilateLineVec32f> >(ksize, 0);
+        if( depth == CV_64F )
+            return makePtr<MorphColumnFilterVHGW<MaxOp<double>, DilateLineVec64f> >(ksize, 0);
+    }
+
+    CV_Error_( CV_StsNotImplemented, ("Unsupported data type (=%d)", type));
+}
+
+// horizontal pass of a rectangular structuring element: the rows of the source image
+// (including the vertical border) are padded and filtered into buf
+class MorphRectRowInvoker : public ParallelLoopBody
+{
+public:
+    MorphRectRowInvoker( const Mat& _src, Mat& _buf, Size _wholeSize, Point _ofs, Rect _r,
+                         int _borderType, const uchar* _borderValue, BaseRowFilter* _rowFilter ) :
+        src(_src), buf(_buf), wholeSize(_wholeSize), ofs(_ofs), r(_r), borderType(_borderType),
+        borderValue(_borderValue), rowFilter(_rowFilter)
+    {
+        int padWidth = src.cols + r.width - 1;
+        // [0, xl) and [xr, padWidth) are the border elements of the padded rows
+        xl = std::min(std::max(-(ofs.x + r.x), 0), padWidth);
+        xr = std::min(std::max(wholeSize.width - (ofs.x + r.x), xl), padWidth);
+        xtab.resize(padWidth);
+        for( int p = 0; p < padWidth; p++ )
+        {
+            int x = ofs.x + r.x + p;
+            if( p < xl || p >= xr )
+                x = borderInterpolate(x, wholeSize.width, borderType);
+            // the offsets are relative to the ROI, so they are negative on the left of it
+            xtab[p] = x < 0 ? INT_MIN : x - ofs.x;
+        }
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int cn = src.channels(), esz = (int)src.elemSize();
+        int padWidth = (int)xtab.size();
+        AutoBuffer<double> _pad((padWidth*esz + sizeof(double) - 1)/sizeof(double));
+        uchar* pad = (uchar*)_pad.data();
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int y = ofs.y + r.y + i, p;
+            if( y < 0 || y >= wholeSize.height )
+                y = borderInterpolate(y, wholeSize.height, borderType);
+
+            if( y < 0 )
+            {
+                for( p = 0; p < padWidth; p++ )
+                    memcpy(pad + p*esz, borderValue, esz);
+            }
+            else
+            {
+                // the row may be outside of the source ROI, but inside of the whole image
+                const uchar* S = src.data + src.step*(ptrdiff_t)(y - ofs.y);
+                for( p = 0; p < padWidth; p++ )
+                {
+                    if( p == xl && xr > xl )
+                    {
+                        memcpy(pad + p*esz, S + (ptrdiff_t)xtab[p]*esz, (xr - xl)*esz);
+                        p = xr - 1;
+                        continue;
+                    }
+                    memcpy(pad + p*esz, xtab[p] == INT_MIN ? borderValue : S + (ptrdiff_t)xtab[p]*esz, esz);
+                }
+            }
+
+            (*rowFilter)(pad, buf.ptr(i), src.cols, cn);
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& buf;
+    Size wholeSize;
+    Point ofs;
+    Rect r;
+    int borderType;
+    const uchar* borderValue;
+    BaseRowFilter* rowFilter;
+    std::vector<int> xtab;
+    int xl, xr;
+
+    MorphRectRowInvoker& operator=(const MorphRectRowInvoker&); // = delete
+};
+
+class MorphRectColumnInvoker : public ParallelLoopBody
+{
+public:
+    MorphRectColumnInvoker( const Mat& _buf, Mat& _dst, BaseColumnFilter* _columnFilter, int _nstripes ) :
+        buf(_buf), dst(_dst), columnFilter(_columnFilter), nstripes(_nstripes)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int y0 = (int)((int64)range.start*dst.rows/nstripes);
+        int y1 = (int)((int64)range.end*dst.rows/nstripes);
+        int n = y1 - y0 + columnFilter->ksize - 1;
+
+        AutoBuffer<const uchar*> rows(n);
+        for( int i = 0; i < n; i++ )
+            rows[i] = buf.ptr(y0 + i);
+        (*columnFilter)(rows.data(), dst.ptr(y0), (int)dst.step, y1 - y0, dst.cols*dst.channels());
+    }
+
+private:
+    const Mat& buf;
+    Mat& dst;
+    BaseColumnFilter* columnFilter;
+    int nstripes;
+
+    MorphRectColumnInvoker& operator=(const MorphRectColumnInvoker&); // = delete
+};
+
+// dst(x, y) = op(src(x + r.x ... x + r.x + r.width - 1, y + r.y ... y + r.y + r.height - 1));
+// dst may be the same as src
+static void
+morphRect( int op, const Mat& src, Mat& dst, Size wholeSize, Point ofs, Rect r,
+           int borderType, const Scalar& borderValue )
+{
+    CV_INSTRUMENT_REGION();
+
+    int type = src.type();
+    Ptr<BaseRowFilter> rowFilter = getMorphologyRowFilter(op, type, r.width, 0);
+    Ptr<BaseColumnFilter> columnFilter = r.height >= morphColumnVHGWKSize(src.depth()) ?
+        getMorphologyColumnFilterVHGW(op, type, r.height) :
+        getMorphologyColumnFilter(op, type, r.height, 0);
+
+    double borderBuf[CV_CN_MAX];
+    scalarToRawData(borderValue, borderBuf, type, 0);
+
+    // the direct column filter expects aligned rows
+    size_t bufStep = alignSize(src.cols*src.elemSize(), 64);
+    Mat bufData(src.rows + r.height - 1, (int)bufStep, CV_8U);
+    Mat buf(bufData.rows, src.cols, type, bufData.ptr(), bufStep);
+    parallel_for_(Range(0, buf.rows),
+                  MorphRectRowInvoker(src, buf, wholeSize, ofs, r, borderType, (const uchar*)borderBuf, rowFilter.get()),
+                  buf.total()/(double)(1<<16));
+
+    // the van Herk/Gil-Werman column filter needs stripes of several ksize
+    int nstripes = std::max(std::min(dst.rows/(r.height*2), getNumThreads()*2), 1);
+    parallel_for_(Range(0, nstripes), MorphRectColumnInvoker(buf, dst, columnFilter.get(), nstripes), nstripes);
+}
+
+// represents the kernel as a union of rectangles; every row of the kernel must be a single run
+static bool decomposeMorphKernel( const Mat& kernel, std::vector<Rect>& rects )
+{
+    int i, j, rows = kernel.rows, cols = kernel.cols;
+    std::vector<Vec2i> runs(rows);
+
+    for( i = 0; i < rows; i++ )
+    {
+        const uchar* k = kernel.ptr<uchar>(i);
+        int j1 = 0;
+        while( j1 < cols && !k[j1] )
+            j1++;
+        int j2 = j1;
+        while( j2 < cols && k[j2] )
+            j2++;
+        for( j = j2; j < cols; j++ )
+            if( k[j] )
+                return false;
+        runs[i] = Vec2i(j1, j2);
+    }
+
+    rects.clear();
+    for( i = 0; i < rows; i++ )
+    {
+        int j1 = runs[i][0], j2 = runs[i][1];
+        if( j1 == j2 )
+            continue;
+
+        // the maximal band of rows containing the run
+        int i1 = i, i2 = i + 1;
+        while( i1 > 0 && runs[i1 - 1][0] <= j1 && runs[i1 - 1][1] >= j2 )
+            i1--;
+        while( i2 < rows && runs[i2][0] <= j1 && runs[i2][1] >= j2 )
+            i2++;
+
+        Rect r(j1, i1, j2 - j1, i2 - i1);
+        if( std::find(rects.begin(), rects.end(), r) == rects.end() )
+            rects.push_back(r);
+    }
+
+    return !rects.empty();
+}
+
 } // namespace anon
 
 /////////////////////////////////// External Interface /////////////////////////////////////
@@ -716,6 +1123,24 @@ Ptr<BaseRowFilter> getMorphologyRowFilter(int op, int type, int ksize, int ancho
     if( anchor < 0 )
         anchor = ksize/2;
     CV_Assert( op == MORPH_ERODE || op == MORPH_DILATE );
+    if( ksize >= morphRowVHGWKSize(depth) )
+    {
+        if( depth == CV_8U )
+            return op == MORPH_ERODE ? Ptr<BaseRowFilter>(makePtr<MorphRowFilterVHGW<MinOp<uchar> > >(ksize, anchor)) :
+                                       Ptr<BaseRowFilter>(makePtr<MorphRowFilterVHGW<MaxOp<uchar> > >(ksize, anchor));
+        if( depth == CV_16U )
+            return op == MORPH_ERODE ? Ptr<BaseRowFilter>(makePtr<MorphRowFilterVHGW<MinOp<ushort> > >(ksize, anchor)) :
+                                       Ptr<BaseRowFilter>(makePtr<MorphRowFilterVHGW<MaxOp<ushort> > >(ksize, anchor));
+        if( depth == CV_16S )
+            return op == MORPH_ERODE ? Ptr<BaseRowFilter>(makePtr<MorphRowFilterVHGW<MinOp<short> > >(ksize, anchor)) :
+                                       Ptr<BaseRowFilter>(makePtr<MorphRowFilterVHGW<MaxOp<short> > >(ksize, anchor));
+        if( depth == CV_32F )
+            return op == MORPH_ERODE ? Ptr<BaseRowFilter>(makePtr<MorphRowFilterVHGW<MinOp<float> > >(ksize, anchor)) :
+                                       Ptr<BaseRowFilter>(makePtr<MorphRowFilterVHGW<MaxOp<float> > >(ksize, anchor));
+        if( depth == CV_64F )
+            return op == MORPH_ERODE ? Ptr<BaseRowFilter>(makePtr<MorphRowFilterVHGW<MinOp<double> > >(ksize, anchor)) :
+                                       Ptr<BaseRowFilter>(makePtr<MorphRowFilterVHGW<MaxOp<double> > >(ksize, anchor));
+    }
     if( op == MORPH_ERODE )
     {
         if( depth == CV_8U )
@@ -841,6 +1266,47 @@ Ptr<BaseFilter> getMorphologyFilter(int op, int type, const Mat& kernel, Point a
     CV_Error_( CV_StsNotImplemented, ("Unsupported data type (=%d)", type));
 }
 
+bool morphVHGW(int op, const Mat& src, Mat& dst, Size wholeSize, Point ofs,
+               const Mat& kernel, Point anchor, int borderType, const Scalar& borderValue)
+{
+    CV_INSTRUMENT_REGION();
+
+    std::vector<Rect> rects;
+    if( kernel.type() != CV_8U || !decomposeMorphKernel(kernel, rects) )
+        return false;
+
+    // FilterEngine is faster for the rectangles of moderate height and for the kernels
+    // that consist of many small rectangles
+    if( rects.size() == 1 )
+    {
+        if( rects[0].size() == kernel.size() && rects[0].height < morphColumnVHGWKSize(src.depth()) )
+            return false;
+    }
+    else if( countNonZero(kernel) < (int)rects.size()*32 )
+        return false;
+
+    if( rects.size() == 1 )
+    {
+        morphRect(op, src, dst, wholeSize, ofs, rects[0] - anchor, borderType, borderValue);
+        return true;
+    }
+
+    // the union of the rectangles
+    Mat acc(src.size(), src.type()), tmp(src.size(), src.type());
+    for( size_t i = 0; i < rects.size(); i++ )
+    {
+        morphRect(op, src, i == 0 ? acc : tmp, wholeSize, ofs, rects[i] - anchor, borderType, borderValue);
+        if( i == 0 )
+            continue;
+        if( op == MORPH_ERODE )
+            cv::min(acc, tmp, acc);
+        else
+            cv::max(acc, tmp, acc);
+    }
+    acc.copyTo(dst);
+    return true;
+}
+
 #endif
 CV_CPU_OPTIMIZATION_NAMESPACE_END
 } // namespace
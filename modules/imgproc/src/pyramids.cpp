@@ -719,24 +719,186 @@ template <> int PyrUpVecV<float, float>(float** src, float** dst, int width)
 
 #endif
 
+// Computes the rows of the pyrDown result one by one, keeping the horizontally filtered source rows
+// in the ring buffer. The source rows are passed as the table of pointers, so they may come from
+// different buffers.
+template<class CastOp>
+class PyrDownRowFilter
+{
+public:
+    typedef typename CastOp::type1 WT;
+    typedef typename CastOp::rtype T;
+    enum { PD_SZ = 5 };
+
+    PyrDownRowFilter(Size _ssize, Size _dsize, int _cn, int _borderType)
+        : ssize(_ssize), dsize(_dsize), cn(_cn), borderType(_borderType), sy(-PD_SZ/2)
+    {
+        CV_Assert( ssize.width > 0 && ssize.height > 0 &&
+                   std::abs(dsize.width*2 - ssize.width) <= 2 &&
+                   std::abs(dsize.height*2 - ssize.height) <= 2 );
+        width0 = std::min((ssize.width-PD_SZ/2-1)/2 + 1, dsize.width);
+
+        for (int x = 0; x <= PD_SZ+1; x++)
+        {
+            int sx0 = borderInterpolate(x - PD_SZ/2, ssize.width, borderType)*cn;
+            int sx1 = borderInterpolate(x + width0*2 - PD_SZ/2, ssize.width, borderType)*cn;
+            for (int k = 0; k < cn; k++)
+            {
+                tabL[x*cn + k] = sx0 + k;
+                tabR[x*cn + k] = sx1 + k;
+            }
+        }
+
+        tabM.allocate(dsize.width*cn);
+        for (int x = 0; x < dsize.width*cn; x++)
+            tabM[x] = (x/cn)*2*cn + x % cn;
+
+        bufstep = (int)alignSize(dsize.width*cn, 16);
+        _buf.allocate(bufstep*PD_SZ + 16);
+        buf = alignPtr(_buf.data(), 16);
+    }
+
+    //! starts the new sequence of the destination rows from y0
+    void reset(int y0) { sy = y0*2 - PD_SZ/2; }
+
+    //! computes the destination row y; the rows must be requested in order after reset()
+    void operator()(int y, const T* const* srcRows, T* dst);
+
+private:
+    Size ssize, dsize;
+    int cn, borderType, width0, bufstep, sy;
+    int tabL[CV_CN_MAX*(PD_SZ+2)], tabR[CV_CN_MAX*(PD_SZ+2)];
+    AutoBuffer<int> tabM;
+    AutoBuffer<WT> _buf;
+    WT* buf;
+
+    PyrDownRowFilter(const PyrDownRowFilter&); // = delete
+    PyrDownRowFilter& operator=(const PyrDownRowFilter&); // = delete
+};
+
+template<class CastOp>
+void PyrDownRowFilter<CastOp>::operator()(int y, const T* const* srcRows, T* dst)
+{
+    const int sy0 = -PD_SZ/2;
+    int swidth = dsize.width*cn, w0 = width0*cn;
+    WT* rows[PD_SZ];
+    CastOp castOp;
+
+    // fill the ring buffer (horizontal convolution and decimation)
+    int sy_limit = y*2 + 2;
+    for( ; sy <= sy_limit; sy++ )
+    {
+        WT* row = buf + ((sy - sy0) % PD_SZ)*bufstep;
+        const T* src = srcRows[borderInterpolate(sy, ssize.height, borderType)];
+
+        do {
+            int x = 0;
+            for( ; x < cn; x++ )
+            {
+                row[x] = src[tabL[x+cn*2]]*6 + (src[tabL[x+cn]] + src[tabL[x+cn*3]])*4 +
+                    src[tabL[x]] + src[tabL[x+cn*4]];
+            }
+
+            if( x == swidth )
+                break;
+
+            if( cn == 1 )
+            {
+                x += PyrDownVecH<T, WT, 1>(src + x * 2 - 2, row + x, w0 - x);
+                for( ; x < w0; x++ )
+                    row[x] = src[x*2]*6 + (src[x*2 - 1] + src[x*2 + 1])*4 +
+                        src[x*2 - 2] + src[x*2 + 2];
+            }
+            else if( cn == 2 )
+            {
+                x += PyrDownVecH<T, WT, 2>(src + x * 2 - 4, row + x, w0 - x);
+                for( ; x < w0; x += 2 )
+                {
+                    const T* s = src + x*2;
+                    WT t0 = s[0] * 6 + (s[-2] + s[2]) * 4 + s[-4] + s[4];
+                    WT t1 = s[1] * 6 + (s[-1] + s[3]) * 4 + s[-3] + s[5];
+                    row[x] = t0; row[x + 1] = t1;
+                }
+            }
+            else if( cn == 3 )
+            {
+                x += PyrDownVecH<T, WT, 3>(src + x * 2 - 6, row + x, w0 - x);
+                for( ; x < w0; x += 3 )
+                {
+                    const T* s = src + x*2;
+                    WT t0 = s[0]*6 + (s[-3] + s[3])*4 + s[-6] + s[6];
+                    WT t1 = s[1]*6 + (s[-2] + s[4])*4 + s[-5] + s[7];
+                    WT t2 = s[2]*6 + (s[-1] + s[5])*4 + s[-4] + s[8];
+                    row[x] = t0; row[x+1] = t1; row[x+2] = t2;
+                }
+            }
+            else if( cn == 4 )
+            {
+                x += PyrDownVecH<T, WT, 4>(src + x * 2 - 8, row + x, w0 - x);
+                for( ; x < w0; x += 4 )
+                {
+                    const T* s = src + x*2;
+                    WT t0 = s[0]*6 + (s[-4] + s[4])*4 + s[-8] + s[8];
+                    WT t1 = s[1]*6 + (s[-3] + s[5])*4 + s[-7] + s[9];
+                    row[x] = t0; row[x+1] = t1;
+                    t0 = s[2]*6 + (s[-2] + s[6])*4 + s[-6] + s[10];
+                    t1 = s[3]*6 + (s[-1] + s[7])*4 + s[-5] + s[11];
+                    row[x+2] = t0; row[x+3] = t1;
+                }
+            }
+            else
+            {
+                for( ; x < w0; x++ )
+                {
+                    int sx = tabM[x];
+                    row[x] = src[sx]*6 + (src[sx - cn] + src[sx + cn])*4 +
+                        src[sx - cn*2] + src[sx + cn*2];
+                }
+            }
+
+            // tabR
+            for (int x_ = 0; x < swidth; x++, x_++)
+            {
+                row[x] = src[tabR[x_+cn*2]]*6 + (src[tabR[x_+cn]] + src[tabR[x_+cn*3]])*4 +
+                    src[tabR[x_]] + src[tabR[x_+cn*4]];
+            }
+        } while (0);
+    }
+
+    // do vertical convolution and decimation and write the result to the destination image
+    for (int k = 0; k < PD_SZ; k++)
+        rows[k] = buf + ((y*2 - PD_SZ/2 + k - sy0) % PD_SZ)*bufstep;
+    WT *row0 = rows[0], *row1 = rows[1], *row2 = rows[2], *row3 = rows[3], *row4 = rows[4];
+
+    int x = PyrDownVecV<WT, T>(rows, dst, swidth);
+    for (; x < swidth; x++ )
+        dst[x] = castOp(row2[x]*6 + (row1[x] + row3[x])*4 + row0[x] + row4[x]);
+}
+
 template<class CastOp>
 struct PyrDownInvoker : ParallelLoopBody
 {
-    PyrDownInvoker(const Mat& src, const Mat& dst, int borderType, int **tabR, int **tabM, int **tabL)
+    typedef typename CastOp::rtype T;
+
+    PyrDownInvoker(const Mat& src, const Mat& dst, int borderType)
     {
         _src = &src;
         _dst = &dst;
         _borderType = borderType;
-        _tabR = tabR;
-        _tabM = tabM;
-        _tabL = tabL;
     }
 
-    void operator()(const Range& range) const CV_OVERRIDE;
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        PyrDownRowFilter<CastOp> filter(_src->size(), _dst->size(), _src->channels(), _borderType);
+        AutoBuffer<const T*> srcRows(_src->rows);
+        for (int i = 0; i < _src->rows; i++)
+            srcRows[i] = _src->ptr<T>(i);
+
+        filter.reset(range.start);
+        for (int y = range.start; y < range.end; y++)
+            filter(y, srcRows.data(), (T*)_dst->ptr<T>(y));
+    }
 
-    int **_tabR;
-    int **_tabM;
-    int **_tabL;
     const Mat *_src;
     const Mat *_dst;
     int _borderType;
@@ -745,265 +907,416 @@ struct PyrDownInvoker : ParallelLoopBody
 template<class CastOp> void
 pyrDown_( const Mat& _src, Mat& _dst, int borderType )
 {
-    const int PD_SZ = 5;
     CV_Assert( !_src.empty() );
     Size ssize = _src.size(), dsize = _dst.size();
-    int cn = _src.channels();
-
-    int tabL[CV_CN_MAX*(PD_SZ+2)], tabR[CV_CN_MAX*(PD_SZ+2)];
-    AutoBuffer<int> _tabM(dsize.width*cn);
-    int* tabM = _tabM.data();
-
     CV_Assert( ssize.width > 0 && ssize.height > 0 &&
                std::abs(dsize.width*2 - ssize.width) <= 2 &&
                std::abs(dsize.height*2 - ssize.height) <= 2 );
-    int width0 = std::min((ssize.width-PD_SZ/2-1)/2 + 1, dsize.width);
 
-    for (int x = 0; x <= PD_SZ+1; x++)
+    cv::parallel_for_(Range(0,dsize.height), cv::PyrDownInvoker<CastOp>(_src, _dst, borderType), cv::getNumThreads());
+}
+
+
+// Computes the pairs of the pyrUp result rows one by one, see PyrDownRowFilter
+template<class CastOp>
+class PyrUpRowFilter
+{
+public:
+    typedef typename CastOp::type1 WT;
+    typedef typename CastOp::rtype T;
+    enum { PU_SZ = 3 };
+
+    PyrUpRowFilter(Size _ssize, Size _dsize, int _cn)
+        : ssize(_ssize), dsize(_dsize), cn(_cn), sy(-PU_SZ/2)
     {
-        int sx0 = borderInterpolate(x - PD_SZ/2, ssize.width, borderType)*cn;
-        int sx1 = borderInterpolate(x + width0*2 - PD_SZ/2, ssize.width, borderType)*cn;
-        for (int k = 0; k < cn; k++)
-        {
-            tabL[x*cn + k] = sx0 + k;
-            tabR[x*cn + k] = sx1 + k;
-        }
+        CV_Assert( std::abs(dsize.width - ssize.width*2) == dsize.width % 2 &&
+                   std::abs(dsize.height - ssize.height*2) == dsize.height % 2);
+
+        bufstep = (int)alignSize((dsize.width+1)*cn, 16);
+        _buf.allocate(bufstep*PU_SZ + 16);
+        buf = alignPtr(_buf.data(), 16);
+        dtab.allocate(ssize.width*cn);
+        for( int x = 0; x < ssize.width*cn; x++ )
+            dtab[x] = (x/cn)*2*cn + x % cn;
     }
 
-    for (int x = 0; x < dsize.width*cn; x++)
-        tabM[x] = (x/cn)*2*cn + x % cn;
+    //! starts the new sequence of the source rows from y0
+    void reset(int y0) { sy = y0 - PU_SZ/2; }
 
-    int *tabLPtr = tabL;
-    int *tabRPtr = tabR;
+    //! computes the destination rows 2*y and 2*y+1 from the source row y; dst1 may be the same as dst0
+    void operator()(int y, const T* const* srcRows, T* dst0, T* dst1);
 
-    cv::parallel_for_(Range(0,dsize.height), cv::PyrDownInvoker<CastOp>(_src, _dst, borderType, &tabRPtr, &tabM, &tabLPtr), cv::getNumThreads());
-}
+private:
+    Size ssize, dsize;
+    int cn, bufstep, sy;
+    AutoBuffer<int> dtab;
+    AutoBuffer<WT> _buf;
+    WT* buf;
+
+    PyrUpRowFilter(const PyrUpRowFilter&); // = delete
+    PyrUpRowFilter& operator=(const PyrUpRowFilter&); // = delete
+};
 
 template<class CastOp>
-void PyrDownInvoker<CastOp>::operator()(const Range& range) const
+void PyrUpRowFilter<CastOp>::operator()(int y, const T* const* srcRows, T* dst0, T* dst1)
 {
-    const int PD_SZ = 5;
-    typedef typename CastOp::type1 WT;
-    typedef typename CastOp::rtype T;
-    Size ssize = _src->size(), dsize = _dst->size();
-    int cn = _src->channels();
-    int bufstep = (int)alignSize(dsize.width*cn, 16);
-    AutoBuffer<WT> _buf(bufstep*PD_SZ + 16);
-    WT* buf = alignPtr((WT*)_buf.data(), 16);
-    WT* rows[PD_SZ];
+    const int sy0 = -PU_SZ/2;
+    int swidth = ssize.width*cn, dwidth = dsize.width*cn;
+    WT* rows[PU_SZ];
+    T* dsts[2];
     CastOp castOp;
+    int x;
 
-    int sy0 = -PD_SZ/2, sy = range.start * 2 + sy0, width0 = std::min((ssize.width-PD_SZ/2-1)/2 + 1, dsize.width);
-
-    ssize.width *= cn;
-    dsize.width *= cn;
-    width0 *= cn;
-
-    for (int y = range.start; y < range.end; y++)
+    // fill the ring buffer (horizontal convolution and decimation)
+    for( ; sy <= y + 1; sy++ )
     {
-        T* dst = (T*)_dst->ptr<T>(y);
-        WT *row0, *row1, *row2, *row3, *row4;
+        WT* row = buf + ((sy - sy0) % PU_SZ)*bufstep;
+        int _sy = borderInterpolate(sy*2, ssize.height*2, BORDER_REFLECT_101)/2;
+        const T* src = srcRows[_sy];
 
-        // fill the ring buffer (horizontal convolution and decimation)
-        int sy_limit = y*2 + 2;
-        for( ; sy <= sy_limit; sy++ )
+        if( swidth == cn )
         {
-            WT* row = buf + ((sy - sy0) % PD_SZ)*bufstep;
-            int _sy = borderInterpolate(sy, ssize.height, _borderType);
-            const T* src = _src->ptr<T>(_sy);
-
-            do {
-                int x = 0;
-                const int* tabL = *_tabL;
-                for( ; x < cn; x++ )
-                {
-                    row[x] = src[tabL[x+cn*2]]*6 + (src[tabL[x+cn]] + src[tabL[x+cn*3]])*4 +
-                        src[tabL[x]] + src[tabL[x+cn*4]];
-                }
-
-                if( x == dsize.width )
-                    break;
+            for( x = 0; x < cn; x++ )
+                row[x] = row[x + cn] = src[x]*8;
+            continue;
+        }
 
-                if( cn == 1 )
-                {
-                    x += PyrDownVecH<T, WT, 1>(src + x * 2 - 2, row + x, width0 - x);
-                    for( ; x < width0; x++ )
-                        row[x] = src[x*2]*6 + (src[x*2 - 1] + src[x*2 + 1])*4 +
-                            src[x*2 - 2] + src[x*2 + 2];
-                }
-                else if( cn == 2 )
-                {
-                    x += PyrDownVecH<T, WT, 2>(src + x * 2 - 4, row + x, width0 - x);
-                    for( ; x < width0; x += 2 )
-                    {
-                        const T* s = src + x*2;
-                        WT t0 = s[0] * 6 + (s[-2] + s[2]) * 4 + s[-4] + s[4];
-                        WT t1 = s[1] * 6 + (s[-1] + s[3]) * 4 + s[-3] + s[5];
-                        row[x] = t0; row[x + 1] = t1;
-                    }
-                }
-                else if( cn == 3 )
-                {
-                    x += PyrDownVecH<T, WT, 3>(src + x * 2 - 6, row + x, width0 - x);
-                    for( ; x < width0; x += 3 )
-                    {
-                        const T* s = src + x*2;
-                        WT t0 = s[0]*6 + (s[-3] + s[3])*4 + s[-6] + s[6];
-                        WT t1 = s[1]*6 + (s[-2] + s[4])*4 + s[-5] + s[7];
-                        WT t2 = s[2]*6 + (s[-1] + s[5])*4 + s[-4] + s[8];
-                        row[x] = t0; row[x+1] = t1; row[x+2] = t2;
-                    }
-                }
-                else if( cn == 4 )
-                {
-                    x += PyrDownVecH<T, WT, 4>(src + x * 2 - 8, row + x, width0 - x);
-                    for( ; x < width0; x += 4 )
-                    {
-                        const T* s = src + x*2;
-                        WT t0 = s[0]*6 + (s[-4] + s[4])*4 + s[-8] + s[8];
-                        WT t1 = s[1]*6 + (s[-3] + s[5])*4 + s[-7] + s[9];
-                        row[x] = t0; row[x+1] = t1;
-                        t0 = s[2]*6 + (s[-2] + s[6])*4 + s[-6] + s[10];
-                        t1 = s[3]*6 + (s[-1] + s[7])*4 + s[-5] + s[11];
-                        row[x+2] = t0; row[x+3] = t1;
-                    }
-                }
-                else
-                {
-                    for( ; x < width0; x++ )
-                    {
-                        int sx = (*_tabM)[x];
-                        row[x] = src[sx]*6 + (src[sx - cn] + src[sx + cn])*4 +
-                            src[sx - cn*2] + src[sx + cn*2];
-                    }
-                }
+        for( x = 0; x < cn; x++ )
+        {
+            int dx = dtab[x];
+            WT t0 = src[x]*6 + src[x + cn]*2;
+            WT t1 = (src[x] + src[x + cn])*4;
+            row[dx] = t0; row[dx + cn] = t1;
+            dx = dtab[swidth - cn + x];
+            int sx = swidth - cn + x;
+            t0 = src[sx - cn] + src[sx]*7;
+            t1 = src[sx]*8;
+            row[dx] = t0; row[dx + cn] = t1;
+
+            if (dwidth > swidth*2)
+            {
+                row[(dsize.width-1) + x] = row[dx + cn];
+            }
+        }
 
-                // tabR
-                const int* tabR = *_tabR;
-                for (int x_ = 0; x < dsize.width; x++, x_++)
-                {
-                    row[x] = src[tabR[x_+cn*2]]*6 + (src[tabR[x_+cn]] + src[tabR[x_+cn*3]])*4 +
-                        src[tabR[x_]] + src[tabR[x_+cn*4]];
-                }
-            } while (0);
+        for( x = cn; x < swidth - cn; x++ )
+        {
+            int dx = dtab[x];
+            WT t0 = src[x-cn] + src[x]*6 + src[x+cn];
+            WT t1 = (src[x] + src[x+cn])*4;
+            row[dx] = t0;
+            row[dx+cn] = t1;
         }
+    }
 
-        // do vertical convolution and decimation and write the result to the destination image
-        for (int k = 0; k < PD_SZ; k++)
-            rows[k] = buf + ((y*2 - PD_SZ/2 + k - sy0) % PD_SZ)*bufstep;
-        row0 = rows[0]; row1 = rows[1]; row2 = rows[2]; row3 = rows[3]; row4 = rows[4];
+    // do vertical convolution and decimation and write the result to the destination image
+    for( int k = 0; k < PU_SZ; k++ )
+        rows[k] = buf + ((y - PU_SZ/2 + k - sy0) % PU_SZ)*bufstep;
+    WT *row0 = rows[0], *row1 = rows[1], *row2 = rows[2];
+    dsts[0] = dst0; dsts[1] = dst1;
 
-        int x = PyrDownVecV<WT, T>(rows, dst, dsize.width);
-        for (; x < dsize.width; x++ )
-            dst[x] = castOp(row2[x]*6 + (row1[x] + row3[x])*4 + row0[x] + row4[x]);
+    x = PyrUpVecV<WT, T>(rows, dsts, dwidth);
+    for( ; x < dwidth; x++ )
+    {
+        T t1 = castOp((row1[x] + row2[x])*4);
+        T t0 = castOp(row0[x] + row1[x]*6 + row2[x]);
+        dst1[x] = t1; dst0[x] = t0;
     }
 }
 
-
 template<class CastOp> void
 pyrUp_( const Mat& _src, Mat& _dst, int)
 {
-    const int PU_SZ = 3;
-    typedef typename CastOp::type1 WT;
     typedef typename CastOp::rtype T;
 
     Size ssize = _src.size(), dsize = _dst.size();
-    int cn = _src.channels();
-    int bufstep = (int)alignSize((dsize.width+1)*cn, 16);
-    AutoBuffer<WT> _buf(bufstep*PU_SZ + 16);
-    WT* buf = alignPtr((WT*)_buf.data(), 16);
-    AutoBuffer<int> _dtab(ssize.width*cn);
-    int* dtab = _dtab.data();
-    WT* rows[PU_SZ];
-    T* dsts[2];
-    CastOp castOp;
-    //PyrUpVecH<T, WT> vecOpH;
+    PyrUpRowFilter<CastOp> filter(ssize, dsize, _src.channels());
+    AutoBuffer<const T*> srcRows(ssize.height);
+    for( int y = 0; y < ssize.height; y++ )
+        srcRows[y] = _src.ptr<T>(y);
 
-    CV_Assert( std::abs(dsize.width - ssize.width*2) == dsize.width % 2 &&
-               std::abs(dsize.height - ssize.height*2) == dsize.height % 2);
-    int k, x, sy0 = -PU_SZ/2, sy = sy0;
+    for( int y = 0; y < ssize.height; y++ )
+        filter(y, srcRows.data(), _dst.ptr<T>(y*2), _dst.ptr<T>(std::min(y*2+1, dsize.height-1)));
 
-    ssize.width *= cn;
-    dsize.width *= cn;
+    if (dsize.height > ssize.height*2)
+    {
+        int width = dsize.width*_src.channels();
+        T* dst0 = _dst.ptr<T>(ssize.height*2-2);
+        T* dst2 = _dst.ptr<T>(ssize.height*2);
+
+        for(int x = 0; x < width ; x++ )
+        {
+            dst2[x] = dst0[x];
+        }
+    }
+}
 
-    for( x = 0; x < ssize.width; x++ )
-        dtab[x] = (x/cn)*2*cn + x % cn;
+template<typename T, typename LT> static void
+pyrSubRow( const T* a, const T* b, LT* dst, int width )
+{
+    for( int x = 0; x < width; x++ )
+        dst[x] = saturate_cast<LT>((LT)a[x] - (LT)b[x]);
+}
 
-    for( int y = 0; y < ssize.height; y++ )
+template<> void
+pyrSubRow( const uchar* a, const uchar* b, short* dst, int width )
+{
+    int x = 0;
+#if CV_SIMD
+    for( ; x <= width - v_uint8::nlanes; x += v_uint8::nlanes )
     {
-        T* dst0 = _dst.ptr<T>(y*2);
-        T* dst1 = _dst.ptr<T>(std::min(y*2+1, dsize.height-1));
-        WT *row0, *row1, *row2;
+        v_uint16 a0, a1, b0, b1;
+        v_expand(vx_load(a + x), a0, a1);
+        v_expand(vx_load(b + x), b0, b1);
+        v_store(dst + x, v_reinterpret_as_s16(v_sub_wrap(a0, b0)));
+        v_store(dst + x + v_int16::nlanes, v_reinterpret_as_s16(v_sub_wrap(a1, b1)));
+    }
+    vx_cleanup();
+#endif
+    for( ; x < width; x++ )
+        dst[x] = (short)(a[x] - b[x]);
+}
 
-        // fill the ring buffer (horizontal convolution and decimation)
-        for( ; sy <= y + 1; sy++ )
-        {
-            WT* row = buf + ((sy - sy0) % PU_SZ)*bufstep;
-            int _sy = borderInterpolate(sy*2, ssize.height*2, BORDER_REFLECT_101)/2;
-            const T* src = _src.ptr<T>(_sy);
+// Builds the levels k0+1..k1 of the Gaussian pyramid and, optionally, the levels k0..k1-1 of the
+// Laplacian one in a single streaming pass: every new row of a level is immediately consumed by the
+// ring buffers of the next coarser level, while it's still in the cache.
+//
+// The rows of every level are split between the stripes processed in parallel. A stripe computes
+// the rows of the finer levels that its rows depend on, including the ones owned by the neighbouring
+// stripes; these are stored in the private buffer, so every output row is written only once.
+template<class DownOp, class UpOp, typename LT>
+class BuildPyramidInvoker : public ParallelLoopBody
+{
+public:
+    typedef typename DownOp::rtype T;
+
+    BuildPyramidInvoker(const std::vector<Mat>& _gauss, const std::vector<Mat>& _lap, int _k0, int _k1,
+                        int _nstripes, int _borderType)
+        : gauss(_gauss), lap(_lap), k0(_k0), k1(_k1), nstripes(_nstripes), borderType(_borderType)
+    {
+    }
+
+    virtual void operator()(const Range& range) const CV_OVERRIDE
+    {
+        for( int s = range.start; s < range.end; s++ )
+            processStripe(s);
+    }
+
+private:
+    Range ownRows(int k, int s) const
+    {
+        int height = gauss[k].rows;
+        return Range((int)((int64)height*s/nstripes), (int)((int64)height*(s+1)/nstripes));
+    }
+
+    static Range unite(const Range& a, const Range& b)
+    {
+        if( a.empty() )
+            return b;
+        if( b.empty() )
+            return a;
+        return Range(std::min(a.start, b.start), std::max(a.end, b.end));
+    }
+
+    // the last row of the finer level read by pyrDown to get the row y
+    int lastDownSrcRow(int y, int height) const
+    {
+        int r = 0;
+        for( int d = -2; d <= 2; d++ )
+            r = std::max(r, borderInterpolate(y*2 + d, height, borderType));
+        return r;
+    }
 
-            if( ssize.width == cn )
+    // the rows of the finer level read by pyrDown to get the rows
+    Range downSrcRows(const Range& rows, int height) const
+    {
+        if( rows.empty() )
+            return rows;
+        int lo = INT_MAX, hi = -1;
+        for( int y = rows.start; y < rows.end; y++ )
+            for( int d = -2; d <= 2; d++ )
             {
-                for( x = 0; x < cn; x++ )
-                    row[x] = row[x + cn] = src[x]*8;
-                continue;
+                int sy = borderInterpolate(y*2 + d, height, borderType);
+                lo = std::min(lo, sy);
+                hi = std::max(hi, sy);
             }
+        return Range(lo, hi + 1);
+    }
 
-            for( x = 0; x < cn; x++ )
+    // the last row of the coarser level read by pyrUp to get the rows 2*y and 2*y+1
+    static int lastUpSrcRow(int y, int height)
+    {
+        return borderInterpolate(std::min(y + 1, height)*2, height*2, BORDER_REFLECT_101)/2;
+    }
+
+    // the rows of the coarser level read by pyrUp to get the rows of the finer one
+    static Range upSrcRows(const Range& rows, int height)
+    {
+        if( rows.empty() )
+            return rows;
+        int lo = INT_MAX, hi = -1;
+        for( int y = rows.start/2; y <= (rows.end - 1)/2; y++ )
+            for( int d = -1; d <= 1; d++ )
             {
-                int dx = dtab[x];
-                WT t0 = src[x]*6 + src[x + cn]*2;
-                WT t1 = (src[x] + src[x + cn])*4;
-                row[dx] = t0; row[dx + cn] = t1;
-                dx = dtab[ssize.width - cn + x];
-                int sx = ssize.width - cn + x;
-                t0 = src[sx - cn] + src[sx]*7;
-                t1 = src[sx]*8;
-                row[dx] = t0; row[dx + cn] = t1;
-
-                if (dsize.width > ssize.width*2)
-                {
-                    row[(_dst.cols-1) + x] = row[dx + cn];
-                }
+                int sy = borderInterpolate((y + d)*2, height*2, BORDER_REFLECT_101)/2;
+                lo = std::min(lo, sy);
+                hi = std::max(hi, sy);
             }
+        return Range(lo, hi + 1);
+    }
+
+    void processStripe(int s) const;
+
+    const std::vector<Mat>& gauss;
+    const std::vector<Mat>& lap;
+    int k0, k1, nstripes, borderType;
+
+    BuildPyramidInvoker& operator=(const BuildPyramidInvoker&); // = delete
+};
 
-            for( x = cn; x < ssize.width - cn; x++ )
+template<class DownOp, class UpOp, typename LT>
+void BuildPyramidInvoker<DownOp, UpOp, LT>::processStripe(int s) const
+{
+    int nlevels = k1 - k0 + 1, cn = gauss[k0].channels();
+    bool laplacian = !lap.empty();
+
+    // the rows of every level computed by the stripe, from the coarsest level to the finest one
+    std::vector<Range> own(nlevels), need(nlevels);
+    for( int i = nlevels - 1; i > 0; i-- )
+    {
+        int k = k0 + i;
+        own[i] = ownRows(k, s);
+        Range r = own[i];
+        if( i < nlevels - 1 )
+            r = unite(r, downSrcRows(need[i+1], gauss[k].rows));
+        if( laplacian )
+            r = unite(r, upSrcRows(ownRows(k - 1, s), gauss[k].rows));
+        need[i] = r;
+    }
+    own[0] = need[0] = Range(0, gauss[k0].rows);
+
+    // the row tables point to the output levels or to the private buffer
+    std::vector<std::vector<T*> > rows(nlevels);
+    size_t haloSize = 0;
+    for( int i = 1; i < nlevels; i++ )
+        haloSize += (size_t)(need[i].size() - std::max(std::min(own[i].end, need[i].end) -
+                                                       std::max(own[i].start, need[i].start), 0))*
+                    gauss[k0 + i].cols*cn;
+    AutoBuffer<T> _halo(haloSize + 1);
+    T* halo = _halo.data();
+    for( int i = 0; i < nlevels; i++ )
+    {
+        const Mat& level = gauss[k0 + i];
+        rows[i].resize(level.rows);
+        for( int y = need[i].start; y < need[i].end; y++ )
+        {
+            if( own[i].start <= y && y < own[i].end )
+                rows[i][y] = (T*)level.ptr<T>(y);
+            else
             {
-                int dx = dtab[x];
-                WT t0 = src[x-cn] + src[x]*6 + src[x+cn];
-                WT t1 = (src[x] + src[x+cn])*4;
-                row[dx] = t0;
-                row[dx+cn] = t1;
+                rows[i][y] = halo;
+                halo += level.cols*cn;
             }
         }
+    }
 
-        // do vertical convolution and decimation and write the result to the destination image
-        for( k = 0; k < PU_SZ; k++ )
-            rows[k] = buf + ((y - PU_SZ/2 + k - sy0) % PU_SZ)*bufstep;
-        row0 = rows[0]; row1 = rows[1]; row2 = rows[2];
-        dsts[0] = dst0; dsts[1] = dst1;
+    std::vector<Ptr<PyrDownRowFilter<DownOp> > > down(nlevels);
+    std::vector<int> next(nlevels);
+    next[0] = gauss[k0].rows;
+    for( int i = 1; i < nlevels; i++ )
+    {
+        down[i] = makePtr<PyrDownRowFilter<DownOp> >(gauss[k0 + i - 1].size(), gauss[k0 + i].size(), cn, borderType);
+        down[i]->reset(need[i].start);
+        next[i] = need[i].start;
+    }
 
-        x = PyrUpVecV<WT, T>(rows, dsts, dsize.width);
-        for( ; x < dsize.width; x++ )
+    // the Laplacian levels are produced by the pairs of rows
+    std::vector<Ptr<PyrUpRowFilter<UpOp> > > up;
+    std::vector<int> upNext, upEnd;
+    AutoBuffer<T> _upbuf;
+    if( laplacian )
+    {
+        up.resize(nlevels - 1);
+        upNext.resize(nlevels - 1);
+        upEnd.resize(nlevels - 1);
+        for( int i = 0; i < nlevels - 1; i++ )
         {
-            T t1 = castOp((row1[x] + row2[x])*4);
-            T t0 = castOp(row0[x] + row1[x]*6 + row2[x]);
-            dst1[x] = t1; dst0[x] = t0;
+            Range r = ownRows(k0 + i, s);
+            up[i] = makePtr<PyrUpRowFilter<UpOp> >(gauss[k0 + i + 1].size(), gauss[k0 + i].size(), cn);
+            upNext[i] = r.start/2;
+            upEnd[i] = r.empty() ? upNext[i] : (r.end - 1)/2 + 1;
+            up[i]->reset(upNext[i]);
         }
+        _upbuf.allocate(gauss[k0].cols*cn*2);
     }
 
-    if (dsize.height > ssize.height*2)
+    for( ;; )
     {
-        T* dst0 = _dst.ptr<T>(ssize.height*2-2);
-        T* dst2 = _dst.ptr<T>(ssize.height*2);
+        bool progress = false;
+        for( int i = 1; i < nlevels; i++ )
+        {
+            // one row of the finest level per iteration, then as many rows of the coarser levels as possible
+            for( int n = 0; next[i] < need[i].end && (i > 1 || n < 1); n++ )
+            {
+                int y = next[i];
+                if( lastDownSrcRow(y, gauss[k0 + i - 1].rows) >= next[i-1] )
+                    break;
+                (*down[i])(y, rows[i-1].data(), rows[i][y]);
+                next[i]++;
+                progress = true;
+            }
+        }
 
-        for(x = 0; x < dsize.width ; x++ )
+        for( int i = 0; i < (int)up.size(); i++ )
         {
-            dst2[x] = dst0[x];
+            const Mat& level = gauss[k0 + i];
+            Range r = ownRows(k0 + i, s);
+            int width = level.cols*cn;
+            for( ; upNext[i] < upEnd[i]; upNext[i]++ )
+            {
+                int y = upNext[i], y0 = std::max(y*2, r.start), y1 = std::min(y*2 + 2, r.end);
+                if( lastUpSrcRow(y, gauss[k0 + i + 1].rows) >= next[i+1] || y1 > next[i] )
+                    break;
+                T* up0 = _upbuf.data();
+                T* up1 = y*2 + 1 < level.rows ? up0 + width : up0;
+                (*up[i])(y, rows[i+1].data(), up0, up1);
+                for( int yy = y0; yy < y1; yy++ )
+                    pyrSubRow(rows[i][yy], up0 + (yy - y*2)*width, (LT*)lap[k0 + i].ptr<LT>(yy), width);
+                progress = true;
+            }
         }
+
+        if( !progress )
+            break;
     }
 }
 
+template<class DownOp, class UpOp, typename LT> static void
+buildPyramid_( const std::vector<Mat>& gauss, const std::vector<Mat>& lap, int borderType )
+{
+    int maxlevel = (int)gauss.size() - 1, nthreads = getNumThreads();
+
+    for( int k0 = 0; k0 < maxlevel; )
+    {
+        int height = gauss[k0 + 1].rows, nstripes = 1, k1 = maxlevel;
+        if( nthreads > 1 && borderType != BORDER_WRAP )
+        {
+            nstripes = std::max(std::min(nthreads, height/32), 1);
+            // a stripe recomputes about 2^(k1-k0+1) rows of the level k0+1 at each side, so the fused
+            // levels are limited to keep the overhead below a quarter; the rest goes to the next pass
+            if( nstripes > 1 )
+                for( k1 = k0 + 1; k1 < maxlevel && nstripes*(16 << (k1 + 1 - k0)) <= height; k1++ )
+                    ;
+        }
+        parallel_for_(Range(0, nstripes), BuildPyramidInvoker<DownOp, UpOp, LT>(gauss, lap, k0, k1,
+                                                                               nstripes, borderType), nstripes);
+        k0 = k1;
+    }
+
+    if( !lap.empty() )
+        gauss[maxlevel].convertTo(lap[maxlevel], lap[maxlevel].type());
+}
+
 typedef void (*PyrFunc)(const Mat&, Mat&, int);
 
 #ifdef HAVE_OPENCL
@@ -1550,6 +1863,79 @@ void cv::buildPyramid( InputArray _src, OutputArrayOfArrays _dst, int maxlevel,
         pyrDown( _dst.getMatRef(i-1), _dst.getMatRef(i), Size(), borderType );
 }
 
+void cv::buildPyramid( InputArray _src, OutputArrayOfArrays _dst, OutputArray _buf, int maxlevel,
+                       int pyrType, int borderType )
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( borderType != BORDER_CONSTANT && maxlevel >= 0 );
+    CV_Assert( pyrType == PYRAMID_GAUSSIAN || pyrType == PYRAMID_LAPLACIAN );
+    CV_Assert( _dst.kind() == _InputArray::STD_VECTOR_MAT );
+
+    Mat src = _src.getMat();
+    CV_Assert( !src.empty() && src.dims <= 2 );
+    borderType &= ~BORDER_ISOLATED;
+    int type = src.type(), depth = src.depth(), cn = src.channels();
+    bool laplacian = pyrType == PYRAMID_LAPLACIAN;
+    int ltype = CV_MAKETYPE(depth == CV_8U ? CV_16S : depth == CV_64F ? CV_64F : CV_32F, cn);
+
+    // the buffer holds the Gaussian levels 1..maxlevel and then the Laplacian levels 0..maxlevel
+    std::vector<Size> sizes(maxlevel + 1);
+    sizes[0] = src.size();
+    for( int i = 1; i <= maxlevel; i++ )
+        sizes[i] = Size((sizes[i-1].width + 1)/2, (sizes[i-1].height + 1)/2);
+
+    std::vector<size_t> gofs(maxlevel + 1), lofs(laplacian ? maxlevel + 1 : 0);
+    size_t total = 0;
+    for( int i = 1; i <= maxlevel; i++ )
+    {
+        gofs[i] = total;
+        total += alignSize(sizes[i].area()*CV_ELEM_SIZE(type), CV_MALLOC_ALIGN);
+    }
+    for( size_t i = 0; i < lofs.size(); i++ )
+    {
+        lofs[i] = total;
+        total += alignSize(sizes[i].area()*CV_ELEM_SIZE(ltype), CV_MALLOC_ALIGN);
+    }
+    total = std::max(total, (size_t)1);
+    CV_Assert( total <= (size_t)INT_MAX );
+
+    if( _buf.empty() || _buf.type() != CV_8UC1 || !_buf.isContinuous() || _buf.total() < total )
+    {
+        _buf.release();
+        _buf.create(1, (int)total, CV_8U);
+    }
+    Mat buf = _buf.getMat();
+
+    std::vector<Mat> gauss(maxlevel + 1), lap(lofs.size());
+    gauss[0] = src;
+    for( int i = 1; i <= maxlevel; i++ )
+        gauss[i] = Mat(sizes[i], type, buf.ptr() + gofs[i]);
+    for( size_t i = 0; i < lap.size(); i++ )
+        lap[i] = Mat(sizes[i], ltype, buf.ptr() + lofs[i]);
+
+    typedef void (*BuildPyramidFunc)(const std::vector<Mat>&, const std::vector<Mat>&, int);
+    BuildPyramidFunc func = 0;
+    if( depth == CV_8U )
+        func = buildPyramid_< FixPtCast<uchar, 8>, FixPtCast<uchar, 6>, short >;
+    else if( depth == CV_16S )
+        func = buildPyramid_< FixPtCast<short, 8>, FixPtCast<short, 6>, float >;
+    else if( depth == CV_16U )
+        func = buildPyramid_< FixPtCast<ushort, 8>, FixPtCast<ushort, 6>, float >;
+    else if( depth == CV_32F )
+        func = buildPyramid_< FltCast<float, 8>, FltCast<float, 6>, float >;
+    else if( depth == CV_64F )
+        func = buildPyramid_< FltCast<double, 8>, FltCast<double, 6>, double >;
+    else
+        CV_Error( CV_StsUnsupportedFormat, "" );
+
+    func( gauss, lap, borderType );
+
+    _dst.create( maxlevel + 1, 1, 0 );
+    for( int i = 0; i <= maxlevel; i++ )
+        _dst.getMatRef(i) = laplacian ? lap[i] : gauss[i];
+}
+
 CV_IMPL void cvPyrDown( const void* srcarr, void* dstarr, int _filter )
 {
     cv::Mat src = cv::cvarrToMat(srcarr), dst = cv::cvarrToMat(dstarr);
@@ -0,0 +1,309 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+/*
+ * Recursive Gaussian filter:
+ *
+ * I.T. Young, L.J. van Vliet. "Recursive implementation of the Gaussian filter",
+ * Signal Processing 44 (1995), pp. 139-151.
+ *
+ * Every direction is filtered by the 3rd order causal and anti-causal IIR filters,
+ * so the cost per pixel does not depend on sigma.
+ */
+
+namespace cv
+{
+
+namespace
+{
+
+// c[0] is the gain, c[1..3] are the feedback coefficients; c[0] + c[1] + c[2] + c[3] == 1
+static void getRecursiveGaussianCoeffs( double sigma, double* c )
+{
+    double q = sigma >= 2.5 ? 0.98711*sigma - 0.96330 :
+                              3.97156 - 4.14554*std::sqrt(1 - 0.26891*sigma);
+    double q2 = q*q, q3 = q2*q;
+    double b0 = 1.57825 + 2.44413*q + 1.4281*q2 + 0.422205*q3;
+    c[1] = (2.44413*q + 2.85619*q2 + 1.26661*q3)/b0;
+    c[2] = -(1.4281*q2 + 1.26661*q3)/b0;
+    c[3] = 0.422205*q3/b0;
+    c[0] = 1 - (c[1] + c[2] + c[3]);
+}
+
+// the number of the border pixels, after which the impulse response is negligible
+static int recursiveGaussianBorder( double sigma )
+{
+    return cvCeil(sigma*4) + 3;
+}
+
+// y[j] = c[0]*x[j] + c[1]*p1[j] + c[2]*p2[j] + c[3]*p3[j]; x and y may be the same
+static int recursiveGaussianRowVec( const float* x, const float* p1, const float* p2,
+                                    const float* p3, float* y, int n, const float* c )
+{
+    int j = 0;
+#if CV_SIMD
+    v_float32 c0 = vx_setall_f32(c[0]), c1 = vx_setall_f32(c[1]);
+    v_float32 c2 = vx_setall_f32(c[2]), c3 = vx_setall_f32(c[3]);
+    for( ; j <= n - v_float32::nlanes; j += v_float32::nlanes )
+    {
+        v_float32 s = v_muladd(vx_load(p1 + j), c1, vx_load(x + j)*c0);
+        s = v_muladd(vx_load(p2 + j), c2, s);
+        v_store(y + j, v_muladd(vx_load(p3 + j), c3, s));
+    }
+#else
+    CV_UNUSED(x); CV_UNUSED(p1); CV_UNUSED(p2); CV_UNUSED(p3); CV_UNUSED(y); CV_UNUSED(n); CV_UNUSED(c);
+#endif
+    return j;
+}
+
+static int recursiveGaussianRowVec( const double* x, const double* p1, const double* p2,
+                                    const double* p3, double* y, int n, const double* c )
+{
+    int j = 0;
+#if CV_SIMD_64F
+    v_float64 c0 = vx_setall_f64(c[0]), c1 = vx_setall_f64(c[1]);
+    v_float64 c2 = vx_setall_f64(c[2]), c3 = vx_setall_f64(c[3]);
+    for( ; j <= n - v_float64::nlanes; j += v_float64::nlanes )
+    {
+        v_float64 s = v_muladd(vx_load(p1 + j), c1, vx_load(x + j)*c0);
+        s = v_muladd(vx_load(p2 + j), c2, s);
+        v_store(y + j, v_muladd(vx_load(p3 + j), c3, s));
+    }
+#else
+    CV_UNUSED(x); CV_UNUSED(p1); CV_UNUSED(p2); CV_UNUSED(p3); CV_UNUSED(y); CV_UNUSED(n); CV_UNUSED(c);
+#endif
+    return j;
+}
+
+template<typename WT> static void
+recursiveGaussianRow( const WT* x, const WT* p1, const WT* p2, const WT* p3, WT* y, int n, const WT* c )
+{
+    int j = recursiveGaussianRowVec(x, p1, p2, p3, y, n, c);
+    for( ; j < n; j++ )
+        y[j] = c[0]*x[j] + c[1]*p1[j] + c[2]*p2[j] + c[3]*p3[j];
+}
+
+// causal and anti-causal passes over a line of len elements, each consisting of cn interleaved
+// channels; the state before the first and after the last element is the steady state of the
+// constant signal, so the first and the last elements substitute the missing ones
+template<typename WT> static void
+recursiveGaussianLine( WT* line, int len, int cn, const WT* c )
+{
+    int p;
+    for( p = 1; p < len; p++ )
+        recursiveGaussianRow(line + p*cn, line + (p - 1)*cn, line + std::max(p - 2, 0)*cn,
+                             line + std::max(p - 3, 0)*cn, line + p*cn, cn, c);
+    for( p = len - 2; p >= 0; p-- )
+        recursiveGaussianRow(line + p*cn, line + (p + 1)*cn, line + std::min(p + 2, len - 1)*cn,
+                             line + std::min(p + 3, len - 1)*cn, line + p*cn, cn, c);
+}
+
+// filters the rows in X direction; the buffer contains additional border rows for Y direction
+template<typename T, typename WT>
+class RecursiveGaussianRowInvoker : public ParallelLoopBody
+{
+public:
+    // the rows are processed in groups, which are interleaved, so that the recursion is vectorized
+    enum { GROUP_SIZE = 8 };
+
+    RecursiveGaussianRowInvoker( const Mat& _src, Mat& _buf, Size _wholeSize, Point _ofs,
+                                 int _borderX, int _borderY, int _borderType, const WT* _c ) :
+        src(_src), buf(_buf), wholeSize(_wholeSize), ofs(_ofs), borderX(_borderX),
+        borderY(_borderY), borderType(_borderType), c(_c)
+    {
+        xtab.resize(src.cols + borderX*2);
+        for( int p = 0; p < (int)xtab.size(); p++ )
+        {
+            int x = ofs.x + p - borderX;
+            if( x < 0 || x >= wholeSize.width )
+                x = borderInterpolate(x, wholeSize.width, borderType);
+            // the offsets are relative to the ROI, so they are negative on the left of it
+            xtab[p] = x < 0 ? INT_MIN : x - ofs.x;
+        }
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int cn = src.channels(), len = (int)xtab.size();
+        AutoBuffer<WT> _line(len*cn*GROUP_SIZE);
+        WT* line = _line.data();
+
+        for( int g = range.start; g < range.end; g++ )
+        {
+            int i0 = g*GROUP_SIZE, n = std::min(buf.rows - i0, (int)GROUP_SIZE), w = n*cn;
+
+            for( int r = 0; r < n; r++ )
+            {
+                int y = ofs.y + i0 + r - borderY;
+                if( y < 0 || y >= wholeSize.height )
+                    y = borderInterpolate(y, wholeSize.height, borderType);
+                // the row may be outside of the source ROI, but inside of the whole image
+                const T* S = y < 0 ? 0 : (const T*)(src.data + src.step*(ptrdiff_t)(y - ofs.y));
+                WT* L = line + r*cn;
+                for( int p = 0; p < len; p++, L += w )
+                {
+                    int x = xtab[p];
+                    for( int k = 0; k < cn; k++ )
+                        L[k] = S && x != INT_MIN ? (WT)S[(ptrdiff_t)x*cn + k] : (WT)0;
+                }
+            }
+
+            recursiveGaussianLine(line, len, w, c);
+
+            for( int r = 0; r < n; r++ )
+            {
+                WT* D = buf.ptr<WT>(i0 + r);
+                const WT* L = line + borderX*w + r*cn;
+                for( int x = 0; x < src.cols; x++, L += w, D += cn )
+                    for( int k = 0; k < cn; k++ )
+                        D[k] = L[k];
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& buf;
+    Size wholeSize;
+    Point ofs;
+    int borderX, borderY, borderType;
+    const WT* c;
+    std::vector<int> xtab;
+
+    RecursiveGaussianRowInvoker& operator=(const RecursiveGaussianRowInvoker&); // = delete
+};
+
+// filters the vertical blocks of the buffer in Y direction in-place and stores the inner rows
+template<typename T, typename WT>
+class RecursiveGaussianColumnInvoker : public ParallelLoopBody
+{
+public:
+    enum { BLOCK_SIZE = 128 };
+
+    RecursiveGaussianColumnInvoker( Mat& _buf, Mat& _dst, int _borderY, const WT* _c ) :
+        buf(_buf), dst(_dst), borderY(_borderY), c(_c)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int width = dst.cols*dst.channels(), rows = buf.rows;
+
+        for( int b = range.start; b < range.end; b++ )
+        {
+            int j0 = b*BLOCK_SIZE, n = std::min(width - j0, (int)BLOCK_SIZE), i;
+
+            // the first row is its own steady state, so it also substitutes the previous ones
+            for( i = 1; i < rows; i++ )
+                recursiveGaussianRow(buf.ptr<WT>(i) + j0, buf.ptr<WT>(i - 1) + j0,
+                                     buf.ptr<WT>(std::max(i - 2, 0)) + j0,
+                                     buf.ptr<WT>(std::max(i - 3, 0)) + j0, buf.ptr<WT>(i) + j0, n, c);
+
+            for( i = rows - 1; i >= borderY; i-- )
+            {
+                WT* B = buf.ptr<WT>(i) + j0;
+                if( i < rows - 1 )
+                    recursiveGaussianRow(B, buf.ptr<WT>(i + 1) + j0,
+                                         buf.ptr<WT>(std::min(i + 2, rows - 1)) + j0,
+                                         buf.ptr<WT>(std::min(i + 3, rows - 1)) + j0, B, n, c);
+                if( i < borderY + dst.rows )
+                {
+                    T* D = dst.ptr<T>(i - borderY) + j0;
+                    for( int j = 0; j < n; j++ )
+                        D[j] = saturate_cast<T>(B[j]);
+                }
+            }
+        }
+    }
+
+private:
+    Mat& buf;
+    Mat& dst;
+    int borderY;
+    const WT* c;
+
+    RecursiveGaussianColumnInvoker& operator=(const RecursiveGaussianColumnInvoker&); // = delete
+};
+
+template<typename T, typename WT> static void
+recursiveGaussianBlur_( const Mat& src, Mat& dst, double sigmaX, double sigmaY, int borderType )
+{
+    WT c[8];
+    double cx[4], cy[4];
+    getRecursiveGaussianCoeffs(sigmaX, cx);
+    getRecursiveGaussianCoeffs(sigmaY, cy);
+    for( int k = 1; k < 4; k++ )
+    {
+        c[k] = (WT)cx[k];
+        c[k + 4] = (WT)cy[k];
+    }
+    // for large sigmas the gain is small, so it's corrected after rounding of the other
+    // coefficients to keep the sum of the impulse response equal to 1
+    c[0] = (WT)(1 - ((double)c[1] + (double)c[2] + (double)c[3]));
+    c[4] = (WT)(1 - ((double)c[5] + (double)c[6] + (double)c[7]));
+
+    Size wholeSize;
+    Point ofs;
+    if( borderType & BORDER_ISOLATED )
+        wholeSize = src.size();
+    else
+        src.locateROI(wholeSize, ofs);
+    borderType &= ~BORDER_ISOLATED;
+
+    int borderX = recursiveGaussianBorder(sigmaX), borderY = recursiveGaussianBorder(sigmaY);
+    Mat buf(src.rows + borderY*2, src.cols, CV_MAKETYPE(DataType<WT>::depth, src.channels()));
+
+    typedef RecursiveGaussianRowInvoker<T, WT> RowInvoker;
+    RowInvoker rowInvoker(src, buf, wholeSize, ofs, borderX, borderY, borderType, c);
+    parallel_for_(Range(0, (buf.rows + RowInvoker::GROUP_SIZE - 1)/RowInvoker::GROUP_SIZE), rowInvoker);
+
+    typedef RecursiveGaussianColumnInvoker<T, WT> ColumnInvoker;
+    ColumnInvoker columnInvoker(buf, dst, borderY, c + 4);
+    int nblocks = (src.cols*src.channels() + ColumnInvoker::BLOCK_SIZE - 1)/ColumnInvoker::BLOCK_SIZE;
+    parallel_for_(Range(0, nblocks), columnInvoker);
+}
+
+} // namespace anon
+
+void recursiveGaussianBlur( InputArray _src, OutputArray _dst, double sigmaX, double sigmaY, int borderType )
+{
+    CV_INSTRUMENT_REGION();
+
+    if( sigmaY <= 0 )
+        sigmaY = sigmaX;
+    CV_CheckGE(sigmaX, 0.5, "");
+    CV_CheckGE(sigmaY, 0.5, "");
+    CV_Assert( (borderType & ~BORDER_ISOLATED) != BORDER_WRAP );
+
+    Mat src = _src.getMat();
+    int depth = src.depth();
+    _dst.create(src.size(), src.type());
+    Mat dst = _dst.getMat();
+    if( src.empty() )
+        return;
+
+    typedef void (*RecursiveGaussianFunc)(const Mat& src, Mat& dst, double sigmaX, double sigmaY, int borderType);
+    static RecursiveGaussianFunc funcs[][2] =
+    {
+        { recursiveGaussianBlur_<uchar, float>, recursiveGaussianBlur_<uchar, double> },
+        { 0, 0 },
+        { recursiveGaussianBlur_<ushort, float>, recursiveGaussianBlur_<ushort, double> },
+        { recursiveGaussianBlur_<short, float>, recursiveGaussianBlur_<short, double> },
+        { 0, 0 },
+        { recursiveGaussianBlur_<float, float>, recursiveGaussianBlur_<float, double> },
+        { recursiveGaussianBlur_<double, double>, recursiveGaussianBlur_<double, double> }
+    };
+
+    // the poles of the filters approach 1 with growing sigma, and the rounding errors of
+    // the single-precision recursion become noticeable
+    RecursiveGaussianFunc func = depth < CV_16F ? funcs[depth][std::max(sigmaX, sigmaY) > 32] : 0;
+    if( !func )
+        CV_Error(Error::StsUnsupportedFormat, "");
+    func(src, dst, sigmaX, sigmaY, borderType);
+}
+
+} // namespace cv
@@ -59,6 +59,8 @@
 #include "opencv2/core/softfloat.hpp"
 #include "fixedpoint.inl.hpp"
 
+#include <map>
+
 using namespace cv;
 
 namespace
@@ -3664,31 +3666,9 @@ static bool ipp_resize(const uchar * src_data, size_t src_step, int src_width, i
 
 //==================================================================================================
 
-namespace hal {
-
-void resize(int src_type,
-            const uchar * src_data, size_t src_step, int src_width, int src_height,
-            uchar * dst_data, size_t dst_step, int dst_width, int dst_height,
-            double inv_scale_x, double inv_scale_y, int interpolation)
+// returns the separable resize for the depth and the interpolation method
+static ResizeFunc getResizeGenericFunc(int depth, int interpolation)
 {
-    CV_INSTRUMENT_REGION();
-
-    CV_Assert((dst_width > 0 && dst_height > 0) || (inv_scale_x > 0 && inv_scale_y > 0));
-    if (inv_scale_x < DBL_EPSILON || inv_scale_y < DBL_EPSILON)
-    {
-        inv_scale_x = static_cast<double>(dst_width) / src_width;
-        inv_scale_y = static_cast<double>(dst_height) / src_height;
-    }
-
-    CALL_HAL(resize, cv_hal_resize, src_type, src_data, src_step, src_width, src_height, dst_data, dst_step, dst_width, dst_height, inv_scale_x, inv_scale_y, interpolation);
-
-    int  depth = CV_MAT_DEPTH(src_type), cn = CV_MAT_CN(src_type);
-    Size dsize = Size(saturate_cast<int>(src_width*inv_scale_x),
-                        saturate_cast<int>(src_height*inv_scale_y));
-    CV_Assert( !dsize.empty() );
-
-    CV_IPP_RUN_FAST(ipp_resize(src_data, src_step, src_width, src_height, dst_data, dst_step, dsize.width, dsize.height, inv_scale_x, inv_scale_y, depth, cn, interpolation))
-
     static ResizeFunc linear_tab[] =
     {
         resizeGeneric_<
@@ -3774,6 +3754,195 @@ void resize(int src_type,
         0
     };
 
+    return interpolation == INTER_CUBIC ? cubic_tab[depth] :
+           interpolation == INTER_LANCZOS4 ? lanczos4_tab[depth] : linear_tab[depth];
+}
+
+// The coefficient tables of the separable resize (INTER_LINEAR, INTER_CUBIC, INTER_LANCZOS4 and the
+// upscaling INTER_AREA). They depend only on the image sizes, so the images of the same size can
+// share them.
+class ResizeGenericPlan
+{
+public:
+    ResizeGenericPlan(int type, Size ssize, Size dsize, double inv_scale_x, double inv_scale_y, int interpolation)
+    {
+        int depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
+        int src_width = ssize.width;
+        int k, sx, sy, dx, dy;
+        double scale_x = 1./inv_scale_x, scale_y = 1./inv_scale_y;
+
+        xmin = 0, xmax = dsize.width, width = dsize.width*cn;
+        height = dsize.height;
+        bool area_mode = interpolation == INTER_AREA;
+        fixpt = depth == CV_8U;
+        float fx, fy;
+        func = 0;
+        ksize = 0;
+        int ksize2;
+        if( interpolation == INTER_CUBIC )
+            ksize = 4, func = getResizeGenericFunc(depth, INTER_CUBIC);
+        else if( interpolation == INTER_LANCZOS4 )
+            ksize = 8, func = getResizeGenericFunc(depth, INTER_LANCZOS4);
+        else if( interpolation == INTER_LINEAR || interpolation == INTER_AREA )
+            ksize = 2, func = getResizeGenericFunc(depth, INTER_LINEAR);
+        else
+            CV_Error( CV_StsBadArg, "Unknown interpolation method" );
+        ksize2 = ksize/2;
+
+        CV_Assert( func != 0 );
+
+        buffer.allocate((width + dsize.height)*(sizeof(int) + sizeof(float)*ksize));
+        int* xofs = (int*)buffer.data();
+        int* yofs = xofs + width;
+        float* alpha = (float*)(yofs + dsize.height);
+        short* ialpha = (short*)alpha;
+        float* beta = alpha + width*ksize;
+        short* ibeta = ialpha + width*ksize;
+        float cbuf[MAX_ESIZE] = {0};
+
+        for( dx = 0; dx < dsize.width; dx++ )
+        {
+            if( !area_mode )
+            {
+                fx = (float)((dx+0.5)*scale_x - 0.5);
+                sx = cvFloor(fx);
+                fx -= sx;
+            }
+            else
+            {
+                sx = cvFloor(dx*scale_x);
+                fx = (float)((dx+1) - (sx+1)*inv_scale_x);
+                fx = fx <= 0 ? 0.f : fx - cvFloor(fx);
+            }
+
+            if( sx < ksize2-1 )
+            {
+                xmin = dx+1;
+                if( sx < 0 && (interpolation != INTER_CUBIC && interpolation != INTER_LANCZOS4))
+                    fx = 0, sx = 0;
+            }
+
+            if( sx + ksize2 >= src_width )
+            {
+                xmax = std::min( xmax, dx );
+                if( sx >= src_width-1 && (interpolation != INTER_CUBIC && interpolation != INTER_LANCZOS4))
+                    fx = 0, sx = src_width-1;
+            }
+
+            for( k = 0, sx *= cn; k < cn; k++ )
+                xofs[dx*cn + k] = sx + k;
+
+            if( interpolation == INTER_CUBIC )
+                interpolateCubic( fx, cbuf );
+            else if( interpolation == INTER_LANCZOS4 )
+                interpolateLanczos4( fx, cbuf );
+            else
+            {
+                cbuf[0] = 1.f - fx;
+                cbuf[1] = fx;
+            }
+            if( fixpt )
+            {
+                for( k = 0; k < ksize; k++ )
+                    ialpha[dx*cn*ksize + k] = saturate_cast<short>(cbuf[k]*INTER_RESIZE_COEF_SCALE);
+                for( ; k < cn*ksize; k++ )
+                    ialpha[dx*cn*ksize + k] = ialpha[dx*cn*ksize + k - ksize];
+            }
+            else
+            {
+                for( k = 0; k < ksize; k++ )
+                    alpha[dx*cn*ksize + k] = cbuf[k];
+                for( ; k < cn*ksize; k++ )
+                    alpha[dx*cn*ksize + k] = alpha[dx*cn*ksize + k - ksize];
+            }
+        }
+
+        for( dy = 0; dy < dsize.height; dy++ )
+        {
+            if( !area_mode )
+            {
+                fy = (float)((dy+0.5)*scale_y - 0.5);
+                sy = cvFloor(fy);
+                fy -= sy;
+            }
+            else
+            {
+                sy = cvFloor(dy*scale_y);
+                fy = (float)((dy+1) - (sy+1)*inv_scale_y);
+                fy = fy <= 0 ? 0.f : fy - cvFloor(fy);
+            }
+
+            yofs[dy] = sy;
+            if( interpolation == INTER_CUBIC )
+                interpolateCubic( fy, cbuf );
+            else if( interpolation == INTER_LANCZOS4 )
+                interpolateLanczos4( fy, cbuf );
+            else
+            {
+                cbuf[0] = 1.f - fy;
+                cbuf[1] = fy;
+            }
+
+            if( fixpt )
+            {
+                for( k = 0; k < ksize; k++ )
+                    ibeta[dy*ksize + k] = saturate_cast<short>(cbuf[k]*INTER_RESIZE_COEF_SCALE);
+            }
+            else
+            {
+                for( k = 0; k < ksize; k++ )
+                    beta[dy*ksize + k] = cbuf[k];
+            }
+        }
+    }
+
+    void apply(const Mat& src, Mat& dst) const
+    {
+        const int* xofs = (const int*)buffer.data();
+        const int* yofs = xofs + width;
+        const float* alpha = (const float*)(yofs + height);
+        const float* beta = alpha + width*ksize;
+        const short* ialpha = (const short*)alpha;
+        const short* ibeta = ialpha + width*ksize;
+        func( src, dst, xofs, fixpt ? (const void*)ialpha : (const void*)alpha, yofs,
+              fixpt ? (const void*)ibeta : (const void*)beta, xmin, xmax, ksize );
+    }
+
+private:
+    AutoBuffer<uchar> buffer;
+    ResizeFunc func;
+    int width, height, ksize, xmin, xmax;
+    bool fixpt;
+
+    ResizeGenericPlan(const ResizeGenericPlan&); // = delete
+    ResizeGenericPlan& operator=(const ResizeGenericPlan&); // = delete
+};
+
+namespace hal {
+
+void resize(int src_type,
+            const uchar * src_data, size_t src_step, int src_width, int src_height,
+            uchar * dst_data, size_t dst_step, int dst_width, int dst_height,
+            double inv_scale_x, double inv_scale_y, int interpolation)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert((dst_width > 0 && dst_height > 0) || (inv_scale_x > 0 && inv_scale_y > 0));
+    if (inv_scale_x < DBL_EPSILON || inv_scale_y < DBL_EPSILON)
+    {
+        inv_scale_x = static_cast<double>(dst_width) / src_width;
+        inv_scale_y = static_cast<double>(dst_height) / src_height;
+    }
+
+    CALL_HAL(resize, cv_hal_resize, src_type, src_data, src_step, src_width, src_height, dst_data, dst_step, dst_width, dst_height, inv_scale_x, inv_scale_y, interpolation);
+
+    int  depth = CV_MAT_DEPTH(src_type), cn = CV_MAT_CN(src_type);
+    Size dsize = Size(saturate_cast<int>(src_width*inv_scale_x),
+                        saturate_cast<int>(src_height*inv_scale_y));
+    CV_Assert( !dsize.empty() );
+
+    CV_IPP_RUN_FAST(ipp_resize(src_data, src_step, src_width, src_height, dst_data, dst_step, dsize.width, dsize.height, inv_scale_x, inv_scale_y, depth, cn, interpolation))
+
     static ResizeAreaFastFunc areafast_tab[] =
     {
         resizeAreaFast_<uchar, int, ResizeAreaFastVec<uchar, ResizeAreaFastVec_SIMD_8u> >,
@@ -3910,130 +4079,8 @@ void resize(int src_type,
         }
     }
 
-    int xmin = 0, xmax = dsize.width, width = dsize.width*cn;
-    bool area_mode = interpolation == INTER_AREA;
-    bool fixpt = depth == CV_8U;
-    float fx, fy;
-    ResizeFunc func=0;
-    int ksize=0, ksize2;
-    if( interpolation == INTER_CUBIC )
-        ksize = 4, func = cubic_tab[depth];
-    else if( interpolation == INTER_LANCZOS4 )
-        ksize = 8, func = lanczos4_tab[depth];
-    else if( interpolation == INTER_LINEAR || interpolation == INTER_AREA )
-        ksize = 2, func = linear_tab[depth];
-    else
-        CV_Error( CV_StsBadArg, "Unknown interpolation method" );
-    ksize2 = ksize/2;
-
-    CV_Assert( func != 0 );
-
-    AutoBuffer<uchar> _buffer((width + dsize.height)*(sizeof(int) + sizeof(float)*ksize));
-    int* xofs = (int*)_buffer.data();
-    int* yofs = xofs + width;
-    float* alpha = (float*)(yofs + dsize.height);
-    short* ialpha = (short*)alpha;
-    float* beta = alpha + width*ksize;
-    short* ibeta = ialpha + width*ksize;
-    float cbuf[MAX_ESIZE] = {0};
-
-    for( dx = 0; dx < dsize.width; dx++ )
-    {
-        if( !area_mode )
-        {
-            fx = (float)((dx+0.5)*scale_x - 0.5);
-            sx = cvFloor(fx);
-            fx -= sx;
-        }
-        else
-        {
-            sx = cvFloor(dx*scale_x);
-            fx = (float)((dx+1) - (sx+1)*inv_scale_x);
-            fx = fx <= 0 ? 0.f : fx - cvFloor(fx);
-        }
-
-        if( sx < ksize2-1 )
-        {
-            xmin = dx+1;
-            if( sx < 0 && (interpolation != INTER_CUBIC && interpolation != INTER_LANCZOS4))
-                fx = 0, sx = 0;
-        }
-
-        if( sx + ksize2 >= src_width )
-        {
-            xmax = std::min( xmax, dx );
-            if( sx >= src_width-1 && (interpolation != INTER_CUBIC && interpolation != INTER_LANCZOS4))
-                fx = 0, sx = src_width-1;
-        }
-
-        for( k = 0, sx *= cn; k < cn; k++ )
-            xofs[dx*cn + k] = sx + k;
-
-        if( interpolation == INTER_CUBIC )
-            interpolateCubic( fx, cbuf );
-        else if( interpolation == INTER_LANCZOS4 )
-            interpolateLanczos4( fx, cbuf );
-        else
-        {
-            cbuf[0] = 1.f - fx;
-            cbuf[1] = fx;
-        }
-        if( fixpt )
-        {
-            for( k = 0; k < ksize; k++ )
-                ialpha[dx*cn*ksize + k] = saturate_cast<short>(cbuf[k]*INTER_RESIZE_COEF_SCALE);
-            for( ; k < cn*ksize; k++ )
-                ialpha[dx*cn*ksize + k] = ialpha[dx*cn*ksize + k - ksize];
-        }
-        else
-        {
-            for( k = 0; k < ksize; k++ )
-                alpha[dx*cn*ksize + k] = cbuf[k];
-            for( ; k < cn*ksize; k++ )
-                alpha[dx*cn*ksize + k] = alpha[dx*cn*ksize + k - ksize];
-        }
-    }
-
-    for( dy = 0; dy < dsize.height; dy++ )
-    {
-        if( !area_mode )
-        {
-            fy = (float)((dy+0.5)*scale_y - 0.5);
-            sy = cvFloor(fy);
-            fy -= sy;
-        }
-        else
-        {
-            sy = cvFloor(dy*scale_y);
-            fy = (float)((dy+1) - (sy+1)*inv_scale_y);
-            fy = fy <= 0 ? 0.f : fy - cvFloor(fy);
-        }
-
-        yofs[dy] = sy;
-        if( interpolation == INTER_CUBIC )
-            interpolateCubic( fy, cbuf );
-        else if( interpolation == INTER_LANCZOS4 )
-            interpolateLanczos4( fy, cbuf );
-        else
-        {
-            cbuf[0] = 1.f - fy;
-            cbuf[1] = fy;
-        }
-
-        if( fixpt )
-        {
-            for( k = 0; k < ksize; k++ )
-                ibeta[dy*ksize + k] = saturate_cast<short>(cbuf[k]*INTER_RESIZE_COEF_SCALE);
-        }
-        else
-        {
-            for( k = 0; k < ksize; k++ )
-                beta[dy*ksize + k] = cbuf[k];
-        }
-    }
-
-    func( src, dst, xofs, fixpt ? (void*)ialpha : (void*)alpha, yofs,
-          fixpt ? (void*)ibeta : (void*)beta, xmin, xmax, ksize );
+    ResizeGenericPlan plan(src_type, Size(src_width, src_height), dsize, inv_scale_x, inv_scale_y, interpolation);
+    plan.apply(src, dst);
 }
 
 } // cv::hal::
@@ -4088,6 +4135,197 @@ void cv::resize( InputArray _src, OutputArray _dst, Size dsize,
     hal::resize(src.type(), src.data, src.step, src.cols, src.rows, dst.data, dst.step, dst.cols, dst.rows, inv_scale_x, inv_scale_y, interpolation);
 }
 
+//==================================================================================================
+
+namespace cv
+{
+
+// true if hal::resize uses the separable resize with the coefficient tables for the given sizes
+static bool isResizeGeneric(Size ssize, Size dsize, int interpolation)
+{
+#ifdef HAVE_IPP_IW
+    if( ipp::useIPP() )
+        return false; // IPP may handle the case, so hal::resize must be called as cv::resize does
+#endif
+    if( ssize == dsize || interpolation == INTER_NEAREST || interpolation == INTER_NEAREST_EXACT ||
+        interpolation == INTER_LINEAR_EXACT )
+        return false;
+
+    // the same arithmetic as in hal::resize
+    double scale_x = 1./((double)dsize.width/ssize.width), scale_y = 1./((double)dsize.height/ssize.height);
+    int iscale_x = saturate_cast<int>(scale_x), iscale_y = saturate_cast<int>(scale_y);
+    bool is_area_fast = std::abs(scale_x - iscale_x) < DBL_EPSILON &&
+            std::abs(scale_y - iscale_y) < DBL_EPSILON;
+    if( interpolation == INTER_LINEAR && is_area_fast && iscale_x == 2 && iscale_y == 2 )
+        return false;
+    if( interpolation == INTER_AREA && scale_x >= 1 && scale_y >= 1 )
+        return false;
+    return true;
+}
+
+// calls the replacement HAL, as hal::resize does first; returns false if it doesn't handle the case
+static bool resizeBatchHal(const Mat& roi, Mat& res, int interpolation)
+{
+    int hal_res = cv_hal_resize(roi.type(), roi.data, roi.step, roi.cols, roi.rows, res.data, res.step,
+                                res.cols, res.rows, (double)res.cols/roi.cols, (double)res.rows/roi.rows,
+                                interpolation);
+    if( hal_res == CV_HAL_ERROR_OK )
+        return true;
+    if( hal_res != CV_HAL_ERROR_NOT_IMPLEMENTED )
+        CV_Error_(cv::Error::StsInternal,
+            ("HAL implementation resize ==> " CVAUX_STR(cv_hal_resize) " returned %d (0x%08x)", hal_res, hal_res));
+    return false;
+}
+
+class ResizeBatchInvoker : public ParallelLoopBody
+{
+public:
+    ResizeBatchInvoker(const Mat& _src, const std::vector<Rect>& _rois, Size _dsize, int _interpolation,
+                       const std::vector<Ptr<ResizeGenericPlan> >& _plans, const std::vector<int>& _planIdx,
+                       int _code, bool _planar, Mat& _dst) :
+        ParallelLoopBody(), src(_src), rois(_rois), dsize(_dsize), interpolation(_interpolation),
+        plans(_plans), planIdx(_planIdx), code(_code), planar(_planar), dst(_dst)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        int dtype = planar ? CV_MAKETYPE(dst.depth(), dst.size[1]) : dst.type();
+        int dcn = CV_MAT_CN(dtype);
+        Mat resized, converted;
+        std::vector<Mat> planes(dcn);
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            Mat roi = src(rois[i]);
+            Mat out;
+            if( !planar )
+                out = Mat(dsize, dtype, dst.ptr(i), dst.step[1]);
+            else
+            {
+                for( int c = 0; c < dcn; c++ )
+                    planes[c] = Mat(dsize, dst.depth(), dst.ptr(i, c), dst.step[2]);
+            }
+            bool direct = code < 0 && !planar;
+
+            // the resized region goes straight to the destination slice when no other step follows
+            Mat res = roi;
+            if( roi.size() != dsize )
+            {
+                if( !direct )
+                    resized.create(dsize, src.type());
+                res = direct ? out : resized;
+                if( !planIdx.empty() && planIdx[i] >= 0 )
+                {
+                    // the cached plan replaces only the generic code, a custom HAL still goes first
+                    if( !resizeBatchHal(roi, res, interpolation) )
+                        plans[planIdx[i]]->apply(roi, res);
+                }
+                else
+                    hal::resize(src.type(), roi.data, roi.step, roi.cols, roi.rows, res.data, res.step,
+                                dsize.width, dsize.height, (double)dsize.width/roi.cols,
+                                (double)dsize.height/roi.rows, interpolation);
+            }
+            else if( direct )
+                roi.copyTo(out);
+
+            if( code >= 0 )
+            {
+                if( !planar )
+                    cvtColor(res, out, code);
+                else
+                {
+                    cvtColor(res, converted, code);
+                    res = converted;
+                }
+            }
+            if( planar )
+                split(res, &planes[0]);
+        }
+    }
+
+private:
+    const Mat& src;
+    const std::vector<Rect>& rois;
+    Size dsize;
+    int interpolation;
+    const std::vector<Ptr<ResizeGenericPlan> >& plans;
+    const std::vector<int>& planIdx;
+    int code;
+    bool planar;
+    Mat& dst;
+
+    ResizeBatchInvoker& operator=(const ResizeBatchInvoker&); // = delete
+};
+
+void resizeBatchROIs(const Mat& src, const std::vector<Rect>& rois, Size dsize, int interpolation,
+                     int code, bool planar, Mat& dst)
+{
+    int n = (int)rois.size();
+    CV_Assert( !dsize.empty() && dst.size[0] == n );
+
+    if( interpolation == INTER_LINEAR_EXACT && (src.depth() == CV_32F || src.depth() == CV_64F) )
+        interpolation = INTER_LINEAR; // the same fallback as in cv::resize
+
+    // the coefficient tables are computed once per distinct region size
+    std::vector<Ptr<ResizeGenericPlan> > plans;
+    std::vector<int> planIdx;
+    std::map<std::pair<int, int>, int> planBySize;
+    for( int i = 0; i < n; i++ )
+    {
+        const Rect& r = rois[i];
+        CV_Assert( 0 <= r.x && 0 < r.width && r.x + r.width <= src.cols &&
+                   0 <= r.y && 0 < r.height && r.y + r.height <= src.rows );
+        if( !isResizeGeneric(r.size(), dsize, interpolation) )
+            continue;
+        if( planIdx.empty() )
+            planIdx.resize(n, -1);
+        std::pair<int, int> key(r.width, r.height);
+        std::map<std::pair<int, int>, int>::const_iterator it = planBySize.find(key);
+        if( it == planBySize.end() )
+        {
+            it = planBySize.insert(std::make_pair(key, (int)plans.size())).first;
+            plans.push_back(makePtr<ResizeGenericPlan>(src.type(), r.size(), dsize,
+                                                       (double)dsize.width/r.width,
+                                                       (double)dsize.height/r.height, interpolation));
+        }
+        planIdx[i] = it->second;
+    }
+
+    parallel_for_(Range(0, n), ResizeBatchInvoker(src, rois, dsize, interpolation, plans, planIdx,
+                                                  code, planar, dst));
+}
+
+} // cv::
+
+void cv::resizeBatch( InputArray _src, const std::vector<Rect>& rois, OutputArray _dst, Size dsize,
+                      int interpolation, bool planar )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = _src.getMat();
+    CV_Assert( !src.empty() && src.dims <= 2 && !dsize.empty() );
+    if( rois.empty() )
+    {
+        _dst.release();
+        return;
+    }
+
+    int n = (int)rois.size(), cn = src.channels();
+    if( planar )
+    {
+        int sz[] = { n, cn, dsize.height, dsize.width };
+        _dst.create(4, sz, src.depth());
+    }
+    else
+    {
+        int sz[] = { n, dsize.height, dsize.width };
+        _dst.create(3, sz, src.type());
+    }
+    Mat dst = _dst.getMat();
+    resizeBatchROIs(src, rois, dsize, interpolation, -1, planar, dst);
+}
+
 
 CV_IMPL void
 cvResize( const CvArr* srcarr, CvArr* dstarr, int method )
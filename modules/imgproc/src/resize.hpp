@@ -70,6 +70,11 @@ void resizeNN4_SSE4_1(const Range&, const Mat&, Mat&, int*, double);
 int VResizeLanczos4Vec_32f16u_SSE41(const float** src, ushort* dst, const float* beta, int width);
 #endif
 }
+
+// Resizes the regions of the image into the slices of dst and optionally converts their color
+// (when code >= 0) in one parallel loop, see cv::resizeBatch and cv::cvtColorBatch
+void resizeBatchROIs(const Mat& src, const std::vector<Rect>& rois, Size dsize, int interpolation,
+                     int code, bool planar, Mat& dst);
 }
 #endif
 /* End of file. */
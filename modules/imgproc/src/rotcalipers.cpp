@@ -89,14 +89,13 @@ enum { CALIPERS_MAXHEIGHT=0, CALIPERS_MINAREARECT=1, CALIPERS_MAXDIST=2 };
  //F*/
 
 /* we will use usual cartesian coordinates */
-static void rotatingCalipers( const Point2f* points, int n, int mode, float* out )
+static void rotatingCalipers( const Point2f* points, int n, int mode, float* out, float* abuf )
 {
     float minarea = FLT_MAX;
     float max_dist = 0;
     char buffer[32] = {};
     int i, k;
-    AutoBuffer<float> abuf(n*3);
-    float* inv_vect_length = abuf.data();
+    float* inv_vect_length = abuf;
     Point2f* vect = (Point2f*)(inv_vect_length + n);
     int left = 0, bottom = 0, right = 0, top = 0;
     int seq[4] = { -1, -1, -1, -1 };
@@ -341,32 +340,16 @@ static void rotatingCalipers( const Point2f* points, int n, int mode, float* out
     }
 }
 
-}
-
 
-cv::RotatedRect cv::minAreaRect( InputArray _points )
+// Finds the box of the convex hull given by the clockwise points. buf must hold n*3 elements
+static RotatedRect minAreaRectOfHull( const Point2f* hpoints, int n, float* buf )
 {
-    CV_INSTRUMENT_REGION();
-
-    Mat hull;
     Point2f out[3];
     RotatedRect box;
 
-    convexHull(_points, hull, true, true);
-
-    if( hull.depth() != CV_32F )
-    {
-        Mat temp;
-        hull.convertTo(temp, CV_32F);
-        hull = temp;
-    }
-
-    int n = hull.checkVector(2);
-    const Point2f* hpoints = hull.ptr<Point2f>();
-
     if( n > 2 )
     {
-        rotatingCalipers( hpoints, n, CALIPERS_MINAREARECT, (float*)out );
+        rotatingCalipers( hpoints, n, CALIPERS_MINAREARECT, (float*)out, buf );
         box.center.x = out[0].x + (out[1].x + out[2].x)*0.5f;
         box.center.y = out[0].y + (out[1].y + out[2].y)*0.5f;
         box.size.width = (float)std::sqrt((double)out[1].x*out[1].x + (double)out[1].y*out[1].y);
@@ -393,6 +376,72 @@ cv::RotatedRect cv::minAreaRect( InputArray _points )
     return box;
 }
 
+}
+
+
+cv::RotatedRect cv::minAreaRect( InputArray _points )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat hull;
+
+    convexHull(_points, hull, true, true);
+
+    if( hull.depth() != CV_32F )
+    {
+        Mat temp;
+        hull.convertTo(temp, CV_32F);
+        hull = temp;
+    }
+
+    int n = hull.checkVector(2);
+    AutoBuffer<float> abuf(n*3);
+    return minAreaRectOfHull(hull.ptr<Point2f>(), n, abuf.data());
+}
+
+
+void cv::minAreaRectBatch( InputArray _points, InputArray _offsets, std::vector<RotatedRect>& boxes )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat points = _points.getMat(), offsets = _offsets.getMat();
+    int ncontours = checkContourBatch(points, offsets);
+    const int* ofs = offsets.ptr<int>();
+    const Point* data = points.ptr<Point>();
+    bool is_float = points.depth() == CV_32F;
+
+    boxes.resize(ncontours);
+    parallel_for_(Range(0, ncontours), [&](const Range& r)
+    {
+        std::vector<Point*> pointer;
+        std::vector<int> stack, hull;
+        std::vector<Point2f> hpoints;
+        std::vector<float> buf;
+        for( int i = r.start; i < r.end; i++ )
+        {
+            int n = ofs[i+1] - ofs[i];
+            if( n == 0 )
+            {
+                boxes[i] = RotatedRect();
+                continue;
+            }
+            if( (int)pointer.size() < n )
+            {
+                pointer.resize(n);
+                stack.resize(n + 2);
+                hull.resize(n);
+                hpoints.resize(n);
+                buf.resize(n*3);
+            }
+            const Point* contour = data + ofs[i];
+            int nh = convexHullIndices(contour, n, is_float, true, &pointer[0], &stack[0], &hull[0]);
+            for( int j = 0; j < nh; j++ )
+                hpoints[j] = is_float ? ((const Point2f*)contour)[hull[j]] : Point2f(contour[hull[j]]);
+            boxes[i] = minAreaRectOfHull(&hpoints[0], nh, &buf[0]);
+        }
+    }, contourBatchStripes(points, ncontours));
+}
+
 
 CV_IMPL CvBox2D
 cvMinAreaRect2( const CvArr* array, CvMemStorage* /*storage*/ )
@@ -64,8 +64,8 @@ struct WSQueue
 };
 
 
-static int
-allocWSNodes( std::vector<WSNode>& storage )
+template<typename Node> static int
+allocWSNodes( std::vector<Node>& storage )
 {
     int sz = (int)storage.size();
     int newsz = MAX(128, sz*3/2);
@@ -325,6 +325,300 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
 }
 
 
+namespace cv
+{
+
+// A pixel to label in the tiled flooding; the coordinates tell the tile it belongs to,
+// and gen is the number of the steps it has been reached from a marker in
+struct WSTileNode
+{
+    int next;
+    int x, y;
+    int gen;
+};
+
+// The part of the image flooded by one thread: the hierarchical queue of its pixels
+// and the pixels of the neighbor tiles it has put to the queue
+struct WSTile
+{
+    WSTile() : free_node(0), minq(256) {}
+
+    void push( int idx, int x, int y, int gen )
+    {
+        if( !free_node )
+            free_node = allocWSNodes( storage );
+        int node = free_node;
+        free_node = storage[node].next;
+        storage[node].next = 0;
+        storage[node].x = x;
+        storage[node].y = y;
+        storage[node].gen = gen;
+        if( q[idx].last )
+            storage[q[idx].last].next = node;
+        else
+            q[idx].first = node;
+        q[idx].last = node;
+        minq = std::min(minq, idx);
+    }
+
+    void pop( int idx, int& x, int& y, int& gen )
+    {
+        int node = q[idx].first;
+        q[idx].first = storage[node].next;
+        if( !storage[node].next )
+            q[idx].last = 0;
+        storage[node].next = free_node;
+        free_node = node;
+        x = storage[node].x;
+        y = storage[node].y;
+        gen = storage[node].gen;
+    }
+
+    // returns the lowest non-empty queue not above the level, or -1
+    int top( int level )
+    {
+        int a = minq;
+        while( a <= level && !q[a].first )
+            a++;
+        minq = a;
+        return a <= level ? a : -1;
+    }
+
+    Rect r;
+    std::vector<WSTileNode> storage;
+    int free_node;
+    WSQueue q[256];
+    // all the queues below minq are empty
+    int minq;
+    // (priority, x, y, gen) of the queued pixels of the neighbor tiles
+    std::vector<Vec4i> outbox;
+};
+
+static inline int wsDiff( const uchar* a, const uchar* b )
+{
+    return std::max(std::max(std::abs(a[0] - b[0]), std::abs(a[1] - b[1])), std::abs(a[2] - b[2]));
+}
+
+class WatershedTileInit_Invoker : public ParallelLoopBody
+{
+public:
+    WatershedTileInit_Invoker( const Mat& _src, Mat& _markers, std::vector<WSTile>& _tiles )
+        : src(_src), markers(_markers), tiles(_tiles) {}
+
+    virtual void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        int mstep = (int)(markers.step/sizeof(int));
+        for( int k = range.start; k < range.end; k++ )
+        {
+            WSTile& t = tiles[k];
+            int y0 = std::max(t.r.y, 1), y1 = std::min(t.r.y + t.r.height, markers.rows - 1);
+            int x0 = std::max(t.r.x, 1), x1 = std::min(t.r.x + t.r.width, markers.cols - 1);
+            for( int y = y0; y < y1; y++ )
+            {
+                const int* m = markers.ptr<int>(y);
+                const uchar* ptr = src.ptr(y);
+                for( int x = x0; x < x1; x++ )
+                {
+                    if( m[x] != 0 || (m[x-1] <= 0 && m[x+1] <= 0 && m[x-mstep] <= 0 && m[x+mstep] <= 0) )
+                        continue;
+                    const uchar* p = ptr + x*3;
+                    int idx = 256;
+                    if( m[x-1] > 0 )
+                        idx = std::min(idx, wsDiff(p, p - 3));
+                    if( m[x+1] > 0 )
+                        idx = std::min(idx, wsDiff(p, p + 3));
+                    if( m[x-mstep] > 0 )
+                        idx = std::min(idx, wsDiff(p, p - src.step));
+                    if( m[x+mstep] > 0 )
+                        idx = std::min(idx, wsDiff(p, p + src.step));
+                    t.push(idx, x, y, 0);
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& markers;
+    std::vector<WSTile>& tiles;
+
+    WatershedTileInit_Invoker& operator=(const WatershedTileInit_Invoker&); // = delete
+};
+
+// Floods the tiles up to the given level, until the pixels reached in the given number of steps.
+// The tiles processed together are never adjacent, so each tile may read and mark the pixels of its
+// neighbors, while the queue entries for them are collected in the outbox and delivered after the pass
+class WatershedTileFlood_Invoker : public ParallelLoopBody
+{
+public:
+    WatershedTileFlood_Invoker( const Mat& _src, Mat& _markers, std::vector<WSTile>& _tiles,
+                                const std::vector<int>& _active, int _level, int _horizon )
+        : src(_src), markers(_markers), tiles(_tiles), active(_active), level(_level), horizon(_horizon) {}
+
+    virtual void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        const int IN_QUEUE = -2, WSHED = -1;
+        const int mstep = (int)(markers.step/sizeof(int)), istep = (int)src.step;
+        const int dx[] = { -1, 1, 0, 0 }, dy[] = { 0, 0, -1, 1 };
+        const int mofs[] = { -1, 1, -mstep, mstep }, iofs[] = { -3, 3, -istep, istep };
+
+        for( int k = range.start; k < range.end; k++ )
+        {
+            WSTile& t = tiles[active[k]];
+            for(;;)
+            {
+                int a = t.top(level);
+                if( a < 0 || t.storage[t.q[a].first].gen >= horizon )
+                    break;
+
+                int x, y, gen;
+                t.pop(a, x, y, gen);
+                int* m = markers.ptr<int>(y) + x;
+                const uchar* ptr = src.ptr(y) + x*3;
+
+                int lab = 0;
+                for( int i = 0; i < 4; i++ )
+                {
+                    int l = m[mofs[i]];
+                    if( l > 0 )
+                    {
+                        if( lab == 0 ) lab = l;
+                        else if( l != lab ) lab = WSHED;
+                    }
+                }
+                CV_DbgAssert( lab != 0 );
+                m[0] = lab;
+                if( lab == WSHED )
+                    continue;
+
+                for( int i = 0; i < 4; i++ )
+                {
+                    if( m[mofs[i]] != 0 )
+                        continue;
+                    int d = wsDiff(ptr, ptr + iofs[i]);
+                    int nx = x + dx[i], ny = y + dy[i];
+                    m[mofs[i]] = IN_QUEUE;
+                    if( t.r.contains(Point(nx, ny)) )
+                        t.push(d, nx, ny, gen + 1);
+                    else
+                        t.outbox.push_back(Vec4i(d, nx, ny, gen + 1));
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& markers;
+    std::vector<WSTile>& tiles;
+    const std::vector<int>& active;
+    int level, horizon;
+
+    WatershedTileFlood_Invoker& operator=(const WatershedTileFlood_Invoker&); // = delete
+};
+
+}
+
+void cv::watershed( InputArray _src, InputOutputArray _markers, Size tileSize )
+{
+    CV_INSTRUMENT_REGION();
+
+    const int IN_QUEUE = -2, WSHED = -1;
+
+    Mat src = _src.getMat(), dst = _markers.getMat();
+    CV_Assert( src.type() == CV_8UC3 && dst.type() == CV_32SC1 );
+    CV_Assert( src.size() == dst.size() );
+    CV_Assert( tileSize.width > 1 && tileSize.height > 1 );
+
+    Size size = src.size();
+    if( size.area() == 0 )
+        return;
+    int ntx = (size.width + tileSize.width - 1)/tileSize.width;
+    int nty = (size.height + tileSize.height - 1)/tileSize.height;
+    int ntiles = ntx*nty;
+
+    // draw a pixel-wide border of dummy "watershed" (i.e. boundary) pixels
+    for( int i = 0; i < size.height; i++ )
+    {
+        int* mask = dst.ptr<int>(i);
+        if( i == 0 || i == size.height-1 )
+        {
+            for( int j = 0; j < size.width; j++ )
+                mask[j] = WSHED;
+            continue;
+        }
+        mask[0] = mask[size.width-1] = WSHED;
+        for( int j = 1; j < size.width-1; j++ )
+            if( mask[j] < 0 )
+                mask[j] = 0;
+    }
+
+    std::vector<WSTile> tiles(ntiles);
+    for( int ty = 0, k = 0; ty < nty; ty++ )
+        for( int tx = 0; tx < ntx; tx++, k++ )
+            tiles[k].r = Rect(tx*tileSize.width, ty*tileSize.height, tileSize.width, tileSize.height) &
+                         Rect(0, 0, size.width, size.height);
+
+    // initial phase: put all the neighbor pixels of each marker to the queues of their tiles
+    parallel_for_(Range(0, ntiles), WatershedTileInit_Invoker(src, dst, tiles));
+    for( int k = 0; k < ntiles; k++ )
+        for( int i = 0; i < 256; i++ )
+            for( int node = tiles[k].q[i].first; node; node = tiles[k].storage[node].next )
+                dst.at<int>(tiles[k].storage[node].y, tiles[k].storage[node].x) = IN_QUEUE;
+
+    // flood the basins level by level. The pixels of each level are processed in rounds of 4 passes,
+    // one per tile of every 2x2 block. Each round advances the flooding by a limited number of steps
+    // from the oldest queued pixel, so the basins grow across the tiles about as fast as within them
+    const int step = 16;
+    std::vector<int> active;
+    for( int level = 0; level < 256; )
+    {
+        for(;;)
+        {
+            int horizon = INT_MAX;
+            for( int k = 0; k < ntiles; k++ )
+            {
+                int a = tiles[k].top(level);
+                if( a >= 0 )
+                    horizon = std::min(horizon, tiles[k].storage[tiles[k].q[a].first].gen + step);
+            }
+            if( horizon == INT_MAX )
+                break;
+
+            for( int phase = 0; phase < 4; phase++ )
+            {
+                active.clear();
+                for( int ty = phase / 2; ty < nty; ty += 2 )
+                    for( int tx = phase % 2; tx < ntx; tx += 2 )
+                        if( tiles[ty*ntx + tx].minq <= level )
+                            active.push_back(ty*ntx + tx);
+                if( active.empty() )
+                    continue;
+
+                parallel_for_(Range(0, (int)active.size()),
+                              WatershedTileFlood_Invoker(src, dst, tiles, active, level, horizon));
+
+                for( size_t k = 0; k < active.size(); k++ )
+                {
+                    std::vector<Vec4i>& outbox = tiles[active[k]].outbox;
+                    for( size_t i = 0; i < outbox.size(); i++ )
+                    {
+                        const Vec4i& e = outbox[i];
+                        tiles[(e[2]/tileSize.height)*ntx + e[1]/tileSize.width].push(e[0], e[1], e[2], e[3]);
+                    }
+                    outbox.clear();
+                }
+            }
+        }
+
+        int next = 256;
+        for( int k = 0; k < ntiles; k++ )
+            next = std::min(next, tiles[k].minq);
+        level = std::max(next, level + 1);
+    }
+}
+
+
 /****************************************************************************************\
 *                                         Meanshift                                      *
 \****************************************************************************************/
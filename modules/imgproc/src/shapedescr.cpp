@@ -304,23 +304,16 @@ double cv::arcLength( InputArray _curve, bool is_closed )
     return perimeter;
 }
 
-// area of a whole sequence
-double cv::contourArea( InputArray _contour, bool oriented )
+namespace cv
 {
-    CV_INSTRUMENT_REGION();
-
-    Mat contour = _contour.getMat();
-    int npoints = contour.checkVector(2);
-    int depth = contour.depth();
-    CV_Assert(npoints >= 0 && (depth == CV_32F || depth == CV_32S));
 
+static double contourArea_( const Point* ptsi, int npoints, bool is_float, bool oriented )
+{
     if( npoints == 0 )
         return 0.;
 
     double a00 = 0;
-    bool is_float = depth == CV_32F;
-    const Point* ptsi = contour.ptr<Point>();
-    const Point2f* ptsf = contour.ptr<Point2f>();
+    const Point2f* ptsf = (const Point2f*)ptsi;
     Point2f prev = is_float ? ptsf[npoints-1] : Point2f((float)ptsi[npoints-1].x, (float)ptsi[npoints-1].y);
 
     for( int i = 0; i < npoints; i++ )
@@ -337,6 +330,21 @@ double cv::contourArea( InputArray _contour, bool oriented )
     return a00;
 }
 
+}
+
+// area of a whole sequence
+double cv::contourArea( InputArray _contour, bool oriented )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat contour = _contour.getMat();
+    int npoints = contour.checkVector(2);
+    int depth = contour.depth();
+    CV_Assert(npoints >= 0 && (depth == CV_32F || depth == CV_32S));
+
+    return contourArea_(contour.ptr<Point>(), npoints, depth == CV_32F, oriented);
+}
+
 namespace cv
 {
 
@@ -1142,6 +1150,69 @@ cv::Rect cv::boundingRect(InputArray array)
     return m.depth() <= CV_8U ? maskBoundingRect(m) : pointSetBoundingRect(m);
 }
 
+int cv::checkContourBatch( const Mat& points, const Mat& offsets )
+{
+    int npoints = 0;
+    if( !points.empty() )
+    {
+        npoints = points.checkVector(2);
+        int depth = points.depth();
+        CV_Assert(npoints >= 0 && (depth == CV_32F || depth == CV_32S) && points.isContinuous());
+    }
+    CV_Assert(offsets.checkVector(1, CV_32S) >= 1 && offsets.isContinuous());
+
+    int ncontours = (int)offsets.total() - 1;
+    const int* ofs = offsets.ptr<int>();
+    if( ofs[0] < 0 || ofs[ncontours] > npoints )
+        CV_Error(CV_StsBadArg, "The contour offsets are out of the point array");
+    for( int i = 0; i < ncontours; i++ )
+        if( ofs[i+1] < ofs[i] )
+            CV_Error(CV_StsBadArg, "The contour offsets must be non-decreasing");
+    return ncontours;
+}
+
+void cv::boundingRectBatch( InputArray _points, InputArray _offsets, std::vector<Rect>& rects )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat points = _points.getMat(), offsets = _offsets.getMat();
+    int ncontours = checkContourBatch(points, offsets);
+    const int* ofs = offsets.ptr<int>();
+    const Point* data = points.ptr<Point>();
+    int type = points.depth() == CV_32F ? CV_32FC2 : CV_32SC2;
+
+    rects.resize(ncontours);
+    parallel_for_(Range(0, ncontours), [&](const Range& r)
+    {
+        for( int i = r.start; i < r.end; i++ )
+        {
+            int n = ofs[i+1] - ofs[i];
+            rects[i] = n == 0 ? Rect() : pointSetBoundingRect(Mat(n, 1, type, (void*)(data + ofs[i])));
+        }
+    }, contourBatchStripes(points, ncontours));
+}
+
+void cv::contourAreaBatch( InputArray _points, InputArray _offsets, OutputArray _areas, bool oriented )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat points = _points.getMat(), offsets = _offsets.getMat();
+    int ncontours = checkContourBatch(points, offsets);
+    const int* ofs = offsets.ptr<int>();
+    const Point* data = points.ptr<Point>();
+    bool is_float = points.depth() == CV_32F;
+
+    _areas.create(ncontours, 1, CV_64F);
+    if( ncontours == 0 )
+        return;
+    double* areas = _areas.getMat().ptr<double>();
+    parallel_for_(Range(0, ncontours), [&](const Range& r)
+    {
+        for( int i = r.start; i < r.end; i++ )
+            areas[i] = contourArea_(data + ofs[i], ofs[i+1] - ofs[i], is_float, oriented);
+    }, contourBatchStripes(points, ncontours));
+}
+
 ////////////////////////////////////////////// C API ///////////////////////////////////////////
 
 CV_IMPL int
@@ -412,6 +412,166 @@ void integral(
 
 } // namespace hal
 
+// Computes the row of the integral images that follows the last row of the previous band:
+// sum = prev + carry + (prefix sum of the source row), where prev is the band-local integral
+// of the previous source row and carry is the final row above the previous band.
+template<typename T, typename ST, typename QT> static void
+integralBandBorder_( const uchar* _src, const uchar* _sumprev, const uchar* _sumcarry, uchar* _sum,
+                     const uchar* _sqprev, const uchar* _sqcarry, uchar* _sqsum, int width, int cn )
+{
+    const T* src = (const T*)_src;
+    const ST* sumprev = (const ST*)_sumprev + cn;
+    const ST* sumcarry = (const ST*)_sumcarry + cn;
+    ST* sum = (ST*)_sum;
+
+    width *= cn;
+    for( int k = 0; k < cn; k++ )
+    {
+        sum[k] = 0;
+        ST s = 0;
+        for( int x = k; x < width; x += cn )
+        {
+            s += src[x];
+            sum[x + cn] = sumprev[x] + sumcarry[x] + s;
+        }
+    }
+
+    if( _sqsum )
+    {
+        const QT* sqprev = (const QT*)_sqprev + cn;
+        const QT* sqcarry = (const QT*)_sqcarry + cn;
+        QT* sqsum = (QT*)_sqsum;
+        for( int k = 0; k < cn; k++ )
+        {
+            sqsum[k] = 0;
+            QT sq = 0;
+            for( int x = k; x < width; x += cn )
+            {
+                T it = src[x];
+                sq += (QT)it*it;
+                sqsum[x + cn] = sqprev[x] + sqcarry[x] + sq;
+            }
+        }
+    }
+}
+
+typedef void (*IntegralBandBorderFunc)( const uchar* src, const uchar* sumprev, const uchar* sumcarry, uchar* sum,
+                                        const uchar* sqprev, const uchar* sqcarry, uchar* sqsum, int width, int cn );
+
+static IntegralBandBorderFunc getIntegralBandBorderFunc( int depth, int sdepth, int sqdepth )
+{
+#define ONE_CALL(A, B, C) return integralBandBorder_<A, B, C>
+
+    if( depth == CV_8U && sdepth == CV_32S && sqdepth == CV_64F )
+        ONE_CALL(uchar, int, double);
+    else if( depth == CV_8U && sdepth == CV_32S && sqdepth == CV_32F )
+        ONE_CALL(uchar, int, float);
+    else if( depth == CV_8U && sdepth == CV_32S && sqdepth == CV_32S )
+        ONE_CALL(uchar, int, int);
+    else if( depth == CV_8U && sdepth == CV_32F && sqdepth == CV_64F )
+        ONE_CALL(uchar, float, double);
+    else if( depth == CV_8U && sdepth == CV_32F && sqdepth == CV_32F )
+        ONE_CALL(uchar, float, float);
+    else if( depth == CV_8U && sdepth == CV_64F && sqdepth == CV_64F )
+        ONE_CALL(uchar, double, double);
+    else if( depth == CV_16U && sdepth == CV_64F && sqdepth == CV_64F )
+        ONE_CALL(ushort, double, double);
+    else if( depth == CV_16S && sdepth == CV_64F && sqdepth == CV_64F )
+        ONE_CALL(short, double, double);
+    else if( depth == CV_32F && sdepth == CV_32F && sqdepth == CV_64F )
+        ONE_CALL(float, float, double);
+    else if( depth == CV_32F && sdepth == CV_32F && sqdepth == CV_32F )
+        ONE_CALL(float, float, float);
+    else if( depth == CV_32F && sdepth == CV_64F && sqdepth == CV_64F )
+        ONE_CALL(float, double, double);
+    else if( depth == CV_64F && sdepth == CV_64F && sqdepth == CV_64F )
+        ONE_CALL(double, double, double);
+
+#undef ONE_CALL
+    return 0;
+}
+
+template<typename ST> static void
+integralAddCarry_( Mat& m, int row0, int row1, int carryRow )
+{
+    int n = m.cols*m.channels();
+    const ST* carry = m.ptr<ST>(carryRow);
+    for( int y = row0; y < row1; y++ )
+    {
+        ST* row = m.ptr<ST>(y);
+        for( int x = 0; x < n; x++ )
+            row[x] += carry[x];
+    }
+}
+
+static void integralAddCarry( Mat& m, int row0, int row1, int carryRow )
+{
+    int depth = m.depth();
+    if( depth == CV_32S )
+        integralAddCarry_<int>(m, row0, row1, carryRow);
+    else if( depth == CV_32F )
+        integralAddCarry_<float>(m, row0, row1, carryRow);
+    else
+        integralAddCarry_<double>(m, row0, row1, carryRow);
+}
+
+// The rows are split into horizontal bands. At the first pass each band computes its own integral images,
+// as if it was the top of the image; the row above the band (zero in the band-local integral) belongs to
+// the previous band and its last source row is left out. Then the rows between the bands are computed
+// sequentially, which is cheap, and they serve as the carry that is added to all the rows of the next band
+// at the second pass.
+static bool integralBands( const Mat& src, Mat& sum, Mat& sqsum, int depth, int sdepth, int sqdepth )
+{
+    const int minBandRows = 32;
+    int height = src.rows, width = src.cols, cn = src.channels();
+    int nbands = std::min(getNumThreads(), height / minBandRows);
+    if( nbands < 2 || (size_t)width*height*cn < (size_t)(1 << 16) )
+        return false;
+
+    IntegralBandBorderFunc borderFunc = getIntegralBandBorderFunc(depth, sdepth, sqdepth);
+    if( !borderFunc )
+        return false;
+
+    bool hasSqsum = !sqsum.empty();
+    std::vector<int> bandRows(nbands + 1);
+    for( int b = 0; b <= nbands; b++ )
+        bandRows[b] = (int)((int64)height*b/nbands);
+
+    parallel_for_(Range(0, nbands), [&](const Range& r)
+    {
+        for( int b = r.start; b < r.end; b++ )
+        {
+            int y0 = bandRows[b], y1 = b == nbands - 1 ? height : bandRows[b+1] - 1;
+            hal::integral(depth, sdepth, sqdepth,
+                          src.ptr(y0), src.step,
+                          sum.ptr(y0), sum.step,
+                          hasSqsum ? sqsum.ptr(y0) : 0, sqsum.step,
+                          0, 0, width, y1 - y0, cn);
+        }
+    }, nbands);
+
+    for( int b = 1; b < nbands; b++ )
+    {
+        int y = bandRows[b], ycarry = bandRows[b-1];
+        borderFunc(src.ptr(y - 1), sum.ptr(y - 1), sum.ptr(ycarry), sum.ptr(y),
+                   hasSqsum ? sqsum.ptr(y - 1) : 0, hasSqsum ? sqsum.ptr(ycarry) : 0,
+                   hasSqsum ? sqsum.ptr(y) : 0, width, cn);
+    }
+
+    parallel_for_(Range(1, nbands), [&](const Range& r)
+    {
+        for( int b = r.start; b < r.end; b++ )
+        {
+            int y0 = bandRows[b] + 1, y1 = b == nbands - 1 ? height + 1 : bandRows[b+1];
+            integralAddCarry(sum, y0, y1, bandRows[b]);
+            if( hasSqsum )
+                integralAddCarry(sqsum, y0, y1, bandRows[b]);
+        }
+    }, nbands - 1);
+
+    return true;
+}
+
 void integral(InputArray _src, OutputArray _sum, OutputArray _sqsum, OutputArray _tilted, int sdepth, int sqdepth )
 {
     CV_INSTRUMENT_REGION();
@@ -442,6 +602,10 @@ void integral(InputArray _src, OutputArray _sum, OutputArray _sqsum, OutputArray
         tilted = _tilted.getMat();
     }
 
+    // the tilted sums propagate along the diagonals, so they don't split into the bands
+    if( tilted.empty() && integralBands(src, sum, sqsum, depth, sdepth, sqdepth) )
+        return;
+
     hal::integral(depth, sdepth, sqdepth,
                   src.ptr(), src.step,
                   sum.ptr(), sum.step,
@@ -41,6 +41,7 @@
 
 #include "precomp.hpp"
 #include "opencl_kernels_imgproc.hpp"
+#include "opencv2/imgproc/template_matcher.hpp"
 
 ////////////////////////////////////////////////// matchTemplate //////////////////////////////////////////////////////////
 
@@ -903,39 +904,42 @@ static void matchTemplateMask( InputArray _img, InputArray _templ, OutputArray _
     }
 }
 
-static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+// Turns the cross-correlation of the template with the image window into the score of the method
+// using the sums of the window pixels and of their squares taken from the integral images
+struct MatchTemplateNormalizer
 {
-    if( method == CV_TM_CCORR )
-        return;
-
-    int numType = method == CV_TM_CCORR || method == CV_TM_CCORR_NORMED ? 0 :
+    MatchTemplateNormalizer( const Mat& templ, int _method )
+    {
+        method = _method;
+        cn = templ.channels();
+        numType = method == CV_TM_CCORR || method == CV_TM_CCORR_NORMED ? 0 :
                   method == CV_TM_CCOEFF || method == CV_TM_CCOEFF_NORMED ? 1 : 2;
-    bool isNormed = method == CV_TM_CCORR_NORMED ||
-                    method == CV_TM_SQDIFF_NORMED ||
-                    method == CV_TM_CCOEFF_NORMED;
-
-    double invArea = 1./((double)templ.rows * templ.cols);
+        isNormed = method == CV_TM_CCORR_NORMED ||
+                   method == CV_TM_SQDIFF_NORMED ||
+                   method == CV_TM_CCOEFF_NORMED;
+        isConstant = false;
+        wndWidth = templ.cols*cn;
+        wndHeight = templ.rows;
+        invArea = 1./((double)templ.rows * templ.cols);
+        templNorm = templSum2 = 0;
+
+        if( method == CV_TM_CCORR )
+            return;
 
-    Mat sum, sqsum;
-    Scalar templMean, templSdv;
-    double *q0 = 0, *q1 = 0, *q2 = 0, *q3 = 0;
-    double templNorm = 0, templSum2 = 0;
+        if( method == CV_TM_CCOEFF )
+        {
+            templMean = mean(templ);
+            return;
+        }
 
-    if( method == CV_TM_CCOEFF )
-    {
-        integral(img, sum, CV_64F);
-        templMean = mean(templ);
-    }
-    else
-    {
-        integral(img, sum, sqsum, CV_64F);
+        Scalar templSdv;
         meanStdDev( templ, templMean, templSdv );
 
         templNorm = templSdv[0]*templSdv[0] + templSdv[1]*templSdv[1] + templSdv[2]*templSdv[2] + templSdv[3]*templSdv[3];
 
         if( templNorm < DBL_EPSILON && method == CV_TM_CCOEFF_NORMED )
         {
-            result = Scalar::all(1);
+            isConstant = true;
             return;
         }
 
@@ -950,83 +954,120 @@ static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method,
         templSum2 /= invArea;
         templNorm = std::sqrt(templNorm);
         templNorm /= std::sqrt(invArea); // care of accuracy here
-
-        CV_Assert(sqsum.data != NULL);
-        q0 = (double*)sqsum.data;
-        q1 = q0 + templ.cols*cn;
-        q2 = (double*)(sqsum.data + templ.rows*sqsum.step);
-        q3 = q2 + templ.cols*cn;
     }
 
-    CV_Assert(sum.data != NULL);
-    double* p0 = (double*)sum.data;
-    double* p1 = p0 + templ.cols*cn;
-    double* p2 = (double*)(sum.data + templ.rows*sum.step);
-    double* p3 = p2 + templ.cols*cn;
-
-    int sumstep = sum.data ? (int)(sum.step / sizeof(double)) : 0;
-    int sqstep = sqsum.data ? (int)(sqsum.step / sizeof(double)) : 0;
+    //! the integral image of squares is needed
+    bool needSqSum() const { return method != CV_TM_CCORR && method != CV_TM_CCOEFF; }
 
-    int i, j, k;
-
-    for( i = 0; i < result.rows; i++ )
+    // p and q point to the top-left corner of the window in the integral images,
+    // the steps are in elements
+    double operator()( double num, const double* p, size_t sumstep,
+                       const double* q, size_t sqstep ) const
     {
-        float* rrow = result.ptr<float>(i);
-        int idx = i * sumstep;
-        int idx2 = i * sqstep;
+        double wndMean2 = 0, wndSum2 = 0, t;
+        int k;
 
-        for( j = 0; j < result.cols; j++, idx += cn, idx2 += cn )
+        if( numType == 1 )
         {
-            double num = rrow[j], t;
-            double wndMean2 = 0, wndSum2 = 0;
-
-            if( numType == 1 )
+            const double* p2 = p + wndHeight*sumstep;
+            for( k = 0; k < cn; k++ )
             {
-                for( k = 0; k < cn; k++ )
-                {
-                    t = p0[idx+k] - p1[idx+k] - p2[idx+k] + p3[idx+k];
-                    wndMean2 += t*t;
-                    num -= t*templMean[k];
-                }
-
-                wndMean2 *= invArea;
+                t = p[k] - p[k+wndWidth] - p2[k] + p2[k+wndWidth];
+                wndMean2 += t*t;
+                num -= t*templMean[k];
             }
 
-            if( isNormed || numType == 2 )
-            {
-                for( k = 0; k < cn; k++ )
-                {
-                    t = q0[idx2+k] - q1[idx2+k] - q2[idx2+k] + q3[idx2+k];
-                    wndSum2 += t;
-                }
+            wndMean2 *= invArea;
+        }
 
-                if( numType == 2 )
-                {
-                    num = wndSum2 - 2*num + templSum2;
-                    num = MAX(num, 0.);
-                }
+        if( isNormed || numType == 2 )
+        {
+            const double* q2 = q + wndHeight*sqstep;
+            for( k = 0; k < cn; k++ )
+            {
+                t = q[k] - q[k+wndWidth] - q2[k] + q2[k+wndWidth];
+                wndSum2 += t;
             }
 
-            if( isNormed )
+            if( numType == 2 )
             {
-                double diff2 = MAX(wndSum2 - wndMean2, 0);
-                if (diff2 <= std::min(0.5, 10 * FLT_EPSILON * wndSum2))
-                    t = 0; // avoid rounding errors
-                else
-                    t = std::sqrt(diff2)*templNorm;
-
-                if( fabs(num) < t )
-                    num /= t;
-                else if( fabs(num) < t*1.125 )
-                    num = num > 0 ? 1 : -1;
-                else
-                    num = method != CV_TM_SQDIFF_NORMED ? 0 : 1;
+                num = wndSum2 - 2*num + templSum2;
+                num = MAX(num, 0.);
             }
+        }
+
+        if( isNormed )
+        {
+            double diff2 = MAX(wndSum2 - wndMean2, 0);
+            if (diff2 <= std::min(0.5, 10 * FLT_EPSILON * wndSum2))
+                t = 0; // avoid rounding errors
+            else
+                t = std::sqrt(diff2)*templNorm;
 
-            rrow[j] = (float)num;
+            if( fabs(num) < t )
+                num /= t;
+            else if( fabs(num) < t*1.125 )
+                num = num > 0 ? 1 : -1;
+            else
+                num = method != CV_TM_SQDIFF_NORMED ? 0 : 1;
         }
+
+        return num;
+    }
+
+    int method, cn, numType;
+    bool isNormed, isConstant;
+    int wndWidth, wndHeight;
+    double invArea, templNorm, templSum2;
+    Scalar templMean;
+};
+
+static void normalizeMatchTemplate( const MatchTemplateNormalizer& norm, const Mat& sum,
+                                    const Mat& sqsum, Mat& result )
+{
+    if( norm.method == CV_TM_CCORR )
+        return;
+
+    if( norm.isConstant )
+    {
+        result = Scalar::all(1);
+        return;
+    }
+
+    CV_Assert(sum.data != NULL && (sqsum.data != NULL || !norm.needSqSum()));
+    int cn = norm.cn;
+    size_t sumstep = sum.step / sizeof(double);
+    size_t sqstep = sqsum.data ? sqsum.step / sizeof(double) : 0;
+
+    for( int i = 0; i < result.rows; i++ )
+    {
+        float* rrow = result.ptr<float>(i);
+        const double* p = sum.ptr<double>(i);
+        const double* q = sqsum.data ? sqsum.ptr<double>(i) : 0;
+
+        for( int j = 0; j < result.cols; j++ )
+            rrow[j] = (float)norm(rrow[j], p + j*cn, sumstep, q ? q + j*cn : 0, sqstep);
     }
 }
+
+static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method )
+{
+    if( method == CV_TM_CCORR )
+        return;
+
+    MatchTemplateNormalizer norm(templ, method);
+    Mat sum, sqsum;
+
+    if( !norm.isConstant )
+    {
+        if( norm.needSqSum() )
+            integral(img, sum, sqsum, CV_64F);
+        else
+            integral(img, sum, CV_64F);
+    }
+
+    normalizeMatchTemplate(norm, sum, sqsum, result);
+}
 }
 
 
@@ -1124,7 +1165,7 @@ static bool ipp_matchTemplate( Mat& img, Mat& templ, Mat& result, int method)
     {
         if(ipp_crossCorr(img, templ, result, false))
         {
-            common_matchTemplate(img, templ, result, CV_TM_SQDIFF_NORMED, 1);
+            common_matchTemplate(img, templ, result, CV_TM_SQDIFF_NORMED);
             return true;
         }
     }
@@ -1142,7 +1183,7 @@ static bool ipp_matchTemplate( Mat& img, Mat& templ, Mat& result, int method)
     {
         if(ipp_crossCorr(img, templ, result, false))
         {
-            common_matchTemplate(img, templ, result, method, 1);
+            common_matchTemplate(img, templ, result, method);
             return true;
         }
     }
@@ -1158,7 +1199,7 @@ void cv::matchTemplate( InputArray _img, InputArray _templ, OutputArray _result,
 {
     CV_INSTRUMENT_REGION();
 
-    int type = _img.type(), depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
+    int type = _img.type(), depth = CV_MAT_DEPTH(type);
     CV_Assert( CV_TM_SQDIFF <= method && method <= CV_TM_CCOEFF_NORMED );
     CV_Assert( (depth == CV_8U || depth == CV_32F) && type == _templ.type() && _img.dims() <= 2 );
 
@@ -1189,7 +1230,665 @@ void cv::matchTemplate( InputArray _img, InputArray _templ, OutputArray _result,
 
     crossCorr( img, templ, result, Point(0,0), 0, 0);
 
-    common_matchTemplate(img, templ, result, method, cn);
+    common_matchTemplate(img, templ, result, method);
+}
+
+/****************************************************************************************\
+*                       Matching many templates against the same image                   *
+\****************************************************************************************/
+
+namespace cv
+{
+
+// the spectra of the image blocks for one DFT size. The block (tx, ty) starts at
+// (tx*blocksize.width, ty*blocksize.height) and is put to the top-left corner of the zero-padded plane,
+// so the templates with the sides up to dftsize - blocksize + 1 may be correlated with it without aliasing
+struct TemplMatchSpectrum
+{
+    Size dftsize, blocksize;
+    int tilesX, tilesY;
+    std::vector<Mat> planes; // (ty*tilesX + tx)*cn + k
+};
+
+struct TemplMatchLevel
+{
+    Mat img, fimg, sum, sqsum;
+    std::vector<TemplMatchSpectrum> spectra;
+};
+
+// the depth of the spectra, the same as crossCorr uses
+static inline int templMatchDepth( int depth )
+{
+    return depth == CV_8U ? CV_32F : CV_64F;
+}
+
+// puts the plane k of the image to the top-left corner of the zero-padded plane and transforms it
+static void templMatchPlaneDFT( const Mat& src, int k, Size dftsize, int ddepth, Mat& dst, Mat& buf )
+{
+    dst.create(dftsize, ddepth);
+    dst = Scalar::all(0);
+    Mat roi(dst, Rect(0, 0, src.cols, src.rows));
+    if( src.channels() == 1 )
+        src.convertTo(roi, ddepth);
+    else
+    {
+        extractChannel(src, buf, k);
+        buf.convertTo(roi, ddepth);
+    }
+    dft(dst, dst, 0, src.rows);
+}
+
+class TemplMatchSpectrumInvoker : public ParallelLoopBody
+{
+public:
+    TemplMatchSpectrumInvoker( const Mat& _img, TemplMatchSpectrum& _spec ) : img(_img), spec(_spec) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        int cn = img.channels(), ddepth = templMatchDepth(img.depth());
+        Mat buf;
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int tile = i / cn;
+            int x = (tile % spec.tilesX)*spec.blocksize.width;
+            int y = (tile / spec.tilesX)*spec.blocksize.height;
+            Rect r(x, y, std::min(spec.blocksize.width, img.cols - x), std::min(spec.blocksize.height, img.rows - y));
+            templMatchPlaneDFT(img(r), i % cn, spec.dftsize, ddepth, spec.planes[i], buf);
+        }
+    }
+
+private:
+    const Mat& img;
+    TemplMatchSpectrum& spec;
+
+    TemplMatchSpectrumInvoker& operator=(const TemplMatchSpectrumInvoker&); // = delete
+};
+
+// the correlation is computed as the convolution with the flipped template. The element (r, c) of
+// the inverse transform of the block product is then the score at (x + c - w + 1, y + r - h + 1),
+// where (x, y) is the block origin, and the results of the neighbor blocks are summed up
+class TemplMatchTemplateInvoker : public ParallelLoopBody
+{
+public:
+    TemplMatchTemplateInvoker( const std::vector<Mat>& _templs, Size _dftsize, int _ddepth,
+                               std::vector<std::vector<Mat> >& _spectra )
+        : templs(_templs), dftsize(_dftsize), ddepth(_ddepth), spectra(_spectra) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        Mat flipped, buf;
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int cn = templs[i].channels();
+            flip(templs[i], flipped, -1);
+            spectra[i].resize(cn);
+            for( int k = 0; k < cn; k++ )
+                templMatchPlaneDFT(flipped, k, dftsize, ddepth, spectra[i][k], buf);
+        }
+    }
+
+private:
+    const std::vector<Mat>& templs;
+    Size dftsize;
+    int ddepth;
+    std::vector<std::vector<Mat> >& spectra;
+
+    TemplMatchTemplateInvoker& operator=(const TemplMatchTemplateInvoker&); // = delete
+};
+
+// processes the block rows phase, phase + nphases, ... of all the templates; the rows of one phase
+// write to the disjoint parts of the score maps
+class TemplMatchCorrInvoker : public ParallelLoopBody
+{
+public:
+    TemplMatchCorrInvoker( const TemplMatchSpectrum& _spec, const std::vector<Mat>& _templs,
+                           const std::vector<std::vector<Mat> >& _tspectra, std::vector<Mat>& _corr,
+                           int _phase, int _nphases )
+        : spec(_spec), templs(_templs), tspectra(_tspectra), corr(_corr), phase(_phase), nphases(_nphases)
+    {
+        nrows = (spec.tilesY - phase + nphases - 1)/nphases;
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        Mat acc, prod;
+        for( int idx = range.start; idx < range.end; idx++ )
+        {
+            int i = idx / nrows, ty = phase + (idx % nrows)*nphases;
+            int cn = templs[i].channels();
+            Size tsz = templs[i].size();
+            Mat& dst = corr[i];
+            int y = ty*spec.blocksize.height, y0 = y - tsz.height + 1;
+            int y1 = std::max(y0, 0), y2 = std::min(y + spec.blocksize.height, dst.rows);
+            if( y1 >= y2 )
+                continue;
+
+            for( int tx = 0; tx < spec.tilesX; tx++ )
+            {
+                int x = tx*spec.blocksize.width, x0 = x - tsz.width + 1;
+                int x1 = std::max(x0, 0), x2 = std::min(x + spec.blocksize.width, dst.cols);
+                if( x1 >= x2 )
+                    continue;
+
+                const Mat* planes = &spec.planes[(ty*spec.tilesX + tx)*cn];
+                for( int k = 0; k < cn; k++ )
+                {
+                    mulSpectrums(planes[k], tspectra[i][k], k == 0 ? acc : prod, 0);
+                    if( k > 0 )
+                        acc += prod;
+                }
+                dft(acc, acc, DFT_INVERSE + DFT_SCALE + DFT_REAL_OUTPUT, y2 - y0);
+
+                Mat part(dst, Rect(x1, y1, x2 - x1, y2 - y1));
+                part += acc(Rect(x1 - x0, y1 - y0, x2 - x1, y2 - y1));
+            }
+        }
+    }
+
+    int count() const { return nrows > 0 ? nrows*(int)templs.size() : 0; }
+
+private:
+    const TemplMatchSpectrum& spec;
+    const std::vector<Mat>& templs;
+    const std::vector<std::vector<Mat> >& tspectra;
+    std::vector<Mat>& corr;
+    int phase, nphases, nrows;
+
+    TemplMatchCorrInvoker& operator=(const TemplMatchCorrInvoker&); // = delete
+};
+
+class TemplMatchNormalizeInvoker : public ParallelLoopBody
+{
+public:
+    TemplMatchNormalizeInvoker( const TemplMatchLevel& _level, const std::vector<Mat>& _templs,
+                                const std::vector<Mat>& _corr, std::vector<Mat>& _results, int _method )
+        : level(_level), templs(_templs), corr(_corr), results(_results), method(_method) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            if( corr[i].data != results[i].data )
+                corr[i].convertTo(results[i], CV_32F);
+            normalizeMatchTemplate(MatchTemplateNormalizer(templs[i], method), level.sum, level.sqsum, results[i]);
+        }
+    }
+
+private:
+    const TemplMatchLevel& level;
+    const std::vector<Mat>& templs;
+    const std::vector<Mat>& corr;
+    std::vector<Mat>& results;
+    int method;
+
+    TemplMatchNormalizeInvoker& operator=(const TemplMatchNormalizeInvoker&); // = delete
+};
+
+struct TemplateMatcher::Impl
+{
+    // builds the pyramid up to the level l
+    TemplMatchLevel& getLevel( int l )
+    {
+        CV_Assert( !levels.empty() );
+        while( (int)levels.size() <= l )
+        {
+            TemplMatchLevel next;
+            pyrDown(levels.back().img, next.img);
+            levels.push_back(next);
+        }
+        return levels[l];
+    }
+
+    void prepareIntegrals( TemplMatchLevel& level, bool sqsum )
+    {
+        if( level.sum.empty() || (sqsum && level.sqsum.empty()) )
+        {
+            if( sqsum )
+                integral(level.img, level.sum, level.sqsum, CV_64F);
+            else
+                integral(level.img, level.sum, CV_64F);
+        }
+    }
+
+    // returns the cached spectra that fit the templates of the given size or computes the new ones
+    const TemplMatchSpectrum& getSpectrum( TemplMatchLevel& level, Size tsz )
+    {
+        const Mat& img = level.img;
+        const double blockScale = 4.5;
+        const int minBlockSize = 256;
+        Size blocksize, dftsize;
+
+        blocksize.width = std::max( cvRound(tsz.width*blockScale), minBlockSize - tsz.width + 1 );
+        blocksize.width = std::min( blocksize.width, img.cols );
+        blocksize.height = std::max( cvRound(tsz.height*blockScale), minBlockSize - tsz.height + 1 );
+        blocksize.height = std::min( blocksize.height, img.rows );
+        dftsize.width = std::max(getOptimalDFTSize(blocksize.width + tsz.width - 1), 2);
+        dftsize.height = getOptimalDFTSize(blocksize.height + tsz.height - 1);
+        if( dftsize.width <= 0 || dftsize.height <= 0 )
+            CV_Error( CV_StsOutOfRange, "the input arrays are too big" );
+
+        for( size_t i = 0; i < level.spectra.size(); i++ )
+        {
+            const TemplMatchSpectrum& s = level.spectra[i];
+            if( s.dftsize.width - s.blocksize.width + 1 >= tsz.width &&
+                s.dftsize.height - s.blocksize.height + 1 >= tsz.height &&
+                s.dftsize.width <= dftsize.width*2 && s.dftsize.height <= dftsize.height*2 )
+                return s;
+        }
+
+        level.spectra.push_back(TemplMatchSpectrum());
+        TemplMatchSpectrum& s = level.spectra.back();
+        s.dftsize = dftsize;
+        s.blocksize = Size(dftsize.width - tsz.width + 1, dftsize.height - tsz.height + 1);
+        s.tilesX = (img.cols + s.blocksize.width - 1)/s.blocksize.width;
+        s.tilesY = (img.rows + s.blocksize.height - 1)/s.blocksize.height;
+        s.planes.resize((size_t)s.tilesX*s.tilesY*img.channels());
+        parallel_for_(Range(0, (int)s.planes.size()), TemplMatchSpectrumInvoker(img, s));
+        return s;
+    }
+
+    // computes the full score maps of the templates at the pyramid level l;
+    // results must be allocated by the caller
+    void match( int l, const std::vector<Mat>& templs, int method, std::vector<Mat>& results )
+    {
+        size_t n = templs.size();
+        if( n == 0 )
+            return;
+
+        TemplMatchLevel& level = getLevel(l);
+        int ddepth = templMatchDepth(level.img.depth());
+        Size maxsz;
+        for( size_t i = 0; i < n; i++ )
+        {
+            maxsz.width = std::max(maxsz.width, templs[i].cols);
+            maxsz.height = std::max(maxsz.height, templs[i].rows);
+        }
+        const TemplMatchSpectrum& spec = getSpectrum(level, maxsz);
+        if( method != CV_TM_CCORR )
+            prepareIntegrals(level, method != CV_TM_CCOEFF);
+
+        std::vector<std::vector<Mat> > tspectra(n);
+        parallel_for_(Range(0, (int)n), TemplMatchTemplateInvoker(templs, spec.dftsize, ddepth, tspectra));
+
+        std::vector<Mat> corr(n);
+        for( size_t i = 0; i < n; i++ )
+        {
+            if( ddepth == CV_32F )
+                corr[i] = results[i];
+            else
+                corr[i].create(results[i].size(), ddepth);
+            corr[i] = Scalar::all(0);
+        }
+
+        // the neighbor block rows overlap in the score maps only if the template is taller than the block
+        int nphases = spec.blocksize.height + 2 > maxsz.height ? 2 : spec.tilesY;
+        for( int phase = 0; phase < nphases; phase++ )
+        {
+            TemplMatchCorrInvoker invoker(spec, templs, tspectra, corr, phase, nphases);
+            if( invoker.count() > 0 )
+                parallel_for_(Range(0, invoker.count()), invoker);
+        }
+
+        parallel_for_(Range(0, (int)n), TemplMatchNormalizeInvoker(level, templs, corr, results, method));
+    }
+
+    std::vector<TemplMatchLevel> levels;
+};
+
+static void checkMatcherTemplate( const TemplMatchLevel& level, const Mat& templ )
+{
+    CV_Assert( !templ.empty() && templ.dims <= 2 );
+    CV_Assert( templ.type() == level.img.type() );
+    CV_Assert( templ.cols <= level.img.cols && templ.rows <= level.img.rows );
+}
+
+// refines the candidates found at the coarse level of the search down to the original image
+class TemplMatchRefineInvoker : public ParallelLoopBody
+{
+public:
+    struct Candidate
+    {
+        Point pt;
+        float score;
+    };
+
+    TemplMatchRefineInvoker( const std::vector<TemplMatchLevel>& _levels,
+                             const std::vector<std::vector<Mat> >& _tpyr, const std::vector<int>& _top,
+                             const std::vector<Mat>& _coarse, std::vector<std::vector<TemplateMatcher::Match> >& _matches,
+                             int _method, double _threshold, double _coarseMargin )
+        : levels(_levels), tpyr(_tpyr), top(_top), coarse(_coarse), matches(_matches),
+          method(_method), threshold(_threshold), coarseMargin(_coarseMargin) {}
+
+    static bool less( const Candidate& a, const Candidate& b )
+    {
+        return a.pt.y < b.pt.y || (a.pt.y == b.pt.y && a.pt.x < b.pt.x);
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        std::vector<Candidate> cand, evaluated, extra;
+        Mat ftempl;
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const Mat& score = coarse[i];
+            int l = top[i];
+
+            cand.clear();
+            for( int y = 0; y < score.rows; y++ )
+            {
+                const float* srow = score.ptr<float>(y);
+                for( int x = 0; x < score.cols; x++ )
+                    if( passes(srow[x], l) )
+                    {
+                        Candidate c = { Point(x, y), srow[x] };
+                        cand.push_back(c);
+                    }
+            }
+
+            if( l == 0 )
+            {
+                evaluated.clear();
+                suppress(i, cand, score, evaluated);
+                continue;
+            }
+
+            while( --l >= 0 )
+            {
+                const TemplMatchLevel& level = levels[l];
+                const Mat& templ = tpyr[i][l];
+                Size rsize(level.img.cols - templ.cols + 1, level.img.rows - templ.rows + 1);
+                MatchTemplateNormalizer norm(templ, method);
+                templ.convertTo(ftempl, CV_32F);
+
+                // the position (x, y) at the coarse level corresponds to (2x, 2y) at the finer one
+                evaluated.clear();
+                for( size_t j = 0; j < cand.size(); j++ )
+                {
+                    Point pt = cand[j].pt;
+                    for( int y = std::max(pt.y*2 - 1, 0); y <= std::min(pt.y*2 + 2, rsize.height - 1); y++ )
+                        for( int x = std::max(pt.x*2 - 1, 0); x <= std::min(pt.x*2 + 2, rsize.width - 1); x++ )
+                        {
+                            Candidate c = { Point(x, y), 0.f };
+                            evaluated.push_back(c);
+                        }
+                }
+                std::sort(evaluated.begin(), evaluated.end(), less);
+                evaluated.erase(std::unique(evaluated.begin(), evaluated.end(), same), evaluated.end());
+
+                cand.clear();
+                for( size_t j = 0; j < evaluated.size(); j++ )
+                {
+                    Candidate& c = evaluated[j];
+                    c.score = evaluate(level, norm, ftempl, c.pt);
+                    if( passes(c.score, l) )
+                        cand.push_back(c);
+                }
+            }
+
+            // extend the found regions at the original image until all the neighbors of the passed
+            // positions are evaluated, so the suppression gives the same peaks as with the full map
+            const TemplMatchLevel& level = levels[0];
+            const Mat& templ = tpyr[i][0];
+            Size rsize(level.img.cols - templ.cols + 1, level.img.rows - templ.rows + 1);
+            MatchTemplateNormalizer norm(templ, method); // ftempl is already converted at the last level
+            size_t start = 0;
+            while( start < cand.size() )
+            {
+                extra.clear();
+                for( size_t j = start; j < cand.size(); j++ )
+                {
+                    Point pt = cand[j].pt;
+                    for( int y = std::max(pt.y - 1, 0); y <= std::min(pt.y + 1, rsize.height - 1); y++ )
+                        for( int x = std::max(pt.x - 1, 0); x <= std::min(pt.x + 1, rsize.width - 1); x++ )
+                        {
+                            Candidate c = { Point(x, y), 0.f };
+                            if( !std::binary_search(evaluated.begin(), evaluated.end(), c, less) )
+                                extra.push_back(c);
+                        }
+                }
+                std::sort(extra.begin(), extra.end(), less);
+                extra.erase(std::unique(extra.begin(), extra.end(), same), extra.end());
+
+                start = cand.size();
+                for( size_t j = 0; j < extra.size(); j++ )
+                {
+                    Candidate& c = extra[j];
+                    c.score = evaluate(level, norm, ftempl, c.pt);
+                    if( passes(c.score, 0) )
+                        cand.push_back(c);
+                }
+                size_t nevaluated = evaluated.size();
+                evaluated.insert(evaluated.end(), extra.begin(), extra.end());
+                std::inplace_merge(evaluated.begin(), evaluated.begin() + nevaluated, evaluated.end(), less);
+            }
+            std::sort(cand.begin(), cand.end(), less);
+
+            suppress(i, cand, Mat(), evaluated);
+        }
+    }
+
+private:
+    static bool same( const Candidate& a, const Candidate& b ) { return a.pt == b.pt; }
+
+    static float evaluate( const TemplMatchLevel& level, const MatchTemplateNormalizer& norm,
+                           const Mat& ftempl, Point pt )
+    {
+        if( norm.isConstant )
+            return 1.f;
+        int cn = level.img.channels();
+        double num = level.fimg(Rect(pt, ftempl.size())).dot(ftempl);
+        return (float)norm(num, level.sum.ptr<double>(pt.y) + pt.x*cn, level.sum.step/sizeof(double),
+                           level.sqsum.ptr<double>(pt.y) + pt.x*cn, level.sqsum.step/sizeof(double));
+    }
+
+    bool passes( float score, int l ) const
+    {
+        double margin = l > 0 ? coarseMargin : 0.;
+        return method == CV_TM_SQDIFF_NORMED ? score <= threshold + margin : score >= threshold - margin;
+    }
+
+    // true if the score a is better than b
+    bool better( float a, float b ) const
+    {
+        return method == CV_TM_SQDIFF_NORMED ? a < b : a > b;
+    }
+
+    // keeps the candidates that are the best among the evaluated neighbors; the full score map
+    // is used instead of the evaluated positions, if it's given. On ties the first candidate wins
+    void suppress( int i, const std::vector<Candidate>& cand, const Mat& score,
+                   const std::vector<Candidate>& evaluated ) const
+    {
+        std::vector<TemplateMatcher::Match>& dst = matches[i];
+        for( size_t j = 0; j < cand.size(); j++ )
+        {
+            const Candidate& c = cand[j];
+            bool best = true;
+            for( int dy = -1; dy <= 1 && best; dy++ )
+                for( int dx = -1; dx <= 1 && best; dx++ )
+                {
+                    if( dx == 0 && dy == 0 )
+                        continue;
+                    Candidate q = { Point(c.pt.x + dx, c.pt.y + dy), 0.f };
+                    if( !score.empty() )
+                    {
+                        if( (unsigned)q.pt.x >= (unsigned)score.cols || (unsigned)q.pt.y >= (unsigned)score.rows )
+                            continue;
+                        q.score = score.at<float>(q.pt);
+                    }
+                    else
+                    {
+                        std::vector<Candidate>::const_iterator it =
+                            std::lower_bound(evaluated.begin(), evaluated.end(), q, less);
+                        if( it == evaluated.end() || it->pt != q.pt )
+                            continue;
+                        q.score = it->score;
+                    }
+                    bool earlier = dy < 0 || (dy == 0 && dx < 0);
+                    if( better(q.score, c.score) || (earlier && q.score == c.score) )
+                        best = false;
+                }
+            if( best )
+                dst.push_back(TemplateMatcher::Match(i, c.pt, c.score));
+        }
+    }
+
+    const std::vector<TemplMatchLevel>& levels;
+    const std::vector<std::vector<Mat> >& tpyr;
+    const std::vector<int>& top;
+    const std::vector<Mat>& coarse;
+    std::vector<std::vector<TemplateMatcher::Match> >& matches;
+    int method;
+    double threshold, coarseMargin;
+
+    TemplMatchRefineInvoker& operator=(const TemplMatchRefineInvoker&); // = delete
+};
+
+TemplateMatcher::TemplateMatcher() : p(makePtr<Impl>())
+{
+}
+
+TemplateMatcher::TemplateMatcher( InputArray image ) : p(makePtr<Impl>())
+{
+    setImage(image);
+}
+
+void TemplateMatcher::setImage( InputArray _image )
+{
+    CV_INSTRUMENT_REGION();
+
+    int type = _image.type(), depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
+    CV_Assert( !_image.empty() && _image.dims() <= 2 );
+    CV_Assert( (depth == CV_8U || depth == CV_32F) && cn <= 4 );
+
+    p->levels.assign(1, TemplMatchLevel());
+    _image.copyTo(p->levels[0].img);
+}
+
+Size TemplateMatcher::getImageSize() const
+{
+    return p->levels.empty() ? Size() : p->levels[0].img.size();
+}
+
+bool TemplateMatcher::empty() const
+{
+    return p->levels.empty();
+}
+
+void TemplateMatcher::match( InputArray templ, OutputArray result, int method )
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !empty() );
+    CV_Assert( CV_TM_SQDIFF <= method && method <= CV_TM_CCOEFF_NORMED );
+    std::vector<Mat> templs(1, templ.getMat()), results(1);
+    const Mat& img = p->levels[0].img;
+    checkMatcherTemplate(p->levels[0], templs[0]);
+    result.create(img.rows - templs[0].rows + 1, img.cols - templs[0].cols + 1, CV_32F);
+    results[0] = result.getMat();
+    p->match(0, templs, method, results);
+}
+
+void TemplateMatcher::matchBatch( InputArrayOfArrays _templs, OutputArrayOfArrays _results, int method )
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !empty() );
+    CV_Assert( CV_TM_SQDIFF <= method && method <= CV_TM_CCOEFF_NORMED );
+    CV_Assert( _results.kind() == _InputArray::STD_VECTOR_MAT || _results.kind() == _InputArray::STD_ARRAY_MAT );
+
+    std::vector<Mat> templs;
+    _templs.getMatVector(templs);
+    int n = (int)templs.size();
+    const Mat& img = p->levels[0].img;
+    std::vector<Mat> results(n);
+
+    _results.create(n, 1, CV_32F);
+    for( int i = 0; i < n; i++ )
+    {
+        checkMatcherTemplate(p->levels[0], templs[i]);
+        _results.create(img.rows - templs[i].rows + 1, img.cols - templs[i].cols + 1, CV_32F, i);
+        results[i] = _results.getMat(i);
+    }
+    p->match(0, templs, method, results);
+}
+
+void TemplateMatcher::search( InputArrayOfArrays _templs, std::vector<Match>& matches, int method,
+                              double threshold, int maxLevel, double coarseMargin )
+{
+    CV_INSTRUMENT_REGION();
+
+    const int minTemplateSize = 16;
+
+    CV_Assert( !empty() );
+    CV_Assert( method == CV_TM_SQDIFF_NORMED || method == CV_TM_CCORR_NORMED || method == CV_TM_CCOEFF_NORMED );
+    CV_Assert( maxLevel >= 0 && coarseMargin >= 0 );
+
+    std::vector<Mat> templs;
+    _templs.getMatVector(templs);
+    size_t i, n = templs.size();
+    matches.clear();
+
+    // the search of each template starts at the coarsest level where it's not too small
+    std::vector<std::vector<Mat> > tpyr(n);
+    std::vector<int> top(n);
+    int maxTop = 0;
+    for( i = 0; i < n; i++ )
+    {
+        checkMatcherTemplate(p->levels[0], templs[i]);
+        tpyr[i].push_back(templs[i]);
+        Size isz = p->levels[0].img.size();
+        for( int l = 0; l < maxLevel; l++ )
+        {
+            Size tsz = tpyr[i].back().size(), next((tsz.width + 1)/2, (tsz.height + 1)/2);
+            isz = Size((isz.width + 1)/2, (isz.height + 1)/2);
+            if( std::min(next.width, next.height) < minTemplateSize ||
+                next.width > isz.width || next.height > isz.height )
+                break;
+            Mat t;
+            pyrDown(tpyr[i].back(), t);
+            tpyr[i].push_back(t);
+        }
+        top[i] = (int)tpyr[i].size() - 1;
+        maxTop = std::max(maxTop, top[i]);
+    }
+
+    p->getLevel(maxTop);
+    for( int l = 0; l <= maxTop; l++ )
+    {
+        TemplMatchLevel& level = p->levels[l];
+        p->prepareIntegrals(level, true);
+        if( level.fimg.empty() )
+            level.img.convertTo(level.fimg, CV_32F);
+    }
+
+    // the full score maps at the starting levels
+    std::vector<Mat> coarse(n);
+    for( int l = 0; l <= maxTop; l++ )
+    {
+        std::vector<Mat> group, results;
+        std::vector<size_t> idx;
+        for( i = 0; i < n; i++ )
+            if( top[i] == l )
+            {
+                const Mat& t = tpyr[i][l];
+                const Mat& img = p->levels[l].img;
+                idx.push_back(i);
+                group.push_back(t);
+                results.push_back(Mat(img.rows - t.rows + 1, img.cols - t.cols + 1, CV_32F));
+            }
+        p->match(l, group, method, results);
+        for( size_t j = 0; j < idx.size(); j++ )
+            coarse[idx[j]] = results[j];
+    }
+
+    std::vector<std::vector<Match> > found(n);
+    parallel_for_(Range(0, (int)n), TemplMatchRefineInvoker(p->levels, tpyr, top, coarse, found,
+                                                           method, threshold, coarseMargin));
+    for( i = 0; i < n; i++ )
+        matches.insert(matches.end(), found[i].begin(), found[i].end());
+}
+
 }
 
 CV_IMPL void
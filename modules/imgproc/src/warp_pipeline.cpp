@@ -0,0 +1,471 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "color.hpp"
+#include "opencv2/imgproc/warp_pipeline.hpp"
+
+#include <functional>
+
+/****************************************************************************************\
+*                 Single-pass execution of geometric transformation chains                *
+\****************************************************************************************/
+
+namespace cv
+{
+
+namespace
+{
+
+typedef std::function<int(int)> PointwiseTypeFunc;
+typedef std::function<void(const Mat&, Mat&)> PointwiseFunc;
+
+enum
+{
+    WARP_STAGE_HOMOGRAPHY = 0,
+    WARP_STAGE_MAP = 1,
+    WARP_STAGE_RESIZE = 2,
+    WARP_STAGE_POINTWISE = 3
+};
+
+struct WarpStage
+{
+    WarpStage() : kind(WARP_STAGE_POINTWISE), fx(0), fy(0) {}
+
+    int kind;
+    // the mapping of the stage output coordinates to the input ones
+    Matx33d M;
+    // the output size of the geometric stages
+    Size dsize;
+    double fx, fy;
+    // CV_32FC2 map of WARP_STAGE_MAP
+    Mat map;
+    PointwiseTypeFunc dstType;
+    PointwiseFunc op;
+};
+
+// the coordinate transformation from the output of the pipeline to the source image
+struct WarpCoordOp
+{
+    Matx33d M;
+    Mat map;
+};
+
+struct WarpPlan
+{
+    // the coordinate transformations in the order of their application,
+    // i.e. from the last geometric stage to the first one
+    std::vector<WarpCoordOp> coords;
+    std::vector<PointwiseFunc> ops;
+    Size dsize;
+    int dstType;
+    int interpolation, borderMode;
+    Scalar borderValue;
+};
+
+// the marker of the points, which are outside of the intermediate images; they get the border value
+static const float WARP_OUTSIDE = -1e5f;
+
+static void applyHomography(const Matx33d& M, float* xy, int n)
+{
+    for( int i = 0; i < n; i++ )
+    {
+        double x = xy[i*2], y = xy[i*2+1];
+        double w = M(2, 0)*x + M(2, 1)*y + M(2, 2);
+        w = w != 0 ? 1./w : std::numeric_limits<double>::quiet_NaN();
+        xy[i*2] = (float)((M(0, 0)*x + M(0, 1)*y + M(0, 2))*w);
+        xy[i*2+1] = (float)((M(1, 0)*x + M(1, 1)*y + M(1, 2))*w);
+    }
+}
+
+// bilinear interpolation of the map; the NaN coordinates are propagated
+static void applyMap(const Mat& map, float* xy, int n)
+{
+    int w = map.cols, h = map.rows;
+    for( int i = 0; i < n; i++ )
+    {
+        float x = xy[i*2], y = xy[i*2+1];
+        if( !(x >= 0 && y >= 0 && x <= w - 1 && y <= h - 1) )
+        {
+            xy[i*2] = xy[i*2+1] = std::numeric_limits<float>::quiet_NaN();
+            continue;
+        }
+        int x0 = std::min(cvFloor(x), w - 1), y0 = std::min(cvFloor(y), h - 1);
+        int x1 = std::min(x0 + 1, w - 1), y1 = std::min(y0 + 1, h - 1);
+        float ax = x - x0, ay = y - y0;
+        const float* m0 = map.ptr<float>(y0);
+        const float* m1 = map.ptr<float>(y1);
+        for( int k = 0; k < 2; k++ )
+        {
+            float v0 = m0[x0*2+k] + (m0[x1*2+k] - m0[x0*2+k])*ax;
+            float v1 = m1[x0*2+k] + (m1[x1*2+k] - m1[x0*2+k])*ax;
+            xy[i*2+k] = v0 + (v1 - v0)*ay;
+        }
+    }
+}
+
+static void computeWarpCoords(const WarpPlan& plan, int y0, Mat& xy)
+{
+    const std::vector<WarpCoordOp>& coords = plan.coords;
+    size_t i = 0;
+    for( int y = 0; y < xy.rows; y++ )
+    {
+        float* XY = xy.ptr<float>(y);
+        if( !coords.empty() && coords[0].map.empty() )
+        {
+            // the first homography is evaluated incrementally
+            const Matx33d& M = coords[0].M;
+            double X = M(0, 1)*(y + y0) + M(0, 2), Y = M(1, 1)*(y + y0) + M(1, 2);
+            double W = M(2, 1)*(y + y0) + M(2, 2);
+            for( int x = 0; x < xy.cols; x++, X += M(0, 0), Y += M(1, 0), W += M(2, 0) )
+            {
+                double w = W != 0 ? 1./W : std::numeric_limits<double>::quiet_NaN();
+                XY[x*2] = (float)(X*w);
+                XY[x*2+1] = (float)(Y*w);
+            }
+            i = 1;
+        }
+        else
+        {
+            for( int x = 0; x < xy.cols; x++ )
+            {
+                XY[x*2] = (float)x;
+                XY[x*2+1] = (float)(y + y0);
+            }
+            i = 0;
+        }
+
+        for( ; i < coords.size(); i++ )
+        {
+            if( coords[i].map.empty() )
+                applyHomography(coords[i].M, XY, xy.cols);
+            else
+                applyMap(coords[i].map, XY, xy.cols);
+        }
+
+        for( int x = 0; x < xy.cols*2; x++ )
+            if( cvIsNaN(XY[x]) || std::abs(XY[x]) > -WARP_OUTSIDE )
+                XY[x] = WARP_OUTSIDE;
+    }
+}
+
+// every task computes a block of rows of one of the destination images
+class WarpPipelineInvoker : public ParallelLoopBody
+{
+public:
+    WarpPipelineInvoker(const Mat& _src, const std::vector<WarpPlan>& _plans, std::vector<Mat>& _dst,
+                        const std::vector<Vec3i>& _tasks)
+        : src(_src), plans(_plans), dst(_dst), tasks(_tasks)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        Mat xy, buf[2];
+        for( int t = range.start; t < range.end; t++ )
+        {
+            const WarpPlan& plan = plans[tasks[t][0]];
+            int y0 = tasks[t][1], y1 = tasks[t][2];
+            Mat D = dst[tasks[t][0]].rowRange(y0, y1);
+
+            xy.create(y1 - y0, plan.dsize.width, CV_32FC2);
+            computeWarpCoords(plan, y0, xy);
+
+            if( plan.ops.empty() )
+            {
+                cv::remap(src, D, xy, noArray(), plan.interpolation, plan.borderMode, plan.borderValue);
+                continue;
+            }
+
+            cv::remap(src, buf[0], xy, noArray(), plan.interpolation, plan.borderMode, plan.borderValue);
+            for( size_t i = 0; i < plan.ops.size(); i++ )
+            {
+                Mat& out = i + 1 < plan.ops.size() ? buf[(i + 1) & 1] : D;
+                const uchar* data = out.data;
+                plan.ops[i](buf[i & 1], out);
+                CV_Assert( out.data == data || i + 1 < plan.ops.size() );
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    const std::vector<WarpPlan>& plans;
+    std::vector<Mat>& dst;
+    const std::vector<Vec3i>& tasks;
+
+    WarpPipelineInvoker& operator=(const WarpPipelineInvoker&); // = delete
+};
+
+static void runWarpPipelines(const Mat& src, const std::vector<WarpPlan>& plans, std::vector<Mat>& dst)
+{
+    // about 16K destination pixels per task
+    std::vector<Vec3i> tasks;
+    for( size_t i = 0; i < plans.size(); i++ )
+    {
+        Size dsize = plans[i].dsize;
+        int blockRows = std::max(std::min((1 << 14)/std::max(dsize.width, 1), dsize.height), 1);
+        for( int y = 0; y < dsize.height; y += blockRows )
+            tasks.push_back(Vec3i((int)i, y, std::min(y + blockRows, dsize.height)));
+    }
+    if( !tasks.empty() )
+        parallel_for_(Range(0, (int)tasks.size()), WarpPipelineInvoker(src, plans, dst, tasks));
+}
+
+} // namespace anon
+
+struct WarpPipeline::Impl
+{
+    Impl() : interpolation(INTER_LINEAR), borderMode(BORDER_CONSTANT) {}
+
+    // resolves the stage sizes for the given source, and composes the neighbor homographies;
+    // the output type is not resolved if srcType is negative
+    void compile(Size ssize, int srcType, WarpPlan& plan) const
+    {
+        plan.coords.clear();
+        plan.ops.clear();
+        plan.interpolation = interpolation;
+        plan.borderMode = borderMode;
+        plan.borderValue = borderValue;
+
+        Size size = ssize;
+        int type = srcType;
+        std::vector<WarpCoordOp> coords;
+        for( size_t i = 0; i < stages.size(); i++ )
+        {
+            const WarpStage& stage = stages[i];
+            if( stage.kind == WARP_STAGE_POINTWISE )
+            {
+                if( type >= 0 )
+                    type = stage.dstType(type);
+                plan.ops.push_back(stage.op);
+                continue;
+            }
+
+            WarpCoordOp c;
+            Size dsize = stage.dsize;
+            if( stage.kind == WARP_STAGE_RESIZE )
+            {
+                double inv_scale_x = stage.fx, inv_scale_y = stage.fy;
+                if( dsize.empty() )
+                    dsize = Size(saturate_cast<int>(size.width*inv_scale_x), saturate_cast<int>(size.height*inv_scale_y));
+                else
+                {
+                    inv_scale_x = (double)dsize.width/size.width;
+                    inv_scale_y = (double)dsize.height/size.height;
+                }
+                CV_Assert( !dsize.empty() );
+                // the pixel centers are aligned as in resize
+                double sx = 1./inv_scale_x, sy = 1./inv_scale_y;
+                c.M = Matx33d(sx, 0, (sx - 1)*0.5, 0, sy, (sy - 1)*0.5, 0, 0, 1);
+            }
+            else if( stage.kind == WARP_STAGE_MAP )
+                c.map = stage.map;
+            else
+                c.M = stage.M;
+            size = dsize;
+
+            if( !coords.empty() && c.map.empty() && coords.back().map.empty() )
+                coords.back().M = coords.back().M*c.M;
+            else
+                coords.push_back(c);
+        }
+
+        plan.coords.assign(coords.rbegin(), coords.rend());
+        plan.dsize = size;
+        plan.dstType = type;
+    }
+
+    std::vector<WarpStage> stages;
+    int interpolation, borderMode;
+    Scalar borderValue;
+};
+
+WarpPipeline::WarpPipeline() : p(makePtr<Impl>()) {}
+
+WarpPipeline& WarpPipeline::warpAffine(InputArray _M, Size dsize, int flags)
+{
+    Mat M = _M.getMat();
+    CV_Assert( M.rows == 2 && M.cols == 3 && M.channels() == 1 && !dsize.empty() );
+    CV_Assert( (flags & ~WARP_INVERSE_MAP) == 0 );
+
+    Matx23d A;
+    M.convertTo(A, CV_64F);
+    if( !(flags & WARP_INVERSE_MAP) )
+        invertAffineTransform(A, A);
+
+    WarpStage stage;
+    stage.kind = WARP_STAGE_HOMOGRAPHY;
+    stage.M = Matx33d(A(0, 0), A(0, 1), A(0, 2), A(1, 0), A(1, 1), A(1, 2), 0, 0, 1);
+    stage.dsize = dsize;
+    p->stages.push_back(stage);
+    return *this;
+}
+
+WarpPipeline& WarpPipeline::warpPerspective(InputArray _M, Size dsize, int flags)
+{
+    Mat M = _M.getMat();
+    CV_Assert( M.rows == 3 && M.cols == 3 && M.channels() == 1 && !dsize.empty() );
+    CV_Assert( (flags & ~WARP_INVERSE_MAP) == 0 );
+
+    WarpStage stage;
+    stage.kind = WARP_STAGE_HOMOGRAPHY;
+    M.convertTo(stage.M, CV_64F);
+    if( !(flags & WARP_INVERSE_MAP) )
+        stage.M = stage.M.inv();
+    stage.dsize = dsize;
+    p->stages.push_back(stage);
+    return *this;
+}
+
+WarpPipeline& WarpPipeline::remap(InputArray map1, InputArray map2)
+{
+    WarpStage stage;
+    stage.kind = WARP_STAGE_MAP;
+    if( map1.type() == CV_32FC2 && map2.empty() )
+        stage.map = map1.getMat().clone();
+    else
+        convertMaps(map1, map2, stage.map, noArray(), CV_32FC2);
+    CV_Assert( !stage.map.empty() );
+    stage.dsize = stage.map.size();
+    p->stages.push_back(stage);
+    return *this;
+}
+
+WarpPipeline& WarpPipeline::crop(const Rect& roi)
+{
+    CV_Assert( !roi.empty() );
+
+    WarpStage stage;
+    stage.kind = WARP_STAGE_HOMOGRAPHY;
+    stage.M = Matx33d(1, 0, roi.x, 0, 1, roi.y, 0, 0, 1);
+    stage.dsize = roi.size();
+    p->stages.push_back(stage);
+    return *this;
+}
+
+WarpPipeline& WarpPipeline::resize(Size dsize, double fx, double fy)
+{
+    CV_Assert( !dsize.empty() || (fx > 0 && fy > 0) );
+
+    WarpStage stage;
+    stage.kind = WARP_STAGE_RESIZE;
+    stage.dsize = dsize;
+    stage.fx = fx;
+    stage.fy = fy;
+    p->stages.push_back(stage);
+    return *this;
+}
+
+WarpPipeline& WarpPipeline::cvtColor(int code)
+{
+    if( impl::isBayer(code) )
+        CV_Error(Error::StsBadArg, "Demosaicing is not a per-pixel operation and can not be a pipeline stage");
+
+    WarpStage stage;
+    stage.dstType = [code](int srcType) { return impl::cvtColorDstType(srcType, code); };
+    stage.op = [code](const Mat& src, Mat& dst) { cv::cvtColor(src, dst, code); };
+    p->stages.push_back(stage);
+    return *this;
+}
+
+WarpPipeline& WarpPipeline::convertTo(int ddepth, double alpha, double beta)
+{
+    WarpStage stage;
+    stage.dstType = [ddepth](int srcType)
+    {
+        return CV_MAKETYPE(ddepth < 0 ? CV_MAT_DEPTH(srcType) : ddepth, CV_MAT_CN(srcType));
+    };
+    stage.op = [ddepth, alpha, beta](const Mat& src, Mat& dst) { src.convertTo(dst, ddepth, alpha, beta); };
+    p->stages.push_back(stage);
+    return *this;
+}
+
+WarpPipeline& WarpPipeline::setInterpolation(int interpolation)
+{
+    CV_Assert( interpolation == INTER_NEAREST || interpolation == INTER_LINEAR ||
+               interpolation == INTER_CUBIC || interpolation == INTER_LANCZOS4 );
+    p->interpolation = interpolation;
+    return *this;
+}
+
+WarpPipeline& WarpPipeline::setBorder(int borderMode, const Scalar& borderValue)
+{
+    CV_Assert( borderMode != BORDER_TRANSPARENT );
+    p->borderMode = borderMode;
+    p->borderValue = borderValue;
+    return *this;
+}
+
+size_t WarpPipeline::size() const
+{
+    return p->stages.size();
+}
+
+bool WarpPipeline::empty() const
+{
+    return p->stages.empty();
+}
+
+void WarpPipeline::clear()
+{
+    p->stages.clear();
+}
+
+Size WarpPipeline::getDstSize(Size srcSize) const
+{
+    WarpPlan plan;
+    p->compile(srcSize, -1, plan);
+    return plan.dsize;
+}
+
+void WarpPipeline::apply(InputArray _src, OutputArray _dst) const
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !_src.empty() && _src.dims() <= 2 );
+    if( p->stages.empty() )
+    {
+        _src.copyTo(_dst);
+        return;
+    }
+
+    Mat src = _src.getMat();
+    std::vector<WarpPlan> plans(1);
+    p->compile(src.size(), src.type(), plans[0]);
+
+    _dst.create(plans[0].dsize, plans[0].dstType);
+    std::vector<Mat> dst(1, _dst.getMat());
+    if( src.data == dst[0].data )
+        src = src.clone();
+    runWarpPipelines(src, plans, dst);
+}
+
+void WarpPipeline::applyBatch(InputArray _src, const std::vector<WarpPipeline>& pipelines,
+                              OutputArrayOfArrays _dst)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !_src.empty() && _src.dims() <= 2 );
+    CV_Assert( _dst.kind() == _InputArray::STD_VECTOR_MAT || _dst.kind() == _InputArray::STD_ARRAY_MAT );
+
+    Mat src = _src.getMat();
+    int n = (int)pipelines.size();
+    std::vector<WarpPlan> plans(n);
+    std::vector<Mat> dst(n);
+
+    _dst.create(n, 1, src.type());
+    for( int i = 0; i < n; i++ )
+    {
+        pipelines[i].p->compile(src.size(), src.type(), plans[i]);
+        _dst.create(plans[i].dsize, plans[i].dstType, i);
+        dst[i] = _dst.getMat(i);
+        if( src.data == dst[i].data )
+            src = src.clone();
+    }
+
+    runWarpPipelines(src, plans, dst);
+}
+
+} // namespace cv
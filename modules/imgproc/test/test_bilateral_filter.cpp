@@ -289,4 +289,65 @@ namespace opencv_test { namespace {
         test.safe_run();
     }
 
+    static void makeBilateralGridTestImage(int type, Mat& clean, Mat& noisy)
+    {
+        clean.create(150, 200, type);
+        clean.setTo(Scalar::all(60));
+        rectangle(clean, Rect(40, 30, 90, 70), Scalar(200, 180, 160), FILLED);
+        circle(clean, Point(150, 100), 35, Scalar(120, 30, 250), FILLED);
+
+        Mat noise(clean.size(), CV_MAKETYPE(CV_32F, clean.channels()));
+        randn(noise, 0, 10);
+        clean.convertTo(noisy, CV_32F);
+        noisy += noise;
+        noisy.convertTo(noisy, type);
+    }
+
+    typedef testing::TestWithParam<int> Imgproc_BilateralGridFilter_Type;
+
+    TEST_P(Imgproc_BilateralGridFilter_Type, denoising)
+    {
+        int type = GetParam();
+        Mat clean, noisy, dst, ref;
+        makeBilateralGridTestImage(type, clean, noisy);
+        double noiseL1 = cvtest::norm(clean, noisy, NORM_L1);
+
+        for (double sigmaSpace = 3; sigmaSpace <= 12; sigmaSpace *= 2)
+        {
+            SCOPED_TRACE(cv::format("sigmaSpace=%g", sigmaSpace));
+            bilateralGridFilter(noisy, dst, 20, sigmaSpace);
+            ASSERT_EQ(type, dst.type());
+            // the noise is suppressed, while the edges are kept
+            EXPECT_LE(cvtest::norm(clean, dst, NORM_L1), noiseL1*0.4);
+            // the color images are filtered by the distance of the grayscale values, not of the colors
+            bilateralFilter(noisy, ref, -1, 20, sigmaSpace);
+            EXPECT_LE(cvtest::norm(ref, dst, NORM_L1)/dst.total()/dst.channels(), 5.);
+        }
+    }
+
+    INSTANTIATE_TEST_CASE_P(/**/, Imgproc_BilateralGridFilter_Type, testing::Values(CV_8UC1, CV_8UC3, CV_32FC1, CV_32FC3));
+
+    TEST(Imgproc_BilateralGridFilter, joint)
+    {
+        Mat clean, noisy, guide, dst;
+        makeBilateralGridTestImage(CV_8UC3, clean, noisy);
+        cvtColor(clean, guide, COLOR_BGR2GRAY);
+        guide.convertTo(guide, CV_32F, 1./255);
+
+        // the edges of the clean guide are kept even with the large color sigma of the noisy image
+        bilateralGridFilter(noisy, dst, 0.05, 8, guide);
+        Mat diff;
+        absdiff(clean, dst, diff);
+        EXPECT_LE(cvtest::norm(diff, NORM_L1)/diff.total()/diff.channels(), 1.5);
+        EXPECT_LE(cvtest::norm(diff, NORM_INF), 20.);
+
+        // in-place filtering of the constant image
+        Mat img(37, 41, CV_32FC1, Scalar::all(7));
+        bilateralGridFilter(img, img, 10, 5);
+        EXPECT_LE(cvtest::norm(img, Mat(img.size(), img.type(), Scalar::all(7)), NORM_INF), 1e-4);
+
+        EXPECT_ANY_THROW(bilateralGridFilter(noisy, dst, 10, 0.5));
+        EXPECT_ANY_THROW(bilateralGridFilter(noisy, dst, 10, 5, noisy));
+    }
+
 }} // namespace
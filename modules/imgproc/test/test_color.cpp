@@ -3088,5 +3088,119 @@ TEST(ImgProc_cvtColorTwoPlane, missing_check_17036)  // test can be removed if r
     );
 }
 
+TEST(ImgProc_cvtColorBatch, accuracy)
+{
+    Mat src(160, 200, CV_8UC3);
+    randu(src, 0, 256);
+    std::vector<Rect> rois;
+    for( int i = 0; i < 25; i++ )
+        rois.push_back(Rect((i*31) % 150, (i*17) % 120, 16 + (i % 4)*9, 12 + (i % 3)*11));
+
+    Size dsize(24, 20);
+    Mat dst;
+    cvtColorBatch(src, rois, dst, COLOR_BGR2HSV, dsize, INTER_LINEAR);
+    ASSERT_EQ(3, dst.dims);
+    ASSERT_EQ(CV_8UC3, dst.type());
+    for( size_t i = 0; i < rois.size(); i++ )
+    {
+        Mat ref;
+        cv::resize(src(rois[i]), ref, dsize, 0, 0, INTER_LINEAR);
+        cvtColor(ref, ref, COLOR_BGR2HSV);
+        EXPECT_EQ(0, cvtest::norm(ref, Mat(dsize, CV_8UC3, dst.ptr((int)i)), NORM_INF)) << i;
+    }
+
+    // without resizing, to the planar layout of a different type
+    std::vector<Rect> equal;
+    for( int i = 0; i < 10; i++ )
+        equal.push_back(Rect(i*13, i*9, 40, 30));
+    Mat f32;
+    src.convertTo(f32, CV_32F, 1./255);
+    cvtColorBatch(f32, equal, dst, COLOR_BGR2Lab, Size(), INTER_LINEAR, true);
+    ASSERT_EQ(4, dst.dims);
+    ASSERT_EQ(CV_32F, dst.type());
+    ASSERT_EQ(3, dst.size[1]);
+    for( size_t i = 0; i < equal.size(); i++ )
+    {
+        Mat ref, planes[3];
+        cvtColor(f32(equal[i]), ref, COLOR_BGR2Lab);
+        cv::split(ref, planes);
+        for( int c = 0; c < 3; c++ )
+            EXPECT_EQ(0, cvtest::norm(planes[c], Mat(equal[i].size(), CV_32F, dst.ptr((int)i, c)), NORM_INF));
+    }
+
+    EXPECT_ANY_THROW(cvtColorBatch(src, rois, dst, COLOR_BGR2GRAY));
+    Mat gray(64, 64, CV_8UC1, Scalar::all(1));
+    EXPECT_ANY_THROW(cvtColorBatch(gray, equal, dst, COLOR_BayerBG2BGR, dsize));
+    EXPECT_ANY_THROW(cvtColorBatch(gray, std::vector<Rect>(1, Rect(0, 0, 64, 48)), dst, COLOR_YUV2BGR_NV12));
+}
+
+TEST(ImgProc_DemosaicingRaw, accuracy)
+{
+    Mat raw(97, 130, CV_16UC1);
+    randu(raw, 0, 4096);
+    cv::GaussianBlur(raw, raw, Size(0, 0), 1.5);
+    raw.at<ushort>(40, 40) = 4095;
+
+    // MIPI RAW12 and GenICam 12p layouts of the same frame
+    Mat mipi(raw.rows, raw.cols/2*3, CV_8UC1), lsb(mipi.size(), CV_8UC1);
+    for( int y = 0; y < raw.rows; y++ )
+        for( int x = 0; x < raw.cols; x += 2 )
+        {
+            int p0 = raw.at<ushort>(y, x), p1 = raw.at<ushort>(y, x + 1);
+            uchar* m = mipi.ptr(y) + x/2*3;
+            m[0] = (uchar)(p0 >> 4); m[1] = (uchar)(p1 >> 4); m[2] = (uchar)((p0 & 15) | ((p1 & 15) << 4));
+            uchar* l = lsb.ptr(y) + x/2*3;
+            l[0] = (uchar)p0; l[1] = (uchar)((p0 >> 8) | ((p1 & 15) << 4)); l[2] = (uchar)(p1 >> 4);
+        }
+
+    Scalar gains(1.6, 1.0, 2.1);
+    Matx33f ccm(1.5f, -0.3f, -0.2f, -0.2f, 1.4f, -0.2f, -0.1f, -0.4f, 1.5f);
+    Matx33f m = ccm*Matx33f(1.6f, 0, 0, 0, 1.f, 0, 0, 0, 2.1f);
+    Mat gamma(1, 4096, CV_8UC1);
+    for( int i = 0; i < 4096; i++ )
+        gamma.at<uchar>(i) = saturate_cast<uchar>(255*std::pow(i/4095., 1/2.2));
+
+    const int codes[] = { COLOR_BayerBG2BGR, COLOR_BayerGR2BGR_EA, COLOR_BayerGB2BGR_EA };
+    for( int i = 0; i < 3; i++ )
+    {
+        Mat bgr, ref;
+        demosaicing(raw, bgr, codes[i]);
+        bgr.convertTo(bgr, CV_32F);
+        cv::transform(bgr, ref, m);
+        ref = cv::min(cv::max(ref, 0), 4095);
+        ref.convertTo(ref, CV_16U);
+
+        Mat dst, dstLUT, packed;
+        demosaicingRaw(raw, dst, codes[i], gains, ccm, noArray(), 12);
+        ASSERT_EQ(CV_16UC3, dst.type());
+        EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 1) << i;
+
+        demosaicingRaw(raw, dstLUT, codes[i], gains, ccm, gamma, 12);
+        ASSERT_EQ(CV_8UC3, dstLUT.type());
+        Mat dst8(dst.size(), CV_8UC3);
+        for( size_t k = 0; k < dst.total()*3; k++ )
+            dst8.ptr()[k] = gamma.at<uchar>(dst.ptr<ushort>()[k]);
+        EXPECT_EQ(0, cvtest::norm(dst8, dstLUT, NORM_INF)) << i;
+
+        demosaicingRaw(mipi, packed, codes[i], gains, ccm, gamma, 0, RAW_PACKED_12_MIPI);
+        EXPECT_EQ(0, cvtest::norm(dstLUT, packed, NORM_INF)) << i;
+        demosaicingRaw(lsb, packed, codes[i], gains, ccm, gamma, 0, RAW_PACKED_12_LSB);
+        EXPECT_EQ(0, cvtest::norm(dstLUT, packed, NORM_INF)) << i;
+
+        // 8-bit frame, only the white balance
+        Mat raw8, bgr8, ref8, dst8u;
+        raw.convertTo(raw8, CV_8U, 1./16);
+        demosaicing(raw8, bgr8, codes[i]);
+        cv::transform(bgr8, ref8, Matx33f(1.6f, 0, 0, 0, 1.f, 0, 0, 0, 2.1f));
+        demosaicingRaw(raw8, dst8u, codes[i], gains);
+        ASSERT_EQ(CV_8UC3, dst8u.type());
+        EXPECT_LE(cvtest::norm(ref8, dst8u, NORM_INF), 1) << i;
+    }
+
+    Mat dst;
+    EXPECT_ANY_THROW(demosaicingRaw(raw, dst, COLOR_BayerBG2BGR_VNG));
+    EXPECT_ANY_THROW(demosaicingRaw(raw, dst, COLOR_BayerBG2BGR, Scalar::all(1), noArray(), gamma));
+    EXPECT_ANY_THROW(demosaicingRaw(raw, dst, COLOR_BayerBG2BGR, Scalar::all(1), noArray(), noArray(), 0, RAW_PACKED_12_MIPI));
+}
 
 }} // namespace
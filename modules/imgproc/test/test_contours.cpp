@@ -485,6 +485,105 @@ TEST(Imgproc_FindContours, border)
     ASSERT_EQ(0, cvtest::norm(img, img_draw_contours, NORM_INF));
 }
 
+// the sequential Suzuki-Abe scanner, as cv::findContours used it for all the modes
+static void findContoursSequential(const Mat& src, vector<vector<Point> >& contours, vector<Vec4i>& hierarchy,
+                                   int mode, int method)
+{
+    Mat img;
+    cv::copyMakeBorder(src, img, 1, 1, 1, 1, BORDER_CONSTANT | BORDER_ISOLATED, Scalar(0));
+    CvMat cimg = cvMat(img);
+    MemStorage storage(cvCreateMemStorage());
+    CvSeq* first = 0;
+    contours.clear();
+    hierarchy.clear();
+    cvFindContours(&cimg, storage, &first, sizeof(CvContour), mode, method, cvPoint(-1, -1));
+    if( !first )
+        return;
+    Seq<CvSeq*> all(cvTreeToNodeSeq(first, sizeof(CvSeq), storage));
+    int total = (int)all.size();
+    contours.resize(total);
+    hierarchy.resize(total);
+    SeqIterator<CvSeq*> it = all.begin();
+    for( int i = 0; i < total; i++, ++it )
+    {
+        ((CvContour*)*it)->color = i;
+        contours[i].resize((*it)->total);
+        cvCvtSeqToArray(*it, &contours[i][0]);
+    }
+    it = all.begin();
+    for( int i = 0; i < total; i++, ++it )
+    {
+        CvSeq* c = *it;
+        hierarchy[i] = Vec4i(c->h_next ? ((CvContour*)c->h_next)->color : -1,
+                             c->h_prev ? ((CvContour*)c->h_prev)->color : -1,
+                             c->v_next ? ((CvContour*)c->v_next)->color : -1,
+                             c->v_prev ? ((CvContour*)c->v_prev)->color : -1);
+    }
+}
+
+typedef testing::TestWithParam<tuple<int, int> > Imgproc_FindContours_Parallel;
+
+TEST_P(Imgproc_FindContours_Parallel, same_as_sequential)
+{
+    const int mode = get<0>(GetParam()), method = get<1>(GetParam());
+    RNG& rng = theRNG();
+
+    for( int iter = 0; iter < 12; iter++ )
+    {
+        Mat img(rng.uniform(1, 250), rng.uniform(1, 250), CV_8U);
+        rng.fill(img, RNG::UNIFORM, 0, 256);
+        if( iter % 3 != 0 )
+            GaussianBlur(img, img, Size(0, 0), iter % 3 == 1 ? 1. : 3.);
+        cv::threshold(img, img, 127, iter % 2 ? 255 : 7, THRESH_BINARY);
+        if( iter == 0 )
+        {
+            // nested blobs and holes, including the ones touching the image border
+            img.setTo(0);
+            rectangle(img, Rect(0, 0, img.cols, img.rows), Scalar::all(255), 3);
+            circle(img, Point(img.cols/2, img.rows/2), std::min(img.cols, img.rows)/3, Scalar::all(255), 5);
+            circle(img, Point(img.cols/2, img.rows/2), std::min(img.cols, img.rows)/6, Scalar::all(255), FILLED);
+            circle(img, Point(img.cols/2, img.rows/2), std::min(img.cols, img.rows)/12, Scalar::all(0), FILLED);
+            img.at<uchar>(img.rows/2, img.cols/2) = 255;
+        }
+
+        vector<vector<Point> > contours, refContours;
+        vector<Vec4i> hierarchy, refHierarchy;
+        findContoursSequential(img, refContours, refHierarchy, mode, method);
+        findContours(img, contours, hierarchy, mode, method);
+
+        ASSERT_EQ(refContours.size(), contours.size()) << "iter=" << iter;
+        for( size_t i = 0; i < contours.size(); i++ )
+            ASSERT_EQ(refContours[i], contours[i]) << "iter=" << iter << " contour=" << i;
+        ASSERT_EQ(refHierarchy, hierarchy) << "iter=" << iter;
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_FindContours_Parallel,
+                        testing::Combine(testing::Values((int)RETR_EXTERNAL, (int)RETR_CCOMP),
+                                         testing::Values((int)CHAIN_APPROX_NONE, (int)CHAIN_APPROX_SIMPLE)));
+
+TEST(Imgproc_FindContours, ccomp_offset)
+{
+    Mat img = Mat::zeros(20, 30, CV_8U);
+    rectangle(img, Rect(2, 3, 10, 8), Scalar::all(255), 2);
+    rectangle(img, Rect(20, 4, 5, 5), Scalar::all(255), FILLED);
+
+    vector<vector<Point> > contours, contours0;
+    vector<Vec4i> hierarchy;
+    findContours(img, contours, hierarchy, RETR_CCOMP, CHAIN_APPROX_SIMPLE, Point(5, -1));
+    findContours(img, contours0, RETR_CCOMP, CHAIN_APPROX_SIMPLE);
+
+    // the component found last in the raster order goes first, the holes follow their component
+    ASSERT_EQ(3u, contours.size());
+    EXPECT_EQ(Vec4i(1, -1, -1, -1), hierarchy[0]);
+    EXPECT_EQ(Vec4i(-1, 0, 2, -1), hierarchy[1]);
+    EXPECT_EQ(Vec4i(-1, -1, -1, 1), hierarchy[2]);
+    EXPECT_EQ(Rect(25, 3, 5, 5), boundingRect(contours[0]));
+    for( size_t i = 0; i < contours.size(); i++ )
+        for( size_t j = 0; j < contours[i].size(); j++ )
+            EXPECT_EQ(contours0[i][j] + Point(5, -1), contours[i][j]);
+}
+
 TEST(Imgproc_PointPolygonTest, regression_10222)
 {
     vector<Point> contour;
@@ -2306,5 +2306,107 @@ TEST(Imgproc_ConvexHull, overflow)
     ASSERT_EQ(hull, hullf);
 }
 
+TEST(Imgproc_ContourBatch, accuracy)
+{
+    RNG& rng = theRNG();
+    Mat img = Mat::zeros(480, 640, CV_8UC1);
+    for( int i = 0; i < 300; i++ )
+        ellipse(img, Point(rng.uniform(0, 640), rng.uniform(0, 480)), Size(rng.uniform(1, 30), rng.uniform(1, 20)),
+                rng.uniform(0., 180.), 0, 360, Scalar::all(255), -1);
+    std::vector<std::vector<Point> > contours;
+    findContours(img, contours, RETR_LIST, CHAIN_APPROX_NONE);
+    contours.insert(contours.begin() + contours.size()/2, std::vector<Point>());
+    contours.push_back(std::vector<Point>(1, Point(3, 5)));
+
+    for( int depth = CV_32S; depth <= CV_32F; depth += CV_32F - CV_32S )
+    {
+        std::vector<int> ofs(1, 0);
+        Mat points;
+        std::vector<Mat> single;
+        for( size_t i = 0; i < contours.size(); i++ )
+        {
+            Mat c = Mat(contours[i], true);
+            if( depth == CV_32F )
+                c.convertTo(c, CV_32F, 0.5);
+            single.push_back(c);
+            points.push_back(c);
+            ofs.push_back(points.rows);
+        }
+        int n = (int)contours.size();
+
+        std::vector<Rect> rects;
+        std::vector<Moments> mom;
+        std::vector<RotatedRect> boxes;
+        Mat areas, hullPoints, hullOfs, approxPoints, approxOfs;
+        cv::boundingRectBatch(points, ofs, rects);
+        cv::contourAreaBatch(points, ofs, areas, true);
+        cv::momentsBatch(points, ofs, mom);
+        cv::minAreaRectBatch(points, ofs, boxes);
+        cv::convexHullBatch(points, ofs, hullPoints, hullOfs, true);
+        cv::approxPolyDPBatch(points, ofs, approxPoints, approxOfs, 2., true);
+        ASSERT_EQ(n, (int)rects.size());
+        ASSERT_EQ(n, (int)mom.size());
+        ASSERT_EQ(n, (int)boxes.size());
+        ASSERT_EQ(n, areas.rows);
+        ASSERT_EQ(n + 1, hullOfs.rows);
+        ASSERT_EQ(n + 1, approxOfs.rows);
+        ASSERT_EQ(CV_MAKETYPE(depth, 2), hullPoints.type());
+        ASSERT_EQ(CV_MAKETYPE(depth, 2), approxPoints.type());
+
+        for( int i = 0; i < n; i++ )
+        {
+            const Mat& c = single[i];
+            Mat hull, approx;
+            if( c.empty() )
+            {
+                EXPECT_EQ(Rect(), rects[i]);
+                EXPECT_EQ(0., areas.at<double>(i));
+                EXPECT_EQ(0., mom[i].m00);
+                EXPECT_EQ(Size2f(), boxes[i].size);
+            }
+            else
+            {
+                EXPECT_EQ(cv::boundingRect(c), rects[i]) << i;
+                EXPECT_EQ(cv::contourArea(c, true), areas.at<double>(i)) << i;
+                Moments m = cv::moments(c);
+                EXPECT_EQ(0, memcmp(&m, &mom[i], sizeof(m))) << i;
+                RotatedRect box = cv::minAreaRect(c);
+                EXPECT_EQ(box.center, boxes[i].center) << i;
+                EXPECT_EQ(box.size, boxes[i].size) << i;
+                EXPECT_EQ(box.angle, boxes[i].angle) << i;
+                cv::convexHull(c, hull, true);
+                cv::approxPolyDP(c, approx, 2., true);
+            }
+            int h0 = hullOfs.at<int>(i), h1 = hullOfs.at<int>(i+1);
+            int a0 = approxOfs.at<int>(i), a1 = approxOfs.at<int>(i+1);
+            ASSERT_EQ(hull.rows, h1 - h0) << i;
+            ASSERT_EQ(approx.rows, a1 - a0) << i;
+            if( hull.rows > 0 )
+            {
+                EXPECT_EQ(0, cvtest::norm(hull, hullPoints.rowRange(h0, h1), NORM_INF)) << i;
+            }
+            if( approx.rows > 0 )
+            {
+                EXPECT_EQ(0, cvtest::norm(approx, approxPoints.rowRange(a0, a1), NORM_INF)) << i;
+            }
+        }
+    }
+
+    std::vector<Rect> rects;
+    std::vector<int> badOfs;
+    badOfs.push_back(0); badOfs.push_back(5); badOfs.push_back(3);
+    Mat points(10, 1, CV_32SC2, Scalar::all(0));
+    EXPECT_ANY_THROW(cv::boundingRectBatch(points, badOfs, rects));
+    badOfs[2] = 11;
+    EXPECT_ANY_THROW(cv::boundingRectBatch(points, badOfs, rects));
+    badOfs[2] = 10;
+    cv::boundingRectBatch(points, badOfs, rects);
+    EXPECT_EQ(2u, rects.size());
+
+    std::vector<int> emptyOfs(3, 0);
+    cv::boundingRectBatch(Mat(), emptyOfs, rects);
+    EXPECT_EQ(2u, rects.size());
+}
+
 }} // namespace
 /* End of file. */
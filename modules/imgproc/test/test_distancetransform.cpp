@@ -283,6 +283,122 @@ void CV_DisTransTest::prepare_to_validation( int /*test_case_idx*/ )
 
 TEST(Imgproc_DistanceTransform, accuracy) { CV_DisTransTest test; test.safe_run(); }
 
+static Mat makeSparseZerosImage(Size size, int count, RNG& rng)
+{
+    Mat src(size, CV_8UC1, Scalar::all(255));
+    for( int i = 0; i < count; i++ )
+        src.at<uchar>(rng.uniform(0, size.height), rng.uniform(0, size.width)) = 0;
+    return src;
+}
+
+TEST(Imgproc_DistanceTransform, chamfer_tiles)
+{
+    RNG& rng = theRNG();
+    Mat src = makeSparseZerosImage(Size(700, 500), 40, rng);
+    const int dist_types[] = { DIST_L1, DIST_C, DIST_L2, DIST_L2 };
+    const int mask_sizes[] = { DIST_MASK_3, DIST_MASK_3, DIST_MASK_3, DIST_MASK_5 };
+    int nthreads = getNumThreads();
+
+    for( int k = 0; k < 4; k++ )
+    {
+        // the tiles are processed only if there are several threads, the result must be the same
+        Mat dst0, dst, labels0, labels, ldst;
+        setNumThreads(1);
+        distanceTransform(src, dst0, dist_types[k], mask_sizes[k]);
+        distanceTransform(src, ldst, labels0, dist_types[k], mask_sizes[k], DIST_LABEL_PIXEL);
+        setNumThreads(4);
+        distanceTransform(src, dst, dist_types[k], mask_sizes[k]);
+        distanceTransform(src, ldst, labels, dist_types[k], mask_sizes[k], DIST_LABEL_PIXEL);
+        setNumThreads(nthreads);
+        EXPECT_EQ(0, cvtest::norm(dst0, dst, NORM_INF)) << k;
+        EXPECT_EQ(0, cvtest::norm(labels0, labels, NORM_INF)) << k;
+    }
+
+    // L1 and C distances are exact
+    std::vector<Point> zeros;
+    findNonZero(src == 0, zeros);
+    Mat l1, c;
+    distanceTransform(src, l1, DIST_L1, DIST_MASK_3);
+    distanceTransform(src, c, DIST_C, DIST_MASK_3);
+    for( int y = 0; y < src.rows; y += 7 )
+        for( int x = 0; x < src.cols; x += 5 )
+        {
+            int dl1 = INT_MAX, dc = INT_MAX;
+            for( size_t i = 0; i < zeros.size(); i++ )
+            {
+                int dx = std::abs(zeros[i].x - x), dy = std::abs(zeros[i].y - y);
+                dl1 = std::min(dl1, dx + dy);
+                dc = std::min(dc, std::max(dx, dy));
+            }
+            ASSERT_EQ((float)dl1, l1.at<float>(y, x)) << x << " " << y;
+            ASSERT_EQ((float)dc, c.at<float>(y, x)) << x << " " << y;
+        }
+}
+
+TEST(Imgproc_DistanceTransform, precise_labels)
+{
+    RNG& rng = theRNG();
+    Mat src = makeSparseZerosImage(Size(333, 251), 50, rng), dst0, dst, labels;
+    // a connected component of zeros
+    src(Rect(100, 80, 30, 2)).setTo(Scalar::all(0));
+    std::vector<Point> zeros;
+    findNonZero(src == 0, zeros);
+
+    distanceTransform(src, dst0, DIST_L2, DIST_MASK_PRECISE);
+    distanceTransform(src, dst, labels, DIST_L2, DIST_MASK_PRECISE, DIST_LABEL_PIXEL);
+    EXPECT_EQ(0, cvtest::norm(dst0, dst, NORM_INF));
+
+    // the labels are assigned to the zero pixels in the raster order
+    std::vector<Point> sites(zeros.size() + 1);
+    for( size_t i = 0; i < zeros.size(); i++ )
+        sites[labels.at<int>(zeros[i])] = zeros[i];
+
+    for( int y = 0; y < src.rows; y++ )
+        for( int x = 0; x < src.cols; x++ )
+        {
+            double d = DBL_MAX;
+            for( size_t i = 0; i < zeros.size(); i++ )
+                d = std::min(d, cv::norm(zeros[i] - Point(x, y)));
+            int label = labels.at<int>(y, x);
+            ASSERT_TRUE(label >= 1 && label <= (int)zeros.size()) << x << " " << y;
+            ASSERT_NEAR(d, dst.at<float>(y, x), 1e-3) << x << " " << y;
+            ASSERT_NEAR(d, cv::norm(sites[label] - Point(x, y)), 1e-3) << x << " " << y;
+        }
+
+    // the whole segment is one connected component
+    Mat ccomp;
+    distanceTransform(src, dst, ccomp, DIST_L2, DIST_MASK_PRECISE, DIST_LABEL_CCOMP);
+    EXPECT_EQ(0, cvtest::norm(dst0, dst, NORM_INF));
+    EXPECT_EQ(ccomp.at<int>(80, 100), ccomp.at<int>(81, 129));
+    for( int y = 0; y < src.rows; y += 3 )
+        for( int x = 0; x < src.cols; x += 3 )
+        {
+            double d = DBL_MAX;
+            for( size_t i = 0; i < zeros.size(); i++ )
+                if( ccomp.at<int>(zeros[i]) == ccomp.at<int>(y, x) )
+                    d = std::min(d, cv::norm(zeros[i] - Point(x, y)));
+            ASSERT_NEAR(d, dst.at<float>(y, x), 1e-3) << x << " " << y;
+        }
+}
+
+TEST(Imgproc_DistanceTransform, precise_labels_no_zeros)
+{
+    Mat src(97, 300, CV_8UC1, Scalar::all(1)), dst;
+    for( int labelType = DIST_LABEL_CCOMP; labelType <= DIST_LABEL_PIXEL; labelType++ )
+    {
+        Mat labels0, labels;
+        distanceTransform(src, dst, labels0, DIST_L2, DIST_MASK_5, labelType);
+        // garbage on the stack must not leak into the labels
+        for( int iter = 0; iter < 3; iter++ )
+        {
+            labels.create(src.size(), CV_32S);
+            labels.setTo(Scalar::all(iter*1000 + 7));
+            distanceTransform(src, dst, labels, DIST_L2, DIST_MASK_PRECISE, labelType);
+            EXPECT_EQ(0, cvtest::norm(labels0, labels, NORM_INF)) << labelType << " " << iter;
+        }
+    }
+}
+
 BIGDATA_TEST(Imgproc_DistanceTransform, large_image_12218)
 {
     const int lls_maxcnt = 79992000;   // labels's maximum count
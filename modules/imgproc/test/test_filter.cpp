@@ -2021,6 +2021,59 @@ TEST(Imgproc_GaussianBlur, borderTypes)
     EXPECT_EQ(27, dst.at<uchar>(0, 0));
 }
 
+typedef testing::TestWithParam<tuple<int, double, int> > Imgproc_RecursiveGaussianBlur_Sigma;
+
+TEST_P(Imgproc_RecursiveGaussianBlur_Sigma, accuracy)
+{
+    int type = get<0>(GetParam());
+    double sigma = get<1>(GetParam());
+    int borderType = get<2>(GetParam());
+
+    RNG& rng = theRNG();
+    Mat src(97, 113, type), src64, ref, dst;
+    rng.fill(src, RNG::UNIFORM, 0, 256);
+    // a sharp edge and a smooth area
+    src(Rect(30, 20, 40, 50)).setTo(Scalar::all(255));
+    cv::GaussianBlur(src(Rect(70, 0, 43, 97)), src(Rect(70, 0, 43, 97)), Size(0, 0), 4);
+
+    src.convertTo(src64, CV_64F);
+    int ksize = cvCeil(sigma*5)*2 + 1;
+    cv::GaussianBlur(src64, ref, Size(ksize, ksize), sigma, sigma*1.5, borderType);
+
+    recursiveGaussianBlur(src, dst, sigma, sigma*1.5, borderType);
+    ASSERT_EQ(type, dst.type());
+    dst.convertTo(dst, CV_64F);
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 255*0.025);
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_L1)/src.total()/src.channels(), 255*0.006);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_RecursiveGaussianBlur_Sigma,
+    testing::Combine(testing::Values(CV_8UC1, CV_8UC3, CV_16SC1, CV_32FC1, CV_64FC1),
+                     testing::Values(3., 8., 40.),
+                     testing::Values(BORDER_REPLICATE, BORDER_REFLECT_101, BORDER_CONSTANT)));
+
+TEST(Imgproc_RecursiveGaussianBlur, roi_and_inplace)
+{
+    Mat img(80, 90, CV_32FC1);
+    randu(img, 0, 100);
+    Mat roi = img(Rect(20, 10, 50, 60)), ref, dst;
+
+    // the pixels outside of ROI are used unless BORDER_ISOLATED is set
+    recursiveGaussianBlur(img, ref, 5);
+    recursiveGaussianBlur(roi, dst, 5);
+    EXPECT_LE(cvtest::norm(ref(Rect(20, 10, 50, 60)), dst, NORM_INF), 0.05);
+
+    recursiveGaussianBlur(roi.clone(), ref, 5, 2);
+    recursiveGaussianBlur(roi, dst, 5, 2, BORDER_DEFAULT | BORDER_ISOLATED);
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 1e-3);
+
+    recursiveGaussianBlur(roi, roi, 5, 2, BORDER_DEFAULT | BORDER_ISOLATED);
+    EXPECT_LE(cvtest::norm(ref, roi, NORM_INF), 1e-3);
+
+    EXPECT_ANY_THROW(recursiveGaussianBlur(img, dst, 0.3));
+    EXPECT_ANY_THROW(recursiveGaussianBlur(img, dst, 5, 5, BORDER_WRAP));
+}
+
 TEST(Imgproc_Morphology, iterated)
 {
     RNG& rng = theRNG();
@@ -2105,6 +2158,79 @@ TEST(Imgproc_Sobel, borderTypes)
     EXPECT_DOUBLE_EQ(0.0, cvtest::norm(expected_dst, dst, NORM_INF));
 }
 
+typedef testing::TestWithParam<tuple<int, int, int> > Imgproc_Morphology_LargeKernel;
+
+TEST_P(Imgproc_Morphology_LargeKernel, accuracy)
+{
+    const int type = get<0>(GetParam()), op = get<1>(GetParam()), borderType = get<2>(GetParam());
+    RNG& rng = theRNG();
+    Mat src(rng.uniform(1, 200), rng.uniform(1, 200), type);
+    rng.fill(src, RNG::UNIFORM, 0, 256);
+
+    Mat ellipse = getStructuringElement(MORPH_ELLIPSE, Size(31, 25));
+    Mat kernels[] = {
+        Mat::ones(31, 31, CV_8U), Mat::ones(1, 101, CV_8U), Mat::ones(41, 1, CV_8U), Mat::ones(9, 70, CV_8U),
+        ellipse, getStructuringElement(MORPH_ELLIPSE, Size(45, 45)), getStructuringElement(MORPH_CROSS, Size(21, 21))
+    };
+    for( size_t i = 0; i < sizeof(kernels)/sizeof(kernels[0]); i++ )
+    {
+        SCOPED_TRACE(cv::format("kernel %d", (int)i));
+        const Mat& kernel = kernels[i];
+        Point anchor(rng.uniform(0, kernel.cols), rng.uniform(0, kernel.rows));
+        Mat dst, ref;
+        if( op == MORPH_ERODE )
+        {
+            cv::erode(src, dst, kernel, anchor, 1, borderType);
+            cvtest::erode(src, ref, kernel, anchor, borderType);
+        }
+        else
+        {
+            cv::dilate(src, dst, kernel, anchor, 1, borderType);
+            cvtest::dilate(src, ref, kernel, anchor, borderType);
+        }
+        ASSERT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_Morphology_LargeKernel,
+    testing::Combine(testing::Values(CV_8UC1, CV_8UC3, CV_16UC1, CV_16SC4, CV_32FC1, CV_64FC1),
+                     testing::Values((int)MORPH_ERODE, (int)MORPH_DILATE),
+                     testing::Values((int)BORDER_REPLICATE, (int)BORDER_REFLECT_101)));
+
+TEST(Imgproc_Morphology, large_kernel_roi_and_iterations)
+{
+    Mat src(300, 400, CV_8UC1), dst;
+    randu(src, 0, 256);
+    Mat kernel = getStructuringElement(MORPH_ELLIPSE, Size(35, 35));
+    Rect roi(20, 50, 200, 150);
+
+    // the pixels outside of a ROI are used as the border
+    Mat full, part;
+    cv::dilate(src, full, kernel);
+    cv::dilate(src(roi), part, kernel);
+    EXPECT_EQ(0, cvtest::norm(full(roi), part, NORM_INF));
+
+    // the border pixels of the whole image may lie on the left or on the top of the ROI
+    Mat wide = Mat::ones(61, 81, CV_8U);
+    cv::erode(src, full, wide, Point(-1, -1), 1, BORDER_REFLECT_101);
+    cv::erode(src(roi), part, wide, Point(-1, -1), 1, BORDER_REFLECT_101);
+    EXPECT_EQ(0, cvtest::norm(full(roi), part, NORM_INF));
+
+    // the default border value does not affect the result
+    Mat ref = src.clone();
+    cv::copyMakeBorder(src, ref, 17, 17, 17, 17, BORDER_CONSTANT, Scalar::all(255));
+    cv::erode(src, dst, kernel);
+    cv::erode(ref, ref, kernel);
+    EXPECT_EQ(0, cvtest::norm(ref(Rect(17, 17, src.cols, src.rows)), dst, NORM_INF));
+
+    // in-place operation with iterations
+    Mat img = src.clone();
+    cv::dilate(src, ref, kernel, Point(-1, -1), 1, BORDER_REPLICATE);
+    cv::dilate(ref, ref, kernel, Point(-1, -1), 1, BORDER_REPLICATE);
+    cv::dilate(img, img, kernel, Point(-1, -1), 2, BORDER_REPLICATE);
+    EXPECT_EQ(0, cvtest::norm(ref, img, NORM_INF));
+}
+
 TEST(Imgproc_MorphEx, hitmiss_regression_8957)
 {
     Mat_<uchar> src(3, 3);
@@ -2292,6 +2418,56 @@ TEST(Imgproc_MedianBlur, hires_regression_13409)
     ASSERT_EQ(0.0, cvtest::norm(dst_hires(Rect(516, 516, 1016, 1016)), dst_ref(Rect(4, 4, 1016, 1016)), NORM_INF));
 }
 
+typedef testing::TestWithParam<tuple<int, int, int> > Imgproc_MedianBlur_LargeAperture;
+
+TEST_P(Imgproc_MedianBlur_LargeAperture, accuracy)
+{
+    const int depth = get<0>(GetParam()), cn = get<1>(GetParam()), ksize = get<2>(GetParam());
+    RNG& rng = theRNG();
+    Mat src(rng.uniform(1, 300), rng.uniform(1, 300), CV_MAKETYPE(depth, cn)), dst;
+    if( depth == CV_16U )
+        rng.fill(src, RNG::UNIFORM, 0, rng.uniform(0, 2) ? 65536 : 64);
+    else
+        rng.fill(src, RNG::NORMAL, 0, 100);
+
+    medianBlur(src, dst, ksize);
+    ASSERT_EQ(src.type(), dst.type());
+    ASSERT_EQ(src.size(), dst.size());
+
+    // reference with BORDER_REPLICATE
+    const int r = ksize/2;
+    Mat ref(src.size(), CV_64FC(cn)), srcd;
+    src.convertTo(srcd, CV_64F);
+    std::vector<double> buf(ksize*ksize);
+    for( int y = 0; y < src.rows; y++ )
+        for( int x = 0; x < src.cols; x++ )
+            for( int c = 0; c < cn; c++ )
+            {
+                int k = 0;
+                for( int dy = -r; dy <= r; dy++ )
+                    for( int dx = -r; dx <= r; dx++ )
+                        buf[k++] = srcd.ptr<double>(std::min(std::max(y + dy, 0), src.rows - 1))
+                                               [std::min(std::max(x + dx, 0), src.cols - 1)*cn + c];
+                std::nth_element(buf.begin(), buf.begin() + k/2, buf.end());
+                ref.ptr<double>(y)[x*cn + c] = buf[k/2];
+            }
+
+    Mat dstd;
+    dst.convertTo(dstd, CV_64F);
+    EXPECT_EQ(0, cvtest::norm(ref, dstd, NORM_INF));
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_MedianBlur_LargeAperture,
+    testing::Combine(testing::Values(CV_16U, CV_32F), testing::Values(1, 3), testing::Values(7, 15, 21)));
+
+TEST(Imgproc_MedianBlur, float_aperture_limit)
+{
+    Mat src(40, 40, CV_32FC1, Scalar::all(1)), dst;
+    medianBlur(src, dst, 127);
+    EXPECT_EQ(0, cvtest::norm(src, dst, NORM_INF));
+    EXPECT_THROW(medianBlur(src, dst, 129), cv::Exception);
+}
+
 TEST(Imgproc_Sobel, s16_regression_13506)
 {
     Mat src = (Mat_<short>(8, 16) << 127, 138, 130, 102, 118,  97,  76,  84, 124,  90, 146,  63, 130,  87, 212,  85,
@@ -2323,6 +2499,64 @@ TEST(Imgproc_Pyrdown, issue_12961)
     ASSERT_EQ(0.0, cv::norm(dst));
 }
 
+typedef testing::TestWithParam<tuple<int, int> > Imgproc_BuildPyramid;
+
+TEST_P(Imgproc_BuildPyramid, single_pass)
+{
+    const int type = get<0>(GetParam()), borderType = get<1>(GetParam());
+    Mat src(347, 213, type);
+    randu(src, 0, 256);
+    const int maxlevel = 5;
+
+    std::vector<Mat> ref;
+    buildPyramid(src, ref, maxlevel, borderType);
+    std::vector<Mat> lref(maxlevel + 1);
+    int ldepth = CV_MAT_DEPTH(type) == CV_8U ? CV_16S : CV_MAT_DEPTH(type) == CV_64F ? CV_64F : CV_32F;
+    for( int i = 0; i < maxlevel; i++ )
+    {
+        Mat up;
+        pyrUp(ref[i+1], up, ref[i].size());
+        cv::subtract(ref[i], up, lref[i], noArray(), ldepth);
+    }
+    ref[maxlevel].convertTo(lref[maxlevel], ldepth);
+
+    int nthreads = getNumThreads();
+    const int threads[] = { 1, 4 };
+    for( int t = 0; t < 2; t++ )
+    {
+        setNumThreads(threads[t]);
+        std::vector<Mat> gauss, lap;
+        Mat buf;
+        buildPyramid(src, gauss, buf, maxlevel, PYRAMID_GAUSSIAN, borderType);
+        uchar* data = buf.data;
+        ASSERT_EQ(ref.size(), gauss.size());
+        for( int i = 0; i <= maxlevel; i++ )
+        {
+            ASSERT_EQ(ref[i].size(), gauss[i].size());
+            ASSERT_EQ(ref[i].type(), gauss[i].type());
+            EXPECT_EQ(0, cvtest::norm(ref[i], gauss[i], NORM_INF)) << "level=" << i << " threads=" << threads[t];
+        }
+
+        // the larger buffer is reused
+        buildPyramid(src, lap, buf, maxlevel, PYRAMID_LAPLACIAN, borderType);
+        buildPyramid(src, gauss, buf, maxlevel, PYRAMID_GAUSSIAN, borderType);
+        EXPECT_EQ(buf.data, gauss[1].data);
+        EXPECT_NE(data, (uchar*)0);
+        buildPyramid(src, lap, buf, maxlevel, PYRAMID_LAPLACIAN, borderType);
+        ASSERT_EQ(lref.size(), lap.size());
+        for( int i = 0; i <= maxlevel; i++ )
+        {
+            ASSERT_EQ(lref[i].type(), lap[i].type());
+            EXPECT_EQ(0, cvtest::norm(lref[i], lap[i], NORM_INF)) << "level=" << i << " threads=" << threads[t];
+        }
+    }
+    setNumThreads(nthreads);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_BuildPyramid, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_16UC1, CV_16SC2, CV_32FC1, CV_64FC1),
+    testing::Values(BORDER_REFLECT_101, BORDER_REPLICATE, BORDER_REFLECT, BORDER_WRAP)));
+
 
 // https://github.com/opencv/opencv/issues/16857
 TEST(Imgproc, filter_empty_src_16857)
@@ -2356,4 +2590,43 @@ TEST(Imgproc, filter_empty_src_16857)
 }
 
 
+TEST(Imgproc_Integral, bands)
+{
+    static const int depths[][3] = {
+        {CV_8U, CV_32S, CV_32S}, {CV_8U, CV_32S, CV_32F}, {CV_8U, CV_32S, CV_64F}, {CV_8U, CV_32F, CV_32F},
+        {CV_8U, CV_32F, CV_64F}, {CV_8U, CV_64F, CV_64F}, {CV_16U, CV_64F, CV_64F}, {CV_16S, CV_64F, CV_64F},
+        {CV_32F, CV_32F, CV_32F}, {CV_32F, CV_32F, CV_64F}, {CV_32F, CV_64F, CV_64F}, {CV_64F, CV_64F, CV_64F}
+    };
+    int nthreads = cv::getNumThreads();
+
+    for( size_t i = 0; i < sizeof(depths)/sizeof(depths[0]); i++ )
+        for( int cn = 1; cn <= 3; cn += 2 )
+        {
+            int depth = depths[i][0], sdepth = depths[i][1], sqdepth = depths[i][2];
+            Mat big(531, 277, CV_MAKETYPE(depth, cn));
+            randu(big, 0, depth == CV_16S ? 100 : 200);
+            if( depth == CV_16S )
+                big -= Scalar::all(50);
+            Mat src = big(Rect(3, 5, 270, 517));
+
+            Mat sum0, sqsum0, sum, sqsum, sum1;
+            cv::setNumThreads(1);
+            cv::integral(src, sum0, sqsum0, sdepth, sqdepth);
+            cv::setNumThreads(4);
+            cv::integral(src, sum, sqsum, sdepth, sqdepth);
+            cv::integral(src, sum1, sdepth);
+            cv::setNumThreads(nthreads);
+
+            ASSERT_EQ(sum0.type(), sum.type());
+            ASSERT_EQ(sqsum0.type(), sqsum.type());
+            // the sums of the integer values are exact, the floating-point ones are summed in different order
+            bool fp = depth == CV_32F || depth == CV_64F;
+            double eps = fp || sdepth == CV_32F ? 1e-5 : 0;
+            double sqeps = fp || sqdepth == CV_32F ? 1e-5 : 0;
+            EXPECT_LE(cvtest::norm(sum0, sum, NORM_INF | NORM_RELATIVE), eps) << i << " " << cn;
+            EXPECT_LE(cvtest::norm(sum0, sum1, NORM_INF | NORM_RELATIVE), eps) << i << " " << cn;
+            EXPECT_LE(cvtest::norm(sqsum0, sqsum, NORM_INF | NORM_RELATIVE), sqeps) << i << " " << cn;
+        }
+}
+
 }} // namespace
@@ -0,0 +1,121 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+#include "opencv2/imgproc/filter_pipeline.hpp"
+
+namespace opencv_test { namespace {
+
+typedef testing::TestWithParam<int> Imgproc_FilterPipeline_Stripes;
+
+TEST_P(Imgproc_FilterPipeline_Stripes, edges)
+{
+    const int stripeHeight = GetParam();
+    RNG& rng = theRNG();
+    Mat src(237, 319, CV_8UC3);
+    rng.fill(src, RNG::UNIFORM, 0, 256);
+    GaussianBlur(src, src, Size(7, 7), 2);
+
+    // reference: the same chain of full-image calls
+    Mat gray, blurred, dx, dy, mag, ref;
+    cvtColor(src, gray, COLOR_BGR2GRAY);
+    gray.convertTo(gray, CV_32F, 1./255);
+    GaussianBlur(gray, blurred, Size(5, 5), 1.2, 0, BORDER_REPLICATE);
+    Sobel(blurred, dx, CV_32F, 1, 0, 3, 1, 0, BORDER_REFLECT_101);
+    Sobel(blurred, dy, CV_32F, 0, 1, 3, 1, 0, BORDER_REFLECT_101);
+    magnitude(dx, dy, mag);
+    cv::threshold(mag, ref, 0.05, 1, THRESH_BINARY);
+
+    FilterPipeline pipeline;
+    pipeline.cvtColor(COLOR_BGR2GRAY)
+            .convertTo(CV_32F, 1./255)
+            .GaussianBlur(Size(5, 5), 1.2, 0, BORDER_REPLICATE)
+            .gradient(CV_32F, 3, 1, BORDER_REFLECT_101)
+            .magnitude()
+            .setStripeHeight(stripeHeight);
+    ASSERT_EQ(5u, pipeline.size());
+
+    Mat res;
+    pipeline.apply(src, res);
+    ASSERT_EQ(CV_32FC1, res.type());
+    EXPECT_LE(cvtest::norm(mag, res, NORM_INF), 1e-5);
+
+    pipeline.threshold(0.05, 1, THRESH_BINARY);
+    pipeline.apply(src, res);
+    // the pixels exactly at the threshold may flip due to the rounding errors
+    EXPECT_LE(cvtest::norm(ref, res, NORM_L1), 3.);
+}
+
+TEST_P(Imgproc_FilterPipeline_Stripes, filters)
+{
+    const int stripeHeight = GetParam();
+    RNG& rng = theRNG();
+    Mat src(150, 97, CV_8UC1);
+    rng.fill(src, RNG::UNIFORM, 0, 256);
+
+    Mat kernel2D(5, 3, CV_32F), kx(1, 7, CV_32F), ky(1, 3, CV_32F);
+    rng.fill(kernel2D, RNG::UNIFORM, -1, 1);
+    rng.fill(kx, RNG::UNIFORM, -1, 1);
+    rng.fill(ky, RNG::UNIFORM, -1, 1);
+    Mat element = getStructuringElement(MORPH_ELLIPSE, Size(5, 5));
+
+    Mat t0, t1, t2, t3, ref;
+    boxFilter(src, t0, CV_16S, Size(3, 5), Point(-1, -1), false, BORDER_REFLECT);
+    cv::filter2D(t0, t1, CV_32F, kernel2D, Point(1, 1), 3, BORDER_CONSTANT);
+    sepFilter2D(t1, t2, CV_32F, kx, ky, Point(-1, -1), 0, BORDER_REPLICATE);
+    cv::dilate(t2, t3, element, Point(-1, -1), 2, BORDER_CONSTANT);
+    cv::erode(t3, ref, Mat(), Point(-1, -1), 1, BORDER_REFLECT_101);
+
+    FilterPipeline pipeline;
+    pipeline.boxFilter(CV_16S, Size(3, 5), Point(-1, -1), false, BORDER_REFLECT)
+            .filter2D(CV_32F, kernel2D, Point(1, 1), 3, BORDER_CONSTANT)
+            .sepFilter2D(CV_32F, kx, ky, Point(-1, -1), 0, BORDER_REPLICATE)
+            .dilate(element, Point(-1, -1), 2, BORDER_CONSTANT)
+            .erode(Mat(), Point(-1, -1), 1, BORDER_REFLECT_101)
+            .setStripeHeight(stripeHeight);
+    ASSERT_EQ(6u, pipeline.size());
+
+    Mat res;
+    pipeline.apply(src, res);
+    ASSERT_EQ(ref.type(), res.type());
+    EXPECT_LE(cvtest::norm(ref, res, NORM_INF | NORM_RELATIVE), 1e-6);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_FilterPipeline_Stripes, testing::Values(0, 1, 3, 16, 1000));
+
+TEST(Imgproc_FilterPipeline, pointwise_inplace)
+{
+    Mat src(64, 80, CV_8UC1);
+    randu(src, 0, 256);
+
+    Mat ref;
+    Sobel(src, ref, CV_16S, 1, 1, 5);
+    ref.convertTo(ref, CV_8U, 0.5, 128);
+
+    FilterPipeline pipeline;
+    pipeline.Sobel(CV_16S, 1, 1, 5)
+            .pointwise([](const Mat& s, Mat& d) { s.convertTo(d, CV_8U, 0.5, 128); }, CV_8UC1)
+            .setStripeHeight(7);
+
+    Mat img = src.clone();
+    pipeline.apply(img, img);
+    EXPECT_EQ(0, cvtest::norm(ref, img, NORM_INF));
+}
+
+TEST(Imgproc_FilterPipeline, bad_stages)
+{
+    Mat bgr(16, 16, CV_8UC3, Scalar::all(1)), dst;
+    EXPECT_ANY_THROW(FilterPipeline().cvtColor(COLOR_BayerBG2BGR));
+    EXPECT_ANY_THROW(FilterPipeline().threshold(0, 255, THRESH_OTSU));
+    EXPECT_ANY_THROW(FilterPipeline().cvtColor(COLOR_BGR2YUV_I420).apply(bgr, dst));
+    EXPECT_ANY_THROW(FilterPipeline().magnitude().apply(bgr, dst));
+    EXPECT_ANY_THROW(FilterPipeline().gradient().apply(bgr, dst));
+    EXPECT_ANY_THROW(FilterPipeline().pointwise([](const Mat& s, Mat& d) { s.convertTo(d, CV_32F); }).apply(bgr, dst));
+
+    FilterPipeline empty;
+    empty.apply(bgr, dst);
+    EXPECT_EQ(0, cvtest::norm(bgr, dst, NORM_INF));
+}
+
+}} // namespace
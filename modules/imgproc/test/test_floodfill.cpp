@@ -541,5 +541,55 @@ TEST(Imgproc_FloodFill, maskValue)
     ASSERT_EQ(1, cvtest::norm(mask.rowRange(1, n-1).colRange(1, n-1), NORM_INF));
 }
 
+TEST(Imgproc_FloodFill, regions)
+{
+    RNG& rng = theRNG();
+    const int types[] = { CV_8UC1, CV_8UC3, CV_32FC1 };
+    const int flagsList[] = { 4, 8, 4 | FLOODFILL_FIXED_RANGE, 8 | FLOODFILL_FIXED_RANGE };
+    for( int t = 0; t < 3; t++ )
+        for( int f = 0; f < 4; f++ )
+        {
+            Mat img(150, 201, types[t]);
+            rng.fill(img, RNG::UNIFORM, 0, 256);
+            cv::GaussianBlur(img, img, Size(0, 0), 3);
+
+            std::vector<Point> seeds;
+            for( int i = 0; i < 60; i++ )
+                seeds.push_back(Point(rng.uniform(0, img.cols), rng.uniform(0, img.rows)));
+            seeds.push_back(seeds[3]);
+            Scalar lo = Scalar::all(2), up = Scalar::all(3);
+            int flags = flagsList[f];
+
+            Mat labels, stats, means;
+            int nregions = floodFillRegions(img, seeds, labels, stats, means, lo, up, flags);
+            ASSERT_EQ(CV_32SC1, labels.type());
+            ASSERT_EQ(Size(CC_STAT_MAX, (int)seeds.size()), stats.size());
+            ASSERT_EQ(Size(img.channels(), (int)seeds.size()), means.size());
+
+            // the successive fills of the same mask
+            Mat mask = Mat::zeros(img.rows + 2, img.cols + 2, CV_8U);
+            int nref = 0;
+            for( int i = 0; i < (int)seeds.size(); i++ )
+            {
+                Rect rect;
+                int area = floodFill(img, mask, seeds[i], Scalar(), &rect, lo, up,
+                                     flags | FLOODFILL_MASK_ONLY | ((i + 1) << 8));
+                Mat region = mask(Rect(1, 1, img.cols, img.rows)) == i + 1;
+                ASSERT_EQ(0, countNonZero(region != (labels == i + 1))) << t << " " << f << " " << i;
+                const int* s = stats.ptr<int>(i);
+                EXPECT_EQ(area, s[CC_STAT_AREA]);
+                if( area == 0 )
+                    continue;
+                nref++;
+                EXPECT_EQ(rect, Rect(s[CC_STAT_LEFT], s[CC_STAT_TOP], s[CC_STAT_WIDTH], s[CC_STAT_HEIGHT]));
+                Scalar m = cv::mean(img, region);
+                for( int c = 0; c < img.channels(); c++ )
+                    EXPECT_NEAR(m[c], means.at<double>(i, c), 1e-6);
+            }
+            EXPECT_EQ(nref, nregions);
+            EXPECT_EQ(0, stats.at<int>((int)seeds.size() - 1, CC_STAT_AREA));
+        }
+}
+
 }} // namespace
 /* End of file. */
@@ -1994,5 +1994,86 @@ TEST(Imgproc_Hist_Calc, badarg)
 }
 
 
+static Mat calcHist1DReference(const Mat& img, const Mat& mask, int histSize, const float* range, bool uniform)
+{
+    Mat hist = Mat::zeros(histSize, 1, CV_32F);
+    double a = histSize/((double)range[1] - range[0]), b = -a*range[0];
+    for( int y = 0; y < img.rows; y++ )
+        for( int x = 0; x < img.cols; x++ )
+        {
+            if( !mask.empty() && !mask.at<uchar>(y, x) )
+                continue;
+            double v = img.depth() == CV_16U ? (double)img.at<ushort>(y, x) : (double)img.at<float>(y, x);
+            int idx = -1;
+            if( uniform )
+            {
+                if( v >= range[0] && v < range[1] )
+                    idx = std::min(std::max(cvFloor(v*a + b), 0), histSize - 1);
+            }
+            else
+                idx = (int)(std::upper_bound(range, range + histSize + 1, v) - range) - 1;
+            if( idx >= 0 && idx < histSize )
+                hist.at<float>(idx)++;
+        }
+    return hist;
+}
+
+TEST(Imgproc_Hist_Calc, parallel_16u_32f)
+{
+    const int histSize = 4096;
+    Mat img16u(600, 701, CV_16UC1), img32f(600, 701, CV_32FC1), mask(600, 701, CV_8UC1);
+    randu(img16u, 0, 65536);
+    randu(img32f, -10.f, 1200.f);
+    randu(mask, 0, 2);
+    img32f.at<float>(5, 5) = 1000.f; // the upper boundary
+    img32f.at<float>(5, 6) = 0.f;
+
+    float range16u[] = { 100.f, 60000.f }, range32f[] = { 0.f, 1000.f };
+    std::vector<float> edges(histSize + 1);
+    for( int i = 0; i <= histSize; i++ )
+        edges[i] = 20.f + i*i*0.003f;
+
+    int nthreads = getNumThreads();
+    const int threads[] = { 1, 4 };
+    for( int t = 0; t < 2; t++ )
+    {
+        setNumThreads(threads[t]);
+        for( int m = 0; m < 2; m++ )
+        {
+            Mat msk = m ? mask : Mat(), hist;
+            const int channels[] = { 0 };
+            const float* ranges16u[] = { range16u };
+            const float* ranges32f[] = { range32f };
+            const float* rangesNonUniform[] = { &edges[0] };
+
+            cv::calcHist(&img16u, 1, channels, msk, hist, 1, &histSize, ranges16u, true);
+            EXPECT_EQ(0, cvtest::norm(calcHist1DReference(img16u, msk, histSize, range16u, true), hist, NORM_INF));
+
+            cv::calcHist(&img16u, 1, channels, msk, hist, 1, &histSize, rangesNonUniform, false);
+            EXPECT_EQ(0, cvtest::norm(calcHist1DReference(img16u, msk, histSize, &edges[0], false), hist, NORM_INF));
+
+            cv::calcHist(&img32f, 1, channels, msk, hist, 1, &histSize, ranges32f, true);
+            EXPECT_EQ(0, cvtest::norm(calcHist1DReference(img32f, msk, histSize, range32f, true), hist, NORM_INF));
+
+            // a column of the image is not continuous
+            Mat roi = img32f.colRange(3, 600), mroi = msk.empty() ? Mat() : msk.colRange(3, 600);
+            cv::calcHist(&roi, 1, channels, mroi, hist, 1, &histSize, ranges32f, true);
+            EXPECT_EQ(0, cvtest::norm(calcHist1DReference(roi, mroi, histSize, range32f, true), hist, NORM_INF));
+        }
+    }
+
+    // the parallel back projection gives the same result
+    Mat hist, bp1, bp4;
+    const int channels[] = { 0 };
+    const float* ranges32f[] = { range32f };
+    cv::calcHist(&img32f, 1, channels, Mat(), hist, 1, &histSize, ranges32f, true);
+    setNumThreads(1);
+    cv::calcBackProject(&img32f, 1, channels, hist, bp1, ranges32f, 0.5, true);
+    setNumThreads(4);
+    cv::calcBackProject(&img32f, 1, channels, hist, bp4, ranges32f, 0.5, true);
+    EXPECT_EQ(0, cvtest::norm(bp1, bp4, NORM_INF));
+    setNumThreads(nthreads);
+}
+
 }} // namespace
 /* End Of File */
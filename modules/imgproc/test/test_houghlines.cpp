@@ -319,4 +319,68 @@ INSTANTIATE_TEST_CASE_P( Imgproc, HoughLinesPointSetTest, testing::Combine(testi
                                                                            testing::Values( (CV_PI / 2.0f), (CV_PI * 5.0f / 12.0f) )
                                                                            ));
 
+TEST(Imgproc_HoughLines, parallel_accumulator)
+{
+    Mat img(480, 640, CV_8UC1);
+    randu(img, 0, 256);
+    cv::GaussianBlur(img, img, Size(0, 0), 3);
+    Canny(img, img, 10, 30);
+    for( int i = 0; i < 5; i++ )
+        line(img, Point(50*i, 0), Point(600 - 70*i, 479), Scalar::all(255));
+
+    int nthreads = getNumThreads();
+    Mat ref, dst;
+    setNumThreads(1);
+    HoughLines(img, ref, 1, CV_PI/180, 100, 0, 0, 0.1, 2.5);
+    setNumThreads(4);
+    HoughLines(img, dst, 1, CV_PI/180, 100, 0, 0, 0.1, 2.5);
+    setNumThreads(nthreads);
+
+    ASSERT_EQ(ref.size(), dst.size());
+    ASSERT_GE(ref.total(), 5u);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+}
+
+TEST(Imgproc_HoughLinesSegments, synthetic)
+{
+    const Vec4i segments[] = { Vec4i(20, 30, 300, 40), Vec4i(400, 20, 420, 400), Vec4i(100, 400, 500, 150),
+                               Vec4i(50, 100, 250, 300) };
+    const int nsegments = (int)(sizeof(segments)/sizeof(segments[0]));
+    Mat img(480, 640, CV_8UC1, Scalar::all(0));
+    for( int i = 0; i < nsegments; i++ )
+        line(img, Point(segments[i][0], segments[i][1]), Point(segments[i][2], segments[i][3]), Scalar::all(255));
+    // the small gap is bridged, the segments are not joined across the large one
+    line(img, Point(80, 450), Point(200, 450), Scalar::all(255));
+    line(img, Point(205, 450), Point(330, 450), Scalar::all(255));
+    line(img, Point(360, 450), Point(600, 450), Scalar::all(255));
+
+    int nthreads = getNumThreads();
+    std::vector<Vec4i> lines, lines1;
+    setNumThreads(1);
+    HoughLinesSegments(img, lines1, 1, CV_PI/180, 50, 30, 10);
+    setNumThreads(4);
+    HoughLinesSegments(img, lines, 1, CV_PI/180, 50, 30, 10);
+    setNumThreads(nthreads);
+    ASSERT_EQ(lines1.size(), lines.size());
+    for( size_t j = 0; j < lines.size(); j++ )
+        EXPECT_EQ(lines1[j], lines[j]);
+
+    const Vec4i expected[] = { segments[0], segments[1], segments[2], segments[3],
+                               Vec4i(80, 450, 330, 450), Vec4i(360, 450, 600, 450) };
+    for( int i = 0; i < 6; i++ )
+    {
+        const Vec4i& e = expected[i];
+        bool found = false;
+        for( size_t j = 0; j < lines.size() && !found; j++ )
+        {
+            const Vec4i& l = lines[j];
+            double d0 = cv::norm(Point(l[0], l[1]) - Point(e[0], e[1])) + cv::norm(Point(l[2], l[3]) - Point(e[2], e[3]));
+            double d1 = cv::norm(Point(l[0], l[1]) - Point(e[2], e[3])) + cv::norm(Point(l[2], l[3]) - Point(e[0], e[1]));
+            found = std::min(d0, d1) <= 4;
+        }
+        EXPECT_TRUE(found) << e;
+    }
+    EXPECT_LE(lines.size(), 8u);
+}
+
 }} // namespace
@@ -1317,6 +1317,56 @@ TEST(Imgproc_resize_area, regression_quarter_round)
 
 TEST(Imgproc_Resize, accuracy) { CV_ResizeTest test; test.safe_run(); }
 TEST(Imgproc_ResizeExact, accuracy) { CV_ResizeExactTest test; test.safe_run(); }
+
+TEST(Imgproc_Resize, batch)
+{
+    Mat src(217, 301, CV_8UC3);
+    randu(src, 0, 256);
+    std::vector<Rect> rois;
+    for( int i = 0; i < 30; i++ )
+        rois.push_back(Rect((i*37) % 200, (i*23) % 150, 10 + (i % 5)*20, 8 + (i % 3)*21));
+    rois.push_back(Rect(0, 0, 64, 32)); // 2x downscale
+    rois.push_back(Rect(5, 5, 32, 16)); // no resize
+
+    const int interps[] = { INTER_NEAREST, INTER_LINEAR, INTER_CUBIC, INTER_AREA, INTER_LANCZOS4,
+                            INTER_LINEAR_EXACT, INTER_NEAREST_EXACT };
+    Size dsize(32, 16);
+    for( size_t k = 0; k < sizeof(interps)/sizeof(interps[0]); k++ )
+    {
+        Mat dst;
+        resizeBatch(src, rois, dst, dsize, interps[k]);
+        ASSERT_EQ(3, dst.dims);
+        ASSERT_EQ((int)rois.size(), dst.size[0]);
+        ASSERT_EQ(src.type(), dst.type());
+        for( size_t i = 0; i < rois.size(); i++ )
+        {
+            Mat ref;
+            cv::resize(src(rois[i]), ref, dsize, 0, 0, interps[k]);
+            Mat res(dsize, dst.type(), dst.ptr((int)i));
+            EXPECT_EQ(0, cvtest::norm(ref, res, NORM_INF)) << "interpolation=" << interps[k] << " roi=" << i;
+        }
+    }
+
+    // the planar layout, the preallocated destination is reused
+    int sz[] = { (int)rois.size(), 3, dsize.height, dsize.width };
+    Mat planar(4, sz, CV_8U);
+    uchar* data = planar.data;
+    resizeBatch(src, rois, planar, dsize, INTER_CUBIC, true);
+    EXPECT_EQ(data, planar.data);
+    for( size_t i = 0; i < rois.size(); i++ )
+    {
+        Mat ref, planes[3];
+        cv::resize(src(rois[i]), ref, dsize, 0, 0, INTER_CUBIC);
+        cv::split(ref, planes);
+        for( int c = 0; c < 3; c++ )
+            EXPECT_EQ(0, cvtest::norm(planes[c], Mat(dsize, CV_8U, planar.ptr((int)i, c)), NORM_INF));
+    }
+
+    Mat empty = planar;
+    resizeBatch(src, std::vector<Rect>(), empty, dsize);
+    EXPECT_TRUE(empty.empty());
+    EXPECT_ANY_THROW(resizeBatch(src, std::vector<Rect>(1, Rect(300, 0, 2, 2)), empty, dsize));
+}
 TEST(Imgproc_WarpAffine, accuracy) { CV_WarpAffineTest test; test.safe_run(); }
 TEST(Imgproc_WarpPerspective, accuracy) { CV_WarpPerspectiveTest test; test.safe_run(); }
 TEST(Imgproc_Remap, accuracy) { CV_RemapTest test; test.safe_run(); }
@@ -1511,6 +1561,109 @@ TEST(Imgproc_Remap, DISABLED_memleak)
     }
 }
 
+static void makeRadialDistortionMaps(Size size, Mat& mapx, Mat& mapy)
+{
+    mapx.create(size, CV_32FC1);
+    mapy.create(size, CV_32FC1);
+    double cx = size.width*0.47, cy = size.height*0.53, f = size.width*0.8;
+    for( int y = 0; y < size.height; y++ )
+        for( int x = 0; x < size.width; x++ )
+        {
+            double u = (x - cx)/f, v = (y - cy)/f, r2 = u*u + v*v;
+            double k = 1 - 0.25*r2 + 0.05*r2*r2;
+            mapx.at<float>(y, x) = (float)(cx + u*k*f);
+            mapy.at<float>(y, x) = (float)(cy + v*k*f);
+        }
+}
+
+TEST(Imgproc_CompiledRemap, accuracy)
+{
+    const int types[] = { CV_8UC1, CV_8UC3, CV_16UC4, CV_32FC1, CV_32FC3 };
+    const int interpolations[] = { INTER_NEAREST, INTER_LINEAR, INTER_CUBIC, INTER_LANCZOS4 };
+    const int borders[] = { BORDER_CONSTANT, BORDER_REPLICATE, BORDER_REFLECT_101 };
+    RNG& rng = theRNG();
+
+    for( int iter = 0; iter < 30; iter++ )
+    {
+        int type = types[iter % 5], interpolation = interpolations[iter % 4], border = borders[iter % 3];
+        Size ssize(rng.uniform(1, 200), rng.uniform(1, 200)), dsize(rng.uniform(1, 300), rng.uniform(1, 300));
+        Mat src(ssize, type), mapx(dsize, CV_32FC1), mapy(dsize, CV_32FC1), ref, dst;
+        randu(src, 0, 256);
+        randu(mapx, -10, ssize.width + 10);
+        randu(mapy, -10, ssize.height + 10);
+
+        // the maps are converted in the same way as in remap, so the results are bit-exact
+        cv::remap(src, ref, mapx, mapy, interpolation, border, Scalar::all(17));
+        CompiledRemap compiled(mapx, mapy, interpolation, 0.05);
+        ASSERT_EQ(0, compiled.getGridStep());
+        ASSERT_EQ(dsize, compiled.size());
+        compiled.apply(src, dst, border, Scalar::all(17));
+        EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF)) << "iter=" << iter;
+    }
+}
+
+TEST(Imgproc_CompiledRemap, compressed)
+{
+    Size size(1000, 750);
+    Mat src(size, CV_8UC3), mapx, mapy, ref, dst;
+    randu(src, 0, 256);
+    cv::GaussianBlur(src, src, Size(0, 0), 1.5);
+    makeRadialDistortionMaps(size, mapx, mapy);
+
+    CompiledRemap compiled(mapx, mapy, INTER_LINEAR, 0.02);
+    EXPECT_GE(compiled.getGridStep(), 8);
+    cv::remap(src, ref, mapx, mapy, INTER_LINEAR, BORDER_REFLECT);
+    compiled.apply(src, dst, BORDER_REFLECT);
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 2);
+
+    // the error bound selects the denser grid
+    CompiledRemap fine(mapx, mapy, INTER_LINEAR, 0.002);
+    EXPECT_LT(fine.getGridStep(), compiled.getGridStep());
+    fine.apply(src, dst, BORDER_REFLECT);
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 1);
+
+    // the affine maps are interpolated exactly, even if they are not divisible by the grid step
+    Mat A = getRotationMatrix2D(Point2f(300, 200), 30, 0.9), affx(333, 517, CV_32FC1), affy(333, 517, CV_32FC1);
+    for( int y = 0; y < affx.rows; y++ )
+        for( int x = 0; x < affx.cols; x++ )
+        {
+            affx.at<float>(y, x) = (float)(A.at<double>(0, 0)*x + A.at<double>(0, 1)*y + A.at<double>(0, 2));
+            affy.at<float>(y, x) = (float)(A.at<double>(1, 0)*x + A.at<double>(1, 1)*y + A.at<double>(1, 2));
+        }
+    CompiledRemap affine(affx, affy, INTER_NEAREST, 1e-3);
+    EXPECT_EQ(64, affine.getGridStep());
+    cv::remap(src, ref, affx, affy, INTER_NEAREST);
+    affine.apply(src, dst);
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_L1)/ref.total(), 1);
+}
+
+TEST(Imgproc_CompiledRemap, map_formats)
+{
+    Size size(150, 110);
+    Mat src(size, CV_8UC1), mapx, mapy, map2c, fixed1, fixed2, ref, dst;
+    randu(src, 0, 256);
+    makeRadialDistortionMaps(size, mapx, mapy);
+    cv::remap(src, ref, mapx, mapy, INTER_LINEAR, BORDER_CONSTANT, Scalar::all(5));
+
+    Mat planes[] = { mapx, mapy };
+    merge(planes, 2, map2c);
+    CompiledRemap(map2c, noArray()).apply(src, dst, BORDER_CONSTANT, Scalar::all(5));
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    convertMaps(mapx, mapy, fixed1, fixed2, CV_16SC2);
+    CompiledRemap(fixed1, fixed2).apply(src, dst, BORDER_CONSTANT, Scalar::all(5));
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    // in-place operation
+    CompiledRemap compiled(mapx, mapy);
+    compiled.apply(src, src, BORDER_CONSTANT, Scalar::all(5));
+    EXPECT_EQ(0, cvtest::norm(ref, src, NORM_INF));
+
+    EXPECT_TRUE(CompiledRemap().empty());
+    EXPECT_ANY_THROW(CompiledRemap().apply(src, dst));
+    EXPECT_ANY_THROW(CompiledRemap(mapx, mapy, INTER_LINEAR_EXACT));
+}
+
 //** @deprecated */
 TEST(Imgproc_linearPolar, identity)
 {
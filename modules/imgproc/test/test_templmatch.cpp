@@ -40,6 +40,7 @@
 //M*/
 
 #include "test_precomp.hpp"
+#include "opencv2/imgproc/template_matcher.hpp"
 
 namespace opencv_test { namespace {
 
@@ -334,4 +335,112 @@ void CV_TemplMatchTest::prepare_to_validation( int /*test_case_idx*/ )
 
 TEST(Imgproc_MatchTemplate, accuracy) { CV_TemplMatchTest test; test.safe_run(); }
 
+static Mat makeTemplateMatcherImage(int type)
+{
+    Mat img(240, 320, type);
+    randu(img, 0, 256);
+    cv::GaussianBlur(img, img, Size(0, 0), 3);
+    return img;
+}
+
+TEST(Imgproc_TemplateMatcher, batch)
+{
+    const int types[] = { CV_8UC1, CV_8UC3, CV_32FC1 };
+    for( int ti = 0; ti < 3; ti++ )
+    {
+        Mat img = makeTemplateMatcherImage(types[ti]);
+        std::vector<Mat> templs;
+        templs.push_back(img(Rect(10, 20, 16, 12)).clone());
+        templs.push_back(img(Rect(100, 50, 45, 60)).clone());
+        templs.push_back(img(Rect(200, 150, 7, 33)).clone() + Scalar::all(3));
+        templs.push_back(Mat(9, 9, types[ti], Scalar::all(100)));
+
+        TemplateMatcher matcher(img);
+        EXPECT_EQ(img.size(), matcher.getImageSize());
+        for( int method = TM_SQDIFF; method <= TM_CCOEFF_NORMED; method++ )
+        {
+            std::vector<Mat> results;
+            matcher.matchBatch(templs, results, method);
+            ASSERT_EQ(templs.size(), results.size());
+            for( size_t i = 0; i < templs.size(); i++ )
+            {
+                Mat ref, dst;
+                cv::matchTemplate(img, templs[i], ref, method);
+                ASSERT_EQ(CV_32FC1, results[i].type());
+                ASSERT_EQ(ref.size(), results[i].size());
+
+                // the rounding errors of the transforms are proportional to the correlation values
+                double tol;
+                if( method == TM_SQDIFF_NORMED || method == TM_CCORR_NORMED || method == TM_CCOEFF_NORMED )
+                    tol = img.depth() == CV_8U ? 1e-2 : 1e-3;
+                else
+                {
+                    cv::matchTemplate(img, templs[i], dst, TM_CCORR);
+                    tol = 1e-5*cvtest::norm(dst, NORM_INF);
+                }
+                EXPECT_LE(cvtest::norm(ref, results[i], NORM_INF), tol) << types[ti] << " " << method << " " << i;
+
+                // the single template reuses the cached spectra
+                matcher.match(templs[i], dst, method);
+                EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), tol) << types[ti] << " " << method << " " << i;
+            }
+        }
+    }
+}
+
+TEST(Imgproc_TemplateMatcher, search)
+{
+    Mat img = makeTemplateMatcherImage(CV_8UC3);
+    Rect rois[] = { Rect(20, 30, 40, 32), Rect(150, 100, 64, 48), Rect(250, 180, 20, 24) };
+    std::vector<Mat> templs;
+    for( int i = 0; i < 3; i++ )
+        templs.push_back(img(rois[i]).clone());
+    Mat noise(30, 30, CV_8UC3);
+    randu(noise, 0, 256);
+    templs.push_back(noise);
+
+    const int methods[] = { TM_SQDIFF_NORMED, TM_CCORR_NORMED, TM_CCOEFF_NORMED };
+    const double thresholds[] = { 1e-3, 0.999, 0.95 };
+    for( int m = 0; m < 3; m++ )
+    {
+        TemplateMatcher matcher(img);
+        std::vector<TemplateMatcher::Match> matches, full;
+        matcher.search(templs, matches, methods[m], thresholds[m]);
+        matcher.search(templs, full, methods[m], thresholds[m], 0);
+
+        for( int i = 0; i < 3; i++ )
+        {
+            bool found = false;
+            for( size_t j = 0; j < matches.size(); j++ )
+                found |= matches[j].templateIdx == i && matches[j].location == rois[i].tl();
+            EXPECT_TRUE(found) << methods[m] << " " << i;
+        }
+        for( size_t j = 0; j < matches.size(); j++ )
+            EXPECT_NE(3, matches[j].templateIdx) << methods[m];
+
+        // the pyramid search finds the same peaks as the full one
+        ASSERT_EQ(full.size(), matches.size()) << methods[m];
+        for( size_t j = 0; j < matches.size(); j++ )
+        {
+            EXPECT_EQ(full[j].templateIdx, matches[j].templateIdx);
+            EXPECT_EQ(full[j].location, matches[j].location);
+            EXPECT_NEAR(full[j].score, matches[j].score, 1e-4);
+        }
+    }
+}
+
+TEST(Imgproc_TemplateMatcher, bad_args)
+{
+    Mat img = makeTemplateMatcherImage(CV_8UC1), result;
+    std::vector<TemplateMatcher::Match> matches;
+    EXPECT_ANY_THROW(TemplateMatcher().match(img(Rect(0, 0, 8, 8)), result, TM_CCORR));
+
+    TemplateMatcher matcher(img);
+    Mat templ32f;
+    img(Rect(0, 0, 8, 8)).convertTo(templ32f, CV_32F);
+    EXPECT_ANY_THROW(matcher.match(templ32f, result, TM_CCORR));
+    EXPECT_ANY_THROW(matcher.match(Mat(300, 10, CV_8UC1, Scalar::all(0)), result, TM_CCORR));
+    EXPECT_ANY_THROW(matcher.search(std::vector<Mat>(1, img(Rect(0, 0, 8, 8))), matches, TM_CCORR, 0.5));
+}
+
 }} // namespace
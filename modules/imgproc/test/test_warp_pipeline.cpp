@@ -0,0 +1,153 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+#include "opencv2/imgproc/warp_pipeline.hpp"
+
+namespace opencv_test { namespace {
+
+static Mat makeWarpPipelineTestImage(int type)
+{
+    Mat img(181, 243, type);
+    randu(img, 0, 256);
+    cv::GaussianBlur(img, img, Size(0, 0), 2);
+    return img;
+}
+
+TEST(Imgproc_WarpPipeline, perspective_color_resize)
+{
+    Mat src = makeWarpPipelineTestImage(CV_8UC3);
+    Matx33d H(0.9, 0.15, -10, -0.1, 1.1, 5, 1e-4, 2e-4, 1);
+    Size warpSize(200, 160), dsize(64, 48);
+
+    // the single interpolation is equivalent to the warp with the composed matrix
+    Matx33d S(64./200, 0, 0.5*64/200 - 0.5, 0, 48./160, 0.5*48/160 - 0.5, 0, 0, 1);
+    Mat ref;
+    cv::warpPerspective(src, ref, S*H, dsize, INTER_LINEAR, BORDER_REFLECT);
+    cv::cvtColor(ref, ref, COLOR_BGR2GRAY);
+    ref.convertTo(ref, CV_32F, 1./255);
+
+    WarpPipeline pipeline;
+    pipeline.warpPerspective(H, warpSize)
+            .cvtColor(COLOR_BGR2GRAY)
+            .resize(dsize)
+            .convertTo(CV_32F, 1./255)
+            .setBorder(BORDER_REFLECT);
+    ASSERT_EQ(4u, pipeline.size());
+    EXPECT_EQ(dsize, pipeline.getDstSize(src.size()));
+
+    Mat dst;
+    pipeline.apply(src, dst);
+    ASSERT_EQ(CV_32FC1, dst.type());
+    ASSERT_EQ(dsize, dst.size());
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 2./255);
+}
+
+TEST(Imgproc_WarpPipeline, affine_crop_remap)
+{
+    Mat src = makeWarpPipelineTestImage(CV_32FC1);
+    Mat A = getRotationMatrix2D(Point2f(120, 90), 15, 0.8);
+    Rect roi(30, 20, 100, 90);
+
+    Mat map1(roi.size(), CV_32FC1), map2(roi.size(), CV_32FC1);
+    for( int y = 0; y < roi.height; y++ )
+        for( int x = 0; x < roi.width; x++ )
+        {
+            map1.at<float>(y, x) = x*1.1f + 3.f;
+            map2.at<float>(y, x) = y*0.9f + x*0.05f;
+        }
+
+    // the maps are evaluated at the integer points, so the only difference is the interpolation of the warp
+    Mat A3 = Mat::eye(3, 3, CV_64F);
+    A.copyTo(A3.rowRange(0, 2));
+    Mat T = (Mat_<double>(3, 3) << 1, 0, -roi.x, 0, 1, -roi.y, 0, 0, 1);
+    Mat mapx(roi.size(), CV_32FC1), mapy(roi.size(), CV_32FC1);
+    Mat Minv = (T*A3).inv();
+    for( int y = 0; y < roi.height; y++ )
+        for( int x = 0; x < roi.width; x++ )
+        {
+            Mat p = Minv*(Mat_<double>(3, 1) << map1.at<float>(y, x), map2.at<float>(y, x), 1);
+            mapx.at<float>(y, x) = (float)(p.at<double>(0)/p.at<double>(2));
+            mapy.at<float>(y, x) = (float)(p.at<double>(1)/p.at<double>(2));
+        }
+    Mat ref, dst;
+    cv::remap(src, ref, mapx, mapy, INTER_CUBIC, BORDER_CONSTANT, Scalar::all(7));
+
+    WarpPipeline pipeline;
+    pipeline.warpAffine(A, Size(300, 250))
+            .crop(roi)
+            .remap(map1, map2)
+            .setInterpolation(INTER_CUBIC)
+            .setBorder(BORDER_CONSTANT, Scalar::all(7));
+    pipeline.apply(src, dst);
+    ASSERT_EQ(roi.size(), dst.size());
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 0.5);
+
+    // the points outside of the intermediate images get the border value
+    Mat shifted = map1 + 1000;
+    WarpPipeline outside;
+    outside.remap(shifted, map2).resize(Size(), 0.5, 0.5);
+    outside.apply(src, dst);
+    EXPECT_EQ(Size(50, 45), dst.size());
+    EXPECT_EQ(0, cvtest::norm(dst, NORM_INF));
+}
+
+TEST(Imgproc_WarpPipeline, resize)
+{
+    Mat src = makeWarpPipelineTestImage(CV_8UC4), ref, dst;
+    cv::resize(src, ref, Size(), 1.7, 1.3, INTER_LINEAR);
+
+    WarpPipeline pipeline;
+    pipeline.resize(Size(), 1.7, 1.3).setBorder(BORDER_REPLICATE);
+    pipeline.apply(src, dst);
+    ASSERT_EQ(ref.size(), dst.size());
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 2);
+}
+
+TEST(Imgproc_WarpPipeline, batch)
+{
+    Mat src = makeWarpPipelineTestImage(CV_8UC3);
+    std::vector<WarpPipeline> pipelines;
+    for( int i = 0; i < 40; i++ )
+    {
+        WarpPipeline p;
+        Mat A = getRotationMatrix2D(Point2f(20.f + i*5, 30.f + i*3), i*9., 1 + i*0.01);
+        p.warpAffine(A, Size(40, 40)).resize(Size(16 + i, 16));
+        if( i % 2 )
+            p.cvtColor(COLOR_BGR2HSV);
+        pipelines.push_back(p);
+    }
+    pipelines.push_back(WarpPipeline());
+
+    std::vector<Mat> dst;
+    WarpPipeline::applyBatch(src, pipelines, dst);
+    ASSERT_EQ(pipelines.size(), dst.size());
+    for( size_t i = 0; i < pipelines.size(); i++ )
+    {
+        Mat ref;
+        pipelines[i].apply(src, ref);
+        EXPECT_EQ(ref.type(), dst[i].type());
+        EXPECT_EQ(0, cvtest::norm(ref, dst[i], NORM_INF)) << i;
+    }
+    EXPECT_EQ(0, cvtest::norm(src, dst.back(), NORM_INF));
+}
+
+TEST(Imgproc_WarpPipeline, bad_stages)
+{
+    Mat src(16, 16, CV_8UC1, Scalar::all(1)), dst;
+    EXPECT_ANY_THROW(WarpPipeline().cvtColor(COLOR_BayerBG2BGR));
+    EXPECT_ANY_THROW(WarpPipeline().cvtColor(COLOR_YUV2BGR_NV12).apply(src, dst));
+    EXPECT_ANY_THROW(WarpPipeline().setInterpolation(INTER_AREA));
+    EXPECT_ANY_THROW(WarpPipeline().warpAffine(Mat::eye(3, 3, CV_64F), Size(4, 4)));
+
+    // in-place operation
+    Mat img = makeWarpPipelineTestImage(CV_8UC1), ref;
+    WarpPipeline flip;
+    flip.warpAffine(Matx23d(-1, 0, img.cols - 1, 0, 1, 0), img.size());
+    cv::flip(img, ref, 1);
+    flip.apply(img, img);
+    EXPECT_EQ(0, cvtest::norm(ref, img, NORM_INF));
+}
+
+}} // namespace
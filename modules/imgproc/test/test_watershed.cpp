@@ -128,3 +128,58 @@ TEST(Imgproc_Watershed, regression) { CV_WatershedTest test; test.safe_run(); }
 }} // namespace
 
 #endif
+
+namespace opencv_test { namespace {
+
+static void makeWatershedTestData(Size size, Mat& img, Mat& markers)
+{
+    RNG& rng = theRNG();
+    img.create(size, CV_8UC3);
+    img = Scalar::all(128);
+    markers = Mat::zeros(size, CV_32S);
+    rectangle(markers, Rect(2, 2, size.width - 4, size.height - 4), Scalar::all(1));
+    int label = 2;
+    for( int y = 40; y < size.height - 30; y += 70 )
+        for( int x = 40; x < size.width - 30; x += 70, label++ )
+        {
+            Point c(x + rng.uniform(-5, 5), y + rng.uniform(-5, 5));
+            circle(img, c, rng.uniform(15, 30), Scalar(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256)), -1);
+            circle(markers, c, 3, Scalar::all(label), -1);
+        }
+    Mat noise(size, CV_8UC3);
+    rng.fill(noise, RNG::NORMAL, 0, 8);
+    cv::add(img, noise, img);
+    cv::GaussianBlur(img, img, Size(0, 0), 1);
+}
+
+TEST(Imgproc_Watershed, tiled)
+{
+    Mat img, markers0;
+    makeWatershedTestData(Size(417, 343), img, markers0);
+
+    Mat ref = markers0.clone();
+    cv::watershed(img, ref);
+
+    // the single tile processes the pixels in the same order
+    Mat single = markers0.clone();
+    cv::watershed(img, single, img.size());
+    EXPECT_EQ(0, cvtest::norm(ref, single, NORM_INF));
+
+    int nthreads = getNumThreads();
+    Mat res[2];
+    for( int k = 0; k < 2; k++ )
+    {
+        setNumThreads(k == 0 ? 1 : 4);
+        res[k] = markers0.clone();
+        cv::watershed(img, res[k], Size(32, 24));
+    }
+    setNumThreads(nthreads);
+    EXPECT_EQ(0, cvtest::norm(res[0], res[1], NORM_INF));
+
+    // every pixel is labeled, and the basins differ only along the boundaries
+    Mat r = res[0](Rect(1, 1, img.cols - 2, img.rows - 2));
+    EXPECT_EQ(0, countNonZero((r == 0) | (r < -1)));
+    EXPECT_LE(countNonZero(res[0] != ref), (int)(img.total()/200));
+}
+
+}} // namespace